@@ -33,6 +33,7 @@ ONEFLOW_API_PYBIND11_MODULE("", m) {
 
   m.attr("char") = DType::Char().GetPtrOrThrow();
   m.attr("float16") = DType::Float16().GetPtrOrThrow();
+  m.attr("bfloat16") = DType::BFloat16().GetPtrOrThrow();
   m.attr("float") = DType::Float().GetPtrOrThrow();
 
   m.attr("float32") = DType::Float().GetPtrOrThrow();
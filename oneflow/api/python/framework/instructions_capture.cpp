@@ -0,0 +1,47 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <pybind11/pybind11.h>
+#include "oneflow/api/python/of_api_registry.h"
+#include "oneflow/core/framework/instructions_capture.h"
+#include "oneflow/core/framework/tensor.h"
+#include "oneflow/core/framework/tensor_tuple.h"
+
+namespace py = pybind11;
+
+namespace oneflow {
+
+ONEFLOW_API_PYBIND11_MODULE("", m) {
+  py::class_<InstructionsCapture, std::shared_ptr<InstructionsCapture>>(m, "InstructionsCapture")
+      .def(py::init([]() { return std::make_shared<InstructionsCapture>(); }))
+      .def("begin_capture",
+           [](InstructionsCapture* capture) { return capture->BeginCapture().GetOrThrow(); })
+      .def("end_capture",
+           [](InstructionsCapture* capture) { return capture->EndCapture().GetOrThrow(); })
+      .def("mark_output",
+           [](InstructionsCapture* capture, const std::shared_ptr<one::Tensor>& tensor) {
+             return capture->MarkOutput(tensor).GetOrThrow();
+           })
+      .def("replay",
+           [](InstructionsCapture* capture, const one::TensorTuple& captured_inputs,
+              const one::TensorTuple& inputs) {
+             return capture->Replay(captured_inputs, inputs).GetPtrOrThrow();
+           })
+      .def_property_readonly("is_capturing", &InstructionsCapture::is_capturing)
+      .def_property_readonly("instruction_size", &InstructionsCapture::instruction_size)
+      .def_property_readonly("external_slot_size", &InstructionsCapture::external_slot_size);
+}
+
+}  // namespace oneflow
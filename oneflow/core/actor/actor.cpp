@@ -97,6 +97,26 @@ void Actor::Init(const JobDesc* job_desc, const TaskProto& task_proto,
   TakeOverNaiveProduced(task_proto.produced_regst_desc());
   InitBnInOp2BlobInfo(task_proto);
   VirtualActorInit(task_proto);
+  InitRegstNumTuningCtx(task_proto);
+}
+
+void Actor::InitRegstNumTuningCtx(const TaskProto& task_proto) {
+  if (Global<RegstNumTuner>::Get() == nullptr) { return; }
+  std::unique_ptr<RegstNumTuningCtx> ctx(new RegstNumTuningCtx);
+  for (const auto& pair : task_proto.produced_regst_desc()) {
+    const RegstDescProto& regst_desc = pair.second;
+    const int64_t regst_desc_id = regst_desc.regst_desc_id();
+    if (!naive_produced_rs_.HasRegstDescId(regst_desc_id)) { continue; }
+    if (produced_regsts_.at(regst_desc_id).size() >= regst_desc.max_register_num()) { continue; }
+    if (!Global<RegstMgr>::Get()->IsRegstNumExtensible(regst_desc)) { continue; }
+    const RtRegstDesc& rt_regst_desc =
+        Global<RegstMgr>::Get()->RegstDesc4RegstDescId(regst_desc_id);
+    if (rt_regst_desc.consumers_actor_id().empty()) { continue; }
+    ctx->regst_desc_id2stat[regst_desc_id].regst_desc = regst_desc;
+  }
+  if (ctx->regst_desc_id2stat.empty()) { return; }
+  ctx->act_duration_counter.reset(new ActDurationCounter);
+  regst_num_tuning_ctx_ = std::move(ctx);
 }
 
 void Actor::TakeOverInplaceConsumedAndProduced(
@@ -199,6 +219,15 @@ void Actor::InitBnInOp2BlobInfo(const TaskProto& task_proto) {
       }
       ek.bn_in_op2blob_info.emplace(bn, std::move(blob_info));
     }
+    ek.is_launched_by_index = true;
+    for (const std::string& bn : ek.kernel->bn_in_op_vec()) {
+      const BlobInfo& blob_info = ek.bn_in_op2blob_info.at(bn);
+      if (blob_info.regst_desc_id != -1 && blob_info.rs == nullptr) {
+        ek.is_launched_by_index = false;
+      }
+      ek.blob_info_vec.push_back(blob_info);
+    }
+    ek.index2blob.resize(ek.blob_info_vec.size(), nullptr);
   }
 }
 
@@ -415,10 +444,89 @@ void Actor::TryLogActEvent(const std::function<void()>& DoAct) const {
   }
 }
 
+void Actor::TryCountActDuration(const std::function<void()>& DoAct) const {
+  if (regst_num_tuning_ctx_ == nullptr) {
+    DoAct();
+    return;
+  }
+  std::shared_ptr<ActDurationCounter> counter = regst_num_tuning_ctx_->act_duration_counter;
+  device_ctx_->AddCallBack([counter]() { counter->start_time = GetCurTime(); });
+  DoAct();
+  device_ctx_->AddCallBack([counter]() {
+    counter->duration_sum += static_cast<int64_t>(GetCurTime() - counter->start_time);
+    counter->act_cnt += 1;
+  });
+}
+
+void Actor::CountRegstDurationIfReturned(Regst* regst) {
+  auto send_time_it = regst_num_tuning_ctx_->regst2send_time.find(regst);
+  if (send_time_it == regst_num_tuning_ctx_->regst2send_time.end()) { return; }
+  RegstNumTuningCtx::RegstDescStat& stat =
+      regst_num_tuning_ctx_->regst_desc_id2stat.at(regst->regst_desc_id());
+  stat.duration_sum += GetCurTime() - send_time_it->second;
+  stat.returned_cnt += 1;
+  regst_num_tuning_ctx_->regst2send_time.erase(send_time_it);
+}
+
+void Actor::TryTuneRegstNum() {
+  RegstNumTuningCtx* ctx = regst_num_tuning_ctx_.get();
+  if (act_id_ != ctx->last_write_blocked_act_id && IsReadReady() && !IsWriteReady()) {
+    ctx->last_write_blocked_act_id = act_id_;
+    for (auto& pair : ctx->regst_desc_id2stat) {
+      if (naive_produced_rs_.Front(pair.first) == nullptr) {
+        pair.second.write_blocked_act_cnt += 1;
+      }
+    }
+  }
+  const int64_t act_cnt = act_id_ + 1;
+  if (act_cnt < Global<RegstNumTuner>::Get()->tuning_act_num()) { return; }
+  const int64_t counted_act_cnt = ctx->act_duration_counter->act_cnt;
+  // the callbacks of a device stream may still be counting
+  if (counted_act_cnt == 0) { return; }
+  const double act_duration =
+      static_cast<double>(ctx->act_duration_counter->duration_sum) / counted_act_cnt;
+  bool is_grown = false;
+  for (const auto& pair : ctx->regst_desc_id2stat) {
+    const RegstNumTuningCtx::RegstDescStat& stat = pair.second;
+    // a regst desc is a bottleneck if at least a quarter of the acts waited for it to return
+    if (stat.returned_cnt == 0 || stat.write_blocked_act_cnt * 4 < act_cnt) { continue; }
+    std::vector<std::unique_ptr<Regst>>& regsts = produced_regsts_.at(pair.first);
+    const int64_t cur_regst_num = regsts.size();
+    const double regst_duration = stat.duration_sum / stat.returned_cnt;
+    const int64_t tuned_regst_num = CalcTunedRegstNum(
+        regst_duration, act_duration, cur_regst_num, stat.regst_desc.max_register_num());
+    const RtRegstDesc& rt_regst_desc = Global<RegstMgr>::Get()->RegstDesc4RegstDescId(pair.first);
+    int64_t regst_num = cur_regst_num;
+    while (regst_num < tuned_regst_num
+           && Global<RegstNumTuner>::Get()->TryReserveMem(
+               rt_regst_desc.mem_case(), rt_regst_desc.MainByteSize4OneRegst())) {
+      Regst* regst = Global<RegstMgr>::Get()->NewExtraRegst(stat.regst_desc);
+      regsts.emplace_back(regst);
+      produced_regst2reading_cnt_[regst] = 0;
+      CHECK_EQ(0, naive_produced_rs_.TryPushBackRegst(regst));
+      regst_num += 1;
+    }
+    if (tuned_regst_num == cur_regst_num) { continue; }
+    LOG(INFO) << "actor " << actor_id_ << " grows regst num of regst desc " << pair.first
+              << " from " << cur_regst_num << " to " << regst_num << ", wanted "
+              << tuned_regst_num << ": blocked after " << stat.write_blocked_act_cnt << " of "
+              << act_cnt << " acts, act duration " << act_duration << " ns, regst duration "
+              << regst_duration << " ns";
+    if (regst_num < tuned_regst_num) {
+      LOG(WARNING) << "actor " << actor_id_ << " ran out of online_regst_num_tuning_mem_mbyte, "
+                   << Global<RegstNumTuner>::Get()->ReservedMemSize(rt_regst_desc.mem_case())
+                   << " bytes reserved in its memory zone";
+    }
+    is_grown = is_grown || regst_num > cur_regst_num;
+  }
+  regst_num_tuning_ctx_.reset();
+  if (is_grown) { ActUntilFail(); }
+}
+
 void Actor::ActUntilFail() {
   while (IsReadReady() && IsWriteReady()) {
     act_id_ += 1;
-    TryLogActEvent([&] { Act(); });
+    TryLogActEvent([&] { TryCountActDuration([&] { Act(); }); });
 
     AsyncSendCustomizedProducedRegstMsgToConsumer();
     AsyncSendNaiveProducedRegstMsgToConsumer();
@@ -430,6 +538,7 @@ void Actor::ActUntilFail() {
 
     AsyncSendQueuedMsg();
   }
+  if (regst_num_tuning_ctx_ != nullptr) { TryTuneRegstNum(); }
 }
 
 void Actor::AsyncSendNaiveProducedRegstMsgToConsumer() {
@@ -522,6 +631,10 @@ int64_t Actor::HandleRegstToConsumer(Regst* regst, std::function<bool(int64_t)>
   }
   total_reading_cnt_ += real_consumer_cnt;
   regst_reading_cnt_it->second += real_consumer_cnt;
+  if (regst_num_tuning_ctx_ != nullptr && real_consumer_cnt > 0
+      && regst_num_tuning_ctx_->regst_desc_id2stat.count(regst->regst_desc_id()) > 0) {
+    regst_num_tuning_ctx_->regst2send_time[regst] = GetCurTime();
+  }
   return real_consumer_cnt;
 }
 
@@ -537,7 +650,28 @@ bool Actor::IsWriteReady() const {
 
 void Actor::AsyncLaunchKernel(const KernelCtx& kernel_ctx,
                               std::function<Regst*(int64_t)> Regst4RegstDescId) {
-  for (const ExecKernel& ek : exec_kernel_vec_) {
+  for (ExecKernel& ek : exec_kernel_vec_) {
+    if (ek.is_launched_by_index) {
+      int64_t last_regst_desc_id = -1;
+      Regst* last_regst = nullptr;
+      FOR_RANGE(int64_t, i, 0, ek.blob_info_vec.size()) {
+        const BlobInfo& info = ek.blob_info_vec.at(i);
+        ek.index2blob.at(i) = nullptr;
+        if (info.regst_desc_id == -1) { continue; }
+        if (info.regst_desc_id != last_regst_desc_id) {
+          last_regst_desc_id = info.regst_desc_id;
+          last_regst = info.rs->Front(info.regst_desc_id);
+        }
+        if (last_regst == nullptr) { continue; }
+        if (info.ordinal >= 0) {
+          ek.index2blob.at(i) = last_regst->GetBlobByOrdinal(info.ordinal);
+        } else {
+          ek.index2blob.at(i) = last_regst->GetBlobByLbi(info.lbi);
+        }
+      }
+      ek.kernel->Launch(kernel_ctx, ek.index2blob);
+      continue;
+    }
     ek.kernel->Launch(kernel_ctx, [&](const std::string& bn_in_op) -> Blob* {
       const auto blob_info_it = ek.bn_in_op2blob_info.find(bn_in_op);
       if (blob_info_it == ek.bn_in_op2blob_info.cend()) { return nullptr; }
@@ -678,6 +812,7 @@ int Actor::TryUpdtStateAsProducedRegst(Regst* regst) {
   reading_cnt_it->second -= 1;
   total_reading_cnt_ -= 1;
   if (reading_cnt_it->second != 0) { return 0; }
+  if (regst_num_tuning_ctx_ != nullptr) { CountRegstDurationIfReturned(regst); }
 
   if (inplace_produced_rs_.TryPushBackRegst(regst) == 0) {
     int64_t in_regst_desc_id = inplace_regst_desc_id_out2in_.at(regst->regst_desc_id());
@@ -27,6 +27,7 @@ limitations under the License.
 #include "oneflow/core/register/register_manager.h"
 #include "oneflow/core/thread/thread_context.h"
 #include "oneflow/core/actor/register_slot.h"
+#include "oneflow/core/actor/regst_num_tuner.h"
 
 namespace oneflow {
 
@@ -57,6 +58,11 @@ class Actor {
   struct ExecKernel {
     std::unique_ptr<const Kernel> kernel;
     HashMap<std::string, BlobInfo> bn_in_op2blob_info;
+    // Blob infos in the order of kernel->bn_in_op_vec(), resolved into index2blob before each
+    // launch if all of them are in regst slots of the actor
+    std::vector<BlobInfo> blob_info_vec;
+    std::vector<Blob*> index2blob;
+    bool is_launched_by_index;
   };
   using MsgHandler = int (Actor::*)(const ActorMsg&);
   enum class RegstNameType { kNaive = 0, kCustomized };
@@ -173,6 +179,12 @@ class Actor {
   }
   void TryLogActEvent(const std::function<void()>& Callback) const;
 
+  // Online regst number tuning
+  void InitRegstNumTuningCtx(const TaskProto& task_proto);
+  void TryCountActDuration(const std::function<void()>& DoAct) const;
+  void CountRegstDurationIfReturned(Regst* regst);
+  void TryTuneRegstNum();
+
   // Ready
   bool IsReadReady() const;
   bool IsWriteReady() const;
@@ -250,6 +262,7 @@ class Actor {
   std::deque<ActorMsg> async_msg_queue_;
   bool is_kernel_launch_synchronized_;
   std::vector<int64_t> tmp_regst_desc_id_vec_;
+  std::unique_ptr<RegstNumTuningCtx> regst_num_tuning_ctx_;
 };
 
 std::unique_ptr<Actor> NewActor(const TaskProto&, const ThreadCtx&);
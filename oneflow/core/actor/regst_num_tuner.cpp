@@ -0,0 +1,51 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/actor/regst_num_tuner.h"
+
+namespace oneflow {
+
+namespace {
+
+int64_t MemZoneId4MemCase(const MemoryCase& mem_case) {
+  if (mem_case.has_device_cuda_mem()) { return mem_case.device_cuda_mem().device_id(); }
+  CHECK(mem_case.has_host_mem());
+  return -1;
+}
+
+}  // namespace
+
+bool RegstNumTuner::TryReserveMem(const MemoryCase& mem_case, int64_t size) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  int64_t& reserved_size = mem_zone_id2reserved_size_[MemZoneId4MemCase(mem_case)];
+  if (reserved_size + size > mem_budget_size_) { return false; }
+  reserved_size += size;
+  return true;
+}
+
+int64_t RegstNumTuner::ReservedMemSize(const MemoryCase& mem_case) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto it = mem_zone_id2reserved_size_.find(MemZoneId4MemCase(mem_case));
+  return it == mem_zone_id2reserved_size_.end() ? 0 : it->second;
+}
+
+int64_t CalcTunedRegstNum(double regst_duration, double act_duration, int64_t cur_regst_num,
+                          int64_t max_regst_num) {
+  if (act_duration <= 0) { return cur_regst_num; }
+  const int64_t regst_num = static_cast<int64_t>(std::ceil(regst_duration / act_duration));
+  return std::max(cur_regst_num, std::min(regst_num, max_regst_num));
+}
+
+}  // namespace oneflow
@@ -0,0 +1,83 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_ACTOR_REGST_NUM_TUNER_H_
+#define ONEFLOW_CORE_ACTOR_REGST_NUM_TUNER_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/memory/memory_case.pb.h"
+#include "oneflow/core/register/register_desc.pb.h"
+
+namespace oneflow {
+
+class Regst;
+
+// Online counterpart of the experiment phase of Improver.
+//
+// During the first `tuning_act_num` acts of a job every actor measures how long its acts take on
+// its stream and how long each naive produced regst stays away at its consumers. An actor whose
+// acts kept waiting for a produced regst to come back then grows that regst desc to the regst
+// number Improver would have planned, with memory taken from a per memory zone budget.
+class RegstNumTuner final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(RegstNumTuner);
+  RegstNumTuner(int64_t tuning_act_num, int64_t mem_budget_size)
+      : tuning_act_num_(tuning_act_num), mem_budget_size_(mem_budget_size) {}
+  ~RegstNumTuner() = default;
+
+  int64_t tuning_act_num() const { return tuning_act_num_; }
+  // Returns false and reserves nothing if `size` bytes would exceed the budget of the zone
+  bool TryReserveMem(const MemoryCase& mem_case, int64_t size);
+  int64_t ReservedMemSize(const MemoryCase& mem_case) const;
+
+ private:
+  const int64_t tuning_act_num_;
+  const int64_t mem_budget_size_;
+  mutable std::mutex mutex_;
+  HashMap<int64_t, int64_t> mem_zone_id2reserved_size_;
+};
+
+// Act durations on the stream of an actor, shared with the callbacks of its device ctx
+struct ActDurationCounter {
+  ActDurationCounter() : act_cnt(0), duration_sum(0), start_time(0) {}
+  std::atomic<int64_t> act_cnt;
+  std::atomic<int64_t> duration_sum;
+  // only touched by the callbacks, which run in stream order
+  double start_time;
+};
+
+// Per actor state of the online tuning
+struct RegstNumTuningCtx {
+  struct RegstDescStat {
+    RegstDescProto regst_desc;
+    int64_t returned_cnt = 0;
+    double duration_sum = 0;
+    int64_t write_blocked_act_cnt = 0;
+  };
+  std::shared_ptr<ActDurationCounter> act_duration_counter;
+  HashMap<int64_t, RegstDescStat> regst_desc_id2stat;
+  HashMap<Regst*, double> regst2send_time;
+  int64_t last_write_blocked_act_id = -1;
+};
+
+// The regst number that hides `regst_duration`, the time a regst takes from being sent to
+// consumers till being returned, behind acts of `act_duration`, as CalcRegstNum of Improver with
+// ii_scale 1. The result is clamped to [cur_regst_num, max_regst_num].
+int64_t CalcTunedRegstNum(double regst_duration, double act_duration, int64_t cur_regst_num,
+                          int64_t max_regst_num);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_ACTOR_REGST_NUM_TUNER_H_
@@ -0,0 +1,47 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/actor/regst_num_tuner.h"
+
+namespace oneflow {
+
+namespace test {
+
+TEST(RegstNumTuner, calc_tuned_regst_num) {
+  // a regst away for 3.5 acts needs 4 regsts to keep its producer busy
+  ASSERT_EQ(CalcTunedRegstNum(350, 100, 2, 8), 4);
+  ASSERT_EQ(CalcTunedRegstNum(350, 100, 2, 3), 3);
+  // never shrinks
+  ASSERT_EQ(CalcTunedRegstNum(100, 100, 2, 8), 2);
+  ASSERT_EQ(CalcTunedRegstNum(350, 0, 2, 8), 2);
+}
+
+TEST(RegstNumTuner, reserve_mem_per_zone) {
+  RegstNumTuner tuner(16, 100);
+  MemoryCase host_mem_case;
+  host_mem_case.mutable_host_mem();
+  MemoryCase device_mem_case;
+  device_mem_case.mutable_device_cuda_mem()->set_device_id(0);
+  ASSERT_TRUE(tuner.TryReserveMem(host_mem_case, 60));
+  ASSERT_FALSE(tuner.TryReserveMem(host_mem_case, 60));
+  ASSERT_TRUE(tuner.TryReserveMem(device_mem_case, 60));
+  ASSERT_TRUE(tuner.TryReserveMem(host_mem_case, 40));
+  ASSERT_EQ(tuner.ReservedMemSize(host_mem_case), 100);
+  ASSERT_EQ(tuner.ReservedMemSize(device_mem_case), 60);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
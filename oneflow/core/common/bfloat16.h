@@ -0,0 +1,81 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_COMMON_BFLOAT16_H_
+#define ONEFLOW_CORE_COMMON_BFLOAT16_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace oneflow {
+
+#if defined(__CUDACC__)
+#define OF_BFLOAT16_FUNC __device__ __host__ __forceinline__
+#else
+#define OF_BFLOAT16_FUNC inline
+#endif
+
+// Brain floating point: the upper 16 bits of an IEEE float32, i.e. 1 sign bit, 8 exponent bits
+// and 7 mantissa bits. It has the range of float32 with less precision, so float32 models can be
+// computed in bfloat16 without loss scaling. Arithmetic goes through float32.
+struct bfloat16 {
+  uint16_t x;
+
+  bfloat16() = default;
+  OF_BFLOAT16_FUNC bfloat16(float val) : x(RoundToNearestEven(val)) {}  // NOLINT
+
+  OF_BFLOAT16_FUNC operator float() const {  // NOLINT
+    const uint32_t bits = static_cast<uint32_t>(x) << 16;
+    float val;
+    std::memcpy(&val, &bits, sizeof(val));
+    return val;
+  }
+
+  OF_BFLOAT16_FUNC bfloat16& operator+=(float rhs) { return *this = float(*this) + rhs; }
+  OF_BFLOAT16_FUNC bfloat16& operator-=(float rhs) { return *this = float(*this) - rhs; }
+  OF_BFLOAT16_FUNC bfloat16& operator*=(float rhs) { return *this = float(*this) * rhs; }
+  OF_BFLOAT16_FUNC bfloat16& operator/=(float rhs) { return *this = float(*this) / rhs; }
+
+  OF_BFLOAT16_FUNC static bfloat16 FromBits(uint16_t bits) {
+    bfloat16 ret;
+    ret.x = bits;
+    return ret;
+  }
+
+  OF_BFLOAT16_FUNC static uint16_t RoundToNearestEven(float val) {
+    uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    // keep NaNs quiet instead of rounding them to infinity
+    if ((bits & 0x7fffffffU) > 0x7f800000U) { return static_cast<uint16_t>((bits >> 16) | 0x40); }
+    bits += 0x7fffU + ((bits >> 16) & 1U);
+    return static_cast<uint16_t>(bits >> 16);
+  }
+};
+
+static_assert(sizeof(bfloat16) == 2, "sizeof(bfloat16) != 2");
+
+inline void ConvertFloatToBFloat16(int64_t n, const float* in, bfloat16* out) {
+  for (int64_t i = 0; i < n; ++i) { out[i] = in[i]; }
+}
+
+inline void ConvertBFloat16ToFloat(int64_t n, const bfloat16* in, float* out) {
+  for (int64_t i = 0; i < n; ++i) { out[i] = in[i]; }
+}
+
+#undef OF_BFLOAT16_FUNC
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_COMMON_BFLOAT16_H_
@@ -0,0 +1,68 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <cmath>
+#include <limits>
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/common/bfloat16.h"
+
+namespace oneflow {
+
+namespace test {
+
+TEST(BFloat16, exact_values) {
+  for (float val : {0.f, 1.f, -2.f, 0.5f, 256.f, -3.f / 128.f}) {
+    ASSERT_EQ(static_cast<float>(bfloat16(val)), val);
+  }
+  ASSERT_EQ(bfloat16(1.f).x, 0x3f80);
+  ASSERT_EQ(bfloat16(-2.f).x, 0xc000);
+}
+
+TEST(BFloat16, round_to_nearest_even) {
+  // 1 + 2^-8 is halfway between 1 and 1 + 2^-7, ties go to the even mantissa
+  ASSERT_EQ(bfloat16(1.f + std::ldexp(1.f, -8)).x, 0x3f80);
+  ASSERT_EQ(bfloat16(1.f + 3.f * std::ldexp(1.f, -8)).x, 0x3f82);
+  ASSERT_EQ(bfloat16(1.f + std::ldexp(1.f, -8) + std::ldexp(1.f, -20)).x, 0x3f81);
+  ASSERT_EQ(bfloat16(std::numeric_limits<float>::max()).x, 0x7f80);
+  ASSERT_EQ(bfloat16(std::numeric_limits<float>::infinity()).x, 0x7f80);
+}
+
+TEST(BFloat16, nan) {
+  const bfloat16 nan(std::numeric_limits<float>::quiet_NaN());
+  ASSERT_TRUE(std::isnan(static_cast<float>(nan)));
+  ASSERT_TRUE(std::isnan(static_cast<float>(bfloat16::FromBits(0x7f81))));
+}
+
+TEST(BFloat16, arithmetic) {
+  bfloat16 val(1.5f);
+  val += 2.f;
+  ASSERT_EQ(static_cast<float>(val), 3.5f);
+  val *= 2.f;
+  ASSERT_EQ(static_cast<float>(val), 7.f);
+  ASSERT_EQ(static_cast<float>(bfloat16(val * 0.5f)), 3.5f);
+}
+
+TEST(BFloat16, convert) {
+  std::vector<float> in = {0.f, 1.f, -1.f, 100.f, 0.1f};
+  std::vector<bfloat16> bf16(in.size());
+  std::vector<float> out(in.size());
+  ConvertFloatToBFloat16(in.size(), in.data(), bf16.data());
+  ConvertBFloat16ToFloat(in.size(), bf16.data(), out.data());
+  for (size_t i = 0; i < in.size(); ++i) { ASSERT_NEAR(out[i], in[i], std::abs(in[i]) / 128); }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -15,6 +15,7 @@ limitations under the License.
 */
 #include "oneflow/core/device/cpu_stream_index.h"
 #include "oneflow/core/job/resource_desc.h"
+#include "oneflow/core/thread/numa_topology.h"
 
 namespace oneflow {
 
@@ -28,12 +29,58 @@ CPUStreamIndexGenerator::CPUStreamIndexGenerator()
   next_stream_index_++;
   tick_tock_stream_index_ = next_stream_index_;
   next_stream_index_++;
+  is_numa_aware_ = IsNumaAwareCpuActorEnabled();
+  const int64_t numa_node_num = is_numa_aware_ ? NumaTopology::Get().node_num() : 1;
+  numa_node2compute_stream_indexes_.resize(numa_node_num);
+  numa_node2compute_stream_index_counter_.resize(numa_node_num, 0);
+  // the i-th compute stream is on the numa node of cpu device i
+  FOR_RANGE(stream_index_t, i, 0, compute_stream_num_) {
+    numa_node2compute_stream_indexes_.at(NumaNode4CpuDevice(i)).push_back(
+        compute_stream_index_begin_ + i);
+  }
+  compute_stream_loads_.resize(compute_stream_num_, 0);
+}
+
+int64_t CPUStreamIndexGenerator::NumaNode4CpuDevice(int64_t dev_phy_id) const {
+  if (!is_numa_aware_) { return 0; }
+  return NumaTopology::Get().NumaNode4CpuDevice(dev_phy_id, compute_stream_num_);
 }
 
 StreamIndexGenerator::stream_index_t CPUStreamIndexGenerator::GenerateComputeStreamIndex() {
   return compute_stream_index_begin_ + (compute_stream_index_counter_++ % compute_stream_num_);
 }
 
+StreamIndexGenerator::stream_index_t CPUStreamIndexGenerator::GenerateComputeStreamIndex4CpuDevice(
+    int64_t dev_phy_id) {
+  if (!is_numa_aware_) { return GenerateComputeStreamIndex(); }
+  const int64_t node = NumaNode4CpuDevice(dev_phy_id);
+  const auto& stream_indexes = numa_node2compute_stream_indexes_.at(node);
+  size_t* counter = &numa_node2compute_stream_index_counter_.at(node);
+  return stream_indexes.at((*counter)++ % stream_indexes.size());
+}
+
+StreamIndexGenerator::stream_index_t
+CPUStreamIndexGenerator::GenerateComputeStreamIndex4CpuDeviceByCost(
+    int64_t dev_phy_id, double cost, int64_t colocated_stream_index) {
+  const auto& stream_indexes =
+      numa_node2compute_stream_indexes_.at(NumaNode4CpuDevice(dev_phy_id));
+  const auto Load4StreamIndex = [&](stream_index_t stream_index) -> double& {
+    return compute_stream_loads_.at(stream_index - compute_stream_index_begin_);
+  };
+  stream_index_t picked = stream_indexes.front();
+  for (stream_index_t stream_index : stream_indexes) {
+    if (Load4StreamIndex(stream_index) < Load4StreamIndex(picked)) { picked = stream_index; }
+  }
+  if (colocated_stream_index != -1
+      && std::find(stream_indexes.begin(), stream_indexes.end(), colocated_stream_index)
+             != stream_indexes.end()
+      && Load4StreamIndex(colocated_stream_index) <= Load4StreamIndex(picked) + cost) {
+    picked = colocated_stream_index;
+  }
+  Load4StreamIndex(picked) += cost;
+  return picked;
+}
+
 StreamIndexGenerator::stream_index_t CPUStreamIndexGenerator::GenerateCommNetStreamIndex() {
   return comm_net_stream_index_;
 }
@@ -28,6 +28,18 @@ class CPUStreamIndexGenerator final : public StreamIndexGenerator {
   ~CPUStreamIndexGenerator() = default;
 
   stream_index_t GenerateComputeStreamIndex() override;
+  // Same as GenerateComputeStreamIndex() unless numa awareness is enabled, in which case the
+  // streams on the numa node of cpu device `dev_phy_id` are picked round-robin. All machines are
+  // assumed to have the numa topology of the compiling one.
+  stream_index_t GenerateComputeStreamIndex4CpuDevice(int64_t dev_phy_id);
+  // Picks the least loaded one among the compute streams of cpu device `dev_phy_id`, those on its
+  // numa node if numa awareness is enabled or all otherwise, and adds `cost` to its load.
+  // `colocated_stream_index` is picked instead if it is a candidate whose load exceeds the least
+  // one by no more than `cost`.
+  stream_index_t GenerateComputeStreamIndex4CpuDeviceByCost(int64_t dev_phy_id, double cost,
+                                                            int64_t colocated_stream_index);
+  // indexed by compute stream index - compute_stream_index_begin
+  const std::vector<double>& compute_stream_loads() const { return compute_stream_loads_; }
   stream_index_t GenerateH2DStreamIndex() override { UNIMPLEMENTED(); }
   stream_index_t GenerateD2HStreamIndex() override { UNIMPLEMENTED(); }
   stream_index_t GenerateCommNetStreamIndex();
@@ -35,6 +47,8 @@ class CPUStreamIndexGenerator final : public StreamIndexGenerator {
   stream_index_t GenerateIndependentTaskStreamIndex(TaskType task_type);
 
  private:
+  int64_t NumaNode4CpuDevice(int64_t dev_phy_id) const;
+
   stream_index_t next_stream_index_;
   stream_index_t compute_stream_index_begin_;
   stream_index_t compute_stream_num_;
@@ -42,6 +56,12 @@ class CPUStreamIndexGenerator final : public StreamIndexGenerator {
   stream_index_t tick_tock_stream_index_;
   // for GenerateComputeStreamIndex
   stream_index_t compute_stream_index_counter_;
+  // for GenerateComputeStreamIndex4CpuDevice*, all compute streams are on node 0 if numa
+  // awareness is disabled
+  bool is_numa_aware_;
+  std::vector<std::vector<stream_index_t>> numa_node2compute_stream_indexes_;
+  std::vector<size_t> numa_node2compute_stream_index_counter_;
+  std::vector<double> compute_stream_loads_;
   // for GenerateIndependentStreamIndex
   HashMap<TaskType, size_t> task_type2max_stream_num_;
   HashMap<TaskType, std::vector<stream_index_t>> task_type2allocated_stream_index_vec_;
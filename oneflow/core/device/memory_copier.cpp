@@ -15,7 +15,12 @@ limitations under the License.
 */
 #include "oneflow/core/device/memory_copier.h"
 #include "oneflow/core/common/auto_registration_factory.h"
+#include "oneflow/core/common/balanced_splitter.h"
 #include "oneflow/core/common/nd_index_offset_helper.h"
+#include "oneflow/core/thread/thread_manager.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace oneflow {
 
@@ -75,28 +80,107 @@ MemoryCopyNdDesc GetDescInBytes(const MemoryCopyNdDesc& desc) {
   return desc_in_bytes;
 }
 
+// host copies smaller than this stay on the calling thread
+constexpr int64_t kParallelHostCopyMinByteSize = 1 << 20;
+constexpr int64_t kParallelHostCopyPartMinByteSize = 256 << 10;
+// rows of host copies larger than the last level cache are written around the cache
+constexpr int64_t kNonTemporalHostCopyMinByteSize = 32 << 20;
+constexpr int64_t kNonTemporalHostCopyRowMinByteSize = 4 << 10;
+
+void CopyHostRow(unsigned char* dst, const unsigned char* src, size_t size,
+                 bool use_non_temporal) {
+#ifdef __SSE2__
+  if (use_non_temporal) {
+    const size_t head = std::min(size, (16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16);
+    memcpy(dst, src, head);
+    size_t i = head;
+    for (; i + 64 <= size; i += 64) {
+      const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+      const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+      const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v0);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 16), v1);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 32), v2);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 48), v3);
+    }
+    _mm_sfence();
+    memcpy(dst + i, src + i, size - i);
+    return;
+  }
+#endif
+  memcpy(dst, src, size);
+}
+
+// Calls Handler with the [begin, end) ranges of `unit_num` units of a copy of `byte_size` bytes,
+// on the threads of Global<ThreadPool> if the copy is large enough
+void ForEachHostCopyPart(int64_t byte_size, int64_t unit_num,
+                         const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  int64_t part_num = 1;
+  if (byte_size >= kParallelHostCopyMinByteSize && Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(),
+                                 byte_size / kParallelHostCopyPartMinByteSize);
+    part_num = std::max<int64_t>(std::min(part_num, unit_num), 1);
+  }
+  if (part_num == 1) {
+    Handler(0, unit_num);
+    return;
+  }
+  BalancedSplitter bs(unit_num, part_num);
+  MultiThreadLoop(part_num, [&](size_t part_id) {
+    const Range range = bs.At(part_id);
+    Handler(range.begin(), range.end());
+  });
+}
+
 }  // namespace
 
 template<int32_t NDIMS>
 void CopyNDCpuImpl(DeviceCtx* ctx, void* dst, const void* src, const MemoryCopyNdDesc& desc) {
-  NdIndexOffsetHelper<int64_t, NDIMS> src_helper(desc.src_shape.dim_vec().data());
-  NdIndexOffsetHelper<int64_t, NDIMS> dst_helper(desc.dst_shape.dim_vec().data());
-  NdIndexOffsetHelper<int64_t, NDIMS> copy_helper(desc.extent.dim_vec().data());
-  FOR_RANGE(int64_t, i, 0, desc.extent.elem_cnt()) {
-    int64_t copy_idx[NDIMS];
-    int64_t src_idx[NDIMS];
-    int64_t dst_idx[NDIMS];
-    copy_helper.OffsetToNdIndex(i, copy_idx);
-    FOR_RANGE(int64_t, j, 0, NDIMS) {
-      src_idx[j] = desc.src_pos.At(j) + copy_idx[j];
-      dst_idx[j] = desc.dst_pos.At(j) + copy_idx[j];
-    }
-    const int64_t src_offset = src_helper.NdIndexToOffset(src_idx);
-    const int64_t dst_offset = dst_helper.NdIndexToOffset(dst_idx);
-    unsigned char* dst_ptr = reinterpret_cast<unsigned char*>(dst) + dst_offset;
-    const unsigned char* src_ptr = reinterpret_cast<const unsigned char*>(src) + src_offset;
-    *dst_ptr = *src_ptr;
+  // The last axis of a desc in bytes is contiguous, so each row along it is copied at once and
+  // the offsets are stepped from row to row instead of being recomputed from nd indices.
+  const int64_t row_size = desc.extent.At(NDIMS - 1);
+  const int64_t byte_size = desc.extent.elem_cnt();
+  const int64_t row_num = byte_size / row_size;
+  const bool use_non_temporal = byte_size >= kNonTemporalHostCopyMinByteSize
+                                && row_size >= kNonTemporalHostCopyRowMinByteSize;
+  int64_t src_strides[NDIMS];
+  int64_t dst_strides[NDIMS];
+  src_strides[NDIMS - 1] = 1;
+  dst_strides[NDIMS - 1] = 1;
+  for (int32_t i = NDIMS - 2; i >= 0; --i) {
+    src_strides[i] = src_strides[i + 1] * desc.src_shape.At(i + 1);
+    dst_strides[i] = dst_strides[i + 1] * desc.dst_shape.At(i + 1);
+  }
+  const unsigned char* src_base = reinterpret_cast<const unsigned char*>(src);
+  unsigned char* dst_base = reinterpret_cast<unsigned char*>(dst);
+  FOR_RANGE(int32_t, i, 0, NDIMS) {
+    src_base += desc.src_pos.At(i) * src_strides[i];
+    dst_base += desc.dst_pos.At(i) * dst_strides[i];
   }
+  NdIndexOffsetHelper<int64_t, NDIMS - 1> row_helper(desc.extent.dim_vec().data());
+  ForEachHostCopyPart(byte_size, row_num, [&](int64_t begin, int64_t end) {
+    int64_t row_idx[NDIMS - 1];
+    row_helper.OffsetToNdIndex(begin, row_idx);
+    int64_t src_offset = 0;
+    int64_t dst_offset = 0;
+    FOR_RANGE(int32_t, i, 0, NDIMS - 1) {
+      src_offset += row_idx[i] * src_strides[i];
+      dst_offset += row_idx[i] * dst_strides[i];
+    }
+    FOR_RANGE(int64_t, row, begin, end) {
+      CopyHostRow(dst_base + dst_offset, src_base + src_offset, row_size, use_non_temporal);
+      for (int32_t i = NDIMS - 2; i >= 0; --i) {
+        row_idx[i] += 1;
+        src_offset += src_strides[i];
+        dst_offset += dst_strides[i];
+        if (row_idx[i] < desc.extent.At(i)) { break; }
+        row_idx[i] = 0;
+        src_offset -= desc.extent.At(i) * src_strides[i];
+        dst_offset -= desc.extent.At(i) * dst_strides[i];
+      }
+    }
+  });
 }
 
 MemoryCopyNdDesc MemoryCopyNdDesc::CreateDimReducedDesc() const {
@@ -194,14 +278,35 @@ void MemoryCopier::CopyND(DeviceCtx* ctx, void* dst, const void* src,
   UNIMPLEMENTED();
 }
 
+void HostMemoryCopier::Copy(DeviceCtx* ctx, void* dst, const void* src,
+                            const MemoryCopyNdDesc& desc) const {
+  CheckMemoryCopyNdDesc(desc);
+  const MemoryCopyNdDesc reduced = desc.CreateDimReducedDesc();
+  if (reduced.extent.NumAxes() == 1) {
+    Copy1D(ctx, (unsigned char*)dst + reduced.dst_pos.At(0),
+           (const unsigned char*)src + reduced.src_pos.At(0), reduced.extent.At(0));
+  } else {
+    CopyND(ctx, dst, src, reduced);
+  }
+}
+
 void HostMemoryCopier::Copy1D(DeviceCtx* ctx, void* dst, const void* src, size_t count) const {
-  memcpy(dst, src, count);
+  unsigned char* dst_ptr = reinterpret_cast<unsigned char*>(dst);
+  const unsigned char* src_ptr = reinterpret_cast<const unsigned char*>(src);
+  const bool use_non_temporal = count >= kNonTemporalHostCopyMinByteSize;
+  ForEachHostCopyPart(count, count, [&](int64_t begin, int64_t end) {
+    CopyHostRow(dst_ptr + begin, src_ptr + begin, end - begin, use_non_temporal);
+  });
 }
 
 void HostMemoryCopier::CopyND(DeviceCtx* ctx, void* dst, const void* src,
                               const MemoryCopyNdDesc& desc) const {
   const int32_t num_axes = desc.src_shape.NumAxes();
-  if (num_axes == 4) {
+  if (num_axes == 2) {
+    CopyNDCpuImpl<2>(ctx, dst, src, desc);
+  } else if (num_axes == 3) {
+    CopyNDCpuImpl<3>(ctx, dst, src, desc);
+  } else if (num_axes == 4) {
     CopyNDCpuImpl<4>(ctx, dst, src, desc);
   } else if (num_axes == 5) {
     CopyNDCpuImpl<5>(ctx, dst, src, desc);
@@ -323,6 +428,8 @@ SPECIALIZE_COPY_ELEM(int8_t)
 #define SPECIALIZE_COPY_ND_CPU_IMPL(NDIMS)                                        \
   template void CopyNDCpuImpl<NDIMS>(DeviceCtx * ctx, void* dst, const void* src, \
                                      const MemoryCopyNdDesc& desc);
+SPECIALIZE_COPY_ND_CPU_IMPL(2)
+SPECIALIZE_COPY_ND_CPU_IMPL(3)
 SPECIALIZE_COPY_ND_CPU_IMPL(4)
 SPECIALIZE_COPY_ND_CPU_IMPL(5)
 SPECIALIZE_COPY_ND_CPU_IMPL(6)
@@ -0,0 +1,96 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/device/memory_copier.h"
+#include "oneflow/core/thread/thread_pool.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+// copies byte by byte as a reference
+void NaiveCopy(void* dst, const void* src, const MemoryCopyNdDesc& desc) {
+  const int64_t num_axes = desc.extent.NumAxes();
+  FOR_RANGE(int64_t, i, 0, desc.extent.elem_cnt()) {
+    int64_t rest = i;
+    int64_t src_offset = 0;
+    int64_t dst_offset = 0;
+    int64_t copy_idx[SHAPE_MAX_AXIS_SIZE];
+    for (int64_t j = num_axes - 1; j >= 0; --j) {
+      copy_idx[j] = rest % desc.extent.At(j);
+      rest /= desc.extent.At(j);
+    }
+    FOR_RANGE(int64_t, j, 0, num_axes) {
+      src_offset = src_offset * desc.src_shape.At(j) + desc.src_pos.At(j) + copy_idx[j];
+      dst_offset = dst_offset * desc.dst_shape.At(j) + desc.dst_pos.At(j) + copy_idx[j];
+    }
+    static_cast<char*>(dst)[dst_offset] = static_cast<const char*>(src)[src_offset];
+  }
+}
+
+void TestHostCopy(const MemoryCopyNdDesc& desc) {
+  std::vector<char> src(desc.src_shape.elem_cnt());
+  FOR_RANGE(size_t, i, 0, src.size()) { src.at(i) = static_cast<char>(i * 7 + 3); }
+  std::vector<char> dst(desc.dst_shape.elem_cnt(), 0);
+  std::vector<char> expected(desc.dst_shape.elem_cnt(), 0);
+  NaiveCopy(expected.data(), src.data(), desc);
+  std::unique_ptr<MemoryCopier> copier(NewDefaultMemoryCopier(DeviceType::kCPU));
+  copier->Copy(nullptr, dst.data(), src.data(), desc);
+  ASSERT_TRUE(dst == expected);
+}
+
+MemoryCopyNdDesc MakeDesc(const Shape& dst_shape, const Shape& src_shape, const NdIndex& dst_pos,
+                          const NdIndex& src_pos, const Shape& extent) {
+  MemoryCopyNdDesc desc;
+  desc.dst_shape = dst_shape;
+  desc.src_shape = src_shape;
+  desc.dst_pos = dst_pos;
+  desc.src_pos = src_pos;
+  desc.extent = extent;
+  return desc;
+}
+
+}  // namespace
+
+TEST(HostMemoryCopier, copy_nd) {
+  TestHostCopy(MakeDesc(Shape({64}), Shape({100}), NdIndex({3}), NdIndex({20}), Shape({50})));
+  TestHostCopy(MakeDesc(Shape({8, 12}), Shape({6, 20}), NdIndex({1, 2}), NdIndex({0, 5}),
+                        Shape({5, 9})));
+  TestHostCopy(MakeDesc(Shape({4, 6, 8}), Shape({4, 6, 8}), NdIndex({0, 0, 0}),
+                        NdIndex({0, 0, 0}), Shape({4, 6, 8})));
+  TestHostCopy(MakeDesc(Shape({3, 5, 7, 9}), Shape({4, 6, 7, 9}), NdIndex({1, 2, 0, 0}),
+                        NdIndex({0, 1, 0, 0}), Shape({2, 3, 7, 9})));
+  TestHostCopy(MakeDesc(Shape({3, 4, 5, 6, 7, 8}), Shape({4, 4, 6, 6, 8, 9}),
+                        NdIndex({0, 1, 2, 0, 3, 1}), NdIndex({1, 0, 1, 2, 0, 4}),
+                        Shape({3, 3, 3, 4, 4, 5})));
+}
+
+TEST(HostMemoryCopier, copy_nd_on_thread_pool) {
+  Global<ThreadPool>::New(4);
+  // large enough to be split into parts
+  TestHostCopy(MakeDesc(Shape({4 << 20}), Shape({5 << 20}), NdIndex({0}), NdIndex({1 << 20}),
+                        Shape({4 << 20})));
+  TestHostCopy(MakeDesc(Shape({1024, 2048}), Shape({2048, 1024}), NdIndex({0, 512}),
+                        NdIndex({512, 0}), Shape({1024, 1024})));
+  TestHostCopy(MakeDesc(Shape({16, 256, 512}), Shape({32, 256, 512}), NdIndex({0, 0, 0}),
+                        NdIndex({16, 0, 0}), Shape({16, 256, 300})));
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -24,6 +24,7 @@ void LocalCallOpKernelPhyInstrOperand::ForEachConstMirroredObject(
     const {
   const auto& input_list = inputs();
   for (int64_t index : opkernel().input_tuple_indexes4const_ibns()) {
+    if (IsInputPreResolved(index)) { continue; }
     const auto& input = input_list->at(index);
     DoEach(nullptr, CHECK_JUST(input->compute_local_dep_object())
                         ->mut_local_dep_object()
@@ -41,6 +42,7 @@ void LocalCallOpKernelPhyInstrOperand::ForEachMutMirroredObject(
 
   const auto& input_list = inputs();
   for (int64_t index : opkernel().input_tuple_indexes4mut_ibns()) {
+    if (IsInputPreResolved(index)) { continue; }
     const auto& input = input_list->at(index);
     DoEach(nullptr, CHECK_JUST(input->compute_local_dep_object())
                         ->mut_local_dep_object()
@@ -48,6 +50,7 @@ void LocalCallOpKernelPhyInstrOperand::ForEachMutMirroredObject(
   }
   const auto& output_list = outputs();
   for (int64_t index : opkernel().output_tuple_indexes4mut_obns()) {
+    if (IsOutputPreResolved(index)) { continue; }
     const auto& output = output_list->at(index);
     DoEach(nullptr, CHECK_JUST(output->compute_local_dep_object())
                         ->mut_local_dep_object()
@@ -60,6 +63,7 @@ void LocalCallOpKernelPhyInstrOperand::ForEachMut2MirroredObject(
     const {
   const auto& output_list = outputs();
   for (int64_t index : opkernel().output_tuple_indexes4mut2_obns()) {
+    if (IsOutputPreResolved(index)) { continue; }
     const auto& output = output_list->at(index);
     DoEach(nullptr, CHECK_JUST(output->compute_local_dep_object())
                         ->mut_local_dep_object()
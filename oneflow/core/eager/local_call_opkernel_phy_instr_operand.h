@@ -80,12 +80,29 @@ class LocalCallOpKernelPhyInstrOperand final : public vm::PhyInstrOperand {
 
   void set_user_opkernel(const user_op::OpKernel* user_opkernel) { user_opkernel_ = user_opkernel; }
 
+  // Masks of the inputs/outputs only accessed by instructions connected with pre-resolved edges.
+  // Their mirrored objects are not consumed by the vm.
+  void set_pre_resolved_masks(const std::shared_ptr<const std::vector<bool>>& input_mask,
+                              const std::shared_ptr<const std::vector<bool>>& output_mask) {
+    pre_resolved_input_mask_ = input_mask;
+    pre_resolved_output_mask_ = output_mask;
+  }
+
  private:
+  bool IsInputPreResolved(int64_t index) const {
+    return pre_resolved_input_mask_ && pre_resolved_input_mask_->at(index);
+  }
+  bool IsOutputPreResolved(int64_t index) const {
+    return pre_resolved_output_mask_ && pre_resolved_output_mask_->at(index);
+  }
+
   std::shared_ptr<one::StatefulLocalOpKernel> opkernel_;
   one::EagerBlobObjectListPtr inputs_;
   one::EagerBlobObjectListPtr outputs_;
   const AttrMap attrs_;
   const user_op::OpKernel* user_opkernel_;
+  std::shared_ptr<const std::vector<bool>> pre_resolved_input_mask_;
+  std::shared_ptr<const std::vector<bool>> pre_resolved_output_mask_;
 };
 
 }  // namespace vm
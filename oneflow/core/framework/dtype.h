@@ -26,6 +26,7 @@ namespace oneflow {
   OF_PP_MAKE_TUPLE_SEQ(InvalidDataType) \
   OF_PP_MAKE_TUPLE_SEQ(Char)            \
   OF_PP_MAKE_TUPLE_SEQ(Float16)         \
+  OF_PP_MAKE_TUPLE_SEQ(BFloat16)        \
   OF_PP_MAKE_TUPLE_SEQ(Float)           \
   OF_PP_MAKE_TUPLE_SEQ(Double)          \
   OF_PP_MAKE_TUPLE_SEQ(Int8)            \
@@ -0,0 +1,176 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/eager_elementwise_fusion.h"
+#include "oneflow/core/framework/device.h"
+#include "oneflow/core/framework/instructions_builder.h"
+#include "oneflow/core/framework/instructions_capture.h"
+#include "oneflow/core/framework/op_expr.h"
+#include "oneflow/core/framework/op_expr_helper.h"
+#include "oneflow/user/kernels/elementwise_unary_chain_kernel.h"
+#include "oneflow/user/kernels/stateful_local_opkernel.h"
+
+namespace oneflow {
+namespace one {
+
+namespace {
+
+struct PendingChain {
+  std::shared_ptr<vm::EagerBlobObject> source;
+  std::shared_ptr<const Device> device;
+  std::vector<std::string> op_type_names;
+  std::vector<float> scalars;
+};
+
+struct PendingChains {
+  HashMap<const vm::EagerBlobObject*, PendingChain> blob_object2chain;
+  HashMap<const vm::EagerBlobObject*, std::vector<std::weak_ptr<vm::EagerBlobObject>>>
+      source2pending_blob_objects;
+};
+
+bool* GetThreadLocalEnabled() {
+  static thread_local bool enabled = false;
+  return &enabled;
+}
+
+PendingChains* GetThreadLocalPendingChains() {
+  static thread_local PendingChains pending_chains;
+  return &pending_chains;
+}
+
+Maybe<UserOpExpr> GetThreadLocalChainOpExpr() {
+  static thread_local std::shared_ptr<UserOpExpr> op_expr;
+  if (!op_expr) { op_expr = JUST(op_expr_helper::ElementwiseUnaryChainOp()); }
+  return op_expr;
+}
+
+Maybe<float> GetScalarOperand(const UserOpExpr& op_expr, const AttrMap& attrs) {
+  const std::string& op_type_name = op_expr.proto().op_type_name();
+  if (op_type_name != "scalar_add" && op_type_name != "scalar_mul") { return 0.f; }
+  ComposedAttrMap composed_attrs(attrs, op_expr.base_attrs());
+  if (JUST(composed_attrs.GetAttr<bool>("has_float_operand"))) {
+    return static_cast<float>(JUST(composed_attrs.GetAttr<double>("float_operand")));
+  } else if (JUST(composed_attrs.GetAttr<bool>("has_int_operand"))) {
+    return static_cast<float>(JUST(composed_attrs.GetAttr<int64_t>("int_operand")));
+  }
+  OF_UNIMPLEMENTED();
+}
+
+Maybe<void> MaterializeSourcedFrom(InstructionsBuilder* builder,
+                                   const vm::EagerBlobObject* source) {
+  auto* pending_chains = GetThreadLocalPendingChains();
+  const auto& iter = pending_chains->source2pending_blob_objects.find(source);
+  if (iter == pending_chains->source2pending_blob_objects.end()) { return Maybe<void>::Ok(); }
+  const auto pending_blob_objects = std::move(iter->second);
+  pending_chains->source2pending_blob_objects.erase(iter);
+  for (const auto& weak_blob_object : pending_blob_objects) {
+    const auto& blob_object = weak_blob_object.lock();
+    if (blob_object) { JUST(EagerElementwiseFusion::Materialize(builder, blob_object, false)); }
+  }
+  return Maybe<void>::Ok();
+}
+
+}  // namespace
+
+/*static*/ bool EagerElementwiseFusion::is_enabled() { return *GetThreadLocalEnabled(); }
+
+/*static*/ void EagerElementwiseFusion::set_enabled(bool enabled) {
+  *GetThreadLocalEnabled() = enabled;
+}
+
+/*static*/ size_t EagerElementwiseFusion::pending_size() {
+  return GetThreadLocalPendingChains()->blob_object2chain.size();
+}
+
+/*static*/ Maybe<bool> EagerElementwiseFusion::TryDefer(
+    const UserOpExpr& op_expr, const AttrMap& attrs, const EagerBlobObjectListPtr& inputs,
+    const EagerBlobObjectListPtr& outputs, const std::shared_ptr<const Device>& device) {
+  if (!is_enabled()) { return false; }
+  // captured regions are replayed instruction by instruction
+  if (InstructionsCapture::ThreadLocalCurrent() != nullptr) { return false; }
+  if (device->type() != "cpu") { return false; }
+  if (inputs->size() != 1 || outputs->size() != 1) { return false; }
+  if (!IsElementwiseUnaryChainFusible(op_expr.proto().op_type_name())) { return false; }
+  const auto& input = inputs->at(0);
+  const auto& output = outputs->at(0);
+  if (input->blob_desc().data_type() != DataType::kFloat) { return false; }
+  if (output->blob_desc().data_type() != DataType::kFloat) { return false; }
+  if (!(input->blob_desc().shape() == output->blob_desc().shape())) { return false; }
+
+  auto* pending_chains = GetThreadLocalPendingChains();
+  PendingChain chain;
+  const auto& input_iter = pending_chains->blob_object2chain.find(input.get());
+  if (input_iter != pending_chains->blob_object2chain.end()) {
+    chain = input_iter->second;
+  } else {
+    chain.source = input;
+    chain.device = device;
+  }
+  chain.op_type_names.push_back(op_expr.proto().op_type_name());
+  chain.scalars.push_back(JUST(GetScalarOperand(op_expr, attrs)));
+  pending_chains->source2pending_blob_objects[chain.source.get()].push_back(output);
+  CHECK_OR_RETURN(pending_chains->blob_object2chain.emplace(output.get(), std::move(chain)).second);
+  return true;
+}
+
+/*static*/ Maybe<void> EagerElementwiseFusion::Materialize(
+    InstructionsBuilder* builder, const std::shared_ptr<vm::EagerBlobObject>& blob_object,
+    bool is_mut) {
+  if (is_mut) { JUST(MaterializeSourcedFrom(builder, blob_object.get())); }
+  auto* pending_chains = GetThreadLocalPendingChains();
+  const auto& iter = pending_chains->blob_object2chain.find(blob_object.get());
+  if (iter == pending_chains->blob_object2chain.end()) { return Maybe<void>::Ok(); }
+  const PendingChain chain = std::move(iter->second);
+  pending_chains->blob_object2chain.erase(iter);
+
+  const auto& op_expr = JUST(GetThreadLocalChainOpExpr());
+  const auto& kernel = JUST(op_expr->MutKernel4Device(*chain.device));
+  kernel->set_need_check_mem_case(true);
+  MutableAttrMap attrs;
+  JUST(attrs.SetAttr<std::vector<std::string>>("op_type_names", chain.op_type_names));
+  JUST(attrs.SetAttr<std::vector<float>>("scalars", chain.scalars));
+  const auto& inputs = std::make_shared<EagerBlobObjectList>(1, chain.source);
+  const auto& outputs = std::make_shared<EagerBlobObjectList>(1, blob_object);
+  const auto& instr_type_name = JUST(chain.device->local_call_instruction_name());
+  return builder->LocalCallOpKernel(kernel, inputs, outputs, AttrMap(attrs),
+                                    chain.device->parallel_desc_ptr(), instr_type_name);
+}
+
+/*static*/ Maybe<void> EagerElementwiseFusion::MaterializeInputs(
+    InstructionsBuilder* builder, const StatefulLocalOpKernel& opkernel,
+    const EagerBlobObjectListPtr& inputs) {
+  auto* pending_chains = GetThreadLocalPendingChains();
+  if (pending_chains->blob_object2chain.empty()
+      && pending_chains->source2pending_blob_objects.empty()) {
+    return Maybe<void>::Ok();
+  }
+  for (int64_t index : opkernel.input_tuple_indexes4mut_ibns()) {
+    JUST(MaterializeSourcedFrom(builder, inputs->at(index).get()));
+  }
+  for (const auto& input : *inputs) { JUST(Materialize(builder, input, false)); }
+  return Maybe<void>::Ok();
+}
+
+/*static*/ Maybe<void> EagerElementwiseFusion::OnRelease(
+    InstructionsBuilder* builder, const std::shared_ptr<vm::EagerBlobObject>& blob_object) {
+  auto* pending_chains = GetThreadLocalPendingChains();
+  pending_chains->blob_object2chain.erase(blob_object.get());
+  // the body of a source is deallocated on release
+  JUST(MaterializeSourcedFrom(builder, blob_object.get()));
+  return Maybe<void>::Ok();
+}
+
+}  // namespace one
+}  // namespace oneflow
@@ -0,0 +1,88 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_FRAMEWORK_EAGER_ELEMENTWISE_FUSION_H_
+#define ONEFLOW_CORE_FRAMEWORK_EAGER_ELEMENTWISE_FUSION_H_
+
+#include "oneflow/core/common/maybe.h"
+#include "oneflow/core/eager/local_call_opkernel_phy_instr_operand.h"
+#include "oneflow/core/framework/attr_map.h"
+
+namespace oneflow {
+
+class Device;
+class InstructionsBuilder;
+
+namespace one {
+
+class UserOpExpr;
+
+// Deferred execution of unary elementwise ops in eager mode.
+//
+// While enabled, a cpu float op accepted by IsElementwiseUnaryChainFusible() is not issued to the
+// vm: its output blob object becomes pending, remembering the materialized source blob object
+// and the chain of ops leading to it. A pending blob object is computed by one
+// elementwise_unary_chain instruction when it is consumed by an instruction, accessed by
+// callback, or when its source is about to be mutated or released. Intermediate values of a
+// chain that are never consumed are never computed.
+//
+// Only chains of unary ops (including scalar_add and scalar_mul) on one source are fused. An op
+// with two tensor operands, e.g. a broadcast or elementwise add of two tensors, materializes its
+// pending inputs and runs unfused.
+struct EagerElementwiseFusion {
+  static bool is_enabled();
+  static void set_enabled(bool enabled);
+
+  // Returns true if the op has been deferred. Tensor descs of `outputs` must be inferred.
+  static Maybe<bool> TryDefer(const UserOpExpr& op_expr, const AttrMap& attrs,
+                              const EagerBlobObjectListPtr& inputs,
+                              const EagerBlobObjectListPtr& outputs,
+                              const std::shared_ptr<const Device>& device);
+
+  // Materializes pending `inputs` and the pending blob objects sourced from inputs mutated by
+  // `opkernel`.
+  static Maybe<void> MaterializeInputs(InstructionsBuilder* builder,
+                                       const StatefulLocalOpKernel& opkernel,
+                                       const EagerBlobObjectListPtr& inputs);
+
+  // Materializes `blob_object` if pending. If `is_mut`, pending blob objects sourced from it are
+  // materialized too.
+  static Maybe<void> Materialize(InstructionsBuilder* builder,
+                                 const std::shared_ptr<vm::EagerBlobObject>& blob_object,
+                                 bool is_mut);
+
+  // Drops the pending computation of a released blob object.
+  static Maybe<void> OnRelease(InstructionsBuilder* builder,
+                               const std::shared_ptr<vm::EagerBlobObject>& blob_object);
+
+  static size_t pending_size();
+};
+
+class EagerElementwiseFusionGuard {
+ public:
+  EagerElementwiseFusionGuard(bool enabled) : prev_enabled_(EagerElementwiseFusion::is_enabled()) {
+    EagerElementwiseFusion::set_enabled(enabled);
+  }
+  ~EagerElementwiseFusionGuard() { EagerElementwiseFusion::set_enabled(prev_enabled_); }
+
+ private:
+  bool prev_enabled_;
+};
+
+}  // namespace one
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_FRAMEWORK_EAGER_ELEMENTWISE_FUSION_H_
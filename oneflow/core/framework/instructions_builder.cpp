@@ -15,6 +15,8 @@ limitations under the License.
 */
 #include <atomic>
 #include "oneflow/core/framework/instructions_builder.h"
+#include "oneflow/core/framework/eager_elementwise_fusion.h"
+#include "oneflow/core/framework/instructions_capture.h"
 #include "oneflow/core/framework/symbol_storage_util.h"
 #include "oneflow/core/eager/eager_symbol.cfg.h"
 #include "oneflow/core/job/job_conf.cfg.h"
@@ -648,6 +650,11 @@ Maybe<void> InstructionsBuilder::LocalCallOpKernel(
     const one::EagerBlobObjectListPtr& output_eager_blob_objects, const AttrMap& attrs,
     const std::shared_ptr<const ParallelDesc>& parallel_desc_sym,
     const std::string& instr_type_name) {
+  JUST(one::EagerElementwiseFusion::MaterializeInputs(this, *opkernel, input_eager_blob_objects));
+  if (auto* capture = InstructionsCapture::ThreadLocalCurrent()) {
+    JUST(capture->Record(opkernel, input_eager_blob_objects, output_eager_blob_objects, attrs,
+                         parallel_desc_sym, instr_type_name));
+  }
   ObjectMsgPtr<vm::InstructionMsg> instruction =
       ObjectMsgPtr<vm::InstructionMsg>::New(instr_type_name);
   auto phy_instr_operand = std::make_shared<vm::LocalCallOpKernelPhyInstrOperand>(
@@ -870,6 +877,7 @@ Maybe<void> InstructionsBuilder::FeedBlob(
 Maybe<void> InstructionsBuilder::ReleaseTensor(
     const std::shared_ptr<vm::EagerBlobObject>& eager_blob_object,
     const std::shared_ptr<const ParallelDesc>& parallel_desc) {
+  JUST(one::EagerElementwiseFusion::OnRelease(this, eager_blob_object));
   std::string instr_name = parallel_desc->device_tag() + ".ReleaseTensor";
   ObjectMsgPtr<vm::InstructionMsg> instruction = ObjectMsgPtr<vm::InstructionMsg>::New(instr_name);
   const std::shared_ptr<VmLocalDepObject>& compute_local_dep_object =
@@ -888,6 +896,7 @@ Maybe<void> InstructionsBuilder::AccessBlobByCallback(const T tensor,
   std::string instr_name = tensor->parallel_desc()->device_tag() + ".AccessBlobByCallback";
   ObjectMsgPtr<vm::InstructionMsg> instruction = ObjectMsgPtr<vm::InstructionMsg>::New(instr_name);
   const std::shared_ptr<vm::EagerBlobObject>& eager_blob_object = JUST(tensor->eager_blob_object());
+  JUST(one::EagerElementwiseFusion::Materialize(this, eager_blob_object, modifier == "mut"));
   const std::shared_ptr<VmLocalDepObject>& compute_local_dep_object =
       JUST(tensor->compute_local_dep_object());
   *instruction->mutable_phy_instr_operand() = std::make_shared<vm::AccessBlobArgCbPhyInstrOperand>(
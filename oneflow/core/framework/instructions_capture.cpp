@@ -0,0 +1,262 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/instructions_capture.h"
+#include "oneflow/core/framework/instructions_builder.h"
+#include "oneflow/core/framework/eager_elementwise_fusion.h"
+#include "oneflow/core/framework/op_interpreter/op_interpreter_util.h"
+#include "oneflow/core/framework/tensor.h"
+#include "oneflow/core/framework/tensor_tuple.h"
+#include "oneflow/core/eager/eager_blob_object.h"
+
+namespace oneflow {
+
+namespace {
+
+InstructionsCapture** MutThreadLocalCapture() {
+  thread_local static InstructionsCapture* capture = nullptr;
+  return &capture;
+}
+
+}  // namespace
+
+/*static*/ InstructionsCapture* InstructionsCapture::ThreadLocalCurrent() {
+  return *MutThreadLocalCapture();
+}
+
+Maybe<void> InstructionsCapture::BeginCapture() {
+  CHECK_OR_RETURN(ThreadLocalCurrent() == nullptr) << "nested instructions capture";
+  slots_.clear();
+  external_slots_.clear();
+  instructions_.clear();
+  output_slot7device_.clear();
+  blob_object2slot_.clear();
+  captured_blob_objects_.clear();
+  slot2last_writer_.clear();
+  slot2readers_.clear();
+  external_blob_objects_.clear();
+  external_blob_object2slot_.clear();
+  is_capturing_ = true;
+  *MutThreadLocalCapture() = this;
+  return Maybe<void>::Ok();
+}
+
+Maybe<void> InstructionsCapture::EndCapture() {
+  CHECK_OR_RETURN(is_capturing_);
+  CHECK_OR_RETURN(ThreadLocalCurrent() == this);
+  *MutThreadLocalCapture() = nullptr;
+  is_capturing_ = false;
+  std::vector<bool> is_internal_slot(slots_.size());
+  for (int64_t slot = 0; slot < slots_.size(); ++slot) {
+    is_internal_slot.at(slot) = slots_.at(slot).producer >= 0;
+  }
+  for (const auto& pair : output_slot7device_) { is_internal_slot.at(pair.first) = false; }
+  for (CapturedInstruction& instruction : instructions_) {
+    instruction.internal_input_mask = MakeInternalMask(instruction.input_slots, is_internal_slot);
+    instruction.internal_output_mask =
+        MakeInternalMask(instruction.output_slots, is_internal_slot);
+  }
+  // Only the blob objects of external slots are kept, as the default binding for Replay.
+  blob_object2slot_.clear();
+  captured_blob_objects_.clear();
+  slot2last_writer_.clear();
+  slot2readers_.clear();
+  return Maybe<void>::Ok();
+}
+
+std::shared_ptr<const std::vector<bool>> InstructionsCapture::MakeInternalMask(
+    const std::vector<int64_t>& slots, const std::vector<bool>& is_internal_slot) const {
+  auto mask = std::make_shared<std::vector<bool>>(slots.size());
+  bool has_internal = false;
+  for (int64_t i = 0; i < slots.size(); ++i) {
+    mask->at(i) = is_internal_slot.at(slots.at(i));
+    has_internal = has_internal || mask->at(i);
+  }
+  if (!has_internal) { return nullptr; }
+  return mask;
+}
+
+Maybe<int64_t> InstructionsCapture::FindOrCreateInputSlot(
+    const std::shared_ptr<vm::EagerBlobObject>& blob_object) {
+  CHECK_OR_RETURN(static_cast<bool>(blob_object));
+  const auto& iter = blob_object2slot_.find(blob_object.get());
+  if (iter != blob_object2slot_.end()) { return iter->second; }
+  const int64_t slot = CreateOutputSlot(blob_object, -1);
+  external_slots_.push_back(slot);
+  external_blob_objects_.push_back(blob_object);
+  external_blob_object2slot_[blob_object.get()] = slot;
+  return slot;
+}
+
+int64_t InstructionsCapture::CreateOutputSlot(
+    const std::shared_ptr<vm::EagerBlobObject>& blob_object, int64_t producer) {
+  const int64_t slot = slots_.size();
+  SlotDesc slot_desc;
+  slot_desc.mem_case = std::make_shared<MemoryCase>(blob_object->mem_case());
+  slot_desc.shape = blob_object->blob_desc().shape();
+  slot_desc.data_type = blob_object->blob_desc().data_type();
+  slot_desc.is_shape_synced = blob_object->is_shape_synced();
+  slot_desc.producer = producer;
+  slots_.push_back(slot_desc);
+  blob_object2slot_[blob_object.get()] = slot;
+  slot2last_writer_.push_back(producer);
+  slot2readers_.emplace_back();
+  // hold the blob object so that its address is not reused by another one during capture
+  captured_blob_objects_.push_back(blob_object);
+  return slot;
+}
+
+void InstructionsCapture::AddSrcInstructions(int64_t slot, bool is_mut,
+                                             CapturedInstruction* instruction) {
+  const int64_t dst = instructions_.size();
+  std::vector<int64_t>* src_instructions = &instruction->src_instructions;
+  const auto& AddSrc = [&](int64_t src) {
+    if (src < 0 || src == dst) { return; }
+    if (std::find(src_instructions->begin(), src_instructions->end(), src)
+        != src_instructions->end()) {
+      return;
+    }
+    src_instructions->push_back(src);
+  };
+  AddSrc(slot2last_writer_.at(slot));
+  std::vector<int64_t>* readers = &slot2readers_.at(slot);
+  if (is_mut) {
+    for (int64_t reader : *readers) { AddSrc(reader); }
+    readers->clear();
+    slot2last_writer_.at(slot) = dst;
+  } else {
+    readers->push_back(dst);
+  }
+}
+
+Maybe<void> InstructionsCapture::Record(
+    const std::shared_ptr<one::StatefulLocalOpKernel>& opkernel,
+    const one::EagerBlobObjectListPtr& inputs, const one::EagerBlobObjectListPtr& outputs,
+    const AttrMap& attrs, const std::shared_ptr<const ParallelDesc>& parallel_desc,
+    const std::string& instr_type_name) {
+  CHECK_OR_RETURN(is_capturing_);
+  const int64_t producer = instructions_.size();
+  CapturedInstruction instruction;
+  instruction.opkernel = opkernel;
+  instruction.attrs = attrs;
+  instruction.parallel_desc = parallel_desc;
+  instruction.instr_type_name = instr_type_name;
+  instruction.instr_msg = ObjectMsgPtr<vm::InstructionMsg>::New(instr_type_name);
+  *instruction.instr_msg->mut_parallel_desc() = parallel_desc;
+  for (const auto& input : *inputs) {
+    instruction.input_slots.push_back(JUST(FindOrCreateInputSlot(input)));
+  }
+  std::vector<bool> is_mut_input(inputs->size());
+  for (int64_t index : opkernel->input_tuple_indexes4mut_ibns()) {
+    is_mut_input.at(index) = true;
+  }
+  for (int64_t i = 0; i < inputs->size(); ++i) {
+    AddSrcInstructions(instruction.input_slots.at(i), is_mut_input.at(i), &instruction);
+  }
+  for (const auto& output : *outputs) {
+    CHECK_OR_RETURN(blob_object2slot_.find(output.get()) == blob_object2slot_.end())
+        << "output blob object of " << instr_type_name << " has been captured before";
+    instruction.output_slots.push_back(CreateOutputSlot(output, producer));
+  }
+  instructions_.push_back(std::move(instruction));
+  return Maybe<void>::Ok();
+}
+
+Maybe<void> InstructionsCapture::MarkOutput(const std::shared_ptr<one::Tensor>& tensor) {
+  CHECK_OR_RETURN(is_capturing_) << "MarkOutput should be called before EndCapture";
+  const auto& blob_object = JUST(tensor->eager_blob_object());
+  const auto& iter = blob_object2slot_.find(blob_object.get());
+  CHECK_OR_RETURN(iter != blob_object2slot_.end()) << "tensor is not used in captured region";
+  output_slot7device_.emplace_back(iter->second, tensor->device());
+  return Maybe<void>::Ok();
+}
+
+Maybe<void> InstructionsCapture::CheckBoundBlobObject(
+    int64_t slot, const vm::EagerBlobObject& blob_object) const {
+  const SlotDesc& slot_desc = slots_.at(slot);
+  CHECK_EQ_OR_RETURN(blob_object.blob_desc().data_type(), slot_desc.data_type);
+  CHECK_OR_RETURN(blob_object.blob_desc().shape() == slot_desc.shape)
+      << "bound shape " << blob_object.blob_desc().shape().ToString()
+      << " mismatches captured shape " << slot_desc.shape.ToString();
+  return Maybe<void>::Ok();
+}
+
+Maybe<one::TensorTuple> InstructionsCapture::Replay(const one::TensorTuple& captured_inputs,
+                                                    const one::TensorTuple& inputs) {
+  CHECK_OR_RETURN(!is_capturing_) << "Replay should be called after EndCapture";
+  CHECK_OR_RETURN(ThreadLocalCurrent() == nullptr) << "Replay is not capturable";
+  CHECK_EQ_OR_RETURN(captured_inputs.size(), inputs.size());
+  std::vector<std::shared_ptr<vm::EagerBlobObject>> slot2blob_object(slots_.size());
+  for (int64_t i = 0; i < external_slots_.size(); ++i) {
+    slot2blob_object.at(external_slots_.at(i)) = external_blob_objects_.at(i);
+  }
+  for (int64_t i = 0; i < inputs.size(); ++i) {
+    const auto& captured_blob_object = JUST(captured_inputs.at(i)->eager_blob_object());
+    const auto& iter = external_blob_object2slot_.find(captured_blob_object.get());
+    CHECK_OR_RETURN(iter != external_blob_object2slot_.end())
+        << "the " << i << "-th captured input is not an input of captured region";
+    const auto& blob_object = JUST(inputs.at(i)->eager_blob_object());
+    JUST(CheckBoundBlobObject(iter->second, *blob_object));
+    slot2blob_object.at(iter->second) = blob_object;
+  }
+  std::vector<const vm::InstructionMsg*> instr_msgs(instructions_.size());
+  JUST(PhysicalRun([&](InstructionsBuilder* builder) -> Maybe<void> {
+    for (int64_t index = 0; index < instructions_.size(); ++index) {
+      const CapturedInstruction& instruction = instructions_.at(index);
+      auto input_blob_objects =
+          std::make_shared<one::EagerBlobObjectList>(instruction.input_slots.size());
+      for (int64_t i = 0; i < instruction.input_slots.size(); ++i) {
+        input_blob_objects->at(i) = slot2blob_object.at(instruction.input_slots.at(i));
+      }
+      auto output_blob_objects =
+          std::make_shared<one::EagerBlobObjectList>(instruction.output_slots.size());
+      for (int64_t i = 0; i < instruction.output_slots.size(); ++i) {
+        const int64_t slot = instruction.output_slots.at(i);
+        const SlotDesc& slot_desc = slots_.at(slot);
+        const auto& blob_object = std::make_shared<vm::EagerBlobObject>(
+            slot_desc.mem_case, std::make_shared<Shape>(slot_desc.shape), slot_desc.data_type,
+            std::make_shared<vm::TensorBuffer>(), instruction.parallel_desc);
+        blob_object->set_is_shape_synced(slot_desc.is_shape_synced);
+        output_blob_objects->at(i) = blob_object;
+        slot2blob_object.at(slot) = blob_object;
+      }
+      // only external inputs can be pending in an elementwise fusion, the check is O(1) otherwise
+      JUST(one::EagerElementwiseFusion::MaterializeInputs(builder, *instruction.opkernel,
+                                                          input_blob_objects));
+      auto phy_instr_operand = std::make_shared<vm::LocalCallOpKernelPhyInstrOperand>(
+          instruction.opkernel, input_blob_objects, output_blob_objects, instruction.attrs);
+      phy_instr_operand->set_pre_resolved_masks(instruction.internal_input_mask,
+                                                instruction.internal_output_mask);
+      auto instr_msg = ObjectMsgPtr<vm::InstructionMsg>::New(*instruction.instr_msg);
+      *instr_msg->mutable_phy_instr_operand() = phy_instr_operand;
+      auto* src_instr_msgs = instr_msg->mutable_pre_resolved_src_instr_msgs();
+      for (int64_t src : instruction.src_instructions) {
+        src_instr_msgs->push_back(instr_msgs.at(src));
+      }
+      instr_msgs.at(index) = instr_msg.Mutable();
+      builder->mut_instruction_list()->EmplaceBack(std::move(instr_msg));
+    }
+    return Maybe<void>::Ok();
+  }));
+  auto outputs = std::make_shared<one::TensorTuple>(output_slot7device_.size());
+  for (int64_t i = 0; i < output_slot7device_.size(); ++i) {
+    const auto& pair = output_slot7device_.at(i);
+    outputs->at(i) = JUST(one::OpInterpUtil::BuildEagerMirroredTensorFromEagerBlobObject(
+        slot2blob_object.at(pair.first), pair.second));
+  }
+  return outputs;
+}
+
+}  // namespace oneflow
@@ -0,0 +1,138 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_FRAMEWORK_INSTRUCTIONS_CAPTURE_H_
+#define ONEFLOW_CORE_FRAMEWORK_INSTRUCTIONS_CAPTURE_H_
+
+#include "oneflow/core/common/maybe.h"
+#include "oneflow/core/common/shape.h"
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/eager/local_call_opkernel_phy_instr_operand.h"
+#include "oneflow/core/framework/attr_map.h"
+#include "oneflow/core/vm/instruction.msg.h"
+
+namespace oneflow {
+
+class ParallelDesc;
+class Device;
+
+namespace one {
+
+class Tensor;
+class TensorTuple;
+
+}  // namespace one
+
+// InstructionsCapture records the LocalCallOpKernel instructions issued by the current thread
+// between BeginCapture() and EndCapture(), together with the dataflow edges between them.
+// Every eager blob object seen during capture is assigned a slot: slots consumed before being
+// produced are external (bound by the caller on each Replay), all others are produced by a
+// recorded instruction.
+//
+// Each recorded instruction keeps a prebuilt InstructionMsg with its instruction type and
+// parallel desc resolved. Replay() clones these messages, attaches operands of the bound and
+// freshly allocated blob objects, and appends them to one instruction list handed to the vm in a
+// single PhysicalRun. The op interpreter, device/data type/tensor desc inference, kernel lookup,
+// instruction type lookup and the per-op PhysicalRun round trip are skipped.
+//
+// Dependencies between recorded instructions are resolved at capture time. Slots that are
+// produced inside the captured region and not marked as outputs are internal: the vm connects
+// their producers and consumers with the pre-resolved edges and never consumes their mirrored
+// objects. Only external slots, marked outputs and devices go through the vm's dependency
+// analysis, as they order replayed instructions against the rest of the program.
+class InstructionsCapture final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(InstructionsCapture);
+  InstructionsCapture() : is_capturing_(false) {}
+  ~InstructionsCapture() = default;
+
+  static InstructionsCapture* ThreadLocalCurrent();
+
+  Maybe<void> BeginCapture();
+  Maybe<void> EndCapture();
+
+  Maybe<void> Record(const std::shared_ptr<one::StatefulLocalOpKernel>& opkernel,
+                     const one::EagerBlobObjectListPtr& inputs,
+                     const one::EagerBlobObjectListPtr& outputs, const AttrMap& attrs,
+                     const std::shared_ptr<const ParallelDesc>& parallel_desc,
+                     const std::string& instr_type_name);
+
+  // Marks a captured tensor as a result of the captured region. Replay returns results in the
+  // order they are marked.
+  Maybe<void> MarkOutput(const std::shared_ptr<one::Tensor>& tensor);
+
+  // Replays the captured instructions. External slots keep the tensors they were bound to at
+  // capture time, except that captured_inputs.at(i) is rebound to inputs.at(i).
+  Maybe<one::TensorTuple> Replay(const one::TensorTuple& captured_inputs,
+                                 const one::TensorTuple& inputs);
+
+  bool is_capturing() const { return is_capturing_; }
+  bool empty() const { return instructions_.empty(); }
+  size_t instruction_size() const { return instructions_.size(); }
+  size_t external_slot_size() const { return external_slots_.size(); }
+
+ private:
+  struct SlotDesc {
+    std::shared_ptr<MemoryCase> mem_case;
+    Shape shape;
+    DataType data_type;
+    bool is_shape_synced;
+    // -1 for external slots
+    int64_t producer;
+  };
+
+  struct CapturedInstruction {
+    std::shared_ptr<one::StatefulLocalOpKernel> opkernel;
+    AttrMap attrs;
+    std::shared_ptr<const ParallelDesc> parallel_desc;
+    std::string instr_type_name;
+    std::vector<int64_t> input_slots;
+    std::vector<int64_t> output_slots;
+    // recorded instructions this one depends on through internal slots
+    std::vector<int64_t> src_instructions;
+    // set by EndCapture(), nullptr if no input/output slot is internal
+    std::shared_ptr<const std::vector<bool>> internal_input_mask;
+    std::shared_ptr<const std::vector<bool>> internal_output_mask;
+    // instruction type and parallel desc resolved at capture time, cloned on each Replay
+    ObjectMsgPtr<vm::InstructionMsg> instr_msg;
+  };
+
+  Maybe<int64_t> FindOrCreateInputSlot(const std::shared_ptr<vm::EagerBlobObject>& blob_object);
+  int64_t CreateOutputSlot(const std::shared_ptr<vm::EagerBlobObject>& blob_object,
+                           int64_t producer);
+  Maybe<void> CheckBoundBlobObject(int64_t slot, const vm::EagerBlobObject& blob_object) const;
+  void AddSrcInstructions(int64_t slot, bool is_mut, CapturedInstruction* instruction);
+  std::shared_ptr<const std::vector<bool>> MakeInternalMask(
+      const std::vector<int64_t>& slots, const std::vector<bool>& is_internal_slot) const;
+
+  bool is_capturing_;
+  std::vector<SlotDesc> slots_;
+  std::vector<int64_t> external_slots_;
+  std::vector<CapturedInstruction> instructions_;
+  std::vector<std::pair<int64_t, std::shared_ptr<const Device>>> output_slot7device_;
+  // only valid while capturing
+  HashMap<const vm::EagerBlobObject*, int64_t> blob_object2slot_;
+  std::vector<std::shared_ptr<vm::EagerBlobObject>> captured_blob_objects_;
+  // last recorded writer (-1 for none) and the readers since then, per slot
+  std::vector<int64_t> slot2last_writer_;
+  std::vector<std::vector<int64_t>> slot2readers_;
+  // default bindings of external slots, kept alive until the next BeginCapture()
+  std::vector<std::shared_ptr<vm::EagerBlobObject>> external_blob_objects_;
+  HashMap<const vm::EagerBlobObject*, int64_t> external_blob_object2slot_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_FRAMEWORK_INSTRUCTIONS_CAPTURE_H_
@@ -547,5 +547,17 @@ Maybe<one::UserOpExpr> PReLUGradOp(const std::string& name) {
       .Build();
 }
 
+Maybe<one::UserOpExpr> ElementwiseUnaryChainOp() {
+  return ElementwiseUnaryChainOp(UniqueOpName("elementwise_unary_chain"));
+}
+Maybe<one::UserOpExpr> ElementwiseUnaryChainOp(const std::string& name) {
+  return one::OpBuilder("elementwise_unary_chain", name)
+      .Input("x")
+      .Output("y")
+      .Attr<std::vector<std::string>>("op_type_names", std::vector<std::string>())
+      .Attr<std::vector<float>>("scalars", std::vector<float>())
+      .Build();
+}
+
 }  // namespace op_expr_helper
 }  // namespace oneflow
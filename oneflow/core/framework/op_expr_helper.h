@@ -180,5 +180,8 @@ Maybe<one::UserOpExpr> SparseSoftmaxCrossEntropyMsGradOp(const int64_t& depth,
 Maybe<one::UserOpExpr> PReLUGradOp();
 Maybe<one::UserOpExpr> PReLUGradOp(const std::string& name);
 
+Maybe<one::UserOpExpr> ElementwiseUnaryChainOp();
+Maybe<one::UserOpExpr> ElementwiseUnaryChainOp(const std::string& name);
+
 }  // namespace op_expr_helper
 }  // namespace oneflow
@@ -17,6 +17,8 @@ limitations under the License.
 #include "oneflow/core/framework/op_interpreter.h"
 #include "oneflow/core/framework/op_interpreter/op_interpreter_util.h"
 #include "oneflow/core/framework/instructions_builder.h"
+#include "oneflow/core/framework/eager_elementwise_fusion.h"
+#include "oneflow/core/framework/instructions_capture.h"
 #include "oneflow/core/framework/op_arg_util.h"
 #include "oneflow/core/framework/scope_util.h"
 #include "oneflow/core/framework/session_util.h"
@@ -95,7 +97,15 @@ Maybe<void> NaiveInterpret(const UserOpExpr& user_op_expr, const TensorTuple& in
   JUST(kernel->InferTensorDesc(input_eager_blob_objects, output_eager_blob_objects,
                                kernel->op_infer_ctx_for_thread_b()));
 
+  if (!need_event_record
+      && JUST(EagerElementwiseFusion::TryDefer(user_op_expr, attrs, input_eager_blob_objects,
+                                               output_eager_blob_objects, op_device))) {
+    return Maybe<void>::Ok();
+  }
   const auto& instr_type_name = JUST(op_device->local_call_instruction_name());
+  // Cross-device event records are not replayed by InstructionsCapture.
+  CHECK_OR_RETURN(!(need_event_record && InstructionsCapture::ThreadLocalCurrent() != nullptr))
+      << "ops with inputs on other devices can not be captured";
   JUST(PhysicalRun([&](InstructionsBuilder* builder) -> Maybe<void> {
     if (need_event_record) {
       for (const auto& input_tensor : inputs) {
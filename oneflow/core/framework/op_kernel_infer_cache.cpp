@@ -16,37 +16,246 @@ limitations under the License.
 #include "oneflow/core/framework/op_kernel_infer_cache.h"
 #include "oneflow/core/framework/op_kernel.h"
 #include "oneflow/core/operator/operator.h"
+#include "oneflow/core/common/protobuf.h"
 
 namespace oneflow {
 
 namespace user_op {
 
-OpKernelInferCache::OpKernelInferCache(const KernelConf& kernel_conf, const JobDesc& job_desc) {
+namespace {
+
+constexpr size_t kDefaultCapacity = 4096;
+
+size_t GetCapacityFromEnv() {
+  const char* env_p = std::getenv("ONEFLOW_OP_KERNEL_INFER_CACHE_CAPACITY");
+  if (env_p == nullptr) { return kDefaultCapacity; }
+  const int64_t capacity = std::stoll(env_p);
+  CHECK_GT(capacity, 0) << "ONEFLOW_OP_KERNEL_INFER_CACHE_CAPACITY should be positive";
+  return capacity;
+}
+
+struct SharedStores {
+  std::mutex mutex;
+  HashMap<std::string, std::weak_ptr<OpKernelInferCacheStore>> op_type_name2store;
+};
+
+SharedStores* MutSharedStores() {
+  static SharedStores shared_stores;
+  return &shared_stores;
+}
+
+// The counts of the living caches and those of the gone ones by op name
+struct CacheCnts {
+  std::mutex mutex;
+  HashSet<const OpKernelInferCache*> living_caches;
+  HashMap<std::string, OpKernelInferCache::Metrics> op_name2gone_metrics;
+};
+
+CacheCnts* MutCacheCnts() {
+  static CacheCnts cache_cnts;
+  return &cache_cnts;
+}
+
+HashMap<std::string, InferCacheShapeBucketFn>* MutOpTypeName2ShapeBucketFn() {
+  static HashMap<std::string, InferCacheShapeBucketFn> op_type_name2shape_bucket_fn;
+  return &op_type_name2shape_bucket_fn;
+}
+
+}  // namespace
+
+double OpKernelInferCacheStore::Metrics::hit_rate() const {
+  const int64_t lookup_cnt = hit_cnt + miss_cnt;
+  return lookup_cnt == 0 ? 0.0 : static_cast<double>(hit_cnt) / lookup_cnt;
+}
+
+std::string OpKernelInferCacheStore::Metrics::ToString() const {
+  return "hit rate " + std::to_string(hit_rate()) + ", hits " + std::to_string(hit_cnt)
+         + ", misses " + std::to_string(miss_cnt) + ", evictions " + std::to_string(evict_cnt);
+}
+
+OpKernelInferCacheStore::OpKernelInferCacheStore(const std::string& op_type_name,
+                                                 size_t capacity)
+    : op_type_name_(op_type_name), capacity_(capacity) {
+  CHECK_GT(capacity_, 0);
+}
+
+OpKernelInferCacheStore::~OpKernelInferCacheStore() {
+  if (metrics_.miss_cnt > 0) {
+    VLOG(1) << "Runtime shape inference cache of op type " << op_type_name_ << ": "
+            << metrics_.ToString();
+  }
+}
+
+std::shared_ptr<OpKernelInferCacheStore> OpKernelInferCacheStore::Get4OpTypeName(
+    const std::string& op_type_name, const std::string& parallel_signature) {
+  SharedStores* shared_stores = MutSharedStores();
+  std::lock_guard<std::mutex> lock(shared_stores->mutex);
+  std::weak_ptr<OpKernelInferCacheStore>* weak_store =
+      &shared_stores->op_type_name2store[op_type_name + "\n" + parallel_signature];
+  std::shared_ptr<OpKernelInferCacheStore> store = weak_store->lock();
+  if (!store) {
+    store.reset(new OpKernelInferCacheStore(op_type_name, GetCapacityFromEnv()));
+    *weak_store = store;
+  }
+  return store;
+}
+
+std::string OpKernelInferCacheStore::GetParallelSignature(const KernelConf& kernel_conf) {
+  // text format prints map entries sorted by key, so equal signatures give equal strings
+  const OpAttribute& op_attribute = kernel_conf.op_attribute();
+  return PbMessage2TxtString(kernel_conf.parallel_ctx())
+         + PbMessage2TxtString(op_attribute.sbp_signature())
+         + PbMessage2TxtString(op_attribute.parallel_distribution_signature())
+         + PbMessage2TxtString(op_attribute.logical_blob_desc_signature())
+         + PbMessage2TxtString(op_attribute.parallel_conf_signature());
+}
+
+void OpKernelInferCacheStore::RegisterShapeBucketFn(const std::string& op_type_name,
+                                                    const InferCacheShapeBucketFn& fn) {
+  CHECK(MutOpTypeName2ShapeBucketFn()->emplace(op_type_name, fn).second)
+      << "InferCacheShapeBucketFn of op type " << op_type_name << " has been registered";
+}
+
+const InferCacheShapeBucketFn* OpKernelInferCacheStore::LookupShapeBucketFn(
+    const std::string& op_type_name) {
+  const auto& it = MutOpTypeName2ShapeBucketFn()->find(op_type_name);
+  if (it == MutOpTypeName2ShapeBucketFn()->end()) { return nullptr; }
+  return &it->second;
+}
+
+OpKernelInferCacheStore::ValueType OpKernelInferCacheStore::Find(const KeyType& key,
+                                                                 size_t hash_value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& it = key2lru_iter_.find(HashEqTraitPtr<const KeyType>(&key, hash_value));
+  if (it == key2lru_iter_.end()) {
+    ++metrics_.miss_cnt;
+    return nullptr;
+  }
+  ++metrics_.hit_cnt;
+  lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+  return it->second->value;
+}
+
+void OpKernelInferCacheStore::Insert(const KeyType& key, size_t hash_value,
+                                     const ValueType& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& it = key2lru_iter_.find(HashEqTraitPtr<const KeyType>(&key, hash_value));
+  if (it != key2lru_iter_.end()) {
+    // another kernel of the op type has inferred the same key meanwhile
+    it->second->value = value;
+    lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+    return;
+  }
+  lru_list_.push_front(Entry{key, hash_value, value});
+  const Entry& entry = lru_list_.front();
+  key2lru_iter_.emplace(HashEqTraitPtr<const KeyType>(&entry.key, entry.hash_value),
+                        lru_list_.begin());
+  while (lru_list_.size() > capacity_) {
+    const Entry& evicted = lru_list_.back();
+    key2lru_iter_.erase(HashEqTraitPtr<const KeyType>(&evicted.key, evicted.hash_value));
+    lru_list_.pop_back();
+    ++metrics_.evict_cnt;
+  }
+}
+
+void OpKernelInferCacheStore::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  key2lru_iter_.clear();
+  lru_list_.clear();
+}
+
+OpKernelInferCacheStore::Metrics OpKernelInferCacheStore::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+size_t OpKernelInferCacheStore::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_list_.size();
+}
+
+OpKernelInferCache::OpKernelInferCache(const KernelConf& kernel_conf, const JobDesc& job_desc)
+    : cache_key_hash_value_(0), last_cache_key_hash_value_(0), hit_cnt_(0), miss_cnt_(0) {
   const OperatorConf& op_conf = kernel_conf.op_attribute().op_conf();
   std::shared_ptr<Operator> op = ConstructOp(op_conf);
+  op_name_ = op_conf.name();
   cache_key_.job_desc = &job_desc;
   cache_key_.op_conf_sym = op->GetOpConfWithoutOpNameAndLbn();
   cache_key_.ibn_idx2shape_sym.resize(op->input_bns().size());
   cache_key_.dtype_signature_sym = SymbolOf(kernel_conf.dtype_signature());
+  const std::string& op_type_name = op_conf.user_conf().op_type_name();
+  shape_bucket_fn_ = OpKernelInferCacheStore::LookupShapeBucketFn(op_type_name);
+  store_ = OpKernelInferCacheStore::Get4OpTypeName(
+      op_type_name, OpKernelInferCacheStore::GetParallelSignature(kernel_conf));
+  CacheCnts* cache_cnts = MutCacheCnts();
+  std::lock_guard<std::mutex> lock(cache_cnts->mutex);
+  CHECK(cache_cnts->living_caches.emplace(this).second);
 }
 
-bool OpKernelInferCache::IsCacheHit() const {
-  size_t hash_value = std::hash<KeyType>()(cache_key_);
-  HashEqTraitPtr<const KeyType> ptr_wrapper(&cache_key_, hash_value);
-  return cached_key2value_.find(ptr_wrapper) != cached_key2value_.end();
+OpKernelInferCache::~OpKernelInferCache() {
+  if (miss_cnt() > 0) {
+    VLOG(2) << "Runtime shape inference cache of op " << op_name_ << ": hits " << hit_cnt()
+            << ", misses " << miss_cnt();
+  }
+  CacheCnts* cache_cnts = MutCacheCnts();
+  std::lock_guard<std::mutex> lock(cache_cnts->mutex);
+  CHECK_EQ(cache_cnts->living_caches.erase(this), 1);
+  Metrics* metrics = &cache_cnts->op_name2gone_metrics[op_name_];
+  metrics->hit_cnt += hit_cnt();
+  metrics->miss_cnt += miss_cnt();
 }
 
-OpKernelInferCache::ValueType OpKernelInferCache::GetCacheValue() const {
-  size_t hash_value = std::hash<KeyType>()(cache_key_);
-  HashEqTraitPtr<const KeyType> ptr_wrapper(&cache_key_, hash_value);
-  CHECK(cached_key2value_.find(ptr_wrapper) != cached_key2value_.end());
-  return cached_key2value_.at(ptr_wrapper);
+HashMap<std::string, OpKernelInferCache::Metrics> OpKernelInferCache::GetOpName2Metrics() {
+  CacheCnts* cache_cnts = MutCacheCnts();
+  std::lock_guard<std::mutex> lock(cache_cnts->mutex);
+  HashMap<std::string, Metrics> op_name2metrics = cache_cnts->op_name2gone_metrics;
+  for (const OpKernelInferCache* cache : cache_cnts->living_caches) {
+    Metrics* metrics = &op_name2metrics[cache->op_name_];
+    metrics->hit_cnt += cache->hit_cnt();
+    metrics->miss_cnt += cache->miss_cnt();
+  }
+  return op_name2metrics;
+}
+
+OpKernelInferCache::ValueType OpKernelInferCache::GetCacheValue() {
+  if (IsLastCacheKey()) {
+    IncreaseCnt(&hit_cnt_);
+    return last_cache_value_;
+  }
+  ValueType cache_value = store_->Find(cache_key_, cache_key_hash_value_);
+  if (cache_value) {
+    IncreaseCnt(&hit_cnt_);
+    SetLastCacheKey(cache_value);
+  } else {
+    IncreaseCnt(&miss_cnt_);
+  }
+  return cache_value;
+}
+
+bool OpKernelInferCache::IsLastCacheKey() const {
+  // the other fields of the key never change
+  return last_cache_value_ && last_cache_key_hash_value_ == cache_key_hash_value_
+         && last_ibn_idx2shape_sym_ == cache_key_.ibn_idx2shape_sym;
+}
+
+void OpKernelInferCache::SetLastCacheKey(const ValueType& value) {
+  last_ibn_idx2shape_sym_ = cache_key_.ibn_idx2shape_sym;
+  last_cache_key_hash_value_ = cache_key_hash_value_;
+  last_cache_value_ = value;
+}
+
+void OpKernelInferCache::IncreaseCnt(std::atomic<int64_t>* cnt) {
+  // the kernel thread is the only writer, so no read-modify-write is needed
+  cnt->store(cnt->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
 
 void OpKernelInferCache::UpdateCacheKey(KernelInferContext* ctx) {
   auto GetSymbolOfShape = [&](const std::string& arg_name, int32_t arg_index) -> Symbol<Shape> {
     Shape shape;
     ctx->ShapeView4ArgNameAndIndex(arg_name, arg_index).ToShape(&shape);
+    if (shape_bucket_fn_ != nullptr) {
+      return SymbolOf((*shape_bucket_fn_)(arg_name, arg_index, shape));
+    }
     return SymbolOf(shape);
   };
   const auto& inputs = ctx->inputs();
@@ -54,10 +263,10 @@ void OpKernelInferCache::UpdateCacheKey(KernelInferContext* ctx) {
     const auto& arg_pair = inputs.at(i);
     cache_key_.ibn_idx2shape_sym.at(i) = GetSymbolOfShape(arg_pair.first, arg_pair.second);
   }
+  cache_key_hash_value_ = std::hash<KeyType>()(cache_key_);
 }
 
 void OpKernelInferCache::UpdateCacheValue(KernelInferContext* ctx) {
-  if (cached_key2value_.size() >= max_size_) { Reset(); }
   auto* cache_value = new OpInferCacheValue();
   cache_value->obn_idx2shape_sym.resize(ctx->outputs().size());
   FOR_RANGE(int, i, 0, ctx->outputs().size()) {
@@ -68,30 +277,9 @@ void OpKernelInferCache::UpdateCacheValue(KernelInferContext* ctx) {
     out_shape_view.ToShape(&out_shape);
     cache_value->obn_idx2shape_sym.at(i).reset(out_shape);
   }
-  KeyType* new_key = new KeyType(cache_key_);
-  key_storage_.emplace_back(new_key);
-  size_t hash_value = std::hash<KeyType>()(cache_key_);
-  HashEqTraitPtr<const KeyType> ptr_wrapper(new_key, hash_value);
-  CHECK(cached_key2value_.emplace(ptr_wrapper, ValueType(cache_value)).second);
-}
-
-void OpKernelInferCache::Reset() {
-  CHECK_EQ(cached_key2value_.size(), key_storage_.size());
-  HashMap to_release_key2values;
-  KeyStorage to_release_key_storage;
-  std::swap(cached_key2value_, to_release_key2values);
-  std::swap(key_storage_, to_release_key_storage);
-  if (to_release_key2values.size() <= kReleaseInIndependentThreadThreshold) {
-    to_release_key2values.clear();
-    to_release_key_storage.clear();
-  } else {
-    std::thread(
-        [](HashMap&& cache, KeyStorage&& key_storage) {
-          cache.clear();
-          key_storage.clear();
-        },
-        std::move(to_release_key2values), std::move(to_release_key_storage));
-  }
+  const ValueType value(cache_value);
+  store_->Insert(cache_key_, cache_key_hash_value_, value);
+  SetLastCacheKey(value);
 }
 
 }  // namespace user_op
@@ -26,28 +26,116 @@ namespace user_op {
 
 class KernelInferContext;
 
+// Maps the runtime shape of an input to the shape its cache key is built from. An op type whose
+// kernels infer the same output shapes for all the input shapes of a bucket may register one, so
+// that a bucket of dynamic shapes takes a single cache entry.
+using InferCacheShapeBucketFn =
+    std::function<Shape(const std::string& arg_name, int32_t arg_index, const Shape& shape)>;
+
+// Output shapes inferred at runtime by the kernels of one op type.
+//
+// The kernels of an op type with the same parallel signature share one store, so that the shapes
+// inferred by one kernel are hits for the others with the same conf. The parallel signature
+// covers the parallel context, sbp and logical blob descs of a kernel, which runtime infer fns
+// may read. Entries are evicted in least recently used order once the
+// store holds more than `capacity` of them, which is read from the environment variable
+// ONEFLOW_OP_KERNEL_INFER_CACHE_CAPACITY for shared stores.
+class OpKernelInferCacheStore final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(OpKernelInferCacheStore);
+  using KeyType = OpInferCacheKey;
+  using ValueType = std::shared_ptr<const OpInferCacheValue>;
+
+  struct Metrics {
+    int64_t hit_cnt = 0;
+    int64_t miss_cnt = 0;
+    int64_t evict_cnt = 0;
+
+    double hit_rate() const;
+    std::string ToString() const;
+  };
+
+  OpKernelInferCacheStore(const std::string& op_type_name, size_t capacity);
+  ~OpKernelInferCacheStore();
+
+  // Returns the store shared by the living kernels of op type `op_type_name` whose parallel
+  // signature is `parallel_signature`.
+  static std::shared_ptr<OpKernelInferCacheStore> Get4OpTypeName(
+      const std::string& op_type_name, const std::string& parallel_signature);
+  // Returns the parallel signature of the kernel of `kernel_conf`.
+  static std::string GetParallelSignature(const KernelConf& kernel_conf);
+  static void RegisterShapeBucketFn(const std::string& op_type_name,
+                                    const InferCacheShapeBucketFn& fn);
+  // Returns nullptr if op type `op_type_name` has no InferCacheShapeBucketFn.
+  static const InferCacheShapeBucketFn* LookupShapeBucketFn(const std::string& op_type_name);
+
+  // Returns nullptr if `key` is not cached. `hash_value` is std::hash<KeyType>()(key).
+  ValueType Find(const KeyType& key, size_t hash_value);
+  void Insert(const KeyType& key, size_t hash_value, const ValueType& value);
+  void Clear();
+
+  Metrics metrics() const;
+  size_t size() const;
+
+ private:
+  struct Entry {
+    KeyType key;
+    size_t hash_value;
+    ValueType value;
+  };
+  // most recently used entries first
+  using EntryList = std::list<Entry>;
+
+  std::string op_type_name_;
+  size_t capacity_;
+  mutable std::mutex mutex_;
+  EntryList lru_list_;
+  std::unordered_map<HashEqTraitPtr<const KeyType>, EntryList::iterator> key2lru_iter_;
+  Metrics metrics_;
+};
+
+#define REGISTER_OP_KERNEL_INFER_CACHE_SHAPE_BUCKET_FN(op_type_name, fn) \
+  COMMAND(::oneflow::user_op::OpKernelInferCacheStore::RegisterShapeBucketFn(op_type_name, fn))
+
 class OpKernelInferCache final {
  public:
   using KeyType = OpInferCacheKey;
   using ValueType = std::shared_ptr<const OpInferCacheValue>;
-  using HashMap = std::unordered_map<HashEqTraitPtr<const KeyType>, ValueType>;
-  using KeyStorage = std::list<std::unique_ptr<KeyType>>;
-  static constexpr size_t kReleaseInIndependentThreadThreshold = 4096;
+  using Metrics = OpKernelInferCacheStore::Metrics;
 
   OpKernelInferCache(const KernelConf& kernel_conf, const JobDesc& job_desc);
-  ~OpKernelInferCache() = default;
+  ~OpKernelInferCache();
 
-  bool IsCacheHit() const;
-  ValueType GetCacheValue() const;
+  // Returns nullptr if the output shapes of the key set by UpdateCacheKey are not cached.
+  ValueType GetCacheValue();
   void UpdateCacheKey(KernelInferContext* ctx);
   void UpdateCacheValue(KernelInferContext* ctx);
-  void Reset();
+
+  int64_t hit_cnt() const { return hit_cnt_.load(std::memory_order_relaxed); }
+  int64_t miss_cnt() const { return miss_cnt_.load(std::memory_order_relaxed); }
+
+  // Returns the hits and misses of the kernels by op name. Kernels which have gone away keep
+  // their counts, and kernels of the same op name add up.
+  static HashMap<std::string, Metrics> GetOpName2Metrics();
 
  private:
+  bool IsLastCacheKey() const;
+  void SetLastCacheKey(const ValueType& value);
+  void IncreaseCnt(std::atomic<int64_t>* cnt);
+
+  std::string op_name_;
   KeyType cache_key_;
-  HashMap cached_key2value_;
-  KeyStorage key_storage_;
-  size_t max_size_;
+  size_t cache_key_hash_value_;
+  const InferCacheShapeBucketFn* shape_bucket_fn_;
+  std::shared_ptr<OpKernelInferCacheStore> store_;
+  // the input shapes of the last key found in or inserted to store_ and its value, which are
+  // checked before store_ so that a kernel whose shapes do not change takes no lock
+  std::vector<Symbol<Shape>> last_ibn_idx2shape_sym_;
+  size_t last_cache_key_hash_value_;
+  ValueType last_cache_value_;
+  // only written by the thread of the kernel, atomic for GetOpName2Metrics
+  std::atomic<int64_t> hit_cnt_;
+  std::atomic<int64_t> miss_cnt_;
 };
 
 }  // namespace user_op
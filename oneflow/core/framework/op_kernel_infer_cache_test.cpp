@@ -0,0 +1,119 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/op_kernel_infer_cache.h"
+#include "oneflow/core/operator/operator.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+OpInferCacheKey MakeKey(int64_t seq_len) {
+  OpInferCacheKey key;
+  key.job_desc = nullptr;
+  key.op_conf_sym = SymbolOf(OperatorConf());
+  key.dtype_signature_sym = SymbolOf(DTypeSignature());
+  key.ibn_idx2shape_sym.push_back(SymbolOf(Shape({8, seq_len})));
+  return key;
+}
+
+std::shared_ptr<const OpInferCacheValue> MakeValue(int64_t seq_len) {
+  auto* value = new OpInferCacheValue();
+  value->obn_idx2shape_sym.push_back(SymbolOf(Shape({8, seq_len, 16})));
+  return std::shared_ptr<const OpInferCacheValue>(value);
+}
+
+std::shared_ptr<const OpInferCacheValue> Find(user_op::OpKernelInferCacheStore* store,
+                                              int64_t seq_len) {
+  const OpInferCacheKey key = MakeKey(seq_len);
+  return store->Find(key, std::hash<OpInferCacheKey>()(key));
+}
+
+void Insert(user_op::OpKernelInferCacheStore* store, int64_t seq_len) {
+  const OpInferCacheKey key = MakeKey(seq_len);
+  store->Insert(key, std::hash<OpInferCacheKey>()(key), MakeValue(seq_len));
+}
+
+}  // namespace
+
+TEST(OpKernelInferCacheStore, evict_least_recently_used) {
+  user_op::OpKernelInferCacheStore store("test", 2);
+  Insert(&store, 1);
+  Insert(&store, 2);
+  ASSERT_TRUE(Find(&store, 1) != nullptr);
+  // 2 is the least recently used one
+  Insert(&store, 3);
+  ASSERT_EQ(store.size(), 2);
+  ASSERT_TRUE(Find(&store, 2) == nullptr);
+  const auto& value = Find(&store, 1);
+  ASSERT_TRUE(value != nullptr);
+  ASSERT_TRUE(*value->obn_idx2shape_sym.at(0) == Shape({8, 1, 16}));
+  ASSERT_TRUE(Find(&store, 3) != nullptr);
+  Insert(&store, 3);
+  ASSERT_EQ(store.size(), 2);
+  const user_op::OpKernelInferCacheStore::Metrics metrics = store.metrics();
+  ASSERT_EQ(metrics.hit_cnt, 3);
+  ASSERT_EQ(metrics.miss_cnt, 1);
+  ASSERT_EQ(metrics.evict_cnt, 1);
+  ASSERT_DOUBLE_EQ(metrics.hit_rate(), 0.75);
+  store.Clear();
+  ASSERT_EQ(store.size(), 0);
+  ASSERT_TRUE(Find(&store, 1) == nullptr);
+}
+
+TEST(OpKernelInferCacheStore, shared_by_op_type_and_parallel_signature) {
+  std::shared_ptr<user_op::OpKernelInferCacheStore> store =
+      user_op::OpKernelInferCacheStore::Get4OpTypeName("a", "");
+  ASSERT_TRUE(user_op::OpKernelInferCacheStore::Get4OpTypeName("a", "") == store);
+  ASSERT_TRUE(user_op::OpKernelInferCacheStore::Get4OpTypeName("b", "") != store);
+  Insert(store.get(), 1);
+  ASSERT_TRUE(Find(user_op::OpKernelInferCacheStore::Get4OpTypeName("a", "").get(), 1) != nullptr);
+  // kernels on another parallel id or with another sbp may infer other shapes for the same key
+  KernelConf kernel_conf;
+  kernel_conf.mutable_parallel_ctx()->set_parallel_id(0);
+  kernel_conf.mutable_parallel_ctx()->set_parallel_num(2);
+  const std::string signature0 =
+      user_op::OpKernelInferCacheStore::GetParallelSignature(kernel_conf);
+  kernel_conf.mutable_parallel_ctx()->set_parallel_id(1);
+  const std::string signature1 =
+      user_op::OpKernelInferCacheStore::GetParallelSignature(kernel_conf);
+  ASSERT_NE(signature0, signature1);
+  std::shared_ptr<user_op::OpKernelInferCacheStore> store0 =
+      user_op::OpKernelInferCacheStore::Get4OpTypeName("a", signature0);
+  ASSERT_TRUE(store0 != store);
+  ASSERT_TRUE(user_op::OpKernelInferCacheStore::Get4OpTypeName("a", signature1) != store0);
+  ASSERT_TRUE(Find(store0.get(), 1) == nullptr);
+  // a store lives as long as a kernel of the op type
+  store.reset();
+  ASSERT_EQ(user_op::OpKernelInferCacheStore::Get4OpTypeName("a", "")->size(), 0);
+}
+
+TEST(OpKernelInferCacheStore, shape_bucket_fn) {
+  ASSERT_TRUE(user_op::OpKernelInferCacheStore::LookupShapeBucketFn("test_bucket") == nullptr);
+  user_op::OpKernelInferCacheStore::RegisterShapeBucketFn(
+      "test_bucket", [](const std::string&, int32_t, const Shape& shape) {
+        return Shape({shape.At(0), (shape.At(1) + 31) / 32 * 32});
+      });
+  const user_op::InferCacheShapeBucketFn* fn =
+      user_op::OpKernelInferCacheStore::LookupShapeBucketFn("test_bucket");
+  ASSERT_TRUE(fn != nullptr);
+  ASSERT_TRUE((*fn)("in", 0, Shape({8, 17})) == Shape({8, 32}));
+}
+
+}  // namespace test
+
+}  // namespace oneflow
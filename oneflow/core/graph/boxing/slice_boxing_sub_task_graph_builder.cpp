@@ -22,6 +22,7 @@ limitations under the License.
 #include "oneflow/core/common/id_util.h"
 #include "oneflow/core/graph/id_serialization.h"
 #include "oneflow/core/device/cpu_stream_index.h"
+#include "oneflow/core/job/resource_desc.h"
 #ifdef WITH_CUDA
 #include "oneflow/core/device/cuda_stream_index.h"
 #endif
@@ -51,6 +52,26 @@ bool IsCopyContiguous(const TensorSliceView& src, const TensorSliceView& dst) {
   return true;
 }
 
+// Splits `slice` along its first axis into chunks of about `chunk_byte` bytes. Returns `slice`
+// itself if it is not larger than `chunk_byte` or if chunking is disabled.
+std::vector<TensorSliceView> SplitSliceIntoChunks(const TensorSliceView& slice, DataType data_type,
+                                                  size_t chunk_byte) {
+  const int64_t row_num = slice.At(0).size();
+  const size_t row_byte = slice.shape().Count(1) * GetSizeOfDataType(data_type);
+  const size_t slice_byte = row_num * row_byte;
+  if (chunk_byte == 0 || slice_byte <= chunk_byte || row_num <= 1) { return {slice}; }
+  const int64_t chunk_num = std::min<int64_t>(row_num, (slice_byte + chunk_byte - 1) / chunk_byte);
+  const BalancedSplitter bs(row_num, chunk_num);
+  std::vector<TensorSliceView> chunks;
+  FOR_RANGE(int64_t, i, 0, chunk_num) {
+    std::vector<Range> ranges = slice.range_vec();
+    const int64_t begin = slice.At(0).begin();
+    ranges.at(0) = Range(begin + bs.At(i).begin(), begin + bs.At(i).end());
+    chunks.emplace_back(ranges);
+  }
+  return chunks;
+}
+
 bool IsSameDevice(const ParallelDesc& in_pd, const ParallelDesc& out_pd,
                   const int64_t in_parallel_id, const int64_t out_parallel_id) {
   return in_pd.device_type() == out_pd.device_type()
@@ -118,7 +139,27 @@ Maybe<SubTskGphBuilderStatus> SliceBoxingSubTskGphBuilder::Build(
     return thrd_id;
   };
 
+  // Blobs sent to another machine are boxed in chunks, each through its own local boxing actor
+  // and comm net actor, so that the transfer of one chunk overlaps the local add/concat of the
+  // next one.
+  const size_t chunk_byte = Global<ResourceDesc, ForSession>::Get()->slice_boxing_chunk_byte();
+  bool is_chunked = false;
   const auto NewEdge = [&ctx]() -> TaskEdge* { return ctx->task_graph()->NewEdge(); };
+  const auto PickLocalBoxingThrdId = [&GetBoxingGpuThrdId](
+                                         const ParallelDesc& in_pd, int64_t in_machine_id,
+                                         const TaskNode* in_node) -> int64_t {
+    if (in_pd.device_type() == DeviceType::kCPU) {
+      return Global<IDMgr>::Get()->PickCpuThrdIdEvenly(in_machine_id);
+    } else if (in_pd.device_type() == DeviceType::kGPU) {
+#ifdef WITH_CUDA
+      return GetBoxingGpuThrdId(in_node->machine_id(), in_node->GpuPhyId(),
+                                CudaWorkType::kCopyD2H);
+#else
+      UNIMPLEMENTED();
+#endif
+    }
+    return -1;
+  };
   const auto CreateBoxingNode121 = [&ctx, &lbi, &GetBoxingGpuThrdId](
                                        const ParallelDesc& pd, const int64_t parallel_id,
                                        const TensorSliceView& slice,
@@ -192,7 +233,7 @@ Maybe<SubTskGphBuilderStatus> SliceBoxingSubTskGphBuilder::Build(
         }
       };
   const auto BuildSubTaskGphS2S = [&ctx, &lbi, &CreateBoxingNode121, &CreateBoxingNodeToHost,
-                                   &GetBoxingGpuThrdId,
+                                   &PickLocalBoxingThrdId, &chunk_byte, &is_chunked,
                                    &NewEdge](const ParallelDesc& in_pd, const ParallelDesc& out_pd,
                                              const SbpParallel& in_sbp, const SbpParallel& out_sbp,
                                              const BlobDesc& blob_desc,
@@ -268,38 +309,37 @@ Maybe<SubTskGphBuilderStatus> SliceBoxingSubTskGphBuilder::Build(
           if (non_empty_intersections.empty()) { continue; }
           const TensorSliceView concat_slice =
               TensorSliceView::Concatenate(non_empty_intersections, in_sbp.split_parallel().axis());
-          SliceBoxingTaskNode* local_concat_node =
-              ctx->task_graph()->NewNode<SliceBoxingTaskNode>();
-          int64_t local_concat_thrd_id = -1;
-          if (in_pd.device_type() == DeviceType::kCPU) {
-            local_concat_thrd_id = Global<IDMgr>::Get()->PickCpuThrdIdEvenly(in_machine_id);
-          } else if (in_pd.device_type() == DeviceType::kGPU) {
-#ifdef WITH_CUDA
-            TaskNode* node = in_nodes.at(in_parallel_ids.at(out_id % in_parallel_ids.size()));
-            local_concat_thrd_id =
-                GetBoxingGpuThrdId(node->machine_id(), node->GpuPhyId(), CudaWorkType::kCopyD2H);
-#else
-            UNIMPLEMENTED();
-#endif
-          }
-          local_concat_node->Init(lbi, concat_slice, kSliceBoxingTaskModeCopy, in_machine_id,
-                                  local_concat_thrd_id, Global<IDMgr>::Get()->CpuMemZoneId());
-          for (const int64_t in_id : in_parallel_ids) {
-            if (!in_id2intersection.at(in_id).IsEmpty()) {
-              local_concat_node->ConnectToSrcNodeWithSlice(in_nodes.at(in_id), NewEdge(),
-                                                           in_slices.at(in_id));
+          const std::vector<TensorSliceView> chunk_slices =
+              SplitSliceIntoChunks(concat_slice, blob_desc.data_type(), chunk_byte);
+          if (chunk_slices.size() > 1) { is_chunked = true; }
+          FOR_RANGE(int64_t, chunk_id, 0, chunk_slices.size()) {
+            const TensorSliceView& chunk_slice = chunk_slices.at(chunk_id);
+            SliceBoxingTaskNode* local_concat_node =
+                ctx->task_graph()->NewNode<SliceBoxingTaskNode>();
+            TaskNode* node =
+                in_nodes.at(in_parallel_ids.at((out_id + chunk_id) % in_parallel_ids.size()));
+            local_concat_node->Init(lbi, chunk_slice, kSliceBoxingTaskModeCopy, in_machine_id,
+                                    PickLocalBoxingThrdId(in_pd, in_machine_id, node),
+                                    Global<IDMgr>::Get()->CpuMemZoneId());
+            for (const int64_t in_id : in_parallel_ids) {
+              const TensorSliceView& intersection = in_id2intersection.at(in_id);
+              if (!intersection.IsEmpty() && !intersection.Intersect(chunk_slice).IsEmpty()) {
+                local_concat_node->ConnectToSrcNodeWithSlice(in_nodes.at(in_id), NewEdge(),
+                                                             in_slices.at(in_id));
+              }
             }
+            TaskNode* local_concat_proxy_node =
+                ctx->task_graph()->GetProxyNode(local_concat_node, lbi, out_node->machine_id(),
+                                                Global<IDMgr>::Get()->CpuMemZoneId());
+            out_node->ConnectToSrcNodeWithSlice(local_concat_proxy_node, NewEdge(), chunk_slice);
           }
-          TaskNode* local_add_proxy_node = ctx->task_graph()->GetProxyNode(
-              local_concat_node, lbi, out_node->machine_id(), Global<IDMgr>::Get()->CpuMemZoneId());
-          out_node->ConnectToSrcNodeWithSlice(local_add_proxy_node, NewEdge(), concat_slice);
         }
       }
       out_nodes->push_back(out_node);
     }
   };
   const auto BuildSubTaskGphP2S = [&ctx, &lbi, &CreateBoxingNode121, &CreateBoxingNodeToHost,
-                                   &GetBoxingGpuThrdId,
+                                   &PickLocalBoxingThrdId, &chunk_byte, &is_chunked,
                                    &NewEdge](const ParallelDesc& in_pd, const ParallelDesc& out_pd,
                                              const SbpParallel& in_sbp, const SbpParallel& out_sbp,
                                              const BlobDesc& blob_desc,
@@ -333,27 +373,41 @@ Maybe<SubTskGphBuilderStatus> SliceBoxingSubTskGphBuilder::Build(
             }
           }
         } else {
-          auto* local_add_node = ctx->task_graph()->NewNode<SliceBoxingTaskNode>();
-          int64_t local_add_thrd_id = -1;
-          if (in_pd.device_type() == DeviceType::kCPU) {
-            local_add_thrd_id = Global<IDMgr>::Get()->PickCpuThrdIdEvenly(in_machine_id);
-          } else if (in_pd.device_type() == DeviceType::kGPU) {
-#ifdef WITH_CUDA
-            TaskNode* node = in_nodes.at(in_parallel_ids.at(out_id % in_parallel_ids.size()));
-            local_add_thrd_id =
-                GetBoxingGpuThrdId(node->machine_id(), node->GpuPhyId(), CudaWorkType::kCopyD2H);
-#else
-            UNIMPLEMENTED();
-#endif
+          const std::vector<TensorSliceView> chunk_slices =
+              SplitSliceIntoChunks(out_slice, blob_desc.data_type(), chunk_byte);
+          std::vector<TaskNode*> local_add_proxy_nodes;
+          FOR_RANGE(int64_t, chunk_id, 0, chunk_slices.size()) {
+            auto* local_add_node = ctx->task_graph()->NewNode<SliceBoxingTaskNode>();
+            TaskNode* node =
+                in_nodes.at(in_parallel_ids.at((out_id + chunk_id) % in_parallel_ids.size()));
+            local_add_node->Init(lbi, chunk_slices.at(chunk_id), kSliceBoxingTaskModeAdd,
+                                 in_machine_id, PickLocalBoxingThrdId(in_pd, in_machine_id, node),
+                                 Global<IDMgr>::Get()->CpuMemZoneId());
+            for (const int64_t in_id : in_parallel_ids) {
+              local_add_node->ConnectToSrcNodeWithSlice(in_nodes.at(in_id), NewEdge(), in_slice);
+            }
+            local_add_proxy_nodes.push_back(
+                ctx->task_graph()->GetProxyNode(local_add_node, lbi, out_node->machine_id(),
+                                                Global<IDMgr>::Get()->CpuMemZoneId()));
           }
-          local_add_node->Init(lbi, out_slice, kSliceBoxingTaskModeAdd, in_machine_id,
-                               local_add_thrd_id, Global<IDMgr>::Get()->CpuMemZoneId());
-          for (const int64_t in_id : in_parallel_ids) {
-            local_add_node->ConnectToSrcNodeWithSlice(in_nodes.at(in_id), NewEdge(), in_slice);
+          if (chunk_slices.size() == 1) {
+            out_node->ConnectToSrcNodeWithSlice(local_add_proxy_nodes.front(), NewEdge(),
+                                                out_slice);
+          } else {
+            // every input of an add node covers its whole out slice, so chunks are gathered by
+            // a copy node on the receiving machine first
+            is_chunked = true;
+            auto* chunk_concat_node = ctx->task_graph()->NewNode<SliceBoxingTaskNode>();
+            chunk_concat_node->Init(
+                lbi, out_slice, kSliceBoxingTaskModeCopy, out_node->machine_id(),
+                Global<IDMgr>::Get()->PickCpuThrdIdEvenly(out_node->machine_id()),
+                Global<IDMgr>::Get()->CpuMemZoneId());
+            FOR_RANGE(int64_t, chunk_id, 0, chunk_slices.size()) {
+              chunk_concat_node->ConnectToSrcNodeWithSlice(local_add_proxy_nodes.at(chunk_id),
+                                                           NewEdge(), chunk_slices.at(chunk_id));
+            }
+            out_node->ConnectToSrcNodeWithSlice(chunk_concat_node, NewEdge(), out_slice);
           }
-          TaskNode* local_add_proxy_node = ctx->task_graph()->GetProxyNode(
-              local_add_node, lbi, out_node->machine_id(), Global<IDMgr>::Get()->CpuMemZoneId());
-          out_node->ConnectToSrcNodeWithSlice(local_add_proxy_node, NewEdge(), out_slice);
         }
       }
       out_nodes->push_back(out_node);
@@ -504,6 +558,7 @@ Maybe<SubTskGphBuilderStatus> SliceBoxingSubTskGphBuilder::Build(
   } else {
     UNIMPLEMENTED();
   }
+  if (is_chunked) { comment += "(Chunked)"; }
   return TRY(BuildSubTskGphBuilderStatus("SliceBoxingSubTskGphBuilder", comment));
 }
 
@@ -0,0 +1,69 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/graph/op_compute_cost.h"
+#include "oneflow/core/framework/user_op_conf.h"
+
+namespace oneflow {
+
+namespace {
+
+// a cpu core computes a few flops in the time it streams one byte from memory
+constexpr double kFlopsPerByte = 4;
+
+const BlobDesc& LogicalBlobDesc4Bn(const OpNode& op_node, const std::string& bn) {
+  const LogicalBlobId& lbi = op_node.op().BnInOp2Lbi(bn);
+  return op_node.LogicalBlobDesc4Lbi(lbi);
+}
+
+double EstimateFlops(const OpNode& op_node) {
+  const OperatorConf& op_conf = op_node.op().op_conf();
+  if (!op_conf.has_user_conf()) { return 0; }
+  const user_op::UserOpConfWrapper user_op_conf(op_conf);
+  const std::string& op_type_name = user_op_conf.op_type_name();
+  if (op_type_name == "matmul" || op_type_name == "batch_matmul"
+      || op_type_name == "broadcast_matmul") {
+    const Shape& a_shape = LogicalBlobDesc4Bn(op_node, GenRepeatedBn("a", 0)).shape();
+    const Shape& out_shape = LogicalBlobDesc4Bn(op_node, GenRepeatedBn("out", 0)).shape();
+    const int64_t num_axes = a_shape.NumAxes();
+    if (num_axes < 2) { return 0; }
+    const int64_t k =
+        a_shape.At(user_op_conf.attr<bool>("transpose_a") ? num_axes - 2 : num_axes - 1);
+    return 2.0 * out_shape.elem_cnt() * k;
+  } else if (op_type_name == "conv1d" || op_type_name == "conv2d" || op_type_name == "conv3d") {
+    const Shape& weight_shape = LogicalBlobDesc4Bn(op_node, GenRepeatedBn("weight", 0)).shape();
+    const Shape& out_shape = LogicalBlobDesc4Bn(op_node, GenRepeatedBn("out", 0)).shape();
+    if (weight_shape.NumAxes() == 0 || weight_shape.At(0) == 0) { return 0; }
+    // multiply-adds of each output element: in channels per group times kernel size
+    return 2.0 * out_shape.elem_cnt() * (weight_shape.elem_cnt() / weight_shape.At(0));
+  }
+  return 0;
+}
+
+}  // namespace
+
+double EstimateCpuOpComputeCost(const OpNode& op_node) {
+  double bytes = 0;
+  for (const std::string& ibn : op_node.op().input_bns()) {
+    bytes += LogicalBlobDesc4Bn(op_node, ibn).ByteSizeOfBlobBody();
+  }
+  for (const std::string& obn : op_node.op().output_bns()) {
+    bytes += LogicalBlobDesc4Bn(op_node, obn).ByteSizeOfBlobBody();
+  }
+  const double cost = bytes + EstimateFlops(op_node) / kFlopsPerByte;
+  return cost / op_node.parallel_desc().parallel_num();
+}
+
+}  // namespace oneflow
@@ -0,0 +1,30 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_GRAPH_OP_COMPUTE_COST_H_
+#define ONEFLOW_CORE_GRAPH_OP_COMPUTE_COST_H_
+
+#include "oneflow/core/graph/op_graph.h"
+
+namespace oneflow {
+
+// Rough cost of one parallel piece of `op_node` on cpu, in bytes: the logical bytes it reads and
+// writes, plus the floating point operations of matmul and conv ops converted to bytes. It is
+// only meant to compare ops with each other.
+double EstimateCpuOpComputeCost(const OpNode& op_node);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_GRAPH_OP_COMPUTE_COST_H_
@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/graph/op_graph.h"
+#include "oneflow/core/graph/op_graph_infer_cache.h"
 #include "oneflow/core/job/job_builder.h"
 #include "oneflow/core/job/mirrored_sig_infer_hint.h"
 #include "oneflow/core/framework/device_registry_manager.h"
@@ -349,8 +350,72 @@ const OpNode* OpGraph::OpNode4OpName(const std::string& op_name) const {
   return op_node_it->second;
 }
 
+namespace {
+
+void AppendInferCacheKeyField(const std::string& field, std::string* key) {
+  key->append(std::to_string(field.size()));
+  key->push_back(':');
+  key->append(field);
+}
+
+Maybe<std::string> MakeInferCacheKey(
+    const OpNode& op_node, bool is_mirrored_conf,
+    const ParallelDistributionSignature& parallel_distribution_sig_conf,
+    const std::string& job_conf_key) {
+  std::string key;
+  AppendInferCacheKeyField(job_conf_key, &key);
+  AppendInferCacheKeyField(op_node.op().op_conf().SerializeAsString(), &key);
+  AppendInferCacheKeyField(op_node.parallel_desc().parallel_conf().SerializeAsString(), &key);
+  AppendInferCacheKeyField(is_mirrored_conf ? "1" : "0", &key);
+  AppendInferCacheKeyField(parallel_distribution_sig_conf.SerializeAsString(), &key);
+  for (const std::string& ibn : op_node.op().input_bns()) {
+    const LogicalBlobId& lbi = op_node.op().BnInOp2Lbi(ibn);
+    const OpNode& producer = op_node.SrcNode4Ibn(ibn);
+    BlobDescProto blob_desc_proto;
+    producer.LogicalBlobDesc4Lbi(lbi).ToProto(&blob_desc_proto);
+    AppendInferCacheKeyField(blob_desc_proto.SerializeAsString(), &key);
+    AppendInferCacheKeyField(producer.ParallelDistribution4Lbi(lbi).SerializeAsString(), &key);
+    AppendInferCacheKeyField(producer.parallel_desc().parallel_conf().SerializeAsString(), &key);
+    const auto& producer_obn = *JUST(producer.op().obn4lbi(lbi));
+    const auto* opt_mirrored_parallel =
+        JUST(producer.op().OptMirroredParallel4BnInOp(producer_obn));
+    AppendInferCacheKeyField(opt_mirrored_parallel->SerializeAsString(), &key);
+  }
+  return key;
+}
+
+Maybe<void> FillInferCacheResult(Operator* op, const OpGraphInferCache::Result& result) {
+  JUST(op->FillMirroredSignature(result.mirrored_signature));
+  JUST(op->FillParallelDistributionSignature(result.parallel_distribution_signature));
+  JUST(op->FillLogicalOutBlobDesc([&](const std::string& obn) -> const BlobDesc& {
+    return *result.output_blob_descs.at(CHECK_JUST(op->GetOutputIndex(obn)));
+  }));
+  return Maybe<void>::Ok();
+}
+
+Maybe<const OpGraphInferCache::Result> MakeInferCacheResult(const Operator& op) {
+  auto result = std::make_shared<OpGraphInferCache::Result>();
+  result->mirrored_signature = *JUST(op.mirrored_signature());
+  result->parallel_distribution_signature = *JUST(op.parallel_distribution_signature());
+  for (int32_t i = 0; i < op.output_bns().size(); ++i) {
+    result->output_blob_descs.push_back(JUST(op.GetLogicalBlobDesc4OutputIndex(i)));
+  }
+  return std::shared_ptr<const OpGraphInferCache::Result>(result);
+}
+
+}  // namespace
+
 Maybe<void> OpGraph::InferLogicalBlobDesc(const Job& job) const {
   JobParallelViewConf job_parallel_view_conf(job.job_parallel_view_conf());
+  OpGraphInferCache* infer_cache = Global<OpGraphInferCache>::Get();
+  const std::string& job_name = job.job_conf().job_name();
+  // ops may read the job conf during inference, so its digest is part of every key
+  std::string job_conf_key;
+  if (infer_cache != nullptr) {
+    const std::string serialized_job_conf = job.job_conf().SerializeAsString();
+    job_conf_key = std::to_string(serialized_job_conf.size()) + "-"
+                   + std::to_string(std::hash<std::string>()(serialized_job_conf));
+  }
   JUST(TopoForEachNodeWithErrorCaptured([&](OpNode* op_node) -> Maybe<void> {
     auto LogicalBlobDesc4InputIndex = [&](int32_t index) -> Maybe<const BlobDesc> {
       CHECK_LT_OR_RETURN(index, op_node->input_index2producer_and_output_index_.size());
@@ -367,7 +432,6 @@ Maybe<void> OpGraph::InferLogicalBlobDesc(const Job& job) const {
       const auto& iter = op_name2is_mirrored.find(op_node->op().op_name());
       if (iter != op_name2is_mirrored.end()) { is_mirrored_conf = iter->second; }
     }
-    JUST(InferOpNodeMirroredSignature(op_node, is_mirrored_conf));
     ParallelDistributionSignature parallel_distribution_sig_conf;
     {
       const auto& op_name2parallel_distribution_sig_conf =
@@ -386,8 +450,28 @@ Maybe<void> OpGraph::InferLogicalBlobDesc(const Job& job) const {
         }
       }
     }
+    // ops without any blob have no mirrored signature to record
+    const bool is_cacheable = infer_cache != nullptr
+                             && !(op_node->op().input_bns().empty()
+                                  && op_node->op().output_bns().empty());
+    std::string infer_cache_key;
+    if (is_cacheable) {
+      infer_cache_key = *JUST(MakeInferCacheKey(*op_node, is_mirrored_conf,
+                                                parallel_distribution_sig_conf, job_conf_key));
+      const auto& result = infer_cache->Find(job_name, op_node->op().op_name(), infer_cache_key);
+      if (result) {
+        JUST(FillInferCacheResult(op_node->mut_op(), *result));
+        op_node->InitLbi2ParallelDistribution();
+        return Maybe<void>::Ok();
+      }
+    }
+    JUST(InferOpNodeMirroredSignature(op_node, is_mirrored_conf));
     InferOpNodeParallelDistributionSignature(op_node, parallel_distribution_sig_conf);
     JUST(op_node->mut_op()->InferLogicalOutBlobDescsIf());
+    if (is_cacheable) {
+      infer_cache->Insert(job_name, op_node->op().op_name(), infer_cache_key,
+                          JUST(MakeInferCacheResult(op_node->op())));
+    }
     return Maybe<void>::Ok();
   }));
   return Maybe<void>::Ok();
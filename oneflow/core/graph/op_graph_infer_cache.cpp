@@ -0,0 +1,77 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/graph/op_graph_infer_cache.h"
+
+namespace oneflow {
+
+namespace {
+
+// bounds the memory held by the keys, which contain serialized op confs
+constexpr size_t kDefaultCapacity = 1 << 18;
+
+std::string JobOpName(const std::string& job_name, const std::string& op_name) {
+  return job_name + "/" + op_name;
+}
+
+}  // namespace
+
+OpGraphInferCache::OpGraphInferCache() : OpGraphInferCache(kDefaultCapacity) {}
+
+OpGraphInferCache::OpGraphInferCache(size_t capacity)
+    : capacity_(capacity), hit_cnt_(0), miss_cnt_(0) {
+  CHECK_GT(capacity_, 0);
+}
+
+std::shared_ptr<const OpGraphInferCache::Result> OpGraphInferCache::Find(
+    const std::string& job_name, const std::string& op_name, const std::string& key) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto& iter = job_op_name2entry_.find(JobOpName(job_name, op_name));
+  if (iter == job_op_name2entry_.end() || iter->second.key != key) {
+    ++miss_cnt_;
+    return nullptr;
+  }
+  ++hit_cnt_;
+  lru_list_.splice(lru_list_.begin(), lru_list_, iter->second.lru_iter);
+  return iter->second.result;
+}
+
+void OpGraphInferCache::Insert(const std::string& job_name, const std::string& op_name,
+                               const std::string& key,
+                               const std::shared_ptr<const Result>& result) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const std::string job_op_name = JobOpName(job_name, op_name);
+  const auto& iter = job_op_name2entry_.find(job_op_name);
+  if (iter != job_op_name2entry_.end()) {
+    iter->second.key = key;
+    iter->second.result = result;
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second.lru_iter);
+    return;
+  }
+  if (job_op_name2entry_.size() >= capacity_) {
+    job_op_name2entry_.erase(lru_list_.back());
+    lru_list_.pop_back();
+  }
+  lru_list_.push_front(job_op_name);
+  job_op_name2entry_.emplace(job_op_name, Entry{key, result, lru_list_.begin()});
+}
+
+void OpGraphInferCache::Clear() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  job_op_name2entry_.clear();
+  lru_list_.clear();
+}
+
+}  // namespace oneflow
@@ -0,0 +1,74 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_GRAPH_OP_GRAPH_INFER_CACHE_H_
+#define ONEFLOW_CORE_GRAPH_OP_GRAPH_INFER_CACHE_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/job/mirrored_parallel.pb.h"
+#include "oneflow/core/job/sbp_parallel.pb.h"
+#include "oneflow/core/register/blob_desc.h"
+
+namespace oneflow {
+
+// Memoizes the logical inference of OpNodes across the OpGraphs built for a job.
+//
+// Job passes build a new OpGraph after each rewrite while most ops stay untouched. An entry is
+// keyed by everything the inference of an op reads: its conf, placement, parallel view confs,
+// a digest of the job conf, and the inferred blob desc, parallel distribution and mirrored parallel
+// of each input. A cached op is filled with the recorded results instead of being re-inferred.
+// At most `capacity` ops are kept and the least recently used one is evicted first.
+class OpGraphInferCache final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(OpGraphInferCache);
+  OpGraphInferCache();
+  explicit OpGraphInferCache(size_t capacity);
+  ~OpGraphInferCache() = default;
+
+  struct Result {
+    MirroredSignature mirrored_signature;
+    ParallelDistributionSignature parallel_distribution_signature;
+    std::vector<std::shared_ptr<const BlobDesc>> output_blob_descs;
+  };
+
+  // Returns nullptr if op `op_name` of job `job_name` has not been inferred with `key`.
+  std::shared_ptr<const Result> Find(const std::string& job_name, const std::string& op_name,
+                                     const std::string& key);
+  void Insert(const std::string& job_name, const std::string& op_name, const std::string& key,
+              const std::shared_ptr<const Result>& result);
+  void Clear();
+
+  int64_t hit_cnt() const { return hit_cnt_; }
+  int64_t miss_cnt() const { return miss_cnt_; }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const Result> result;
+    std::list<std::string>::iterator lru_iter;
+  };
+
+  size_t capacity_;
+  std::mutex mutex_;
+  // most recently used job op name first
+  std::list<std::string> lru_list_;
+  HashMap<std::string, Entry> job_op_name2entry_;
+  std::atomic<int64_t> hit_cnt_;
+  std::atomic<int64_t> miss_cnt_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_GRAPH_OP_GRAPH_INFER_CACHE_H_
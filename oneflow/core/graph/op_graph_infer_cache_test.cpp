@@ -0,0 +1,62 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/graph/op_graph_infer_cache.h"
+
+namespace oneflow {
+
+namespace test {
+
+TEST(OpGraphInferCache, find_inserted) {
+  OpGraphInferCache cache;
+  auto result = std::make_shared<OpGraphInferCache::Result>();
+  result->output_blob_descs.emplace_back(std::make_shared<BlobDesc>(Shape({2, 3}), kFloat));
+  ASSERT_TRUE(cache.Find("job", "op", "key") == nullptr);
+  cache.Insert("job", "op", "key", result);
+  const auto& found = cache.Find("job", "op", "key");
+  ASSERT_TRUE(found == result);
+  ASSERT_TRUE(found->output_blob_descs.at(0)->shape() == Shape({2, 3}));
+  ASSERT_EQ(cache.hit_cnt(), 1);
+  ASSERT_EQ(cache.miss_cnt(), 1);
+}
+
+TEST(OpGraphInferCache, key_changed) {
+  OpGraphInferCache cache;
+  cache.Insert("job", "op", "key", std::make_shared<OpGraphInferCache::Result>());
+  ASSERT_TRUE(cache.Find("job", "op", "new_key") == nullptr);
+  ASSERT_TRUE(cache.Find("other_job", "op", "key") == nullptr);
+  cache.Insert("job", "op", "new_key", std::make_shared<OpGraphInferCache::Result>());
+  ASSERT_TRUE(cache.Find("job", "op", "key") == nullptr);
+  ASSERT_TRUE(cache.Find("job", "op", "new_key") != nullptr);
+  cache.Clear();
+  ASSERT_TRUE(cache.Find("job", "op", "new_key") == nullptr);
+  ASSERT_EQ(cache.hit_cnt(), 1);
+  ASSERT_EQ(cache.miss_cnt(), 4);
+}
+
+TEST(OpGraphInferCache, evict_least_recently_used) {
+  OpGraphInferCache cache(2);
+  cache.Insert("job", "op0", "key", std::make_shared<OpGraphInferCache::Result>());
+  cache.Insert("job", "op1", "key", std::make_shared<OpGraphInferCache::Result>());
+  ASSERT_TRUE(cache.Find("job", "op0", "key") != nullptr);
+  cache.Insert("job", "op2", "key", std::make_shared<OpGraphInferCache::Result>());
+  ASSERT_TRUE(cache.Find("job", "op0", "key") != nullptr);
+  ASSERT_TRUE(cache.Find("job", "op1", "key") == nullptr);
+  ASSERT_TRUE(cache.Find("job", "op2", "key") != nullptr);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
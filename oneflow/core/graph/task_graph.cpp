@@ -29,6 +29,8 @@ limitations under the License.
 #include "oneflow/core/graph/boxing/sub_task_graph_builder_util.h"
 #include "oneflow/core/graph/boxing/hierarchical_sub_task_graph_builder_impl.h"
 #include "oneflow/core/graph/stream_index_getter_registry_manager.h"
+#include "oneflow/core/device/cpu_stream_index.h"
+#include "oneflow/core/graph/op_compute_cost.h"
 
 namespace oneflow {
 
@@ -266,7 +268,19 @@ Maybe<void> MakeGetterTaskNode4MachineId7ThrdId(
   return Maybe<void>::Ok();
 }
 
-void GenSortedCompTaskNodes(const OpNode* op_node, std::vector<CompTaskNode*>* sorted_comp_tasks) {
+CPUStreamIndexGenerator* GetCPUStreamIndexGenerator(int64_t machine_id) {
+  DeviceId device_id{static_cast<DeviceId::rank_t>(machine_id), DeviceType::kCPU,
+                     DeviceId::kCPUDeviceIndex};
+  auto* generator = dynamic_cast<CPUStreamIndexGenerator*>(
+      Global<IDMgr>::Get()->GetStreamIndexGeneratorManager()->GetGenerator(device_id));
+  CHECK_NOTNULL(generator);
+  return generator;
+}
+
+void GenSortedCompTaskNodes(
+    const OpNode* op_node,
+    const HashMap<const OpNode*, std::vector<StreamId::stream_index_t>>& op_node2stream_indexes,
+    std::vector<CompTaskNode*>* sorted_comp_tasks) {
   int64_t parallel_idx = 0;
   const ParallelDesc& parallel_desc = op_node->parallel_desc();
   int64_t parallel_num = parallel_desc.parallel_num();
@@ -288,6 +302,13 @@ void GenSortedCompTaskNodes(const OpNode* op_node, std::vector<CompTaskNode*>* s
         int32_t stream_index_hint = op_node->op().op_conf().stream_index_hint();
         LOG(INFO) << "set op: " << op_node->op().op_name() << " to stream: " << stream_index_hint;
         stream_index = static_cast<StreamId::stream_index_t>(stream_index_hint);
+      } else if (op_node2stream_indexes.find(op_node) != op_node2stream_indexes.end()) {
+        stream_index =
+            op_node2stream_indexes.at(op_node).at(comp_task_node->parallel_ctx()->parallel_id());
+      } else if (parallel_desc.device_type() == DeviceType::kCPU
+                 && comp_task_node->GetTaskType() == TaskType::kNormalForward) {
+        auto* generator = GetCPUStreamIndexGenerator(machine_id);
+        stream_index = generator->GenerateComputeStreamIndex4CpuDevice(dev_phy_id);
       } else {
         stream_index = StreamIndexGetterRegistryManager::Get().StreamIndex4DeviceIdAndTaskType(
             device_id, comp_task_node->GetTaskType());
@@ -313,6 +334,65 @@ bool IsConnectedLbisAllSameParallelDistribution(const OpEdge* op_edge) {
   return *predicators.begin();
 }
 
+// Assigns the compute streams of cpu normal compute tasks by their estimated costs. Ops are
+// visited in topological order, so that the producer an op exchanges the most bytes with,
+// without boxing, has been assigned and its streams may be reused to keep the chain local.
+void AssignCpuComputeStreamsByCost(
+    const OpGraph& op_graph,
+    HashMap<const OpNode*, std::vector<StreamId::stream_index_t>>* op_node2stream_indexes) {
+  std::set<int64_t> machine_ids;
+  op_graph.TopoForEachNode([&](const OpNode* op_node) {
+    const ParallelDesc& parallel_desc = op_node->parallel_desc();
+    if (parallel_desc.device_type() != DeviceType::kCPU) { return; }
+    if (op_node->op().op_conf().has_stream_index_hint()) { return; }
+    std::unique_ptr<CompTaskNode> comp_task_node(NewCompTaskNode4OpNode(op_node));
+    if (comp_task_node->GetTaskType() != TaskType::kNormalForward) { return; }
+    const OpNode* colocated_producer = nullptr;
+    size_t max_edge_bytes = 0;
+    for (const OpEdge* op_edge : op_node->in_edges()) {
+      const OpNode* producer = op_edge->src_node();
+      if (op_node2stream_indexes->find(producer) == op_node2stream_indexes->end()) { continue; }
+      if (!(producer->parallel_desc() == parallel_desc)) { continue; }
+      if (!IsConnectedLbisAllSameParallelDistribution(op_edge)) { continue; }
+      size_t edge_bytes = 0;
+      for (const LogicalBlobId& lbi : op_edge->lbis()) {
+        edge_bytes += producer->LogicalBlobDesc4Lbi(lbi).ByteSizeOfBlobBody();
+      }
+      if (colocated_producer == nullptr || edge_bytes > max_edge_bytes) {
+        colocated_producer = producer;
+        max_edge_bytes = edge_bytes;
+      }
+    }
+    const double cost = EstimateCpuOpComputeCost(*op_node);
+    std::vector<StreamId::stream_index_t> stream_indexes;
+    for (int64_t machine_id : parallel_desc.sorted_machine_ids()) {
+      machine_ids.insert(machine_id);
+      for (int64_t dev_phy_id : parallel_desc.sorted_dev_phy_ids(machine_id)) {
+        const int64_t colocated_stream_index =
+            colocated_producer == nullptr
+                ? -1
+                : op_node2stream_indexes->at(colocated_producer).at(stream_indexes.size());
+        stream_indexes.push_back(
+            GetCPUStreamIndexGenerator(machine_id)->GenerateComputeStreamIndex4CpuDeviceByCost(
+                dev_phy_id, cost, colocated_stream_index));
+      }
+    }
+    CHECK(op_node2stream_indexes->emplace(op_node, std::move(stream_indexes)).second);
+  });
+  for (int64_t machine_id : machine_ids) {
+    const auto& loads = GetCPUStreamIndexGenerator(machine_id)->compute_stream_loads();
+    double total_load = 0;
+    for (double load : loads) { total_load += load; }
+    std::stringstream ss;
+    ss << "predicted load of cpu compute streams on machine " << machine_id << ":";
+    FOR_RANGE(size_t, i, 0, loads.size()) {
+      ss << "\n  stream " << i << ": " << loads.at(i) << " ("
+         << (total_load > 0 ? loads.at(i) / total_load * 100 : 0) << "%)";
+    }
+    LOG(INFO) << ss.str();
+  }
+}
+
 BldSubTskGphMthd GetMthdForBldSubTskGph(const OpEdge* op_edge) {
   const OpNode* src_node = op_edge->src_node();
   const OpNode* dst_node = op_edge->dst_node();
@@ -418,10 +498,14 @@ TaskGraph::TaskGraph() {
   boxing_logger_ = CreateBoxingLogger();
   hierarchical_sub_tsk_gph_builder_.reset(new DispatchHierarchicalSubTskGphBuilder());
   HashMap<const OpNode*, std::vector<CompTaskNode*>> op_node2sorted_comp_tasks;
+  HashMap<const OpNode*, std::vector<StreamId::stream_index_t>> op_node2cpu_stream_indexes;
+  if (Global<ResourceDesc, ForSession>::Get()->enable_cost_aware_cpu_stream_assignment()) {
+    AssignCpuComputeStreamsByCost(*op_graph, &op_node2cpu_stream_indexes);
+  }
 
   op_graph->ForEachNode([&](const OpNode* op_node) {
     std::vector<CompTaskNode*>* sorted_comp_tasks = &(op_node2sorted_comp_tasks[op_node]);
-    GenSortedCompTaskNodes(op_node, sorted_comp_tasks);
+    GenSortedCompTaskNodes(op_node, op_node2cpu_stream_indexes, sorted_comp_tasks);
     for (CompTaskNode* comp_task : *sorted_comp_tasks) { AddAllocatedNode(comp_task); }
   });
 
@@ -18,6 +18,8 @@ limitations under the License.
 #include "oneflow/core/common/str_util.h"
 #include "oneflow/core/common/shape.h"
 #include "oneflow/core/job/id_manager.h"
+#include "oneflow/core/job/job_desc.h"
+#include "oneflow/core/job/mem_lifetime_packing.h"
 #include "oneflow/core/register/runtime_register_desc.h"
 #include "oneflow/core/thread/thread_pool.h"
 #include "oneflow/core/graph/task_node.h"
@@ -29,6 +31,7 @@ enum MemAllocAlgoType {
   kMemSizeFirstAlgo = 0,
   kMutualExclusionFirstAlgo = 1,
   kTimeLineAlgo = 2,
+  kLifetimePackingAlgo = 3,
 };
 
 }  // namespace oneflow
@@ -688,6 +691,41 @@ void MemReusedAlgorithm_TimeLineAlgo(
   result->mem_block_size = bfc_allocator.buffer_size();
 }
 
+void GenMemLifetimes(const std::vector<HashSet<RegstDescProto*>>& alloc_regsts_timeline,
+                     const std::vector<HashSet<RegstDescProto*>>& free_regsts_timeline,
+                     std::vector<RegstDescProto*>* regsts, std::vector<MemLifetime>* lifetimes) {
+  HashMap<RegstDescProto*, int64_t> regst2id;
+  CHECK_EQ(alloc_regsts_timeline.size(), free_regsts_timeline.size());
+  for (int64_t i = 0; i < alloc_regsts_timeline.size(); ++i) {
+    for (RegstDescProto* alloc_regst : alloc_regsts_timeline.at(i)) {
+      CHECK(regst2id.emplace(alloc_regst, regsts->size()).second);
+      regsts->push_back(alloc_regst);
+      lifetimes->push_back(
+          MemLifetime{RtRegstDesc(*alloc_regst).TotalMainByteSize4AllRegst(), i, -1});
+    }
+    for (RegstDescProto* free_regst : free_regsts_timeline.at(i)) {
+      lifetimes->at(regst2id.at(free_regst)).free_index = i;
+    }
+  }
+}
+
+void MemReusedAlgorithm_LifetimePackingAlgo(
+    const std::vector<HashSet<RegstDescProto*>>& alloc_regsts_timeline,
+    const std::vector<HashSet<RegstDescProto*>>& free_regsts_timeline, MemBlockResultInfo* result) {
+  std::vector<RegstDescProto*> regsts;
+  std::vector<MemLifetime> lifetimes;
+  GenMemLifetimes(alloc_regsts_timeline, free_regsts_timeline, &regsts, &lifetimes);
+  const int64_t max_search_steps = GlobalJobDesc()
+                                       .job_conf()
+                                       .memory_allocation_algorithm_conf()
+                                       .lifetime_packing_algo_max_search_steps();
+  std::vector<int64_t> offsets;
+  result->mem_block_size = PackMemLifetimes(lifetimes, max_search_steps, &offsets);
+  for (int64_t i = 0; i < regsts.size(); ++i) {
+    CHECK(result->regst_desc2offset.emplace(regsts.at(i), offsets.at(i)).second);
+  }
+}
+
 void SelectAlgorithmGenMemBlockOffset4Regsts(
     MemAllocAlgoType algo_id, const std::vector<HashSet<RegstDescProto*>>& alloc_regsts_timeline,
     const std::vector<HashSet<RegstDescProto*>>& free_regsts_timeline,
@@ -705,6 +743,9 @@ void SelectAlgorithmGenMemBlockOffset4Regsts(
     case kTimeLineAlgo:
       MemReusedAlgorithm_TimeLineAlgo(alloc_regsts_timeline, free_regsts_timeline, result);
       break;
+    case kLifetimePackingAlgo:
+      MemReusedAlgorithm_LifetimePackingAlgo(alloc_regsts_timeline, free_regsts_timeline, result);
+      break;
     default: UNIMPLEMENTED();
   }
   CHECK_GT(result->mem_block_size, 0);
@@ -718,6 +759,7 @@ int64_t CountMemAllocAlgoNum() {
   if (mem_alloc_algo_conf.use_mem_size_first_algo()) { ++ret; }
   if (mem_alloc_algo_conf.use_mutual_exclusion_first_algo()) { ++ret; }
   if (mem_alloc_algo_conf.use_time_line_algo()) { ++ret; }
+  if (mem_alloc_algo_conf.use_lifetime_packing_algo()) { ++ret; }
   CHECK_GE(ret, 0);
   return ret;
 }
@@ -735,6 +777,9 @@ void InitAlgo2Result(HashMap<MemAllocAlgoType, MemBlockResultInfo>* algo2result)
   if (mem_alloc_algo_conf.use_time_line_algo()) {
     CHECK(algo2result->emplace(kTimeLineAlgo, MemBlockResultInfo()).second);
   }
+  if (mem_alloc_algo_conf.use_lifetime_packing_algo()) {
+    CHECK(algo2result->emplace(kLifetimePackingAlgo, MemBlockResultInfo()).second);
+  }
 }
 
 }  // namespace
@@ -798,12 +843,26 @@ void IntraJobMemSharingUtil::InferMemBlockId4MemReusedRegst(
   // step 3: choose best one for each mem chain and set offset for inplace consumer regst
   for (const auto& pair : mem_chain2algo2result) {
     const MemBlockResultInfo* best_result = nullptr;
+    MemAllocAlgoType best_algo_id = kMemSizeFirstAlgo;
     for (const auto& algo_result_pair : pair.second) {
       if (!best_result || algo_result_pair.second.mem_block_size < best_result->mem_block_size) {
         best_result = &algo_result_pair.second;
+        best_algo_id = algo_result_pair.first;
       }
     }
     CHECK(best_result != nullptr);
+    {
+      std::vector<RegstDescProto*> regsts;
+      std::vector<MemLifetime> lifetimes;
+      GenMemLifetimes(mem_chain2task2alloc_regsts.at(pair.first),
+                      mem_chain2task2free_regsts.at(pair.first), &regsts, &lifetimes);
+      const int64_t peak_alive_size = PeakAliveSize(lifetimes);
+      LOG(INFO) << "mem chain " << pair.first << " shares " << best_result->mem_block_size
+                << " bytes by mem alloc algo " << best_algo_id << ", peak alive bytes "
+                << peak_alive_size << ", overhead "
+                << (best_result->mem_block_size - peak_alive_size) * 100.0 / peak_alive_size
+                << "%";
+    }
     int64_t mem_block_id = Global<IDMgr>::Get()->NewMemBlockId();
     CHECK_EQ(mem_chain2mem_reused_regsts.at(pair.first).size(),
              (best_result->regst_desc2offset.size()
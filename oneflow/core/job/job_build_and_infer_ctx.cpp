@@ -17,6 +17,7 @@ limitations under the License.
 #include "oneflow/core/vm/symbol_storage.h"
 #include "oneflow/core/framework/config_def.h"
 #include "oneflow/core/framework/to_string.h"
+#include "oneflow/core/graph/op_graph_infer_cache.h"
 #include "oneflow/core/job/foreign_callback.h"
 #include "oneflow/core/job/job_build_and_infer_ctx.h"
 #include "oneflow/core/job/mirrored_sig_infer_hint.h"
@@ -967,8 +968,22 @@ Maybe<void> LazyJobBuildAndInferCtx::Complete() {
   Global<JobDesc>::Delete();
   auto scope = std::make_unique<GlobalJobDescScope>(mut_job()->job_conf(), job_id());
   JobPassCtx job_pass_ctx(GlobalJobDesc());
+  const OpGraphInferCache* infer_cache = Global<OpGraphInferCache>::Get();
+  const auto InferCacheHitCnt = [&]() { return infer_cache ? infer_cache->hit_cnt() : 0; };
+  const auto InferCacheMissCnt = [&]() { return infer_cache ? infer_cache->miss_cnt() : 0; };
+  const double complete_start = GetCurTime();
+  const int64_t complete_hit_cnt = InferCacheHitCnt();
+  const int64_t complete_miss_cnt = InferCacheMissCnt();
+  std::stringstream pass_time_log;
   auto DoPass = [&](const std::string& pass_name) -> Maybe<void> {
-    return JobPass4Name(pass_name)(mut_job(), &job_pass_ctx);
+    const double start = GetCurTime();
+    const int64_t hit_cnt = InferCacheHitCnt();
+    const int64_t miss_cnt = InferCacheMissCnt();
+    JUST(JobPass4Name(pass_name)(mut_job(), &job_pass_ctx));
+    pass_time_log << "\n  " << pass_name << " time: " << (GetCurTime() - start) / 1e9
+                  << " seconds, op inference cache hits: " << InferCacheHitCnt() - hit_cnt
+                  << ", misses: " << InferCacheMissCnt() - miss_cnt;
+    return Maybe<void>::Ok();
   };
   if (GlobalJobDesc().Bool("__is_user_function__")) {
     JUST(DoPass("ModelUpdateConfCompatiblePass"));
@@ -976,15 +991,15 @@ Maybe<void> LazyJobBuildAndInferCtx::Complete() {
     JUST(DoPass("AddInputOutputOpsPass"));
     JUST(DoPass("NormalizationExponentialAverageAutoTickPass"));
     JUST(DoPass("GradientAccumulationRewritePass"));
-#ifdef WITH_CUDA
     JUST(DoPass("AutoMixedPrecision"));
     JUST(DoPass("PruneAmpWhiteIdentityOpPass"));
-#endif
     JUST(DoPass("OptimizerPlacementOptimizationPass"));
     JUST(DoPass("DynamicLossScaleSchedulePass"));
     JUST(DoPass("AutoTrainStep"));
     JUST(DoPass("AutoLearningRate"));
     JUST(DoPass("QuantAwareTraining"));
+    // inference only, so no backward op is built from the unfused chain
+    JUST(DoPass("FuseElementwiseChainPass"));
     JUST(DoPass("GenerateBackwardAndOptimizerOpConfs"));
     JUST(DoPass("AddSspVariableProxy"));
     JUST(DoPass("CheckpointingPass"));
@@ -1006,6 +1021,10 @@ Maybe<void> LazyJobBuildAndInferCtx::Complete() {
   }
   JUST(DoPass("DumpBlobParallelConfPass"));
   JUST(CheckJob());
+  LOG(INFO) << "job " << job().job_conf().job_name()
+            << " complete time: " << (GetCurTime() - complete_start) / 1e9
+            << " seconds, op inference cache hits: " << InferCacheHitCnt() - complete_hit_cnt
+            << ", misses: " << InferCacheMissCnt() - complete_miss_cnt << pass_time_log.str();
   return Maybe<void>::Ok();
 }
 
@@ -55,7 +55,9 @@ class JobDesc final {
   bool IsPredict() const { return job_conf_.has_predict_conf(); }
   bool enable_reuse_mem() const { return job_conf_.enable_reuse_mem(); }
   bool enable_inplace() const { return job_conf_.enable_inplace(); }
+  int64_t recomputation_memory_budget() const { return job_conf_.recomputation_memory_budget(); }
   bool enable_auto_mixed_precision() const { return job_conf_.enable_auto_mixed_precision(); }
+  DataType mixed_precision_data_type() const { return job_conf_.mixed_precision_data_type(); }
   bool do_parallel_cast_before_widening_type_cast() const {
     return job_conf_.do_parallel_cast_before_widening_type_cast();
   };
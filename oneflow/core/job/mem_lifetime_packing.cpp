@@ -0,0 +1,173 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/mem_lifetime_packing.h"
+#include <list>
+#include <numeric>
+#include <random>
+#include <tuple>
+
+namespace oneflow {
+
+namespace {
+
+bool IsOverlapped(const MemLifetime& lhs, const MemLifetime& rhs) {
+  return lhs.alloc_index <= rhs.free_index && rhs.alloc_index <= lhs.free_index;
+}
+
+std::vector<std::vector<int64_t>> GenOverlappedIds(const std::vector<MemLifetime>& lifetimes) {
+  std::vector<int64_t> ids(lifetimes.size());
+  std::iota(ids.begin(), ids.end(), 0);
+  std::sort(ids.begin(), ids.end(), [&](int64_t lhs, int64_t rhs) {
+    return lifetimes.at(lhs).alloc_index < lifetimes.at(rhs).alloc_index;
+  });
+  std::vector<std::vector<int64_t>> id2overlapped_ids(lifetimes.size());
+  std::list<int64_t> alive_ids;
+  for (int64_t id : ids) {
+    const MemLifetime& lifetime = lifetimes.at(id);
+    alive_ids.remove_if(
+        [&](int64_t alive_id) { return lifetimes.at(alive_id).free_index < lifetime.alloc_index; });
+    for (int64_t alive_id : alive_ids) {
+      CHECK(IsOverlapped(lifetime, lifetimes.at(alive_id)));
+      id2overlapped_ids.at(id).push_back(alive_id);
+      id2overlapped_ids.at(alive_id).push_back(id);
+    }
+    alive_ids.push_back(id);
+  }
+  return id2overlapped_ids;
+}
+
+// Places the buffers in `order`, each one at the lowest offset of the smallest gap it fits in.
+int64_t PlaceByOrder(const std::vector<MemLifetime>& lifetimes,
+                     const std::vector<std::vector<int64_t>>& id2overlapped_ids,
+                     const std::vector<int64_t>& order, std::vector<int64_t>* offsets) {
+  offsets->assign(lifetimes.size(), -1);
+  int64_t block_size = 0;
+  std::vector<std::pair<int64_t, int64_t>> occupied_ranges;
+  for (int64_t id : order) {
+    const int64_t size = lifetimes.at(id).size;
+    occupied_ranges.clear();
+    for (int64_t overlapped_id : id2overlapped_ids.at(id)) {
+      const int64_t offset = offsets->at(overlapped_id);
+      if (offset == -1) { continue; }
+      occupied_ranges.emplace_back(offset, offset + lifetimes.at(overlapped_id).size);
+    }
+    std::sort(occupied_ranges.begin(), occupied_ranges.end());
+    int64_t best_offset = -1;
+    int64_t best_gap = std::numeric_limits<int64_t>::max();
+    int64_t gap_begin = 0;
+    for (const auto& range : occupied_ranges) {
+      const int64_t gap = range.first - gap_begin;
+      if (gap >= size && gap < best_gap) {
+        best_offset = gap_begin;
+        best_gap = gap;
+      }
+      gap_begin = std::max(gap_begin, range.second);
+    }
+    if (best_offset == -1) { best_offset = gap_begin; }
+    offsets->at(id) = best_offset;
+    block_size = std::max(block_size, best_offset + size);
+  }
+  return block_size;
+}
+
+}  // namespace
+
+int64_t PeakAliveSize(const std::vector<MemLifetime>& lifetimes) {
+  std::vector<std::pair<int64_t, int64_t>> index7size_deltas;
+  for (const MemLifetime& lifetime : lifetimes) {
+    index7size_deltas.emplace_back(lifetime.alloc_index, lifetime.size);
+    index7size_deltas.emplace_back(lifetime.free_index + 1, -lifetime.size);
+  }
+  // frees at an index happen before allocs at the same index
+  std::sort(index7size_deltas.begin(), index7size_deltas.end());
+  int64_t alive_size = 0;
+  int64_t peak_alive_size = 0;
+  for (const auto& pair : index7size_deltas) {
+    alive_size += pair.second;
+    peak_alive_size = std::max(peak_alive_size, alive_size);
+  }
+  return peak_alive_size;
+}
+
+int64_t PackMemLifetimes(const std::vector<MemLifetime>& lifetimes, int64_t max_search_steps,
+                         std::vector<int64_t>* offsets) {
+  if (lifetimes.empty()) {
+    offsets->clear();
+    return 0;
+  }
+  const int64_t peak_alive_size = PeakAliveSize(lifetimes);
+  const std::vector<std::vector<int64_t>> id2overlapped_ids = GenOverlappedIds(lifetimes);
+
+  std::vector<int64_t> init_order(lifetimes.size());
+  std::iota(init_order.begin(), init_order.end(), 0);
+  const auto Length = [&](int64_t id) {
+    return lifetimes.at(id).free_index - lifetimes.at(id).alloc_index + 1;
+  };
+  std::vector<std::function<bool(int64_t, int64_t)>> greedy_orders{
+      [&](int64_t lhs, int64_t rhs) {
+        return std::make_tuple(-lifetimes.at(lhs).size, -Length(lhs), lhs)
+               < std::make_tuple(-lifetimes.at(rhs).size, -Length(rhs), rhs);
+      },
+      [&](int64_t lhs, int64_t rhs) {
+        return std::make_tuple(-lifetimes.at(lhs).size * Length(lhs), lhs)
+               < std::make_tuple(-lifetimes.at(rhs).size * Length(rhs), rhs);
+      },
+      [&](int64_t lhs, int64_t rhs) {
+        return std::make_tuple(-Length(lhs), -lifetimes.at(lhs).size, lhs)
+               < std::make_tuple(-Length(rhs), -lifetimes.at(rhs).size, rhs);
+      },
+  };
+  std::vector<int64_t> best_order;
+  int64_t best_size = std::numeric_limits<int64_t>::max();
+  for (const auto& Less : greedy_orders) {
+    std::vector<int64_t> order = init_order;
+    std::sort(order.begin(), order.end(), Less);
+    std::vector<int64_t> cur_offsets;
+    const int64_t size = PlaceByOrder(lifetimes, id2overlapped_ids, order, &cur_offsets);
+    if (size < best_size) {
+      best_size = size;
+      best_order = order;
+      *offsets = cur_offsets;
+    }
+  }
+
+  // local search: move a buffer ending at the top of the block to an earlier position
+  // the seed and the step count fix the search, so a job always gets the same plan
+  std::mt19937 random_engine(lifetimes.size());
+  std::vector<int64_t> cur_offsets;
+  std::vector<int64_t> top_positions;
+  for (int64_t step = 0; step < max_search_steps && best_size > peak_alive_size; ++step) {
+    top_positions.clear();
+    FOR_RANGE(int64_t, pos, 1, best_order.size()) {
+      const int64_t id = best_order.at(pos);
+      if (offsets->at(id) + lifetimes.at(id).size == best_size) { top_positions.push_back(pos); }
+    }
+    if (top_positions.empty()) { break; }
+    const int64_t from = top_positions.at(random_engine() % top_positions.size());
+    const int64_t to = random_engine() % from;
+    std::vector<int64_t> order = best_order;
+    std::rotate(order.begin() + to, order.begin() + from, order.begin() + from + 1);
+    const int64_t size = PlaceByOrder(lifetimes, id2overlapped_ids, order, &cur_offsets);
+    if (size <= best_size) {
+      best_size = size;
+      best_order.swap(order);
+      offsets->swap(cur_offsets);
+    }
+  }
+  return best_size;
+}
+
+}  // namespace oneflow
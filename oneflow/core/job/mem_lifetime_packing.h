@@ -0,0 +1,47 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_JOB_MEM_LIFETIME_PACKING_H_
+#define ONEFLOW_CORE_JOB_MEM_LIFETIME_PACKING_H_
+
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// A buffer of `size` bytes alive from the `alloc_index`-th to the `free_index`-th task of a mem
+// chain, both included. Buffers whose lifetimes overlap can not share memory.
+struct MemLifetime {
+  int64_t size;
+  int64_t alloc_index;
+  int64_t free_index;
+};
+
+// Returns the max total size of the buffers alive at the same task, a lower bound of the size of
+// any mem block holding all `lifetimes`.
+int64_t PeakAliveSize(const std::vector<MemLifetime>& lifetimes);
+
+// Packs `lifetimes` into one mem block and returns its size, `offsets` being the offset of each
+// buffer in the block.
+//
+// Buffers are placed one by one in the best fitting gap among the placed buffers they overlap
+// with. The placing order starts from the best of a few greedy orders and is refined by moving
+// buffers that end at the top of the block earlier, for at most `max_search_steps` moves or until
+// the size reaches PeakAliveSize. The result only depends on `lifetimes` and `max_search_steps`.
+int64_t PackMemLifetimes(const std::vector<MemLifetime>& lifetimes, int64_t max_search_steps,
+                         std::vector<int64_t>* offsets);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_JOB_MEM_LIFETIME_PACKING_H_
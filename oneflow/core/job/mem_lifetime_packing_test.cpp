@@ -0,0 +1,75 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job/mem_lifetime_packing.h"
+#include <random>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+void CheckNoOverlappedBuffer(const std::vector<MemLifetime>& lifetimes,
+                             const std::vector<int64_t>& offsets, int64_t block_size) {
+  ASSERT_EQ(lifetimes.size(), offsets.size());
+  FOR_RANGE(size_t, i, 0, lifetimes.size()) {
+    ASSERT_GE(offsets.at(i), 0);
+    ASSERT_LE(offsets.at(i) + lifetimes.at(i).size, block_size);
+    FOR_RANGE(size_t, j, 0, i) {
+      const bool is_alive_together = lifetimes.at(i).alloc_index <= lifetimes.at(j).free_index
+                                     && lifetimes.at(j).alloc_index <= lifetimes.at(i).free_index;
+      if (!is_alive_together) { continue; }
+      const bool is_disjoint = offsets.at(i) + lifetimes.at(i).size <= offsets.at(j)
+                               || offsets.at(j) + lifetimes.at(j).size <= offsets.at(i);
+      ASSERT_TRUE(is_disjoint);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(MemLifetimePacking, reach_peak) {
+  // a chain of buffers each alive with the next one only
+  std::vector<MemLifetime> lifetimes{{4, 0, 1}, {8, 1, 2}, {4, 2, 3}, {8, 3, 4}, {2, 4, 4}};
+  ASSERT_EQ(PeakAliveSize(lifetimes), 12);
+  std::vector<int64_t> offsets;
+  const int64_t block_size = PackMemLifetimes(lifetimes, 100, &offsets);
+  CheckNoOverlappedBuffer(lifetimes, offsets, block_size);
+  ASSERT_EQ(block_size, 12);
+}
+
+TEST(MemLifetimePacking, random_lifetimes) {
+  std::mt19937 random_engine(0);
+  std::vector<MemLifetime> lifetimes;
+  FOR_RANGE(int64_t, i, 0, 500) {
+    const int64_t alloc_index = random_engine() % 200;
+    const int64_t free_index = alloc_index + random_engine() % 20;
+    lifetimes.push_back(MemLifetime{1 + static_cast<int64_t>(random_engine() % 1024), alloc_index,
+                                    free_index});
+  }
+  std::vector<int64_t> offsets;
+  const int64_t block_size = PackMemLifetimes(lifetimes, 50, &offsets);
+  CheckNoOverlappedBuffer(lifetimes, offsets, block_size);
+  ASSERT_GE(block_size, PeakAliveSize(lifetimes));
+  // the plan is deterministic
+  std::vector<int64_t> repacked_offsets;
+  ASSERT_EQ(PackMemLifetimes(lifetimes, 50, &repacked_offsets), block_size);
+  ASSERT_EQ(repacked_offsets, offsets);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
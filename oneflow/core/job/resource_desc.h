@@ -49,6 +49,19 @@ class ResourceDesc final {
   bool enable_numa_aware_cuda_malloc_host() const {
     return resource_.enable_numa_aware_cuda_malloc_host();
   }
+  bool enable_numa_aware_cpu_actor() const { return resource_.enable_numa_aware_cpu_actor(); }
+  bool enable_cost_aware_cpu_stream_assignment() const {
+    return resource_.enable_cost_aware_cpu_stream_assignment();
+  }
+  int64_t online_regst_num_tuning_act_num() const {
+    return resource_.online_regst_num_tuning_act_num();
+  }
+  size_t online_regst_num_tuning_mem_byte() const {
+    return resource_.online_regst_num_tuning_mem_mbyte() * kMB;
+  }
+  bool enable_transport_cross_memory_attach() const {
+    return resource_.enable_transport_cross_memory_attach();
+  }
   bool thread_enable_local_message_queue() const {
     return resource_.thread_enable_local_message_queue();
   }
@@ -59,6 +72,7 @@ class ResourceDesc final {
   bool enable_dry_run() const;
   CollectiveBoxingConf collective_boxing_conf() const;
   bool nccl_use_compute_stream() const;
+  size_t slice_boxing_chunk_byte() const { return resource_.slice_boxing_chunk_mbyte() * kMB; }
 
   void SetMachineNum(int32_t val) { resource_.set_machine_num(val); }
   void SetCpuDeviceNum(int32_t val) { resource_.set_cpu_device_num(val); }
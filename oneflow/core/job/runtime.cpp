@@ -24,6 +24,7 @@ limitations under the License.
 #include "oneflow/core/job/runtime_job_descs.h"
 #include "oneflow/core/thread/thread_manager.h"
 #include "oneflow/core/actor/act_event_logger.h"
+#include "oneflow/core/actor/regst_num_tuner.h"
 #include "oneflow/core/graph/task_node.h"
 #include "oneflow/core/device/cuda_util.h"
 #include "oneflow/core/memory/memory_allocator.h"
@@ -31,6 +32,7 @@ limitations under the License.
 #include "oneflow/user/summary/events_writer.h"
 #include "oneflow/core/job/collective_boxing_executor.h"
 #include "oneflow/core/job/collective_boxing_device_ctx_poller.h"
+#include "oneflow/core/framework/op_kernel_infer_cache.h"
 #ifdef WITH_RDMA
 #include "oneflow/core/dl/include/ibv.h"
 #endif  // WITH_RDMA
@@ -61,6 +63,28 @@ bool HasNonCtrlConsumedRegstDescId(const TaskProto& task) {
   return false;
 }
 
+void LogOpKernelInferCacheMetrics() {
+  const auto& op_name2metrics = user_op::OpKernelInferCache::GetOpName2Metrics();
+  if (op_name2metrics.empty()) { return; }
+  std::vector<std::string> op_names;
+  user_op::OpKernelInferCache::Metrics total;
+  for (const auto& pair : op_name2metrics) {
+    op_names.push_back(pair.first);
+    total.hit_cnt += pair.second.hit_cnt;
+    total.miss_cnt += pair.second.miss_cnt;
+  }
+  LOG(INFO) << "Runtime shape inference cache of " << op_names.size() << " ops: hit rate "
+            << total.hit_rate() << ", hits " << total.hit_cnt << ", misses " << total.miss_cnt;
+  if (!VLOG_IS_ON(1)) { return; }
+  std::sort(op_names.begin(), op_names.end());
+  for (const std::string& op_name : op_names) {
+    const auto& metrics = op_name2metrics.at(op_name);
+    VLOG(1) << "Runtime shape inference cache of op " << op_name << ": hit rate "
+            << metrics.hit_rate() << ", hits " << metrics.hit_cnt << ", misses "
+            << metrics.miss_cnt;
+  }
+}
+
 }  // namespace
 
 Runtime::Runtime(const Plan& plan, size_t total_piece_num, bool is_experiment_phase) {
@@ -94,6 +118,8 @@ Runtime::Runtime(const Plan& plan, size_t total_piece_num, bool is_experiment_ph
 Runtime::~Runtime() {
   Global<RuntimeCtx>::Get()->WaitUntilCntEqualZero("running_actor_cnt");
   OF_SESSION_BARRIER();
+  // counted since the process started, as kernels of earlier runtimes keep their counts
+  LogOpKernelInferCacheMetrics();
   DeleteAllGlobal();
 }
 
@@ -129,6 +155,11 @@ void Runtime::NewAllGlobal(const Plan& plan, size_t total_piece_num, bool is_exp
   Global<boxing::collective::CollectiveBoxingExecutor>::New(plan);
   Global<MemoryAllocator>::New();
   Global<RegstMgr>::New(plan);
+  const ResourceDesc* resource_desc = Global<ResourceDesc, ForSession>::Get();
+  if (!is_experiment_phase && resource_desc->online_regst_num_tuning_act_num() > 0) {
+    Global<RegstNumTuner>::New(resource_desc->online_regst_num_tuning_act_num(),
+                               resource_desc->online_regst_num_tuning_mem_byte());
+  }
   Global<ActorMsgBus>::New();
   Global<ThreadMgr>::New(plan);
   Global<boxing::collective::CollectiveBoxingDeviceCtxPoller>::New();
@@ -140,6 +171,7 @@ void Runtime::DeleteAllGlobal() {
   Global<RuntimeJobDescs>::Delete();
   Global<boxing::collective::CollectiveBoxingDeviceCtxPoller>::Delete();
   Global<ThreadMgr>::Delete();
+  Global<RegstNumTuner>::Delete();
   Global<ActorMsgBus>::Delete();
   Global<RegstMgr>::Delete();
   Global<MemoryAllocator>::Delete();
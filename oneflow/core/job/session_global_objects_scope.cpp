@@ -32,6 +32,7 @@ limitations under the License.
 #include "oneflow/core/job/job_build_and_infer_ctx_mgr.h"
 #include "oneflow/core/job/job_set_compile_ctx.h"
 #include "oneflow/core/job/runtime_buffer_managers_scope.h"
+#include "oneflow/core/graph/op_graph_infer_cache.h"
 #include "oneflow/core/framework/load_library.h"
 #include "oneflow/core/job/version.h"
 #include "oneflow/core/job/global_for.h"
@@ -111,6 +112,9 @@ Maybe<void> SessionGlobalObjectsScope::Init(const ConfigProto& config_proto) {
     Global<CriticalSectionDesc>::New();
     Global<InterUserJobInfo>::New();
     Global<LazyJobBuildAndInferCtxMgr>::New();
+    if (std::getenv("ONEFLOW_DISABLE_OP_GRAPH_INFER_CACHE") == nullptr) {
+      Global<OpGraphInferCache>::New();
+    }
     Global<JobSetCompileCtx>::New();
     Global<RuntimeBufferManagersScope>::New();
   }
@@ -138,6 +142,7 @@ SessionGlobalObjectsScope::~SessionGlobalObjectsScope() {
   if (GlobalProcessCtx::IsThisProcessMaster()) {
     Global<RuntimeBufferManagersScope>::Delete();
     Global<JobSetCompileCtx>::Delete();
+    if (Global<OpGraphInferCache>::Get() != nullptr) { Global<OpGraphInferCache>::Delete(); }
     Global<LazyJobBuildAndInferCtxMgr>::Delete();
     Global<InterUserJobInfo>::Delete();
     Global<CriticalSectionDesc>::Delete();
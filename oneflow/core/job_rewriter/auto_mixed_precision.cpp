@@ -14,13 +14,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-#ifdef WITH_CUDA
-
 #include "oneflow/core/job_rewriter/auto_mixed_precision_lists.h"
 
 #include <algorithm>
 
+#ifdef WITH_CUDA
 #include "oneflow/core/device/cuda_util.h"
+#endif
 #include "oneflow/core/framework/framework.h"
 #include "oneflow/core/job_rewriter/job_pass.h"
 #include "oneflow/core/job_rewriter/pass_util.h"
@@ -53,17 +53,24 @@ bool FindInNoCastRegisry(const std::string& op_type, const OpArg& op_arg) {
   return false;
 }
 
-std::function<bool(OpNode*)> MakePredicatorIsAllowedToRunWithHalf(const OpGraph& op_graph) {
+// float16 runs on gpu devices and bfloat16 on cpu devices
+DeviceType DeviceType4LowPrecisionDataType(DataType low_precision_data_type) {
+  return low_precision_data_type == DataType::kBFloat16 ? DeviceType::kCPU : DeviceType::kGPU;
+}
+
+std::function<bool(OpNode*)> MakePredicatorIsAllowedToRunWithHalf(
+    const OpGraph& op_graph, DataType low_precision_data_type) {
+  const DeviceType device_type = DeviceType4LowPrecisionDataType(low_precision_data_type);
   auto allowed_set = std::make_shared<HashSet<OpNode*>>();
   op_graph.ForEachNode([&](OpNode* node) {
-    if (node->parallel_desc().device_type() != DeviceType::kGPU) { return; }
+    if (node->parallel_desc().device_type() != device_type) { return; }
     if (node->op().output_bns().size() > 0) { INSERT_CHECK(allowed_set->insert(node)); }
   });
   return [allowed_set](OpNode* node) -> bool { return IsKeyFound(*allowed_set, node); };
 }
 
-void InsertCastOpImpl(bool f2h, const OpGraph& op_graph, const HashSet<OpNode*>& white_set,
-                      JobBuilder* job_builder) {
+void InsertCastOpImpl(bool f2h, DataType low_precision_data_type, const OpGraph& op_graph,
+                      const HashSet<OpNode*>& white_set, JobBuilder* job_builder) {
   HashSet<OpEdge*> white_set_edges;
   {
     std::function<const std::unordered_set<OpEdge*>&(OpNode*)> Node2Edges =
@@ -104,7 +111,7 @@ void InsertCastOpImpl(bool f2h, const OpGraph& op_graph, const HashSet<OpNode*>&
     if (blob_desc.data_type() != DataType::kFloat) { continue; }
 
     std::string cast_suffix = f2h ? "-cast_f2h" : "-cast_h2f";
-    DataType cast_data_type = f2h ? DataType::kFloat16 : DataType::kFloat;
+    DataType cast_data_type = f2h ? low_precision_data_type : DataType::kFloat;
     auto cast_op = user_op::UserOpConfWrapperBuilder(ReplaceSlashToDash4Lbn(lbn) + cast_suffix)
                        .Op("cast")
                        .Input("in", lbn)
@@ -153,54 +160,78 @@ void InsertCastOpImpl(bool f2h, const OpGraph& op_graph, const HashSet<OpNode*>&
   job_builder->MutOpsOnlyOnce(dst_op_confs);
 }
 
+struct AMPLists {
+  const AMPList& white_list;
+  const AMPList& black_list;
+  const AMPList& gray_list;
+  const AMPList& clear_list;
+};
+
 class AutoMixedPrecision final : public JobPass {
  public:
   OF_DISALLOW_COPY_AND_MOVE(AutoMixedPrecision);
   AutoMixedPrecision()
-      : white_list_(AutoMixedPrecisionLists::WhiteList()),
-        black_list_(AutoMixedPrecisionLists::BlackList()),
-        gray_list_(AutoMixedPrecisionLists::GrayList()),
-        clear_list_(AutoMixedPrecisionLists::ClearList()) {}
+      : half_lists_{AutoMixedPrecisionLists::WhiteList(), AutoMixedPrecisionLists::BlackList(),
+                    AutoMixedPrecisionLists::GrayList(), AutoMixedPrecisionLists::ClearList()},
+        bfloat16_lists_{AutoMixedPrecisionLists::BFloat16WhiteList(),
+                        AutoMixedPrecisionLists::BlackList(),
+                        AutoMixedPrecisionLists::BFloat16GrayList(),
+                        AutoMixedPrecisionLists::BFloat16ClearList()} {}
   ~AutoMixedPrecision() = default;
 
   bool IsEnabled(const JobPassCtx& ctx) const {
     return ctx.job_desc().enable_auto_mixed_precision();
   }
 
-  Maybe<void> Apply(const OpGraph& op_graph, JobBuilder* job_builder) const;
+  Maybe<void> Apply(const OpGraph& op_graph, DataType low_precision_data_type,
+                    JobBuilder* job_builder) const;
 
   Maybe<void> Apply(Job* job, JobPassCtx* ctx) const override {
     if (!IsEnabled(*ctx)) { return Maybe<void>::Ok(); }
     const OpGraph op_graph(*job);
     JobBuilder job_builder(job);
-    return Apply(op_graph, &job_builder);
+    return Apply(op_graph, ctx->job_desc().mixed_precision_data_type(), &job_builder);
   }
 
  private:
-  void FillBlackSet(const OpGraph& op_graph, HashSet<OpNode*>* black_set) const;
-  void FillWhiteSet(const OpGraph& op_graph, std::function<bool(OpNode*)> IsAllowedToRunWithHalf,
+  void FillBlackSet(const OpGraph& op_graph, const AMPLists& lists,
+                    HashSet<OpNode*>* black_set) const;
+  void FillWhiteSet(const OpGraph& op_graph, const AMPLists& lists,
+                    std::function<bool(OpNode*)> IsAllowedToRunWithHalf,
                     const HashSet<OpNode*>& black_set, HashSet<OpNode*>* white_set) const;
-  void PropagateWhiteThroughClearNodes(const OpGraph& op_graph,
+  void PropagateWhiteThroughClearNodes(const OpGraph& op_graph, const AMPLists& lists,
                                        std::function<bool(OpNode*)> IsAllowedToRunWithHalf,
                                        const HashSet<OpNode*>& black_set,
                                        HashSet<OpNode*>* white_set) const;
-  void InsertCastOp(const OpGraph& op_graph, const HashSet<OpNode*>& white_set,
-                    JobBuilder* job_builder) const;
+  void InsertCastOp(const OpGraph& op_graph, DataType low_precision_data_type,
+                    const HashSet<OpNode*>& white_set, JobBuilder* job_builder) const;
 
-  const AMPList& white_list_;
-  const AMPList& black_list_;
-  const AMPList& gray_list_;
-  const AMPList& clear_list_;
+  const AMPLists half_lists_;
+  const AMPLists bfloat16_lists_;
 };
 
-Maybe<void> AutoMixedPrecision::Apply(const OpGraph& op_graph, JobBuilder* job_builder) const {
-  CHECK_GE(CUDA_VERSION, 10000);
-  CHECK(GlobalJobDesc().DefaultDataType() == DataType::kFloat);
+Maybe<void> AutoMixedPrecision::Apply(const OpGraph& op_graph, DataType low_precision_data_type,
+                                      JobBuilder* job_builder) const {
+  if (low_precision_data_type == DataType::kFloat16) {
+#ifdef WITH_CUDA
+    CHECK_GE_OR_RETURN(CUDA_VERSION, 10000);
+#else
+    // float16 kernels are cuda only, the job runs in float as if amp was disabled
+    LOG(WARNING) << "float16 auto mixed precision is ignored in a build without cuda";
+    return Maybe<void>::Ok();
+#endif
+  } else {
+    CHECK_EQ_OR_RETURN(low_precision_data_type, DataType::kBFloat16)
+        << "auto mixed precision supports float16 and bfloat16 only";
+  }
+  CHECK_OR_RETURN(GlobalJobDesc().DefaultDataType() == DataType::kFloat);
+  const AMPLists& lists =
+      low_precision_data_type == DataType::kBFloat16 ? bfloat16_lists_ : half_lists_;
 
-  VerifyAMPList(white_list_);
-  VerifyAMPList(black_list_);
-  VerifyAMPList(gray_list_);
-  VerifyAMPList(clear_list_);
+  VerifyAMPList(lists.white_list);
+  VerifyAMPList(lists.black_list);
+  VerifyAMPList(lists.gray_list);
+  VerifyAMPList(lists.clear_list);
 
   std::function<std::string(OpNode* const&)> OpName4Node = [](OpNode* const& node) {
     return node->op().op_name();
@@ -208,30 +239,33 @@ Maybe<void> AutoMixedPrecision::Apply(const OpGraph& op_graph, JobBuilder* job_b
   HashSet<OpNode*> black_set;
   HashSet<OpNode*> white_set;
 
-  FillBlackSet(op_graph, &black_set);
+  FillBlackSet(op_graph, lists, &black_set);
   VLOG(1) << "BlackSet include: "
           << Container2Str<HashSet<OpNode*>, OpNode*>(black_set, OpName4Node);
 
-  auto IsAllowedToRunWithHalf = MakePredicatorIsAllowedToRunWithHalf(op_graph);
-  FillWhiteSet(op_graph, IsAllowedToRunWithHalf, black_set, &white_set);
+  auto IsAllowedToRunWithHalf =
+      MakePredicatorIsAllowedToRunWithHalf(op_graph, low_precision_data_type);
+  FillWhiteSet(op_graph, lists, IsAllowedToRunWithHalf, black_set, &white_set);
   VLOG(2) << "WhiteSet Before Propagate include: "
           << Container2Str<HashSet<OpNode*>, OpNode*>(white_set, OpName4Node);
-  PropagateWhiteThroughClearNodes(op_graph, IsAllowedToRunWithHalf, black_set, &white_set);
+  PropagateWhiteThroughClearNodes(op_graph, lists, IsAllowedToRunWithHalf, black_set,
+                                  &white_set);
   VLOG(1) << "WhiteSet include: "
           << Container2Str<HashSet<OpNode*>, OpNode*>(white_set, OpName4Node);
 
-  InsertCastOp(op_graph, white_set, job_builder);
+  InsertCastOp(op_graph, low_precision_data_type, white_set, job_builder);
   return Maybe<void>::Ok();
 }
 
-void AutoMixedPrecision::FillBlackSet(const OpGraph& op_graph, HashSet<OpNode*>* black_set) const {
+void AutoMixedPrecision::FillBlackSet(const OpGraph& op_graph, const AMPLists& lists,
+                                      HashSet<OpNode*>* black_set) const {
   HashSet<OpNode*> upstream_or_part_of_black_and_gray;
   DfsTopoGraphTraversal(
       op_graph, true,
       [&](OpNode* node) {
-        return IsNodeInList(black_list_, node) || IsNodeInList(gray_list_, node);
+        return IsNodeInList(lists.black_list, node) || IsNodeInList(lists.gray_list, node);
       },
-      [&](OpNode* node) { return IsNodeInList(clear_list_, node); },
+      [&](OpNode* node) { return IsNodeInList(lists.clear_list, node); },
       [&](OpNode* node) { return IsKeyFound(upstream_or_part_of_black_and_gray, node); },
       [&](OpNode* node) {
         INSERT_CHECK(upstream_or_part_of_black_and_gray.insert(node));
@@ -241,7 +275,7 @@ void AutoMixedPrecision::FillBlackSet(const OpGraph& op_graph, HashSet<OpNode*>*
 
   // propagate black through upstream_or_part_of_black_and_gray
   DfsTopoGraphTraversal(
-      op_graph, false, [&](OpNode* node) { return IsNodeInList(black_list_, node); },
+      op_graph, false, [&](OpNode* node) { return IsNodeInList(lists.black_list, node); },
       [&](OpNode* node) { return IsKeyFound(upstream_or_part_of_black_and_gray, node); },
       [&](OpNode* node) { return IsKeyFound(*black_set, node); },
       [&](OpNode* node) {
@@ -250,19 +284,19 @@ void AutoMixedPrecision::FillBlackSet(const OpGraph& op_graph, HashSet<OpNode*>*
       });
 }
 
-void AutoMixedPrecision::FillWhiteSet(const OpGraph& op_graph,
+void AutoMixedPrecision::FillWhiteSet(const OpGraph& op_graph, const AMPLists& lists,
                                       std::function<bool(OpNode*)> IsAllowedToRunWithHalf,
                                       const HashSet<OpNode*>& black_set,
                                       HashSet<OpNode*>* white_set) const {
   HashSet<OpNode*> upstream_or_part_of_white;
   auto IsWhiteAndAllowedToRunHalf = [&](OpNode* node) {
-    return IsAllowedToRunWithHalf(node) && IsNodeInList(white_list_, node);
+    return IsAllowedToRunWithHalf(node) && IsNodeInList(lists.white_list, node);
   };
   DfsTopoGraphTraversal(
       op_graph, true, IsWhiteAndAllowedToRunHalf,
       [&](OpNode* node) {
         return !IsKeyFound(black_set, node) && IsAllowedToRunWithHalf(node)
-               && (IsNodeInList(gray_list_, node) || IsNodeInList(clear_list_, node));
+               && (IsNodeInList(lists.gray_list, node) || IsNodeInList(lists.clear_list, node));
       },
       [&](OpNode* node) { return IsKeyFound(upstream_or_part_of_white, node); },
       [&](OpNode* node) {
@@ -282,14 +316,15 @@ void AutoMixedPrecision::FillWhiteSet(const OpGraph& op_graph,
 }
 
 void AutoMixedPrecision::PropagateWhiteThroughClearNodes(
-    const OpGraph& op_graph, std::function<bool(OpNode*)> IsAllowedToRunWithHalf,
+    const OpGraph& op_graph, const AMPLists& lists,
+    std::function<bool(OpNode*)> IsAllowedToRunWithHalf,
     const HashSet<OpNode*>& black_set, HashSet<OpNode*>* white_set) const {
   auto PropagateIntoOneDirection = [&](bool is_downward) {
     DfsTopoGraphTraversal(
         op_graph, !is_downward, [&](OpNode* node) { return false; },
         [&](OpNode* node) {
           return !IsKeyFound(*white_set, node) && !IsKeyFound(black_set, node)
-                 && IsNodeInList(clear_list_, node) && IsAllowedToRunWithHalf(node);
+                 && IsNodeInList(lists.clear_list, node) && IsAllowedToRunWithHalf(node);
         },
         [&](OpNode* node) { return IsKeyFound(*white_set, node); },
         [&](OpNode* node) {
@@ -302,10 +337,11 @@ void AutoMixedPrecision::PropagateWhiteThroughClearNodes(
   PropagateIntoOneDirection(false);
 }
 
-void AutoMixedPrecision::InsertCastOp(const OpGraph& op_graph, const HashSet<OpNode*>& white_set,
+void AutoMixedPrecision::InsertCastOp(const OpGraph& op_graph, DataType low_precision_data_type,
+                                      const HashSet<OpNode*>& white_set,
                                       JobBuilder* job_builder) const {
-  InsertCastOpImpl(true, op_graph, white_set, job_builder);
-  InsertCastOpImpl(false, op_graph, white_set, job_builder);
+  InsertCastOpImpl(true, low_precision_data_type, op_graph, white_set, job_builder);
+  InsertCastOpImpl(false, low_precision_data_type, op_graph, white_set, job_builder);
 }
 
 REGISTER_JOB_PASS("AutoMixedPrecision", AutoMixedPrecision);
@@ -342,5 +378,3 @@ REGISTER_NO_CAST_REGISTRY("normalization_add_relu", "beta", 0)
 }  // namespace
 
 }  // namespace oneflow
-
-#endif  // WITH_CUDA
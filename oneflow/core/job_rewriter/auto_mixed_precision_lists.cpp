@@ -93,4 +93,28 @@ const AMPList& AutoMixedPrecisionLists::ClearList() {
   return clear_list;
 }
 
+const AMPList& AutoMixedPrecisionLists::BFloat16WhiteList() {
+  static AMPList white_list = {"matmul", "batch_matmul", "broadcast_matmul", "amp_white_identity"};
+  return white_list;
+}
+
+const AMPList& AutoMixedPrecisionLists::BFloat16GrayList() {
+  static AMPList gray_list = {"add_n",      "bias_add",   "multiply",
+                              "scalar_mul", "scalar_add", "gelu"};
+  return gray_list;
+}
+
+const AMPList& AutoMixedPrecisionLists::BFloat16ClearList() {
+  static AMPList clear_list = {"reshape",
+                               "relu",
+                               "identity",
+                               "flatten",
+                               "squeeze",
+                               "expand_dims",
+                               "cast_to_static_shape",
+                               "parallel_cast",
+                               "hierarchical_parallel_cast"};
+  return clear_list;
+}
+
 }  // namespace oneflow
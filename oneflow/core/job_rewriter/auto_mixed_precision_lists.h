@@ -30,6 +30,11 @@ class AutoMixedPrecisionLists final {
   static const AMPList& BlackList();
   static const AMPList& GrayList();
   static const AMPList& ClearList();
+
+  // ops of the bfloat16 mode, restricted to the ops with bfloat16 cpu kernels
+  static const AMPList& BFloat16WhiteList();
+  static const AMPList& BFloat16GrayList();
+  static const AMPList& BFloat16ClearList();
 };
 
 }  // namespace oneflow
@@ -37,12 +37,15 @@ class CheckpointingPass final : public JobPass {
     if (!IsEnabled(*ctx)) { return Maybe<void>::Ok(); }
     const OpGraph op_graph(*job);
     JobBuilder job_builder(job);
-    return Apply(op_graph, &job_builder);
+    return Apply(op_graph, &job_builder, ctx->job_desc().recomputation_memory_budget());
   }
 
   bool IsEnabled(const JobPassCtx& ctx) const { return ctx.job_desc().IsTrain(); }
 
-  Maybe<void> Apply(const OpGraph& op_graph, JobBuilder* job_builder) const;
+  // Ops in checkpointing scopes are always recomputed. If `memory_budget` is positive, more
+  // forward ops are picked until the activations kept for backward pass fit the budget.
+  Maybe<void> Apply(const OpGraph& op_graph, JobBuilder* job_builder,
+                    int64_t memory_budget) const;
 };
 
 const std::string kCheckpointingFakeOpNamePrefix = "OneFlow-System-Checkpointing-Fake-Fw-Op_";
@@ -121,10 +124,217 @@ void GenConnectedCheckpointingSubgraphs(
   }
 }
 
-Maybe<void> CheckpointingPass::Apply(const OpGraph& op_graph, JobBuilder* job_builder) const {
+// Returns the bytes of blob `bn_in_op` of `op_node` held by each device of its placement.
+int64_t DeviceByteSize4BnInOp(const OpNode* op_node, const std::string& bn_in_op) {
+  const LogicalBlobId& lbi = op_node->op().BnInOp2Lbi(bn_in_op);
+  int64_t byte_size = op_node->LogicalBlobDesc4Lbi(lbi).ByteSizeOfBlobBody();
+  const ParallelDistribution& parallel_distribution =
+      op_node->ParallelDistribution4BnInOp(bn_in_op);
+  const Shape& hierarchy = *op_node->parallel_desc().hierarchy();
+  FOR_RANGE(int64_t, i, 0, parallel_distribution.sbp_parallel_size()) {
+    if (parallel_distribution.sbp_parallel(i).has_split_parallel()) {
+      byte_size = RoundUp(byte_size, hierarchy.At(i)) / hierarchy.At(i);
+    }
+  }
+  return byte_size;
+}
+
+// Estimates the logical FLOPs spent on recomputing `op_node` in backward pass. Ops other than
+// matmul and conv are memory bound, so they cost as many FLOPs as the elements they touch.
+double RecomputationCost4OpNode(const OpNode* op_node) {
+  const Operator& op = op_node->op();
+  const auto ElemCnt4BnInOp = [&](const std::string& bn_in_op) -> double {
+    return op_node->LogicalBlobDesc4Lbi(op.BnInOp2Lbi(bn_in_op)).shape().elem_cnt();
+  };
+  const user_op::UserOpConfWrapper user_op_conf(op.op_conf());
+  const std::string& op_type_name = user_op_conf.op_type_name();
+  if (op_type_name == "matmul" || op_type_name == "batch_matmul"
+      || op_type_name == "broadcast_matmul") {
+    const Shape& a_shape =
+        op_node->LogicalBlobDesc4Lbi(op.BnInOp2Lbi(GenRepeatedBn("a", 0))).shape();
+    const int64_t k = user_op_conf.attr<bool>("transpose_a") ? a_shape.At(a_shape.NumAxes() - 2)
+                                                             : a_shape.At(a_shape.NumAxes() - 1);
+    return 2.0 * ElemCnt4BnInOp(GenRepeatedBn("out", 0)) * k;
+  }
+  if (op_type_name == "conv1d" || op_type_name == "conv2d" || op_type_name == "conv3d") {
+    const Shape& weight_shape =
+        op_node->LogicalBlobDesc4Lbi(op.BnInOp2Lbi(GenRepeatedBn("weight", 0))).shape();
+    return 2.0 * ElemCnt4BnInOp(GenRepeatedBn("out", 0)) * weight_shape.Count(1);
+  }
+  double cost = 0;
+  for (const std::string& ibn : op.input_bns()) { cost += ElemCnt4BnInOp(ibn); }
+  for (const std::string& obn : op.output_bns()) { cost += ElemCnt4BnInOp(obn); }
+  return cost;
+}
+
+bool IsRecomputable(const OpNode* op_node) {
+  // NOTE: random ops would generate different values when recomputed.
+  static const HashSet<std::string> ignore_op_type_names = {
+      "normalization", "normalization_add_relu", "cudnn_fused_normalization_add_relu", "repeat",
+      "unpack", "random_mask_like"};
+  const OperatorConf& op_conf = op_node->op().op_conf();
+  if (!op_conf.has_user_conf()) { return false; }
+  if (ignore_op_type_names.find(op_conf.user_conf().op_type_name())
+      != ignore_op_type_names.end()) {
+    return false;
+  }
+  return !op_node->op().input_bns().empty() && !op_node->op().output_bns().empty();
+}
+
+// Picks forward ops whose outputs are dropped after forward pass and recomputed in backward
+// pass, so that the activations each device keeps for backward pass fit `budget` bytes.
+//
+// A forward blob is kept for backward pass if it is consumed by a backward op or by the
+// recomputation of a dropped op. Dropping an op releases its outputs but keeps its inputs, so
+// ops are dropped greedily by the most released bytes per FLOP of recomputation, until every
+// placement fits the budget or no op releases memory anymore. Ops already in
+// `checkpointing_op_name2op_node` are dropped from the start.
+void SelectRecomputationOpsByMemoryBudget(
+    const OpGraph& op_graph, int64_t budget,
+    HashMap<std::string, const OpNode*>* checkpointing_op_name2op_node) {
+  struct BlobInfo {
+    const OpNode* producer;
+    int64_t byte_size;
+    bool is_consumed_by_bw;
+    int64_t dropped_consumer_cnt;
+  };
+  HashMap<LogicalBlobId, BlobInfo> lbi2blob_info;
+  HashMap<const OpNode*, bool> fw_op_node2is_dropped;
+  op_graph.ForEachNode([&](const OpNode* op_node) {
+    if (!IsForwardPassScope(Scope4OpNode(op_node))) { return; }
+    const bool is_dropped = checkpointing_op_name2op_node->find(op_node->op().op_name())
+                            != checkpointing_op_name2op_node->end();
+    fw_op_node2is_dropped.emplace(op_node, is_dropped);
+    // variables are persistent and never counted as activations
+    if (op_node->op().op_conf().has_variable_conf()) { return; }
+    for (const std::string& obn : op_node->op().output_bns()) {
+      lbi2blob_info.emplace(op_node->op().BnInOp2Lbi(obn),
+                            BlobInfo{op_node, DeviceByteSize4BnInOp(op_node, obn), false, 0});
+    }
+  });
+  op_graph.ForEachNode([&](const OpNode* op_node) {
+    const auto& it = fw_op_node2is_dropped.find(op_node);
+    const bool is_bw = it == fw_op_node2is_dropped.end();
+    if (!is_bw && !it->second) { return; }
+    for (const std::string& ibn : op_node->op().input_bns()) {
+      const auto& blob_it = lbi2blob_info.find(op_node->op().BnInOp2Lbi(ibn));
+      if (blob_it == lbi2blob_info.end()) { continue; }
+      if (is_bw) {
+        blob_it->second.is_consumed_by_bw = true;
+      } else {
+        blob_it->second.dropped_consumer_cnt += 1;
+      }
+    }
+  });
+  const auto IsKept = [&](const BlobInfo& info) {
+    return !fw_op_node2is_dropped.at(info.producer)
+           && (info.is_consumed_by_bw || info.dropped_consumer_cnt > 0);
+  };
+  HashMap<ParallelDesc, int64_t> parallel_desc2kept_bytes;
+  for (const auto& pair : lbi2blob_info) {
+    if (IsKept(pair.second)) {
+      parallel_desc2kept_bytes[pair.second.producer->parallel_desc()] += pair.second.byte_size;
+    }
+  }
+  HashMap<ParallelDesc, int64_t> parallel_desc2origin_kept_bytes = parallel_desc2kept_bytes;
+
+  // Returns the kept bytes released by dropping `op_node`, which may be negative.
+  const auto ReleasedBytes4OpNode = [&](const OpNode* op_node) {
+    int64_t released_bytes = 0;
+    for (const std::string& obn : op_node->op().output_bns()) {
+      const BlobInfo& info = lbi2blob_info.at(op_node->op().BnInOp2Lbi(obn));
+      if (IsKept(info)) { released_bytes += info.byte_size; }
+    }
+    HashSet<LogicalBlobId> input_lbis;
+    for (const std::string& ibn : op_node->op().input_bns()) {
+      const LogicalBlobId& lbi = op_node->op().BnInOp2Lbi(ibn);
+      const auto& blob_it = lbi2blob_info.find(lbi);
+      if (blob_it == lbi2blob_info.end() || !input_lbis.insert(lbi).second) { continue; }
+      const BlobInfo& info = blob_it->second;
+      if (!fw_op_node2is_dropped.at(info.producer) && !IsKept(info)) {
+        released_bytes -= info.byte_size;
+      }
+    }
+    return released_bytes;
+  };
+  const auto Drop = [&](const OpNode* op_node) {
+    for (const std::string& obn : op_node->op().output_bns()) {
+      LogicalBlobId lbi = op_node->op().BnInOp2Lbi(obn);
+      BlobInfo* info = &lbi2blob_info.at(lbi);
+      if (IsKept(*info)) { parallel_desc2kept_bytes[op_node->parallel_desc()] -= info->byte_size; }
+    }
+    HashSet<LogicalBlobId> input_lbis;
+    for (const std::string& ibn : op_node->op().input_bns()) {
+      const LogicalBlobId& lbi = op_node->op().BnInOp2Lbi(ibn);
+      const auto& blob_it = lbi2blob_info.find(lbi);
+      if (blob_it == lbi2blob_info.end() || !input_lbis.insert(lbi).second) { continue; }
+      BlobInfo* info = &blob_it->second;
+      if (!fw_op_node2is_dropped.at(info->producer) && !IsKept(*info)) {
+        parallel_desc2kept_bytes[info->producer->parallel_desc()] += info->byte_size;
+      }
+      info->dropped_consumer_cnt += 1;
+    }
+    fw_op_node2is_dropped.at(op_node) = true;
+    CHECK(checkpointing_op_name2op_node->emplace(op_node->op().op_name(), op_node).second);
+  };
+  const auto IsOverBudget = [&](const ParallelDesc& parallel_desc) {
+    return parallel_desc2kept_bytes[parallel_desc] > budget;
+  };
+
+  // lazy greedy: a popped candidate is re-scored and pushed back if its score dropped
+  using Score7OpNode = std::pair<double, const OpNode*>;
+  std::priority_queue<Score7OpNode> candidates;
+  HashMap<const OpNode*, double> op_node2cost;
+  const auto Score4OpNode = [&](const OpNode* op_node) {
+    return ReleasedBytes4OpNode(op_node) / std::max(op_node2cost.at(op_node), 1.0);
+  };
+  for (const auto& pair : fw_op_node2is_dropped) {
+    if (pair.second || !IsRecomputable(pair.first)) { continue; }
+    if (!IsOverBudget(pair.first->parallel_desc())) { continue; }
+    op_node2cost.emplace(pair.first, RecomputationCost4OpNode(pair.first));
+    candidates.push(std::make_pair(Score4OpNode(pair.first), pair.first));
+  }
+  HashMap<ParallelDesc, double> parallel_desc2recomputation_cost;
+  HashMap<ParallelDesc, int64_t> parallel_desc2dropped_op_cnt;
+  while (!candidates.empty()) {
+    const Score7OpNode top = candidates.top();
+    candidates.pop();
+    const OpNode* op_node = top.second;
+    if (!IsOverBudget(op_node->parallel_desc())) { continue; }
+    const double score = Score4OpNode(op_node);
+    if (score <= 0) { continue; }
+    if (score < top.first && !candidates.empty() && score < candidates.top().first) {
+      candidates.push(std::make_pair(score, op_node));
+      continue;
+    }
+    Drop(op_node);
+    parallel_desc2recomputation_cost[op_node->parallel_desc()] += op_node2cost.at(op_node);
+    parallel_desc2dropped_op_cnt[op_node->parallel_desc()] += 1;
+  }
+
+  for (const auto& pair : parallel_desc2kept_bytes) {
+    const ParallelDesc& parallel_desc = pair.first;
+    LOG(INFO) << "CheckpointingPass: placement " << parallel_desc.parallel_conf().ShortDebugString()
+              << " keeps " << parallel_desc2origin_kept_bytes[parallel_desc] << " -> "
+              << pair.second << " bytes of activations per device for backward pass, budget "
+              << budget << ", recomputing " << parallel_desc2dropped_op_cnt[parallel_desc]
+              << " more ops with " << parallel_desc2recomputation_cost[parallel_desc]
+              << " logical FLOPs";
+    if (pair.second > budget) {
+      LOG(WARNING) << "CheckpointingPass: activations kept for backward pass exceed "
+                   << "recomputation_memory_budget even if all recomputable ops are dropped";
+    }
+  }
+}
+
+Maybe<void> CheckpointingPass::Apply(const OpGraph& op_graph, JobBuilder* job_builder,
+                                     int64_t memory_budget) const {
   // step 1. collect all checkpointing ops in forwardpass.
   HashMap<std::string, const OpNode*> checkpointing_op_name2op_node;
   CollectAllCheckpointingOpsInForwardPass(op_graph, &checkpointing_op_name2op_node);
+  if (memory_budget > 0) {
+    SelectRecomputationOpsByMemoryBudget(op_graph, memory_budget, &checkpointing_op_name2op_node);
+  }
   if (checkpointing_op_name2op_node.empty()) { return Maybe<void>::Ok(); }
 
   // step 2. get all connected subgraphs in checkpointing ops.
@@ -157,6 +367,15 @@ Maybe<void> CheckpointingPass::Apply(const OpGraph& op_graph, JobBuilder* job_bu
       });
     }
     if (bw_consumers.empty()) { continue; }
+    if (memory_budget > 0) {
+      const auto IsEarlier = [&](const OpNode* lhs, const OpNode* rhs) {
+        return op_node2order.at(lhs) < op_node2order.at(rhs);
+      };
+      const OpNode* first = *std::min_element(subgraph.begin(), subgraph.end(), IsEarlier);
+      const OpNode* last = *std::max_element(subgraph.begin(), subgraph.end(), IsEarlier);
+      LOG(INFO) << "CheckpointingPass: recompute segment of " << subgraph.size() << " ops from "
+                << first->op().op_name() << " to " << last->op().op_name();
+    }
 
     HashMap<std::string, const OpNode*> subgraph_op_name2op_node;
     ParallelConf parallel_conf;
@@ -0,0 +1,198 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/job_rewriter/job_pass.h"
+#include "oneflow/core/framework/framework.h"
+#include "oneflow/user/kernels/elementwise_unary_chain_kernel.h"
+
+namespace oneflow {
+
+namespace {
+
+std::function<bool(const OpNode* op_node)> MakePredicatorIsFusible(const OpGraph& op_graph) {
+  HashSet<std::string> ctrl_in_op_names;
+  op_graph.ForEachNode([&](const OpNode* op_node) {
+    for (const std::string& ctrl_in_op_name : op_node->op().op_conf().ctrl_in_op_name()) {
+      ctrl_in_op_names.insert(ctrl_in_op_name);
+    }
+  });
+  return [=](const OpNode* op_node) {
+    const OperatorConf& op_conf = op_node->op().op_conf();
+    if (!op_conf.has_user_conf()) { return false; }
+    if (!IsElementwiseUnaryChainFusible(op_conf.user_conf().op_type_name())) { return false; }
+    if (op_node->parallel_desc().device_type() != DeviceType::kCPU) { return false; }
+    if (op_node->op().input_bns().size() != 1 || op_node->op().output_bns().size() != 1) {
+      return false;
+    }
+    if (!op_conf.ctrl_in_op_name().empty()) { return false; }
+    if (ctrl_in_op_names.find(op_conf.name()) != ctrl_in_op_names.end()) { return false; }
+    const LogicalBlobId& in_lbi = op_node->op().BnInOp2Lbi(op_node->op().SoleIbn());
+    const LogicalBlobId& out_lbi = op_node->op().BnInOp2Lbi(op_node->op().SoleObn());
+    const DataType data_type = op_node->LogicalBlobDesc4Lbi(out_lbi).data_type();
+    if (data_type != DataType::kFloat && data_type != DataType::kDouble) { return false; }
+    return op_node->LogicalBlobDesc4Lbi(in_lbi).data_type() == data_type;
+  };
+}
+
+double GetScalarOperand(const user_op::UserOpConfWrapper& user_op_conf) {
+  if (user_op_conf.op_type_name() != "scalar_add" && user_op_conf.op_type_name() != "scalar_mul") {
+    return 0;
+  }
+  if (user_op_conf.attr<bool>("has_int_operand")) {
+    return static_cast<double>(user_op_conf.attr<int64_t>("int_operand"));
+  } else if (user_op_conf.attr<bool>("has_float_operand")) {
+    return user_op_conf.attr<double>("float_operand");
+  } else {
+    UNIMPLEMENTED();
+  }
+}
+
+class FuseElementwiseChainPass final : public JobPass {
+ public:
+  FuseElementwiseChainPass() = default;
+  ~FuseElementwiseChainPass() override = default;
+
+  bool IsEnabled(const JobPassCtx& ctx) const {
+    // elementwise_unary_chain has no grad, so training jobs are left unfused
+    return ctx.job_desc().job_conf().enable_fuse_elementwise_chain() && !ctx.job_desc().IsTrain();
+  }
+  Maybe<void> Apply(const OpGraph& op_graph, JobBuilder* job_builder) const;
+
+  Maybe<void> Apply(Job* job, JobPassCtx* ctx) const override {
+    if (!IsEnabled(*ctx)) { return Maybe<void>::Ok(); }
+    const OpGraph op_graph(*job);
+    JobBuilder job_builder(job);
+    return Apply(op_graph, &job_builder);
+  }
+};
+
+Maybe<void> FuseElementwiseChainPass::Apply(const OpGraph& op_graph,
+                                            JobBuilder* job_builder) const {
+  const auto IsFusible = MakePredicatorIsFusible(op_graph);
+  // Returns the node fused right after `op_node`, or nullptr if the chain ends at `op_node`.
+  // The output of every op in a chain but the last one is consumed by its successor only, on
+  // the same placement and without boxing.
+  const auto GetNextInChain = [&](const OpNode* op_node) -> const OpNode* {
+    if (op_node->out_edges().size() != 1) { return nullptr; }
+    const OpEdge* out_edge = op_node->SoleOutEdge();
+    if (out_edge->lbis().size() != 1) { return nullptr; }
+    const OpNode* dst_node = out_edge->dst_node();
+    if (!IsFusible(dst_node)) { return nullptr; }
+    if (!(dst_node->parallel_desc() == op_node->parallel_desc())) { return nullptr; }
+    if (dst_node->ParallelDistribution4BnInOp(dst_node->op().SoleIbn())
+        != op_node->ParallelDistribution4BnInOp(op_node->op().SoleObn())) {
+      return nullptr;
+    }
+    return dst_node;
+  };
+  std::vector<std::vector<const OpNode*>> chains;
+  op_graph.TopoForEachNode([&](const OpNode* op_node) {
+    if (!IsFusible(op_node)) { return; }
+    if (op_node->in_edges().size() == 1) {
+      const OpNode* src_node = op_node->SoleInEdge()->src_node();
+      if (IsFusible(src_node) && GetNextInChain(src_node) == op_node) { return; }
+    }
+    std::vector<const OpNode*> chain;
+    for (const OpNode* node = op_node; node != nullptr; node = GetNextInChain(node)) {
+      chain.push_back(node);
+    }
+    if (chain.size() > 1) { chains.push_back(std::move(chain)); }
+  });
+  if (chains.empty()) { return Maybe<void>::Ok(); }
+
+  HashSet<std::string> fused_op_names;
+  HashMap<std::string, std::string> tail_lbn2fused_lbn;
+  for (const auto& chain : chains) {
+    for (const OpNode* op_node : chain) { fused_op_names.insert(op_node->op().op_name()); }
+    const OpNode* tail = chain.back();
+    const std::string fused_op_name = tail->op().op_name() + "-fused_elementwise_chain";
+    tail_lbn2fused_lbn[GenLogicalBlobName(tail->op().BnInOp2Lbi(tail->op().SoleObn()))] =
+        fused_op_name + "/y_0";
+  }
+  const auto FusedLbn4Lbn = [&](const std::string& lbn) -> std::string {
+    const auto& iter = tail_lbn2fused_lbn.find(lbn);
+    return iter == tail_lbn2fused_lbn.end() ? lbn : iter->second;
+  };
+
+  int64_t removed_intermediate_bytes = 0;
+  std::vector<std::string> del_op_names;
+  for (const auto& chain : chains) {
+    const OpNode* head = chain.front();
+    const OpNode* tail = chain.back();
+    std::vector<std::string> op_type_names;
+    std::vector<float> scalars;
+    for (const OpNode* op_node : chain) {
+      const user_op::UserOpConfWrapper user_op_conf(op_node->op().op_conf());
+      op_type_names.push_back(user_op_conf.op_type_name());
+      scalars.push_back(static_cast<float>(GetScalarOperand(user_op_conf)));
+      if (op_node != tail) {
+        const LogicalBlobId& out_lbi = op_node->op().BnInOp2Lbi(op_node->op().SoleObn());
+        removed_intermediate_bytes += op_node->LogicalBlobDesc4Lbi(out_lbi).ByteSizeOfBlobBody();
+      }
+      del_op_names.push_back(op_node->op().op_name());
+    }
+    const std::string in_lbn =
+        FusedLbn4Lbn(GenLogicalBlobName(head->op().BnInOp2Lbi(head->op().SoleIbn())));
+    const std::string tail_lbn = GenLogicalBlobName(tail->op().BnInOp2Lbi(tail->op().SoleObn()));
+    const std::string& fused_lbn = tail_lbn2fused_lbn.at(tail_lbn);
+    user_op::UserOpConfWrapperBuilder fused_op_builder(GenLogicalBlobId(fused_lbn).op_name());
+    fused_op_builder.OpTypeName("elementwise_unary_chain")
+        .Input("x", in_lbn)
+        .Attr<std::vector<std::string>>("op_type_names", op_type_names)
+        .Attr<std::vector<float>>("scalars", scalars)
+        .Output("y");
+    OperatorConf fused_op_conf = tail->op().op_conf();
+    fused_op_conf.set_name(GenLogicalBlobId(fused_lbn).op_name());
+    *fused_op_conf.mutable_user_conf() = fused_op_builder.Build().op_conf().user_conf();
+    job_builder->AddOps(tail->parallel_desc().parallel_conf(), {fused_op_conf});
+  }
+
+  HashMap<std::string, OperatorConf> op_name2op_conf;
+  for (const auto& chain : chains) {
+    const OpNode* tail = chain.back();
+    const LogicalBlobId& tail_lbi = tail->op().BnInOp2Lbi(tail->op().SoleObn());
+    const std::string& fused_lbn = tail_lbn2fused_lbn.at(GenLogicalBlobName(tail_lbi));
+    for (const OpEdge* out_edge : tail->out_edges()) {
+      const OpNode* consumer = out_edge->dst_node();
+      const std::string& consumer_op_name = consumer->op().op_name();
+      // heads of other chains already take their input from the fused op
+      if (fused_op_names.find(consumer_op_name) != fused_op_names.end()) { continue; }
+      if (op_name2op_conf.find(consumer_op_name) == op_name2op_conf.end()) {
+        op_name2op_conf[consumer_op_name] = consumer->op().op_conf();
+      }
+      OperatorConf& consumer_op_conf = op_name2op_conf.at(consumer_op_name);
+      for (const std::string& ibn : consumer->op().input_bns()) {
+        if (consumer->op().BnInOp2Lbi(ibn) == tail_lbi) {
+          const auto& old_val =
+              ReplaceInputLbnInOpCustomizedConf(&consumer_op_conf, ibn, fused_lbn);
+          CHECK_EQ_OR_RETURN(GenLogicalBlobName(tail_lbi), old_val);
+        }
+      }
+    }
+  }
+  for (const auto& pair : op_name2op_conf) { job_builder->MutOpsOnlyOnce({pair.second}); }
+  job_builder->DelOps(del_op_names);
+  LOG(INFO) << "FuseElementwiseChainPass: fused " << del_op_names.size() << " ops into "
+            << chains.size() << " elementwise_unary_chain ops, saving "
+            << del_op_names.size() - chains.size() << " actors and " << removed_intermediate_bytes
+            << " bytes of logical intermediate blobs";
+  return Maybe<void>::Ok();
+}
+
+}  // namespace
+
+REGISTER_JOB_PASS("FuseElementwiseChainPass", FuseElementwiseChainPass);
+
+}  // namespace oneflow
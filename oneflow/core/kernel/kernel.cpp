@@ -31,6 +31,15 @@ void Kernel::InitBase(const JobDesc* job_desc, const KernelConf& kernel_conf) {
   kernel_conf_ = kernel_conf;
   shape_infer_helper_ =
       new RuntimeBlobShapeInferHelper(this->op_conf(), this->kernel_conf(), &this->job_desc());
+  bn_in_op_vec_.clear();
+  bn_in_op2index_.clear();
+  for (const auto& pair : op_attribute().arg_signature().bn_in_op2lbi()) {
+    bn_in_op_vec_.push_back(pair.first);
+  }
+  std::sort(bn_in_op_vec_.begin(), bn_in_op_vec_.end());
+  FOR_RANGE(int64_t, i, 0, bn_in_op_vec_.size()) {
+    bn_in_op2index_.emplace(bn_in_op_vec_.at(i), i);
+  }
 }
 
 void Kernel::Init(const JobDesc* job_desc, const KernelConf& kernel_conf, DeviceCtx* device_ctx) {
@@ -43,6 +52,22 @@ void Kernel::Launch(const KernelCtx& ctx,
   Forward(ctx, BnInOp2Blob);
 }
 
+void Kernel::Launch(const KernelCtx& ctx, const std::vector<Blob*>& index2blob) const {
+  CHECK_EQ(index2blob.size(), bn_in_op_vec_.size());
+  VirtualBindBlobs(index2blob);
+  Forward(ctx, [&](const std::string& bn_in_op) -> Blob* {
+    const int64_t index = Index4BnInOp(bn_in_op);
+    if (index == -1) { return nullptr; }
+    return index2blob[index];
+  });
+}
+
+int64_t Kernel::Index4BnInOp(const std::string& bn_in_op) const {
+  const auto it = bn_in_op2index_.find(bn_in_op);
+  if (it == bn_in_op2index_.end()) { return -1; }
+  return it->second;
+}
+
 const LogicalBlobId& Kernel::BnInOp2Lbi(const std::string& bn_in_op) const {
   return op_attribute().arg_signature().bn_in_op2lbi().at(bn_in_op);
 }
@@ -42,6 +42,14 @@ class Kernel {
   void Init(const JobDesc* job_desc, const KernelConf&, DeviceCtx*);
 
   void Launch(const KernelCtx& ctx, std::function<Blob*(const std::string&)> BnInOp2Blob) const;
+  // Launches with the blobs bound to slots, index2blob.at(i) being the blob of bn_in_op_vec().at(i)
+  // or nullptr. The caller resolves the blobs once per launch instead of once per lookup.
+  void Launch(const KernelCtx& ctx, const std::vector<Blob*>& index2blob) const;
+
+  // All bns in op of the kernel, sorted; the index of a bn is its slot in a launch by index.
+  const std::vector<std::string>& bn_in_op_vec() const { return bn_in_op_vec_; }
+  // Returns -1 if `bn_in_op` is not a bn of the kernel.
+  int64_t Index4BnInOp(const std::string& bn_in_op) const;
 
   const LogicalBlobId& BnInOp2Lbi(const std::string& bn_in_op) const;
   const OperatorConf& op_conf() const { return op_attribute().op_conf(); }
@@ -76,6 +84,8 @@ class Kernel {
   void InitBase(const JobDesc* job_desc, const KernelConf&);
   virtual void VirtualKernelInit(DeviceCtx* device_ctx) { VirtualKernelInit(); }
   virtual void VirtualKernelInit() {}
+  // Called by a launch by index before Forward, for kernels that keep state per bound blob.
+  virtual void VirtualBindBlobs(const std::vector<Blob*>& index2blob) const {}
   const KernelConf& kernel_conf() const { return kernel_conf_; }
 
   template<typename HandlerT>
@@ -125,6 +135,8 @@ class Kernel {
   const JobDesc* job_desc_;
   RuntimeBlobShapeInferHelper* shape_infer_helper_;
   KernelConf kernel_conf_;
+  std::vector<std::string> bn_in_op_vec_;
+  HashMap<std::string, int64_t> bn_in_op2index_;
 };
 
 template<DeviceType device_type>
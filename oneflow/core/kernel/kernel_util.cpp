@@ -17,6 +17,7 @@ limitations under the License.
 #include "oneflow/core/common/balanced_splitter.h"
 #include "oneflow/core/register/register_manager.h"
 #include "oneflow/core/kernel/kernel.h"
+#include "oneflow/core/kernel/philox_random.h"
 #include "oneflow/core/memory/memory_case.pb.h"
 
 namespace oneflow {
@@ -25,53 +26,24 @@ namespace {
 
 template<typename T>
 void RngUniform(const int64_t elem_cnt, const T min, const T max, uint32_t random_seed, T* dptr) {
-  CHECK_GE(elem_cnt, 0);
-  CHECK(dptr);
-  CHECK_LE(min, max);
-  std::mt19937 generator(random_seed);
-  std::uniform_real_distribution<T> random_distribution(min, std::nextafter(max, GetMaxVal<T>()));
-  for (int64_t i = 0; i < elem_cnt; ++i) { dptr[i] = random_distribution(generator); }
+  PhiloxRandom(random_seed).Uniform<T>(elem_cnt, min, max, dptr);
 }
 
 template<typename T>
 void RngIntUniform(const int64_t elem_cnt, const T min, const T max, uint32_t random_seed,
                    T* dptr) {
-  CHECK_GE(elem_cnt, 0);
-  CHECK(dptr);
-  CHECK_LE(min, max);
-  std::mt19937 generator(random_seed);
-  std::uniform_int_distribution<T> random_distribution(min, std::nextafter(max, GetMaxVal<T>()));
-  for (int64_t i = 0; i < elem_cnt; ++i) { dptr[i] = random_distribution(generator); }
+  PhiloxRandom(random_seed).Uniform<T>(elem_cnt, min, max, dptr);
 }
 
 template<typename T>
 void RngNormal(const int64_t elem_cnt, const T mean, const T std, uint32_t random_seed, T* dptr) {
-  CHECK_GE(elem_cnt, 0);
-  CHECK(dptr);
-  CHECK_GT(std, 0.0);
-  std::mt19937 generator(random_seed);
-  std::normal_distribution<T> random_distribution(mean, std);
-
-  for (int64_t i = 0; i < elem_cnt; ++i) { dptr[i] = random_distribution(generator); }
+  PhiloxRandom(random_seed).Normal<T>(elem_cnt, mean, std, dptr);
 }
 
 template<typename T>
 void RngTruncatedNormal(const int64_t elem_cnt, const T mean, const T std, uint32_t random_seed,
                         T* dptr) {
-  CHECK_GE(elem_cnt, 0);
-  CHECK(dptr);
-  CHECK_GT(std, 0.0);
-  T truncated_value = 2 * std;
-  std::mt19937 generator(random_seed);
-  std::normal_distribution<T> random_distribution(mean, std);
-  int64_t index = 0;
-  while (true) {
-    T val = random_distribution(generator);
-    if (std::abs(val - mean) < truncated_value) {
-      dptr[index++] = val;
-      if (index >= elem_cnt) { break; }
-    }
-  }
+  PhiloxRandom(random_seed).TruncatedNormal<T>(elem_cnt, mean, std, dptr);
 }
 
 template<typename T>
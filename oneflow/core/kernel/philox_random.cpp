@@ -0,0 +1,321 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/philox_random.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/common/data_type.h"
+#include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include "oneflow/user/kernels/cpu_vector_math.h"
+
+namespace oneflow {
+
+namespace {
+
+constexpr uint32_t kPhiloxM0 = 0xD2511F53;
+constexpr uint32_t kPhiloxM1 = 0xCD9E8D57;
+constexpr uint32_t kPhiloxW0 = 0x9E3779B9;
+constexpr uint32_t kPhiloxW1 = 0xBB67AE85;
+constexpr int32_t kPhiloxRoundNum = 10;
+
+// fills smaller than this number of blocks stay on the calling thread
+constexpr int64_t kParallelFillMinBlockNum = 1 << 14;
+// blocks of normals whose uniforms are transformed together
+constexpr int64_t kBoxMullerBatchBlockNum = 64;
+constexpr int64_t kBoxMullerMaxPairNum = kBoxMullerBatchBlockNum * 4 / 2;
+
+// The random blocks of one fill. Block `block_id` of the fill is drawn from the counter
+// (block_id, sub, offset), `sub` telling apart the redraws of a block.
+class PhiloxStream final {
+ public:
+  PhiloxStream(uint64_t seed, uint32_t offset)
+      : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}, offset_(offset) {}
+
+  void Block(uint64_t block_id, uint32_t sub, uint32_t out[4]) const {
+    const uint32_t counter[4] = {static_cast<uint32_t>(block_id),
+                                 static_cast<uint32_t>(block_id >> 32), sub, offset_};
+    PhiloxRandom::Philox4x32(counter, key_, out);
+  }
+
+ private:
+  uint32_t key_[2];
+  uint32_t offset_;
+};
+
+// Calls Handler with [begin, end) ranges of `block_num` blocks, on the threads of
+// Global<ThreadPool> if there are enough blocks
+void ForEachBlockPart(int64_t block_num,
+                      const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  int64_t part_num = 1;
+  if (block_num >= 2 * kParallelFillMinBlockNum && Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(),
+                                 block_num / kParallelFillMinBlockNum);
+  }
+  if (part_num <= 1) {
+    Handler(0, block_num);
+    return;
+  }
+  BalancedSplitter bs(block_num, part_num);
+  MultiThreadLoop(part_num, [&](size_t part_id) {
+    const Range range = bs.At(part_id);
+    Handler(range.begin(), range.end());
+  });
+}
+
+// Uniforms of the bits of a block, in [0, 1) by Convert and in (0, 1] by ConvertNonZero
+template<typename T>
+struct PhiloxUniform;
+
+template<>
+struct PhiloxUniform<float> {
+  static constexpr int32_t kNumPerBlock = 4;
+  static void Convert(const uint32_t bits[4], float out[4]) {
+    FOR_RANGE(int32_t, i, 0, 4) { out[i] = (bits[i] >> 8) * (1.0f / 16777216.0f); }
+  }
+  static void ConvertNonZero(const uint32_t bits[4], float out[4]) {
+    FOR_RANGE(int32_t, i, 0, 4) { out[i] = ((bits[i] >> 8) + 1) * (1.0f / 16777216.0f); }
+  }
+};
+
+template<>
+struct PhiloxUniform<double> {
+  static constexpr int32_t kNumPerBlock = 2;
+  static void Convert(const uint32_t bits[4], double out[2]) {
+    FOR_RANGE(int32_t, i, 0, 2) { out[i] = Bits53(bits, i) * (1.0 / 9007199254740992.0); }
+  }
+  static void ConvertNonZero(const uint32_t bits[4], double out[2]) {
+    FOR_RANGE(int32_t, i, 0, 2) { out[i] = (Bits53(bits, i) + 1) * (1.0 / 9007199254740992.0); }
+  }
+
+ private:
+  static uint64_t Bits53(const uint32_t bits[4], int32_t i) {
+    return ((static_cast<uint64_t>(bits[2 * i]) << 32) | bits[2 * i + 1]) >> 11;
+  }
+};
+
+// Transforms `pair_num` pairs of uniforms in (0, 1] into normals in place
+template<typename T>
+void BoxMuller(int64_t pair_num, T* dptr) {
+  constexpr T kTwoPi = static_cast<T>(6.283185307179586);
+  for (int64_t i = 0; i < pair_num; ++i) {
+    const T radius = std::sqrt(static_cast<T>(-2) * std::log(dptr[2 * i]));
+    const T theta = kTwoPi * dptr[2 * i + 1];
+    dptr[2 * i] = radius * std::cos(theta);
+    dptr[2 * i + 1] = radius * std::sin(theta);
+  }
+}
+
+// Floats take log, sin and cos from cpu_vector_math over the whole batch
+template<>
+void BoxMuller<float>(int64_t pair_num, float* dptr) {
+  CHECK_LE(pair_num, kBoxMullerMaxPairNum);
+  constexpr float kTwoPi = 6.283185307179586f;
+  float radius[kBoxMullerMaxPairNum];
+  float theta[kBoxMullerMaxPairNum];
+  float sin[kBoxMullerMaxPairNum];
+  for (int64_t i = 0; i < pair_num; ++i) {
+    radius[i] = dptr[2 * i];
+    theta[i] = kTwoPi * dptr[2 * i + 1];
+  }
+  cpu_vector_math::Log(pair_num, radius, radius);
+  cpu_vector_math::Sin(pair_num, theta, sin);
+  cpu_vector_math::Cos(pair_num, theta, theta);
+  for (int64_t i = 0; i < pair_num; ++i) {
+    const float r = std::sqrt(-2.f * radius[i]);
+    dptr[2 * i] = r * theta[i];
+    dptr[2 * i + 1] = r * sin[i];
+  }
+}
+
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type UniformFill(
+    const PhiloxStream& stream, int64_t elem_cnt, T min, T max, T* dptr) {
+  constexpr int32_t kNumPerBlock = PhiloxUniform<T>::kNumPerBlock;
+  const T scale = max - min;
+  // min + u * scale rounds up to max for some u close to 1, which is taken down to the largest
+  // value below max to keep the fill in [min, max)
+  const T below_max = std::nextafter(max, min);
+  ForEachBlockPart(RoundUp(elem_cnt, kNumPerBlock) / kNumPerBlock, [&](int64_t begin,
+                                                                      int64_t end) {
+    uint32_t bits[4];
+    T uniforms[kNumPerBlock];
+    FOR_RANGE(int64_t, block_id, begin, end) {
+      stream.Block(block_id, 0, bits);
+      PhiloxUniform<T>::Convert(bits, uniforms);
+      const int64_t offset = block_id * kNumPerBlock;
+      const int64_t num = std::min<int64_t>(kNumPerBlock, elem_cnt - offset);
+      FOR_RANGE(int64_t, i, 0, num) {
+        dptr[offset + i] = std::min(min + uniforms[i] * scale, below_max);
+      }
+    }
+  });
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value>::type UniformFill(const PhiloxStream& stream,
+                                                                      int64_t elem_cnt, T min,
+                                                                      T max, T* dptr) {
+  // zero when [min, max] covers all 64-bit values
+  const uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+  ForEachBlockPart(RoundUp(elem_cnt, 2) / 2, [&](int64_t begin, int64_t end) {
+    uint32_t bits[4];
+    FOR_RANGE(int64_t, block_id, begin, end) {
+      stream.Block(block_id, 0, bits);
+      const int64_t offset = block_id * 2;
+      const int64_t num = std::min<int64_t>(2, elem_cnt - offset);
+      FOR_RANGE(int64_t, i, 0, num) {
+        const uint64_t x = (static_cast<uint64_t>(bits[2 * i]) << 32) | bits[2 * i + 1];
+        dptr[offset + i] = static_cast<T>(static_cast<uint64_t>(min) + (range ? x % range : x));
+      }
+    }
+  });
+}
+
+}  // namespace
+
+void PhiloxRandom::Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+  uint32_t ctr[4] = {counter[0], counter[1], counter[2], counter[3]};
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  FOR_RANGE(int32_t, round, 0, kPhiloxRoundNum) {
+    const uint64_t prod0 = static_cast<uint64_t>(kPhiloxM0) * ctr[0];
+    const uint64_t prod1 = static_cast<uint64_t>(kPhiloxM1) * ctr[2];
+    const uint32_t next[4] = {static_cast<uint32_t>(prod1 >> 32) ^ ctr[1] ^ k0,
+                              static_cast<uint32_t>(prod1),
+                              static_cast<uint32_t>(prod0 >> 32) ^ ctr[3] ^ k1,
+                              static_cast<uint32_t>(prod0)};
+    FOR_RANGE(int32_t, i, 0, 4) { ctr[i] = next[i]; }
+    k0 += kPhiloxW0;
+    k1 += kPhiloxW1;
+  }
+  FOR_RANGE(int32_t, i, 0, 4) { out[i] = ctr[i]; }
+}
+
+template<typename T>
+void PhiloxRandom::Uniform(int64_t elem_cnt, T min, T max, T* dptr) {
+  CHECK_GE(elem_cnt, 0);
+  CHECK(dptr);
+  CHECK_LE(min, max);
+  UniformFill<T>(PhiloxStream(seed_, NextOffset()), elem_cnt, min, max, dptr);
+}
+
+template<typename T>
+void PhiloxRandom::Normal(int64_t elem_cnt, T mean, T std, T* dptr) {
+  CHECK_GE(elem_cnt, 0);
+  CHECK(dptr);
+  CHECK_GT(std, 0.0);
+  constexpr int32_t kNumPerBlock = PhiloxUniform<T>::kNumPerBlock;
+  const PhiloxStream stream(seed_, NextOffset());
+  ForEachBlockPart(RoundUp(elem_cnt, kNumPerBlock) / kNumPerBlock, [&](int64_t begin,
+                                                                      int64_t end) {
+    uint32_t bits[4];
+    T normals[kBoxMullerBatchBlockNum * kNumPerBlock];
+    for (int64_t batch_begin = begin; batch_begin < end; batch_begin += kBoxMullerBatchBlockNum) {
+      const int64_t batch_end = std::min(batch_begin + kBoxMullerBatchBlockNum, end);
+      FOR_RANGE(int64_t, block_id, batch_begin, batch_end) {
+        stream.Block(block_id, 0, bits);
+        PhiloxUniform<T>::ConvertNonZero(bits, normals + (block_id - batch_begin) * kNumPerBlock);
+      }
+      BoxMuller<T>((batch_end - batch_begin) * kNumPerBlock / 2, normals);
+      const int64_t offset = batch_begin * kNumPerBlock;
+      const int64_t num = std::min<int64_t>((batch_end - batch_begin) * kNumPerBlock,
+                                            elem_cnt - offset);
+      FOR_RANGE(int64_t, i, 0, num) { dptr[offset + i] = mean + normals[i] * std; }
+    }
+  });
+}
+
+template<typename T>
+void PhiloxRandom::TruncatedNormal(int64_t elem_cnt, T mean, T std, T* dptr) {
+  CHECK_GE(elem_cnt, 0);
+  CHECK(dptr);
+  CHECK_GT(std, 0.0);
+  constexpr int32_t kNumPerBlock = PhiloxUniform<T>::kNumPerBlock;
+  const PhiloxStream stream(seed_, NextOffset());
+  // element i redraws block i until one of its normals is within two stds
+  ForEachBlockPart(elem_cnt, [&](int64_t begin, int64_t end) {
+    uint32_t bits[4];
+    T normals[kNumPerBlock];
+    FOR_RANGE(int64_t, i, begin, end) {
+      bool is_done = false;
+      for (uint32_t sub = 0; !is_done; ++sub) {
+        stream.Block(i, sub, bits);
+        PhiloxUniform<T>::ConvertNonZero(bits, normals);
+        BoxMuller<T>(kNumPerBlock / 2, normals);
+        FOR_RANGE(int32_t, j, 0, kNumPerBlock) {
+          if (std::abs(normals[j]) < static_cast<T>(2)) {
+            dptr[i] = mean + normals[j] * std;
+            is_done = true;
+            break;
+          }
+        }
+      }
+    }
+  });
+}
+
+template<typename T, typename K>
+void PhiloxRandom::Bernoulli(int64_t elem_cnt, const T* prob, K* out) {
+  CHECK_GE(elem_cnt, 0);
+  const PhiloxStream stream(seed_, NextOffset());
+  ForEachBlockPart(RoundUp(elem_cnt, 2) / 2, [&](int64_t begin, int64_t end) {
+    uint32_t bits[4];
+    double uniforms[2];
+    FOR_RANGE(int64_t, block_id, begin, end) {
+      stream.Block(block_id, 0, bits);
+      PhiloxUniform<double>::Convert(bits, uniforms);
+      const int64_t offset = block_id * 2;
+      const int64_t num = std::min<int64_t>(2, elem_cnt - offset);
+      FOR_RANGE(int64_t, i, 0, num) {
+        const double p = static_cast<double>(prob[offset + i]);
+        CHECK(p >= 0.0 && p <= 1.0);
+        out[offset + i] = uniforms[i] < p ? GetOneVal<K>() : GetZeroVal<K>();
+      }
+    }
+  });
+}
+
+void PhiloxRandom::Mask(int64_t elem_cnt, float rate, int8_t* mask) {
+  CHECK_GE(elem_cnt, 0);
+  const PhiloxStream stream(seed_, NextOffset());
+  ForEachBlockPart(RoundUp(elem_cnt, 4) / 4, [&](int64_t begin, int64_t end) {
+    uint32_t bits[4];
+    float uniforms[4];
+    FOR_RANGE(int64_t, block_id, begin, end) {
+      stream.Block(block_id, 0, bits);
+      PhiloxUniform<float>::Convert(bits, uniforms);
+      const int64_t offset = block_id * 4;
+      const int64_t num = std::min<int64_t>(4, elem_cnt - offset);
+      FOR_RANGE(int64_t, i, 0, num) { mask[offset + i] = uniforms[i] > rate; }
+    }
+  });
+}
+
+#define INSTANTIATE_PHILOX_RANDOM_UNIFORM(T, typeproto) \
+  template void PhiloxRandom::Uniform<T>(int64_t elem_cnt, T min, T max, T * dptr);
+OF_PP_FOR_EACH_TUPLE(INSTANTIATE_PHILOX_RANDOM_UNIFORM, ARITHMETIC_DATA_TYPE_SEQ);
+
+#define INSTANTIATE_PHILOX_RANDOM_NORMAL(T, typeproto)                                   \
+  template void PhiloxRandom::Normal<T>(int64_t elem_cnt, T mean, T std, T * dptr);    \
+  template void PhiloxRandom::TruncatedNormal<T>(int64_t elem_cnt, T mean, T std, T * dptr);
+OF_PP_FOR_EACH_TUPLE(INSTANTIATE_PHILOX_RANDOM_NORMAL, FLOATING_DATA_TYPE_SEQ);
+
+#define INSTANTIATE_PHILOX_RANDOM_BERNOULLI(T_pair, K_pair)                                   \
+  template void PhiloxRandom::Bernoulli<OF_PP_PAIR_FIRST(T_pair), OF_PP_PAIR_FIRST(K_pair)>( \
+      int64_t elem_cnt, const OF_PP_PAIR_FIRST(T_pair) * prob, OF_PP_PAIR_FIRST(K_pair) * out);
+OF_PP_SEQ_PRODUCT_FOR_EACH_TUPLE(INSTANTIATE_PHILOX_RANDOM_BERNOULLI, FLOATING_DATA_TYPE_SEQ,
+                                 ARITHMETIC_DATA_TYPE_SEQ);
+
+}  // namespace oneflow
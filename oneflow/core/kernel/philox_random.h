@@ -0,0 +1,62 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_KERNEL_PHILOX_RANDOM_H_
+#define ONEFLOW_CORE_KERNEL_PHILOX_RANDOM_H_
+
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// Philox4x32-10 counter-based generator ("Parallel Random Numbers: As Easy as 1, 2, 3", Salmon
+// et al., SC11) for cpu kernels.
+//
+// Each fill takes a fresh offset of the generator and element i of the fill is computed from
+// (seed, offset, i) only. So large tensors are filled in parallel chunks on Global<ThreadPool>
+// and the result does not depend on the number of threads, unlike a shared std::mt19937.
+class PhiloxRandom final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(PhiloxRandom);
+  explicit PhiloxRandom(uint64_t seed) : seed_(seed), offset_(0) {}
+  ~PhiloxRandom() = default;
+
+  // Uniform in [min, max) for floating T and in [min, max] for integral T. Note the floating
+  // uniform initializers of KernelUtil, which go through here, used to include max.
+  template<typename T>
+  void Uniform(int64_t elem_cnt, T min, T max, T* dptr);
+  template<typename T>
+  void Normal(int64_t elem_cnt, T mean, T std, T* dptr);
+  // Normal resampled until within two stds from the mean
+  template<typename T>
+  void TruncatedNormal(int64_t elem_cnt, T mean, T std, T* dptr);
+  // out[i] is one with probability prob[i] and zero otherwise
+  template<typename T, typename K>
+  void Bernoulli(int64_t elem_cnt, const T* prob, K* out);
+  // mask[i] is zero with probability rate and one otherwise
+  void Mask(int64_t elem_cnt, float rate, int8_t* mask);
+
+  // The 4 x 32 random bits of `counter` under `key`
+  static void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+ private:
+  uint32_t NextOffset() { return offset_++; }
+
+  uint64_t seed_;
+  uint32_t offset_;
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_KERNEL_PHILOX_RANDOM_H_
@@ -0,0 +1,131 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/kernel/philox_random.h"
+#include "oneflow/core/thread/thread_pool.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+template<typename T>
+void CalcMeanAndStd(const std::vector<T>& vec, double* mean, double* std) {
+  double sum = 0;
+  double square_sum = 0;
+  for (const T& x : vec) {
+    sum += x;
+    square_sum += static_cast<double>(x) * x;
+  }
+  *mean = sum / vec.size();
+  *std = std::sqrt(square_sum / vec.size() - *mean * *mean);
+}
+
+}  // namespace
+
+TEST(PhiloxRandom, known_answer) {
+  // test vectors of the Random123 library
+  uint32_t out[4];
+  const uint32_t counter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+  const uint32_t key[2] = {0xa4093822, 0x299f31d0};
+  PhiloxRandom::Philox4x32(counter, key, out);
+  ASSERT_EQ(out[0], 0xd16cfe09);
+  ASSERT_EQ(out[1], 0x94fdcceb);
+  ASSERT_EQ(out[2], 0x5001e420);
+  ASSERT_EQ(out[3], 0x24126ea1);
+}
+
+TEST(PhiloxRandom, distribution) {
+  const int64_t elem_cnt = (1 << 20) + 3;
+  double mean = 0;
+  double std = 0;
+  std::vector<float> floats(elem_cnt);
+  PhiloxRandom(1).Uniform<float>(elem_cnt, -1.0f, 3.0f, floats.data());
+  ASSERT_TRUE(std::all_of(floats.begin(), floats.end(),
+                          [](float x) { return x >= -1.0f && x < 3.0f; }));
+  CalcMeanAndStd(floats, &mean, &std);
+  ASSERT_NEAR(mean, 1.0, 0.01);
+  PhiloxRandom(2).Normal<float>(elem_cnt, 1.0f, 2.0f, floats.data());
+  CalcMeanAndStd(floats, &mean, &std);
+  ASSERT_NEAR(mean, 1.0, 0.01);
+  ASSERT_NEAR(std, 2.0, 0.01);
+  std::vector<double> doubles(elem_cnt);
+  PhiloxRandom(3).TruncatedNormal<double>(elem_cnt, 0.0, 1.0, doubles.data());
+  ASSERT_TRUE(std::all_of(doubles.begin(), doubles.end(),
+                          [](double x) { return std::abs(x) < 2.0; }));
+  CalcMeanAndStd(doubles, &mean, &std);
+  ASSERT_NEAR(mean, 0.0, 0.01);
+  ASSERT_NEAR(std, 0.8796, 0.01);
+  // max is excluded even where min + u * (max - min) would round to it
+  PhiloxRandom(1).Uniform<float>(elem_cnt, 1.0f, 1.0f + 1e-6f, floats.data());
+  ASSERT_TRUE(std::all_of(floats.begin(), floats.end(),
+                          [](float x) { return x >= 1.0f && x < 1.0f + 1e-6f; }));
+  std::vector<int8_t> mask(elem_cnt);
+  PhiloxRandom(4).Mask(elem_cnt, 0.3f, mask.data());
+  CalcMeanAndStd(mask, &mean, &std);
+  ASSERT_NEAR(mean, 0.7, 0.01);
+  std::vector<int32_t> ints(elem_cnt);
+  PhiloxRandom(5).Uniform<int32_t>(elem_cnt, -3, 4, ints.data());
+  ASSERT_TRUE(std::all_of(ints.begin(), ints.end(), [](int32_t x) { return x >= -3 && x <= 4; }));
+  CalcMeanAndStd(ints, &mean, &std);
+  ASSERT_NEAR(mean, 0.5, 0.01);
+}
+
+TEST(PhiloxRandom, independent_of_thread_num) {
+  const int64_t elem_cnt = (1 << 22) + 1;
+  std::vector<float> serial(elem_cnt);
+  std::vector<float> parallel(elem_cnt);
+  PhiloxRandom serial_random(6);
+  serial_random.Normal<float>(elem_cnt, 0.0f, 1.0f, serial.data());
+  Global<ThreadPool>::New(5);
+  PhiloxRandom parallel_random(6);
+  parallel_random.Normal<float>(elem_cnt, 0.0f, 1.0f, parallel.data());
+  ASSERT_TRUE(serial == parallel);
+  // the next fill of the same generator takes new numbers
+  parallel_random.Normal<float>(elem_cnt, 0.0f, 1.0f, parallel.data());
+  ASSERT_FALSE(serial == parallel);
+  Global<ThreadPool>::Delete();
+}
+
+TEST(PhiloxRandom, benchmark_against_mt19937) {
+  const int64_t elem_cnt = 1 << 24;
+  std::vector<float> dptr(elem_cnt);
+  const auto Milliseconds = [](const std::function<void()>& Fill) {
+    const auto start = std::chrono::steady_clock::now();
+    Fill();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  const double mt19937_ms = Milliseconds([&]() {
+    std::mt19937 generator(7);
+    std::normal_distribution<float> random_distribution(0.0f, 1.0f);
+    for (int64_t i = 0; i < elem_cnt; ++i) { dptr[i] = random_distribution(generator); }
+  });
+  const double philox_ms =
+      Milliseconds([&]() { PhiloxRandom(7).Normal<float>(elem_cnt, 0.0f, 1.0f, dptr.data()); });
+  const int64_t thread_num = std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+  Global<ThreadPool>::New(thread_num);
+  const double parallel_philox_ms =
+      Milliseconds([&]() { PhiloxRandom(7).Normal<float>(elem_cnt, 0.0f, 1.0f, dptr.data()); });
+  Global<ThreadPool>::Delete();
+  LOG(INFO) << "normal initializer of " << elem_cnt << " floats, mt19937: " << mt19937_ms
+            << " ms, philox: " << philox_ms << " ms, philox on " << thread_num
+            << " threads: " << parallel_philox_ms << " ms";
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include "oneflow/core/common/data_type.h"
 #include "oneflow/core/job/resource.pb.h"
 #include "oneflow/core/device/device_context.h"
+#include "oneflow/core/kernel/philox_random.h"
 
 namespace oneflow {
 
@@ -31,7 +32,7 @@ template<>
 class RandomGenerator<DeviceType::kCPU> final {
  public:
   OF_DISALLOW_COPY_AND_MOVE(RandomGenerator);
-  RandomGenerator(int64_t seed, DeviceCtx* device_ctx) : mt19937_generator_(seed) {}
+  RandomGenerator(int64_t seed, DeviceCtx* device_ctx) : philox_random_(seed) {}
   ~RandomGenerator() {}
 
   template<typename T>
@@ -40,7 +41,7 @@ class RandomGenerator<DeviceType::kCPU> final {
   void Uniform(const int64_t elem_cnt, const T min, const T max, T* dptr);
 
  private:
-  std::mt19937 mt19937_generator_;
+  PhiloxRandom philox_random_;
 };
 
 template<>
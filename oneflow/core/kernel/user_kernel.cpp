@@ -404,6 +404,7 @@ namespace {
 
 struct BnTensorPair {
   std::string bn;
+  int64_t bn_index = -1;
   std::unique_ptr<user_op::BlobTensorView> tensor;
 };
 
@@ -460,15 +461,28 @@ class UserKernelComputeContext final : public user_op::KernelComputeContext {
 
   void UpdateTensorWithCorrBlob(const std::function<Blob*(const std::string&)>& BnInOp2Blob) {
     for (auto& pair : arg2bn_tensor_pair_) {
-      std::unique_ptr<user_op::BlobTensorView>* arg_tensor_ptr = &pair.second.tensor;
-      Blob* blob = BnInOp2Blob(pair.second.bn);
-      if (blob == nullptr) { continue; }
-      if (*arg_tensor_ptr) {
-        arg_tensor_ptr->get()->Reset(blob);
-      } else {
-        arg_tensor_ptr->reset(new user_op::BlobTensorView(blob));
-      }
+      UpdateTensor(&pair.second.tensor, BnInOp2Blob(pair.second.bn));
+    }
+    is_tensor_bound_ = false;
+  }
+
+  void InitBnIndex(const std::function<int64_t(const std::string&)>& Index4BnInOp) {
+    for (auto& pair : arg2bn_tensor_pair_) { pair.second.bn_index = Index4BnInOp(pair.second.bn); }
+  }
+
+  // Tensors updated here stay bound until the next compute, which skips UpdateTensorWithCorrBlob.
+  void UpdateTensorWithIndex2Blob(const std::vector<Blob*>& index2blob) {
+    for (auto& pair : arg2bn_tensor_pair_) {
+      if (pair.second.bn_index == -1) { continue; }
+      UpdateTensor(&pair.second.tensor, index2blob.at(pair.second.bn_index));
     }
+    is_tensor_bound_ = true;
+  }
+
+  bool TryUnbindTensor() {
+    const bool is_tensor_bound = is_tensor_bound_;
+    is_tensor_bound_ = false;
+    return is_tensor_bound;
   }
 
   DeviceType device_type() const override { return base_ctx_.device_type(); }
@@ -486,10 +500,20 @@ class UserKernelComputeContext final : public user_op::KernelComputeContext {
 
   const user_op::UserOpConfWrapper& user_op_conf() const override { return user_op_conf_; }
 
+  static void UpdateTensor(std::unique_ptr<user_op::BlobTensorView>* arg_tensor_ptr, Blob* blob) {
+    if (blob == nullptr) { return; }
+    if (*arg_tensor_ptr) {
+      arg_tensor_ptr->get()->Reset(blob);
+    } else {
+      arg_tensor_ptr->reset(new user_op::BlobTensorView(blob));
+    }
+  }
+
   user_op::UserOpConfWrapper user_op_conf_;
   DeviceCtx* device_ctx_;
   HashMap<std::pair<std::string, int32_t>, BnTensorPair> arg2bn_tensor_pair_;
   UserKernelBaseContext base_ctx_;
+  bool is_tensor_bound_ = false;
 };
 
 class UserKernelRegContext final : public user_op::KernelRegContext {
@@ -523,6 +547,7 @@ class UserKernelRegContext final : public user_op::KernelRegContext {
 
 void UserKernel::InitUserKernel(DeviceCtx* device_ctx) {
   ctx_.reset(new UserKernelComputeContext(device_ctx, kernel_conf(), job_desc()));
+  ctx_->InitBnIndex([&](const std::string& bn_in_op) { return Index4BnInOp(bn_in_op); });
   infer_ctx_.reset(new UserKernelInferContext(device_ctx, kernel_conf(), job_desc()));
   infer_cache_.reset(new user_op::OpKernelInferCache(kernel_conf(), job_desc()));
   {
@@ -548,10 +573,14 @@ const std::shared_ptr<user_op::OpKernelState>& UserKernel::GetOpKernelState() co
 
 void UserKernel::ForwardUserKernel(std::function<Blob*(const std::string&)> BnInOp2Blob,
                                    user_op::OpKernelState* opkernel_state) const {
-  ctx_->UpdateTensorWithCorrBlob(BnInOp2Blob);
+  if (!ctx_->TryUnbindTensor()) { ctx_->UpdateTensorWithCorrBlob(BnInOp2Blob); }
   kernel_->Compute(ctx_.get(), opkernel_state);
 }
 
+void UserKernel::VirtualBindBlobs(const std::vector<Blob*>& index2blob) const {
+  ctx_->UpdateTensorWithIndex2Blob(index2blob);
+}
+
 void UserKernel::VirtualKernelInit(DeviceCtx* device_ctx) {
   InitUserKernel(device_ctx);
   CHECK(opkernel_state_.get() == nullptr);
@@ -567,7 +596,8 @@ void UserKernel::ForwardShape(const KernelCtx& ctx,
                               std::function<Blob*(const std::string&)> BnInOp2Blob) const {
   infer_ctx_->UpdateArg2Tensor(BnInOp2Blob);
   infer_cache_->UpdateCacheKey(infer_ctx_.get());
-  if (!infer_cache_->IsCacheHit()) {
+  std::shared_ptr<const OpInferCacheValue> cache_value_ptr = infer_cache_->GetCacheValue();
+  if (!cache_value_ptr) {
     auto* op_infer_ctx = dynamic_cast<UserKernelOpInferContext*>(infer_ctx_->MutOpInferContext());
     CHECK_NOTNULL(op_infer_ctx);
     op_infer_ctx->UpdateArg2TensorDesc(BnInOp2Blob);
@@ -586,7 +616,6 @@ void UserKernel::ForwardShape(const KernelCtx& ctx,
     }
     infer_cache_->UpdateCacheValue(infer_ctx_.get());
   } else {
-    std::shared_ptr<const OpInferCacheValue> cache_value_ptr = infer_cache_->GetCacheValue();
     FOR_RANGE(int, i, 0, infer_ctx_->outputs().size()) {
       const auto& out_arg_pair = infer_ctx_->outputs().at(i);
       MutShapeView* mut_shape_view =
@@ -42,6 +42,7 @@ class UserKernel final : public Kernel {
 
  private:
   void VirtualKernelInit(DeviceCtx* device_ctx) override;
+  void VirtualBindBlobs(const std::vector<Blob*>& index2blob) const override;
 
   void ForwardDataContent(const KernelCtx& ctx,
                           std::function<Blob*(const std::string&)> BnInOp2Blob) const override;
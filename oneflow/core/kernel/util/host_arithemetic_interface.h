@@ -71,6 +71,8 @@ struct ArithemeticIf<DeviceType::kCPU> {
                           int32_t* z);
   static void MulByScalar(DeviceCtx* ctx, const int64_t n, const int64_t* x, const int64_t y,
                           int64_t* z);
+  static void MulByScalar(DeviceCtx* ctx, const int64_t n, const bfloat16* x, const bfloat16 y,
+                          bfloat16* z);
 
   static void AddByScalar(DeviceCtx* ctx, const int64_t n, const float* x, const float y, float* z);
   static void AddByScalar(DeviceCtx* ctx, const int64_t n, const double* x, const double y,
@@ -81,6 +83,8 @@ struct ArithemeticIf<DeviceType::kCPU> {
                           int32_t* z);
   static void AddByScalar(DeviceCtx* ctx, const int64_t n, const int64_t* x, const int64_t y,
                           int64_t* z);
+  static void AddByScalar(DeviceCtx* ctx, const int64_t n, const bfloat16* x, const bfloat16 y,
+                          bfloat16* z);
 
   static void MulByScalarPtr(DeviceCtx* ctx, const int64_t n, const float* x, const float* y,
                              float* z);
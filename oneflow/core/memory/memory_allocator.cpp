@@ -104,7 +104,10 @@ char* MemoryAllocator::Allocate(MemoryCase mem_case, std::size_t size) {
   } else {
     UNIMPLEMENTED();
   }
-  deleters_.push_front(std::bind(&MemoryAllocator::Deallocate, this, dptr, mem_case));
+  {
+    std::unique_lock<std::mutex> lock(deleters_mutex_);
+    deleters_.push_front(std::bind(&MemoryAllocator::Deallocate, this, dptr, mem_case));
+  }
   return dptr;
 }
 
@@ -14,15 +14,117 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/ndarray/ndarray_apply_broadcast_binary_core.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 
+namespace {
+
+constexpr int64_t kParallelBroadcastMinPartSize = 32768;
+
+// Inner loops over n contiguous elements of y, written for the compiler to vectorize. ScalarA and
+// ScalarB are for a and b broadcast along the innermost dim.
+template<typename T, template<typename> class binary_func>
+void ApplyContiguous(int64_t n, typename BinaryFuncTrait<binary_func, T>::return_type* y,
+                     const T* a, const T* b) {
+  for (int64_t i = 0; i < n; ++i) { y[i] = binary_func<T>::Invoke(a[i], b[i]); }
+}
+
+template<typename T, template<typename> class binary_func>
+void ApplyScalarA(int64_t n, typename BinaryFuncTrait<binary_func, T>::return_type* y,
+                  const T* a, const T* b) {
+  const T a_val = *a;
+  for (int64_t i = 0; i < n; ++i) { y[i] = binary_func<T>::Invoke(a_val, b[i]); }
+}
+
+template<typename T, template<typename> class binary_func>
+void ApplyScalarB(int64_t n, typename BinaryFuncTrait<binary_func, T>::return_type* y,
+                  const T* a, const T* b) {
+  const T b_val = *b;
+  for (int64_t i = 0; i < n; ++i) { y[i] = binary_func<T>::Invoke(a[i], b_val); }
+}
+
+// Computes y = binary_func(a, b) with a and b broadcast to the shape of y. The shapes are
+// expected to be simplified by SimplifyBroadcastShapes, so that y is walked row by row along its
+// innermost dim, each row being a contiguous, scalar or row broadcast of a and b. Large outputs
+// are split into ranges of elements computed on the thread pool.
+template<typename T, template<typename> class binary_func>
+void CpuBroadcastApply(const XpuShape& y_shape,
+                       typename BinaryFuncTrait<binary_func, T>::return_type* y,
+                       const XpuShape& a_shape, const T* a, const XpuShape& b_shape, const T* b) {
+  const int64_t elem_cnt = y_shape.ElemNum();
+  if (elem_cnt == 0) { return; }
+  const int64_t num_axes = y_shape.NumAxes();
+  const int64_t outer_num_axes = num_axes - 1;
+  const int64_t inner_size = y_shape.At(outer_num_axes);
+  // strides of a and b along the outer dims of y, 0 on the broadcast dims
+  DimVector a_strides(outer_num_axes);
+  DimVector b_strides(outer_num_axes);
+  FOR_RANGE(int64_t, i, 0, outer_num_axes) {
+    a_strides[i] = a_shape.At(i) == 1 ? 0 : a_shape.DimElemNum(i);
+    b_strides[i] = b_shape.At(i) == 1 ? 0 : b_shape.DimElemNum(i);
+  }
+  const int64_t a_inner_stride = a_shape.At(outer_num_axes) == inner_size ? 1 : 0;
+  const int64_t b_inner_stride = b_shape.At(outer_num_axes) == inner_size ? 1 : 0;
+  auto ApplyRow = &ApplyContiguous<T, binary_func>;
+  if (a_inner_stride == 0 && b_inner_stride == 1) {
+    ApplyRow = &ApplyScalarA<T, binary_func>;
+  } else if (a_inner_stride == 1 && b_inner_stride == 0) {
+    ApplyRow = &ApplyScalarB<T, binary_func>;
+  }
+  const auto ApplyRange = [&](int64_t begin, int64_t end) {
+    DimVector coord(outer_num_axes);
+    int64_t row = begin / inner_size;
+    int64_t col = begin % inner_size;
+    int64_t a_offset = 0;
+    int64_t b_offset = 0;
+    for (int64_t i = outer_num_axes - 1; i >= 0; --i) {
+      coord[i] = row % y_shape.At(i);
+      row /= y_shape.At(i);
+      a_offset += coord[i] * a_strides[i];
+      b_offset += coord[i] * b_strides[i];
+    }
+    while (begin < end) {
+      const int64_t n = std::min(inner_size - col, end - begin);
+      ApplyRow(n, y + begin, a + a_offset + col * a_inner_stride,
+               b + b_offset + col * b_inner_stride);
+      begin += n;
+      col = 0;
+      for (int64_t i = outer_num_axes - 1; i >= 0; --i) {
+        a_offset += a_strides[i];
+        b_offset += b_strides[i];
+        if (++coord[i] < y_shape.At(i)) { break; }
+        a_offset -= coord[i] * a_strides[i];
+        b_offset -= coord[i] * b_strides[i];
+        coord[i] = 0;
+      }
+    }
+  };
+  int64_t part_num = 1;
+  if (Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(),
+                                 elem_cnt / kParallelBroadcastMinPartSize);
+  }
+  if (part_num <= 1) {
+    ApplyRange(0, elem_cnt);
+    return;
+  }
+  BalancedSplitter bs(elem_cnt, part_num);
+  MultiThreadLoop(part_num, [&](size_t part_id) {
+    const Range range = bs.At(part_id);
+    ApplyRange(range.begin(), range.end());
+  });
+}
+
+}  // namespace
+
 template<typename T, int NDIMS, template<typename> class binary_func>
 struct NdarrayApplyBroadcastBinaryCoreWrapper<DeviceType::kCPU, T, NDIMS, binary_func> final {
   static void Apply(DeviceCtx* ctx,
                     const XpuVarNdarray<typename BinaryFuncTrait<binary_func, T>::return_type>& y,
                     const XpuVarNdarray<const T>& a, const XpuVarNdarray<const T>& b) {
-    NdarrayApplyBroadcastBinaryCore<T, NDIMS, binary_func>::Apply(y, a, b);
+    CpuBroadcastApply<T, binary_func>(y.shape(), y.ptr(), a.shape(), a.ptr(), b.shape(), b.ptr());
   }
 };
 
@@ -31,7 +133,7 @@ struct NdarrayApplyBroadcastInplaceBinaryCoreWrapper<DeviceType::kCPU, T, NDIMS,
     final {
   static void InplaceApply(DeviceCtx* ctx, const XpuVarNdarray<T>& y,
                            const XpuVarNdarray<const T>& x) {
-    NdarrayApplyBroadcastBinaryCore<T, NDIMS, binary_func>::InplaceApply(y, x);
+    CpuBroadcastApply<T, binary_func>(y.shape(), y.ptr(), y.shape(), y.ptr(), x.shape(), x.ptr());
   }
 };
 
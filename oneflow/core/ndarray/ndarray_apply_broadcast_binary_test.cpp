@@ -0,0 +1,94 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/ndarray/ndarray_util.h"
+#include "oneflow/core/thread/thread_pool.h"
+#include <gtest/gtest.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+int64_t BroadcastOffset(const Shape& y_shape, const Shape& x_shape, int64_t y_offset) {
+  int64_t x_offset = 0;
+  int64_t x_stride = 1;
+  for (int64_t i = y_shape.NumAxes() - 1; i >= 0; --i) {
+    const int64_t coord = y_offset % y_shape.At(i);
+    y_offset /= y_shape.At(i);
+    if (x_shape.At(i) != 1) { x_offset += coord * x_stride; }
+    x_stride *= x_shape.At(i);
+  }
+  return x_offset;
+}
+
+void TestBroadcastSub(const Shape& a_shape, const Shape& b_shape) {
+  DimVector y_dim_vec(a_shape.NumAxes());
+  FOR_RANGE(int64_t, i, 0, a_shape.NumAxes()) {
+    y_dim_vec[i] = std::max(a_shape.At(i), b_shape.At(i));
+  }
+  const Shape y_shape(y_dim_vec);
+  std::vector<float> a(a_shape.elem_cnt());
+  std::vector<float> b(b_shape.elem_cnt());
+  FOR_RANGE(size_t, i, 0, a.size()) { a[i] = static_cast<float>(i % 1000); }
+  FOR_RANGE(size_t, i, 0, b.size()) { b[i] = static_cast<float>(i % 777) * 0.5f; }
+  std::vector<float> y(y_shape.elem_cnt());
+  NdarrayUtil<DeviceType::kCPU, float>::BroadcastSub(nullptr,
+                                                      XpuVarNdarray<float>(y_shape, y.data()),
+                                                      XpuVarNdarray<const float>(a_shape, a.data()),
+                                                      XpuVarNdarray<const float>(b_shape, b.data()));
+  FOR_RANGE(int64_t, i, 0, y_shape.elem_cnt()) {
+    const float expected =
+        a[BroadcastOffset(y_shape, a_shape, i)] - b[BroadcastOffset(y_shape, b_shape, i)];
+    ASSERT_EQ(y[i], expected) << a_shape.ToString() << " - " << b_shape.ToString() << " at " << i;
+  }
+  if (a_shape == y_shape) {
+    NdarrayUtil<DeviceType::kCPU, float>::InplaceBroadcastSub(
+        nullptr, XpuVarNdarray<float>(y_shape, a.data()),
+        XpuVarNdarray<const float>(b_shape, b.data()));
+    ASSERT_TRUE(a == y) << "inplace " << a_shape.ToString() << " - " << b_shape.ToString();
+  }
+}
+
+void TestBroadcastShapes() {
+  // bias add
+  TestBroadcastSub(Shape({64, 1000}), Shape({1, 1000}));
+  TestBroadcastSub(Shape({8, 64, 49}), Shape({1, 64, 1}));
+  // column, scalar and outer product
+  TestBroadcastSub(Shape({300, 7}), Shape({300, 1}));
+  TestBroadcastSub(Shape({1, 1}), Shape({300, 7}));
+  TestBroadcastSub(Shape({1, 1024}), Shape({1, 1}));
+  TestBroadcastSub(Shape({300, 1}), Shape({1, 513}));
+  // attention mask
+  TestBroadcastSub(Shape({4, 8, 64, 64}), Shape({4, 1, 1, 64}));
+  TestBroadcastSub(Shape({2, 3, 5, 7, 11}), Shape({2, 1, 5, 1, 11}));
+}
+
+}  // namespace
+
+TEST(NdarrayApplyBroadcastBinary, serial) { TestBroadcastShapes(); }
+
+TEST(NdarrayApplyBroadcastBinary, parallel) {
+  Global<ThreadPool>::New(4);
+  TestBroadcastShapes();
+  TestBroadcastSub(Shape({3, 100003}), Shape({1, 100003}));
+  TestBroadcastSub(Shape({100003, 3}), Shape({100003, 1}));
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -772,6 +772,12 @@ Maybe<void> Operator::InferMirroredSignatureIf(
                                 parallel_desc);
 }
 
+Maybe<void> Operator::FillMirroredSignature(const MirroredSignature& signature) {
+  CHECK_OR_RETURN(!mirrored_signature_);
+  mirrored_signature_.reset(new MirroredSignature(signature));
+  return Maybe<void>::Ok();
+}
+
 std::string DebugString4MirroredHint(
     std::function<Maybe<const MirroredSigInferHint*>(const std::string&)> MirroredSigInferHint4Ibn,
     const Operator& op) {
@@ -871,6 +877,11 @@ Maybe<const OptMirroredParallel*> Operator::OptMirroredParallel4BnInOp(
   return &iter->second;
 }
 
+Maybe<const MirroredSignature*> Operator::mirrored_signature() const {
+  CHECK_OR_RETURN(mirrored_signature_) << "mirrored signature not infered";
+  return mirrored_signature_.get();
+}
+
 OptMirroredParallel* Operator::MutOptMirroredParallel(const std::string& bn_in_op) {
   if (!mirrored_signature_) { mirrored_signature_.reset(new MirroredSignature()); }
   auto* map = mirrored_signature_->mutable_bn_in_op2opt_mirrored_parallel();
@@ -0,0 +1,342 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/record/ofrecord_scanner.h"
+
+namespace oneflow {
+
+namespace {
+
+// Field numbers of record.proto: OFRecord.feature is a map, serialized as entries with the key in
+// field 1 and the value in field 2, and the lists of a Feature keep their values in field 1.
+constexpr int kFeatureMapFieldNumber = 1;
+constexpr int kMapKeyFieldNumber = 1;
+constexpr int kMapValueFieldNumber = 2;
+constexpr int kListValueFieldNumber = 1;
+
+enum WireType {
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+  kFixed32 = 5,
+};
+
+class WireReader final {
+ public:
+  WireReader(const char* data, size_t size)
+      : cur_(reinterpret_cast<const uint8_t*>(data)),
+        end_(reinterpret_cast<const uint8_t*>(data) + size) {}
+  ~WireReader() = default;
+
+  bool Done() const { return cur_ == end_; }
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+      CHECK(cur_ < end_ && shift < 64) << "malformed OFRecord: bad varint";
+      const uint8_t byte = *cur_++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) { return value; }
+    }
+  }
+
+  void ReadTag(int* field_number, int* wire_type) {
+    const uint64_t tag = ReadVarint();
+    *field_number = static_cast<int>(tag >> 3);
+    *wire_type = static_cast<int>(tag & 7);
+  }
+
+  const char* ReadLengthDelimited(size_t* size) {
+    const uint64_t length = ReadVarint();
+    CHECK_LE(length, static_cast<uint64_t>(end_ - cur_)) << "malformed OFRecord: truncated field";
+    const char* data = reinterpret_cast<const char*>(cur_);
+    cur_ += length;
+    *size = length;
+    return data;
+  }
+
+  // The wire format is little endian, as the hosts oneflow runs on.
+  template<typename T>
+  T ReadFixed() {
+    CHECK_LE(sizeof(T), static_cast<size_t>(end_ - cur_)) << "malformed OFRecord: truncated field";
+    T value;
+    std::memcpy(&value, cur_, sizeof(T));
+    cur_ += sizeof(T);
+    return value;
+  }
+
+  void Skip(int wire_type) {
+    size_t size = 0;
+    switch (wire_type) {
+      case kVarint: ReadVarint(); break;
+      case kFixed64: ReadFixed<uint64_t>(); break;
+      case kLengthDelimited: ReadLengthDelimited(&size); break;
+      case kFixed32: ReadFixed<uint32_t>(); break;
+      default: LOG(FATAL) << "malformed OFRecord: unsupported wire type " << wire_type;
+    }
+  }
+
+ private:
+  const uint8_t* cur_;
+  const uint8_t* end_;
+};
+
+void ScanFeature(const char* data, size_t size, SerializedFeature* feature) {
+  WireReader reader(data, size);
+  while (!reader.Done()) {
+    int field_number = 0;
+    int wire_type = 0;
+    reader.ReadTag(&field_number, &wire_type);
+    if (field_number >= Feature::kBytesList && field_number <= Feature::kInt64List
+        && wire_type == kLengthDelimited) {
+      size_t list_size = 0;
+      const char* list_data = reader.ReadLengthDelimited(&list_size);
+      feature->MergeList(static_cast<Feature::KindCase>(field_number), list_data, list_size);
+    } else {
+      reader.Skip(wire_type);
+    }
+  }
+}
+
+// Numeric values of a list are usually packed into one length delimited field, but a parser also
+// has to accept them unpacked, one field per value. Values are counted from *cnt on.
+template<typename T>
+void ReadNumericValues(Feature::KindCase kind_case, const char* data, size_t size, T* out,
+                       int64_t max_cnt, int64_t* cnt) {
+  const auto Write = [&](T value) {
+    if (*cnt < max_cnt) { out[*cnt] = value; }
+    ++*cnt;
+  };
+  const auto ReadValue = [&](WireReader* reader) {
+    switch (kind_case) {
+      case Feature::kFloatList: Write(static_cast<T>(reader->ReadFixed<float>())); break;
+      case Feature::kDoubleList: Write(static_cast<T>(reader->ReadFixed<double>())); break;
+      case Feature::kInt32List:
+        Write(static_cast<T>(static_cast<int32_t>(reader->ReadVarint())));
+        break;
+      case Feature::kInt64List:
+        Write(static_cast<T>(static_cast<int64_t>(reader->ReadVarint())));
+        break;
+      default: UNIMPLEMENTED();
+    }
+  };
+  WireReader reader(data, size);
+  while (!reader.Done()) {
+    int field_number = 0;
+    int wire_type = 0;
+    reader.ReadTag(&field_number, &wire_type);
+    if (field_number != kListValueFieldNumber) {
+      reader.Skip(wire_type);
+    } else if (wire_type == kLengthDelimited) {
+      size_t packed_size = 0;
+      const char* packed_data = reader.ReadLengthDelimited(&packed_size);
+      WireReader packed_reader(packed_data, packed_size);
+      while (!packed_reader.Done()) { ReadValue(&packed_reader); }
+    } else {
+      ReadValue(&reader);
+    }
+  }
+}
+
+// Copies packed floats as they are, unpacked ones one by one. Values are counted from *cnt on.
+void ReadFloatValues(const char* data, size_t size, float* out, int64_t max_cnt, int64_t* cnt) {
+  WireReader reader(data, size);
+  while (!reader.Done()) {
+    int field_number = 0;
+    int wire_type = 0;
+    reader.ReadTag(&field_number, &wire_type);
+    if (field_number == kListValueFieldNumber && wire_type == kLengthDelimited) {
+      size_t packed_size = 0;
+      const char* packed_data = reader.ReadLengthDelimited(&packed_size);
+      CHECK_EQ(packed_size % sizeof(float), 0) << "malformed OFRecord: truncated field";
+      const int64_t packed_cnt = packed_size / sizeof(float);
+      const int64_t copy_cnt = std::max<int64_t>(std::min(packed_cnt, max_cnt - *cnt), 0);
+      if (copy_cnt > 0) { std::memcpy(out + *cnt, packed_data, copy_cnt * sizeof(float)); }
+      *cnt += packed_cnt;
+    } else if (field_number == kListValueFieldNumber && wire_type == kFixed32) {
+      const float value = reader.ReadFixed<float>();
+      if (*cnt < max_cnt) { out[*cnt] = value; }
+      ++*cnt;
+    } else {
+      reader.Skip(wire_type);
+    }
+  }
+}
+
+template<typename T>
+struct ValuesReader {
+  static void Read(Feature::KindCase kind_case, const char* data, size_t size, T* out,
+                   int64_t max_cnt, int64_t* cnt) {
+    ReadNumericValues<T>(kind_case, data, size, out, max_cnt, cnt);
+  }
+};
+
+template<>
+struct ValuesReader<float> {
+  static void Read(Feature::KindCase kind_case, const char* data, size_t size, float* out,
+                   int64_t max_cnt, int64_t* cnt) {
+    if (kind_case == Feature::kFloatList) {
+      ReadFloatValues(data, size, out, max_cnt, cnt);
+    } else {
+      ReadNumericValues<float>(kind_case, data, size, out, max_cnt, cnt);
+    }
+  }
+};
+
+}  // namespace
+
+void SerializedFeature::Clear() {
+  kind_case_ = Feature::KIND_NOT_SET;
+  list_data7size_.clear();
+}
+
+void SerializedFeature::MergeList(Feature::KindCase kind_case, const char* data, size_t size) {
+  if (kind_case != kind_case_) {
+    kind_case_ = kind_case;
+    list_data7size_.clear();
+  }
+  list_data7size_.emplace_back(data, size);
+}
+
+int64_t SerializedFeature::value_size() const {
+  if (kind_case_ == Feature::kBytesList) {
+    int64_t cnt = 0;
+    ForEachBytesValue([&](const char*, size_t) { ++cnt; });
+    return cnt;
+  }
+  // the lengths of packed fixed size values give their number without reading them
+  if (kind_case_ == Feature::kFloatList || kind_case_ == Feature::kDoubleList) {
+    const size_t value_bytes = kind_case_ == Feature::kFloatList ? sizeof(float) : sizeof(double);
+    const int fixed_wire_type = kind_case_ == Feature::kFloatList ? kFixed32 : kFixed64;
+    int64_t cnt = 0;
+    for (const auto& pair : list_data7size_) {
+      WireReader reader(pair.first, pair.second);
+      while (!reader.Done()) {
+        int field_number = 0;
+        int wire_type = 0;
+        reader.ReadTag(&field_number, &wire_type);
+        if (field_number == kListValueFieldNumber && wire_type == kLengthDelimited) {
+          size_t packed_size = 0;
+          reader.ReadLengthDelimited(&packed_size);
+          CHECK_EQ(packed_size % value_bytes, 0) << "malformed OFRecord: truncated field";
+          cnt += packed_size / value_bytes;
+        } else {
+          if (field_number == kListValueFieldNumber && wire_type == fixed_wire_type) { ++cnt; }
+          reader.Skip(wire_type);
+        }
+      }
+    }
+    return cnt;
+  }
+  if (kind_case_ == Feature::KIND_NOT_SET) { return 0; }
+  return CopyValues<int64_t>(nullptr, 0);
+}
+
+template<typename T>
+int64_t SerializedFeature::CopyValues(T* out, int64_t max_cnt) const {
+  int64_t cnt = 0;
+  for (const auto& pair : list_data7size_) {
+    ValuesReader<T>::Read(kind_case_, pair.first, pair.second, out, max_cnt, &cnt);
+  }
+  return cnt;
+}
+
+void SerializedFeature::ForEachBytesValue(
+    const std::function<void(const char* data, size_t size)>& Handler) const {
+  CHECK(has_bytes_list());
+  for (const auto& pair : list_data7size_) {
+    WireReader reader(pair.first, pair.second);
+    while (!reader.Done()) {
+      int field_number = 0;
+      int wire_type = 0;
+      reader.ReadTag(&field_number, &wire_type);
+      if (field_number == kListValueFieldNumber && wire_type == kLengthDelimited) {
+        size_t value_size = 0;
+        const char* value_data = reader.ReadLengthDelimited(&value_size);
+        Handler(value_data, value_size);
+      } else {
+        reader.Skip(wire_type);
+      }
+    }
+  }
+}
+
+#define INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(T) \
+  template int64_t SerializedFeature::CopyValues<T>(T * out, int64_t max_cnt) const;
+INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(char)
+INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(float)
+INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(double)
+INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(int8_t)
+INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(int32_t)
+INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(int64_t)
+INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES(uint8_t)
+#undef INSTANTIATE_SERIALIZED_FEATURE_COPY_VALUES
+
+bool FindSerializedFeature(const char* record, size_t record_size, const std::string& name,
+                           SerializedFeature* feature) {
+  // as when parsing a map, the last entry of a key replaces the earlier ones, while the values
+  // written more than once in an entry are merged
+  bool found = false;
+  WireReader reader(record, record_size);
+  while (!reader.Done()) {
+    int field_number = 0;
+    int wire_type = 0;
+    reader.ReadTag(&field_number, &wire_type);
+    if (field_number != kFeatureMapFieldNumber || wire_type != kLengthDelimited) {
+      reader.Skip(wire_type);
+      continue;
+    }
+    size_t entry_size = 0;
+    const char* entry_data = reader.ReadLengthDelimited(&entry_size);
+    const auto ForEachEntryField = [&](const std::function<void(int, const char*, size_t)>& Do) {
+      WireReader entry_reader(entry_data, entry_size);
+      while (!entry_reader.Done()) {
+        int entry_field_number = 0;
+        int entry_wire_type = 0;
+        entry_reader.ReadTag(&entry_field_number, &entry_wire_type);
+        if ((entry_field_number == kMapKeyFieldNumber
+             || entry_field_number == kMapValueFieldNumber)
+            && entry_wire_type == kLengthDelimited) {
+          size_t size = 0;
+          const char* data = entry_reader.ReadLengthDelimited(&size);
+          Do(entry_field_number, data, size);
+        } else {
+          entry_reader.Skip(entry_wire_type);
+        }
+      }
+    };
+    // of keys written more than once, the last one is kept
+    const char* key_data = nullptr;
+    size_t key_size = 0;
+    ForEachEntryField([&](int entry_field_number, const char* data, size_t size) {
+      if (entry_field_number == kMapKeyFieldNumber) {
+        key_data = data;
+        key_size = size;
+      }
+    });
+    if (key_size != name.size()
+        || (key_size > 0 && std::memcmp(key_data, name.data(), key_size) != 0)) {
+      continue;
+    }
+    found = true;
+    feature->Clear();
+    ForEachEntryField([&](int entry_field_number, const char* data, size_t size) {
+      if (entry_field_number == kMapValueFieldNumber) { ScanFeature(data, size, feature); }
+    });
+  }
+  return found;
+}
+
+}  // namespace oneflow
@@ -0,0 +1,64 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_RECORD_OFRECORD_SCANNER_H_
+#define ONEFLOW_CORE_RECORD_OFRECORD_SCANNER_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/record/record.pb.h"
+
+namespace oneflow {
+
+// A feature of a serialized OFRecord, read from the protobuf wire format in place. It points into
+// the serialized record, which must outlive it. A list written more than once in a feature is
+// merged as when parsing, so the feature keeps every span of the list.
+class SerializedFeature final {
+ public:
+  SerializedFeature() : kind_case_(Feature::KIND_NOT_SET) {}
+  ~SerializedFeature() = default;
+
+  Feature::KindCase kind_case() const { return kind_case_; }
+  bool has_bytes_list() const { return kind_case_ == Feature::kBytesList; }
+
+  // Number of values of the list.
+  int64_t value_size() const;
+  // Converts the values of a float, double, int32 or int64 list to T and writes the first
+  // min(value_size(), max_cnt) of them to out. Returns value_size().
+  template<typename T>
+  int64_t CopyValues(T* out, int64_t max_cnt) const;
+  // Calls Handler with each value of a bytes list, without copying it.
+  void ForEachBytesValue(const std::function<void(const char* data, size_t size)>& Handler) const;
+
+  void Clear();
+  // Merges a serialized list of kind `kind_case` into the feature. A list of another kind replaces
+  // the current one, as setting a oneof does.
+  void MergeList(Feature::KindCase kind_case, const char* data, size_t size);
+
+ private:
+  Feature::KindCase kind_case_;
+  std::vector<std::pair<const char*, size_t>> list_data7size_;
+};
+
+// Locates feature `name` of the OFRecord serialized in record[0, record_size) without parsing the
+// record into an OFRecord. Returns false if the record has no such feature. A malformed record
+// fails a CHECK, as a failed ParseFromArray does. The ofrecord decoders use it on the records of
+// ofrecord_reader with output_serialized, and so do the decode workers of the ofrecord image
+// classification reader.
+bool FindSerializedFeature(const char* record, size_t record_size, const std::string& name,
+                           SerializedFeature* feature);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_RECORD_OFRECORD_SCANNER_H_
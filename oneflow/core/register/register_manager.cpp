@@ -22,6 +22,7 @@ limitations under the License.
 #include "oneflow/core/control/global_process_ctx.h"
 #include "oneflow/core/memory/memory_case.pb.h"
 #include "oneflow/core/memory/memory_allocator.h"
+#include "oneflow/core/thread/numa_topology.h"
 
 namespace oneflow {
 
@@ -43,6 +44,30 @@ struct PackedChunkInfo {
 
 }  // namespace
 
+HashSet<int64_t> GenInplaceBoundRegstDescIds(const Plan& plan) {
+  HashSet<int64_t> regst_desc_ids;
+  HashSet<int64_t> inplace_mem_block_ids;
+  for (const TaskProto& task : plan.task()) {
+    for (const auto& pair : task.produced_regst_desc()) {
+      const RegstDescProto& regst_desc = pair.second;
+      if (regst_desc.inplace_consumed_regst_desc_id() == -1) { continue; }
+      regst_desc_ids.insert(regst_desc.regst_desc_id());
+      regst_desc_ids.insert(regst_desc.inplace_consumed_regst_desc_id());
+      const int64_t mem_block_id = regst_desc.mem_block_id();
+      if (mem_block_id != -1) { inplace_mem_block_ids.insert(mem_block_id); }
+    }
+  }
+  for (const TaskProto& task : plan.task()) {
+    for (const auto& pair : task.produced_regst_desc()) {
+      const RegstDescProto& regst_desc = pair.second;
+      if (inplace_mem_block_ids.find(regst_desc.mem_block_id()) != inplace_mem_block_ids.end()) {
+        regst_desc_ids.insert(regst_desc.regst_desc_id());
+      }
+    }
+  }
+  return regst_desc_ids;
+}
+
 RegstMgr::RegstMgr(const Plan& plan) {
   int64_t this_machine_id = GlobalProcessCtx::Rank();
 
@@ -91,9 +116,19 @@ RegstMgr::RegstMgr(const Plan& plan) {
                 }
                 return lhs->thrd_id_hint() < rhs->thrd_id_hint();
               });
+    // host blocks produced by cpu compute actors go to the numa nodes the actors are pinned to
+    bool bind_numa_node = packed_chunk->mem_case.has_host_mem()
+                                && !packed_chunk->mem_case.host_mem().has_cuda_pinned_mem()
+                                && IsNumaAwareCpuActorEnabled();
     int64_t offset = 0;
     for (const MemBlockProto* block : packed_chunk->blocks) {
       CHECK(mem_block_id2ptr_.emplace(block->mem_block_id(), ptr + offset).second);
+      const int64_t numa_node = bind_numa_node ? NumaNode4CpuThrdId(block->thrd_id_hint()) : -1;
+      if (numa_node != -1 && !NumaBindMemory(ptr + offset, block->mem_size(), numa_node)) {
+        LOG(WARNING) << "failed to bind mem block " << block->mem_block_id() << " to numa node "
+                     << numa_node << ", stop binding the rest of its chunk";
+        bind_numa_node = false;
+      }
       offset += block->mem_size();
     }
     CHECK_EQ(offset, packed_chunk->size);
@@ -117,6 +152,7 @@ RegstMgr::RegstMgr(const Plan& plan) {
   for (const auto& pair : plan.ctrl_regst_desc_info().ctrl_regst_desc_id2producer_task_id()) {
     CHECK(ctrl_regst_desc_id2producer_task_id_.emplace(pair.first, pair.second).second);
   }
+  inplace_bound_regst_desc_ids_ = GenInplaceBoundRegstDescIds(plan);
 }
 
 void RegstMgr::NewRegsts(const RegstDescProto& regst_desc_proto,
@@ -166,6 +202,41 @@ void RegstMgr::NewRegsts(const RegstDescProto& regst_desc_proto,
   }
 }
 
+bool RegstMgr::IsRegstNumExtensible(const RegstDescProto& regst_desc_proto) const {
+  if (!regst_desc_proto.regst_desc_type().has_data_regst_desc()) { return false; }
+  // an extra regst would not be at the address of its inplace counterpart
+  if (inplace_bound_regst_desc_ids_.find(regst_desc_proto.regst_desc_id())
+      != inplace_bound_regst_desc_ids_.end()) {
+    return false;
+  }
+  const int64_t mem_block_id = regst_desc_proto.mem_block_id();
+  if (mem_block_id == -1 || mem_block_id2ptr_.find(mem_block_id) == mem_block_id2ptr_.end()) {
+    return false;
+  }
+  const MemoryCase& mem_case = regst_desc_proto.mem_case();
+  // regsts read by CommNet are registered to it before the runtime starts
+  return !(mem_case.has_host_mem() && mem_case.host_mem().used_by_network());
+}
+
+Regst* RegstMgr::NewExtraRegst(const RegstDescProto& regst_desc_proto) {
+  CHECK(IsRegstNumExtensible(regst_desc_proto));
+  const RtRegstDesc* rt_regst_desc =
+      regst_desc_id2rt_regst_desc_.at(regst_desc_proto.regst_desc_id()).get();
+  std::vector<LbiBlobDescPair> lbi_pairs;
+  for (const LbiBlobDescPair& pair :
+       regst_desc_proto.regst_desc_type().data_regst_desc().lbi2blob_desc()) {
+    lbi_pairs.push_back(pair);
+  }
+  std::sort(lbi_pairs.begin(), lbi_pairs.end(), &CompareLbiBlobDescPair);
+  char* main_mem_ptr = Global<MemoryAllocator>::Get()->Allocate(
+      rt_regst_desc->mem_case(), rt_regst_desc->MainByteSize4OneRegst());
+  Regst* regst = new Regst;
+  regst->set_regst_desc(rt_regst_desc);
+  // a nullptr header ptr makes NewBlobsInOneRegst allocate a separated header of its own
+  NewBlobsInOneRegst(lbi_pairs, regst, rt_regst_desc, main_mem_ptr, nullptr);
+  return regst;
+}
+
 void RegstMgr::NewBlobsInOneRegst(const std::vector<LbiBlobDescPair>& lbis, Regst* regst,
                                   const RtRegstDesc* rt_regst_desc, char* main_mem_ptr,
                                   char* separated_header_mem_ptr) {
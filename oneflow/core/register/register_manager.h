@@ -29,6 +29,11 @@ limitations under the License.
 
 namespace oneflow {
 
+// Ids of the regst descs whose regsts must stay in their mem blocks: regst descs consumed inplace,
+// whose consumers produce regsts at the same address, the inplace produced ones and every regst
+// desc sharing a mem block with an inplace produced one.
+HashSet<int64_t> GenInplaceBoundRegstDescIds(const Plan& plan);
+
 class RegstMgr final {
  public:
   OF_DISALLOW_COPY_AND_MOVE(RegstMgr);
@@ -36,6 +41,9 @@ class RegstMgr final {
   ~RegstMgr() = default;
 
   void NewRegsts(const RegstDescProto& regst_desc_proto, std::function<void(Regst*)> OneRegstDone);
+  // Whether regsts of a data regst desc can be added at runtime in memory outside of its mem block
+  bool IsRegstNumExtensible(const RegstDescProto& regst_desc_proto) const;
+  Regst* NewExtraRegst(const RegstDescProto& regst_desc_proto);
   const RtRegstDesc& RegstDesc4RegstDescId(int64_t regst_desc_id) const;
   bool HasRegstDescId(int64_t regst_desc_id) const;
   int64_t ProducerTaskId4RegstDescId(int64_t regst_desc_id) const;
@@ -53,6 +61,7 @@ class RegstMgr final {
   HashMap<int64_t, char*> mem_block_id2ptr_;
   HashMap<int64_t, ParallelContext> regst_desc_id2parallel_ctx_;
   HashMap<int64_t, int64_t> ctrl_regst_desc_id2producer_task_id_;
+  HashSet<int64_t> inplace_bound_regst_desc_ids_;
   std::mutex mutex_;
 };
 
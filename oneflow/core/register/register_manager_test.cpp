@@ -0,0 +1,62 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/register/register_manager.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+RegstDescProto* AddProducedRegstDesc(TaskProto* task, const std::string& name,
+                                     int64_t regst_desc_id, int64_t mem_block_id) {
+  RegstDescProto* regst_desc = &(*task->mutable_produced_regst_desc())[name];
+  regst_desc->set_regst_desc_id(regst_desc_id);
+  regst_desc->set_producer_task_id(task->task_id());
+  regst_desc->set_mem_block_id(mem_block_id);
+  return regst_desc;
+}
+
+}  // namespace
+
+TEST(RegstMgr, inplace_bound_regst_desc_ids) {
+  Plan plan;
+  TaskProto* producer = plan.add_task();
+  producer->set_task_id(0);
+  AddProducedRegstDesc(producer, "out", 1, 10);
+  AddProducedRegstDesc(producer, "other_out", 2, 11);
+  // the consumer writes regst desc 3 inplace into regst desc 1, regst desc 4 shares the mem block
+  TaskProto* inplace_consumer = plan.add_task();
+  inplace_consumer->set_task_id(1);
+  AddProducedRegstDesc(inplace_consumer, "out", 3, 10)->set_inplace_consumed_regst_desc_id(1);
+  AddProducedRegstDesc(inplace_consumer, "tmp", 4, 10);
+  AddProducedRegstDesc(inplace_consumer, "no_mem_block", 5, -1);
+  const HashSet<int64_t> ids = GenInplaceBoundRegstDescIds(plan);
+  ASSERT_EQ(ids, (HashSet<int64_t>{1, 3, 4}));
+}
+
+TEST(RegstMgr, no_inplace_regst_desc) {
+  Plan plan;
+  TaskProto* task = plan.add_task();
+  task->set_task_id(0);
+  AddProducedRegstDesc(task, "out", 1, 10);
+  AddProducedRegstDesc(task, "tmp", 2, 10);
+  ASSERT_TRUE(GenInplaceBoundRegstDescIds(plan).empty());
+}
+
+}  // namespace test
+
+}  // namespace oneflow
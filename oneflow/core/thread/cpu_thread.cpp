@@ -15,6 +15,7 @@ limitations under the License.
 */
 #include "oneflow/core/thread/cpu_thread.h"
 #include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/core/thread/numa_topology.h"
 #include "oneflow/core/profiler/profiler.h"
 #include "oneflow/core/graph/id_serialization.h"
 
@@ -22,8 +23,10 @@ namespace oneflow {
 
 CpuThread::CpuThread(int64_t thrd_id) {
   set_thrd_id(thrd_id);
-  mut_actor_thread() = std::thread([this, thrd_id]() {
+  const int64_t numa_node = NumaNode4CpuThrdId(thrd_id);
+  mut_actor_thread() = std::thread([this, thrd_id, numa_node]() {
     OF_PROFILER_NAME_THIS_HOST_THREAD("CPU Actor : (" + std::to_string(thrd_id) + ")");
+    if (numa_node != -1) { NumaBindCurrentThread(numa_node); }
     ThreadCtx ctx;
 #ifdef WITH_CUDA
     ctx.cb_event_chan = nullptr;
@@ -0,0 +1,177 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/thread/numa_topology.h"
+#include "oneflow/core/common/platform.h"
+#include "oneflow/core/common/id_util.h"
+#include "oneflow/core/graph/id_serialization.h"
+#include "oneflow/core/job/resource_desc.h"
+#include "oneflow/core/job/global_for.h"
+
+#ifdef OF_PLATFORM_POSIX
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // OF_PLATFORM_POSIX
+
+namespace oneflow {
+
+namespace {
+
+const std::string kSysNodePath = "/sys/devices/system/node/";
+
+bool ReadFirstLine(const std::string& path, std::string* line) {
+  std::ifstream is(path);
+  if (!is.is_open()) { return false; }
+  std::getline(is, *line);
+  return !line->empty();
+}
+
+// parses lists like "0-11,24-35"
+bool ParseIdList(const std::string& id_list, std::vector<int64_t>* ids) {
+  const char* pos = id_list.c_str();
+  while (*pos != '\0' && *pos != '\n') {
+    char* end = nullptr;
+    const int64_t first = std::strtoll(pos, &end, 10);
+    if (end == pos) { return false; }
+    int64_t last = first;
+    pos = end;
+    if (*pos == '-') {
+      last = std::strtoll(pos + 1, &end, 10);
+      if (end == pos + 1 || last < first) { return false; }
+      pos = end;
+    }
+    FOR_RANGE(int64_t, id, first, last + 1) { ids->push_back(id); }
+    if (*pos == ',') { ++pos; }
+  }
+  return !ids->empty();
+}
+
+std::string IdListToString(const std::vector<int64_t>& ids) {
+  std::string ret;
+  for (size_t i = 0; i < ids.size();) {
+    size_t j = i;
+    while (j + 1 < ids.size() && ids.at(j + 1) == ids.at(j) + 1) { ++j; }
+    if (!ret.empty()) { ret += ","; }
+    ret += std::to_string(ids.at(i));
+    if (j > i) { ret += "-" + std::to_string(ids.at(j)); }
+    i = j + 1;
+  }
+  return ret;
+}
+
+}  // namespace
+
+NumaTopology::NumaTopology() {
+  std::string node_list;
+  std::vector<int64_t> node_ids;
+  if (ReadFirstLine(kSysNodePath + "online", &node_list) && ParseIdList(node_list, &node_ids)) {
+    for (int64_t node_id : node_ids) {
+      std::string cpu_list;
+      std::vector<int64_t> cpus;
+      if (!ReadFirstLine(kSysNodePath + "node" + std::to_string(node_id) + "/cpulist", &cpu_list)
+          || !ParseIdList(cpu_list, &cpus)) {
+        node_ids_.clear();
+        node2cpus_.clear();
+        break;
+      }
+      node_ids_.push_back(node_id);
+      node2cpus_.push_back(cpus);
+    }
+  }
+  if (node2cpus_.empty()) {
+    node_ids_.push_back(0);
+    node2cpus_.emplace_back();
+    FOR_RANGE(int64_t, cpu, 0, std::thread::hardware_concurrency()) {
+      node2cpus_.back().push_back(cpu);
+    }
+  }
+}
+
+/*static*/ const NumaTopology& NumaTopology::Get() {
+  static const NumaTopology topology;
+  return topology;
+}
+
+int64_t NumaTopology::NumaNode4CpuDevice(int64_t index, int64_t num) const {
+  if (num <= 0) { return 0; }
+  return (index % num) * node_num() / num;
+}
+
+std::string NumaTopology::ToString(int64_t cpu_device_num) const {
+  std::string ret = "numa nodes: " + std::to_string(node_num());
+  FOR_RANGE(int64_t, node, 0, node_num()) {
+    ret += "\n  node " + std::to_string(node_ids_.at(node)) + ": "
+           + std::to_string(node2cpus_.at(node).size())
+           + " cpus, cpu list: " + IdListToString(node2cpus_.at(node));
+    std::vector<int64_t> cpu_devices;
+    FOR_RANGE(int64_t, i, 0, cpu_device_num) {
+      if (NumaNode4CpuDevice(i, cpu_device_num) == node) { cpu_devices.push_back(i); }
+    }
+    if (!cpu_devices.empty()) { ret += ", cpu devices: " + IdListToString(cpu_devices); }
+  }
+  return ret;
+}
+
+bool IsNumaAwareCpuActorEnabled() {
+  const auto* resource_desc = Global<ResourceDesc, ForSession>::Get();
+  if (resource_desc == nullptr || !resource_desc->enable_numa_aware_cpu_actor()) { return false; }
+  return NumaTopology::Get().node_num() > 1;
+}
+
+int64_t NumaNode4CpuThrdId(int64_t thrd_id) {
+  if (thrd_id < 0 || !IsNumaAwareCpuActorEnabled()) { return -1; }
+  const StreamId stream_id = DeserializeStreamIdFromInt64(thrd_id);
+  if (stream_id.device_id().device_type() != DeviceType::kCPU) { return -1; }
+  const int64_t compute_stream_num = Global<ResourceDesc, ForSession>::Get()->CpuDeviceNum();
+  if (stream_id.stream_index() >= compute_stream_num) { return -1; }
+  return NumaTopology::Get().NumaNode4CpuDevice(stream_id.stream_index(), compute_stream_num);
+}
+
+void NumaBindCurrentThread(int64_t node) {
+#ifdef OF_PLATFORM_POSIX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int64_t cpu : NumaTopology::Get().cpus4node(node)) { CPU_SET(cpu, &cpu_set); }
+  if (sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set) != 0) {
+    LOG(WARNING) << "failed to pin thread to numa node " << node;
+  }
+#else
+  UNIMPLEMENTED();
+#endif  // OF_PLATFORM_POSIX
+}
+
+bool NumaBindMemory(void* ptr, size_t size, int64_t node) {
+#if defined(OF_PLATFORM_POSIX) && defined(SYS_mbind)
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  const size_t begin = RoundUp(reinterpret_cast<size_t>(ptr), page_size);
+  const size_t end = (reinterpret_cast<size_t>(ptr) + size) / page_size * page_size;
+  if (end <= begin) { return true; }
+  const int64_t node_id = NumaTopology::Get().node_id(node);
+  constexpr int64_t kBitsPerLong = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> node_mask(node_id / kBitsPerLong + 1, 0);
+  node_mask.at(node_id / kBitsPerLong) |= 1UL << (node_id % kBitsPerLong);
+  // MPOL_BIND and MPOL_MF_MOVE of <numaif.h>, which comes with libnuma
+  constexpr int kMpolBind = 2;
+  constexpr unsigned kMpolMfMove = 1U << 1;
+  return syscall(SYS_mbind, begin, end - begin, kMpolBind, node_mask.data(),
+                 node_mask.size() * kBitsPerLong + 1, kMpolMfMove)
+         == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace oneflow
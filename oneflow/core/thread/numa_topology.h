@@ -0,0 +1,66 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_CORE_THREAD_NUMA_TOPOLOGY_H_
+#define ONEFLOW_CORE_THREAD_NUMA_TOPOLOGY_H_
+
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// NUMA nodes of this machine and their cpus, read from sysfs. A machine without NUMA information
+// is seen as a single node.
+//
+// When enable_numa_aware_cpu_actor is set, the cpu devices of a machine and its cpu compute
+// streams, which are as many as cpu devices, are partitioned into node_num() contiguous ranges:
+// the actor thread of a compute stream is pinned to the cpus of its node, and the host regst
+// memory produced on that thread is bound to the same node.
+class NumaTopology final {
+ public:
+  OF_DISALLOW_COPY_AND_MOVE(NumaTopology);
+  ~NumaTopology() = default;
+
+  static const NumaTopology& Get();
+
+  int64_t node_num() const { return node2cpus_.size(); }
+  // id of the `node`-th online node in sysfs
+  int64_t node_id(int64_t node) const { return node_ids_.at(node); }
+  const std::vector<int64_t>& cpus4node(int64_t node) const { return node2cpus_.at(node); }
+  // `index` is a cpu device id or a cpu compute stream index, in [0, `num`)
+  int64_t NumaNode4CpuDevice(int64_t index, int64_t num) const;
+  // also reports the cpu devices of each node when `cpu_device_num` > 0
+  std::string ToString(int64_t cpu_device_num) const;
+
+ private:
+  NumaTopology();
+
+  std::vector<int64_t> node_ids_;
+  std::vector<std::vector<int64_t>> node2cpus_;
+};
+
+bool IsNumaAwareCpuActorEnabled();
+
+// Returns the node of the cpu compute stream serialized in `thrd_id`, or -1 if `thrd_id` is not
+// such a stream or numa awareness is disabled.
+int64_t NumaNode4CpuThrdId(int64_t thrd_id);
+
+void NumaBindCurrentThread(int64_t node);
+
+// Moves the whole pages within [ptr, ptr + size) to `node`. Returns false on failure.
+bool NumaBindMemory(void* ptr, size_t size, int64_t node);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_CORE_THREAD_NUMA_TOPOLOGY_H_
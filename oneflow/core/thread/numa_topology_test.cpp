@@ -0,0 +1,47 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/thread/numa_topology.h"
+
+namespace oneflow {
+
+namespace test {
+
+TEST(NumaTopology, cpus_of_nodes) {
+  const NumaTopology& topology = NumaTopology::Get();
+  ASSERT_GE(topology.node_num(), 1);
+  FOR_RANGE(int64_t, node, 0, topology.node_num()) {
+    ASSERT_FALSE(topology.cpus4node(node).empty());
+  }
+}
+
+TEST(NumaTopology, partition_cpu_devices) {
+  const NumaTopology& topology = NumaTopology::Get();
+  const int64_t cpu_device_num = topology.node_num() * 3;
+  std::vector<int64_t> node2cpu_device_num(topology.node_num(), 0);
+  int64_t prev_node = 0;
+  FOR_RANGE(int64_t, i, 0, cpu_device_num) {
+    const int64_t node = topology.NumaNode4CpuDevice(i, cpu_device_num);
+    ASSERT_GE(node, prev_node);
+    ASSERT_LT(node, topology.node_num());
+    node2cpu_device_num.at(node) += 1;
+    prev_node = node;
+  }
+  for (int64_t num : node2cpu_device_num) { ASSERT_EQ(num, 3); }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
@@ -18,6 +18,7 @@ limitations under the License.
 #include "oneflow/core/job/global_for.h"
 #include "oneflow/core/thread/cpu_thread.h"
 #include "oneflow/core/thread/gpu_thread.h"
+#include "oneflow/core/thread/numa_topology.h"
 #include "oneflow/core/common/balanced_splitter.h"
 #include "oneflow/core/common/blocking_counter.h"
 #include "oneflow/core/control/global_process_ctx.h"
@@ -44,6 +45,10 @@ Thread* ThreadMgr::GetThrd(int64_t thrd_id) {
 
 ThreadMgr::ThreadMgr(const Plan& plan) {
   const int64_t this_rank = GlobalProcessCtx::Rank();
+  if (IsNumaAwareCpuActorEnabled()) {
+    LOG(INFO) << NumaTopology::Get().ToString(
+        Global<ResourceDesc, ForSession>::Get()->CpuDeviceNum());
+  }
   for (const TaskProto& task : plan.task()) {
     TaskId task_id = DeserializeTaskIdFromInt64(task.task_id());
     StreamId stream_id = task_id.stream_id();
@@ -15,15 +15,47 @@ limitations under the License.
 */
 #ifdef __linux__
 
+#include <sys/uio.h>
+#include <fstream>
+
+#include "oneflow/core/control/ctrl_client.h"
 #include "oneflow/core/control/global_process_ctx.h"
+#include "oneflow/core/job/global_for.h"
+#include "oneflow/core/job/resource_desc.h"
 #include "oneflow/core/transport/transport.h"
 
 namespace oneflow {
 
+namespace {
+
+// Processes with the same boot id and pid namespace can address each other by pid. Returns an
+// empty string if either is unknown.
+std::string GetHostIdentity() {
+  std::string boot_id;
+  std::ifstream boot_id_file("/proc/sys/kernel/random/boot_id");
+  if (!(boot_id_file >> boot_id)) { return ""; }
+  char pid_ns[256];
+  const ssize_t len = readlink("/proc/self/ns/pid", pid_ns, sizeof(pid_ns) - 1);
+  if (len <= 0) { return ""; }
+  return boot_id + "/" + std::string(pid_ns, len);
+}
+
+std::string HostIdentityKey(int64_t machine_id) {
+  return "TransportHostIdentity/" + std::to_string(machine_id);
+}
+
+}  // namespace
+
 Transport::Transport() {
   comm_net_ = Global<EpollCommNet>::Get();
   this_machine_id_ = GlobalProcessCtx::Rank();
   CHECK(comm_net_ != nullptr);
+  host_identity_ = GetHostIdentity();
+  is_cross_memory_attach_enabled_ =
+      Global<ResourceDesc, ForSession>::Get()->enable_transport_cross_memory_attach()
+      && !host_identity_.empty();
+  Global<CtrlClient>::Get()->PushKV(HostIdentityKey(this_machine_id_),
+                                    host_identity_ + ":" + std::to_string(getpid()));
   // maybe need new read id for each dst machine id, maybe need 2 * machine num read ids
   read_id_ = comm_net_->NewActorReadId();
   msg_poller_ = std::thread([this]() { PollMsgChannel(); });
@@ -113,6 +145,7 @@ void Transport::HandlerAchievedTransportSendMsgFromSrcMachine(const TransportMsg
     CHECK(stat->src_mem_token == nullptr);
     // src_mem_token MUST init in the block protected by lock
     stat->src_mem_token = msg.src_mem_token;
+    stat->src_ptr = msg.src_ptr;
   }
 
   if (recv_before_send) {
@@ -200,6 +233,7 @@ void Transport::Send(uint64_t token, int64_t dst_machine_id, const void* ptr, st
   msg.size = size;
   msg.src_mem_token = stat->src_mem_token;
   msg.dst_mem_token = stat->dst_mem_token;
+  msg.src_ptr = mut_ptr;
   msg.type = TransportMsgType::kSend;
   comm_net_->SendTransportMsg(msg.dst_machine_id, msg);
 }
@@ -275,33 +309,95 @@ void Transport::DoRead(uint64_t token) {
   CHECK(stat->dst_machine_id != -1);
   CHECK(stat->size != -1);
   CHECK(stat->callback);
+  if (TryReadFromLocalHostMachine(stat->src_machine_id, stat->src_ptr, stat->dst_ptr,
+                                  stat->size)) {
+    DoReadDone(token);
+    return;
+  }
   comm_net_->Read(read_id_, stat->src_machine_id, stat->src_mem_token, stat->dst_mem_token);
-  comm_net_->AddReadCallBack(read_id_, [stat, this]() {
-    // Send ack message to source machine
-    TransportMsg msg;
-    msg.token = stat->token;
-    msg.src_machine_id = stat->src_machine_id;
-    msg.dst_machine_id = stat->dst_machine_id;
-    msg.size = stat->size;
-    msg.src_mem_token = stat->src_mem_token;
-    msg.dst_mem_token = stat->dst_mem_token;
-    msg.type = TransportMsgType::kAck;
-    comm_net_->SendTransportMsg(msg.src_machine_id, msg);
-
-    // UnRegisterMemory
-    comm_net_->UnRegisterMemory(msg.dst_mem_token);
-
-    // Do Receive callback
-    stat->callback();
+  comm_net_->AddReadCallBack(read_id_, [token, this]() { DoReadDone(token); });
+}
 
-    // Recovery status
-    {
-      std::unique_lock<std::mutex> lock(status_mutex_);
-      auto it = token2status_.find(stat->token);
-      CHECK(it != token2status_.end());
-      token2status_.erase(it);
+void Transport::DoReadDone(uint64_t token) {
+  TransportStatus* stat = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(status_mutex_);
+    auto it = token2status_.find(token);
+    CHECK(it != token2status_.end());
+    stat = &(it->second);
+  }
+  // Send ack message to source machine
+  TransportMsg msg;
+  msg.token = stat->token;
+  msg.src_machine_id = stat->src_machine_id;
+  msg.dst_machine_id = stat->dst_machine_id;
+  msg.size = stat->size;
+  msg.src_mem_token = stat->src_mem_token;
+  msg.dst_mem_token = stat->dst_mem_token;
+  msg.src_ptr = stat->src_ptr;
+  msg.type = TransportMsgType::kAck;
+  comm_net_->SendTransportMsg(msg.src_machine_id, msg);
+
+  // UnRegisterMemory
+  comm_net_->UnRegisterMemory(msg.dst_mem_token);
+
+  // Do Receive callback
+  stat->callback();
+
+  // Recovery status
+  {
+    std::unique_lock<std::mutex> lock(status_mutex_);
+    auto it = token2status_.find(token);
+    CHECK(it != token2status_.end());
+    token2status_.erase(it);
+  }
+}
+
+int64_t Transport::Pid4LocalHostMachineId(int64_t machine_id) {
+  std::unique_lock<std::mutex> lock(local_host_pid_mutex_);
+  auto it = machine_id2local_host_pid_.find(machine_id);
+  if (it == machine_id2local_host_pid_.end()) {
+    std::string identity;
+    Global<CtrlClient>::Get()->PullKV(HostIdentityKey(machine_id), &identity);
+    const size_t pos = identity.rfind(':');
+    CHECK_NE(pos, std::string::npos);
+    int64_t pid = -1;
+    if (pos > 0 && identity.substr(0, pos) == host_identity_) {
+      pid = std::stoll(identity.substr(pos + 1));
+    }
+    it = machine_id2local_host_pid_.emplace(machine_id, pid).first;
+  }
+  return it->second;
+}
+
+bool Transport::TryReadFromLocalHostMachine(int64_t src_machine_id, const void* src_ptr,
+                                            void* dst_ptr, std::size_t size) {
+  if (!is_cross_memory_attach_enabled_ || src_ptr == nullptr) { return false; }
+  const int64_t pid = Pid4LocalHostMachineId(src_machine_id);
+  if (pid == -1) { return false; }
+  std::size_t read_size = 0;
+  while (read_size < size) {
+    struct iovec local_iov;
+    local_iov.iov_base = static_cast<char*>(dst_ptr) + read_size;
+    local_iov.iov_len = size - read_size;
+    struct iovec remote_iov;
+    remote_iov.iov_base = const_cast<char*>(static_cast<const char*>(src_ptr)) + read_size;
+    remote_iov.iov_len = size - read_size;
+    const ssize_t n = process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
+    if (n <= 0) {
+      if (errno == EPERM || errno == ENOSYS) {
+        // e.g. restricted by ptrace_scope of Yama, which will not change while running
+        PLOG(WARNING) << "process_vm_readv from machine " << src_machine_id
+                      << " not permitted, Transport falls back to CommNet";
+        is_cross_memory_attach_enabled_ = false;
+      } else {
+        PLOG(WARNING) << "process_vm_readv from machine " << src_machine_id << " failed";
+      }
+      return false;
     }
-  });
+    read_size += n;
+  }
+  return true;
 }
 
 void Transport::SendToLocalMachine(uint64_t token, void* ptr, std::size_t size,
@@ -42,6 +42,10 @@ namespace oneflow {
 //
 // Transport supports send and receive data on local machine.
 //
+// When the two machines are processes of the same host, the dst machine reads the data from the
+// address space of the src machine with process_vm_readv, a single copy without the sockets of
+// CommNet. It falls back to CommNet if the kernel does not permit that.
+//
 class Transport {
  public:
   OF_DISALLOW_COPY_AND_MOVE(Transport);
@@ -58,6 +62,11 @@ class Transport {
   void HandlerAchievedTransportSendMsgFromSrcMachine(const TransportMsg& msg);
   void HandlerAchievedTransportAckMsgFromDstMachine(const TransportMsg& msg);
   void DoRead(uint64_t token);
+  void DoReadDone(uint64_t token);
+  // Returns -1 if `machine_id` is not a process of this host
+  int64_t Pid4LocalHostMachineId(int64_t machine_id);
+  bool TryReadFromLocalHostMachine(int64_t src_machine_id, const void* src_ptr, void* dst_ptr,
+                                   std::size_t size);
   void SendToLocalMachine(uint64_t token, void* ptr, std::size_t size,
                           std::function<void()> callback);
   void RecvFromLocalMachine(uint64_t token, void* ptr, std::size_t max_size,
@@ -82,6 +91,7 @@ class Transport {
     bool is_recv_ready;
     void* src_mem_token;
     void* dst_mem_token;
+    void* src_ptr;
     // NOTE(chengcheng): must store dst_ptr in status when Receive max_size > Send size
     void* dst_ptr;
     std::size_t size;
@@ -94,6 +104,7 @@ class Transport {
           is_recv_ready(false),
           src_mem_token(nullptr),
           dst_mem_token(nullptr),
+          src_ptr(nullptr),
           size(-1),
           src_machine_id(-1),
           dst_machine_id(-1) {}
@@ -126,6 +137,12 @@ class Transport {
   std::mutex local_copy_lock_;
   HashMap<uint64_t, CopyStatusOnLocalMachine> token2local_copy_status_;
 
+  // for reading from other processes of this host
+  std::atomic<bool> is_cross_memory_attach_enabled_;
+  std::string host_identity_;
+  std::mutex local_host_pid_mutex_;
+  HashMap<int64_t, int64_t> machine_id2local_host_pid_;
+
   int64_t this_machine_id_;
   void* read_id_;
   EpollCommNet* comm_net_;
@@ -33,6 +33,8 @@ struct TransportMsg {
   uint64_t token;
   void* src_mem_token;
   void* dst_mem_token;
+  // address of the sent data in the source process, read directly by a dst on the same host
+  void* src_ptr;
   std::size_t size;
   int64_t src_machine_id;
   int64_t dst_machine_id;
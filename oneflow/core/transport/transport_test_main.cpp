@@ -290,19 +290,7 @@ void TestThroughput() {
   std::cout << "Test for throughput. Done.\n\n";
 }
 
-Maybe<void> TestTransportOn2Machine(const std::string& first_machine_ip,
-                                    const std::string& second_machine_ip, int32_t ctrl_port) {
-  EnvProto env_proto = GetEnvProto(first_machine_ip, second_machine_ip, ctrl_port);
-  Global<EnvDesc>::New(env_proto);
-  Global<CtrlServer>::New();
-  Global<ProcessCtx>::New();
-  JUST(HostListCtrlBootstrap(*Global<EnvDesc>::Get())
-           .InitProcessCtx(Global<CtrlServer>::Get()->port(), Global<ProcessCtx>::Get()));
-  auto* client = new GrpcCtrlClient(*Global<ProcessCtx>::Get());
-  Global<CtrlClient>::SetAllocated(client);
-  Global<ResourceDesc, ForEnv>::New(GetResource(), GlobalProcessCtx::NumOfProcessPerNode());
-  Global<ResourceDesc, ForSession>::New(GetResource(), GlobalProcessCtx::NumOfProcessPerNode());
-
+void TestTransportWithGlobals() {
   // do transport test
   // The Global<EpollCommNet> must new first before Global<Transport> new.
   std::cout << "New All Global" << std::endl;
@@ -333,6 +321,45 @@ Maybe<void> TestTransportOn2Machine(const std::string& first_machine_ip,
   Global<CtrlServer>::Delete();
   Global<EnvDesc>::Delete();
   std::cout << "All Done!" << std::endl;
+}
+
+Maybe<void> TestTransportOn2Machine(const std::string& first_machine_ip,
+                                    const std::string& second_machine_ip, int32_t ctrl_port) {
+  EnvProto env_proto = GetEnvProto(first_machine_ip, second_machine_ip, ctrl_port);
+  Global<EnvDesc>::New(env_proto);
+  Global<CtrlServer>::New();
+  Global<ProcessCtx>::New();
+  JUST(HostListCtrlBootstrap(*Global<EnvDesc>::Get())
+           .InitProcessCtx(Global<CtrlServer>::Get()->port(), Global<ProcessCtx>::Get()));
+  auto* client = new GrpcCtrlClient(*Global<ProcessCtx>::Get());
+  Global<CtrlClient>::SetAllocated(client);
+  Global<ResourceDesc, ForEnv>::New(GetResource(), GlobalProcessCtx::NumOfProcessPerNode());
+  Global<ResourceDesc, ForSession>::New(GetResource(), GlobalProcessCtx::NumOfProcessPerNode());
+  TestTransportWithGlobals();
+  return Maybe<void>::Ok();
+}
+
+// Both machines are processes of this host, so that the dst machine reads the data sent by the
+// src machine with process_vm_readv.
+Maybe<void> TestTransportOn2LocalProcess(int64_t rank, int32_t ctrl_port) {
+  EnvProto env_proto;
+  env_proto.set_ctrl_port(ctrl_port);
+  BootstrapConf* bootstrap_conf = env_proto.mutable_ctrl_bootstrap_conf();
+  bootstrap_conf->mutable_master_addr()->set_host("127.0.0.1");
+  bootstrap_conf->mutable_master_addr()->set_port(ctrl_port);
+  bootstrap_conf->set_rank(rank);
+  bootstrap_conf->set_world_size(2);
+  bootstrap_conf->set_node_size(1);
+  Global<EnvDesc>::New(env_proto);
+  Global<CtrlServer>::New(0);
+  Global<ProcessCtx>::New();
+  JUST(RankInfoCtrlBootstrap(env_proto.ctrl_bootstrap_conf())
+           .InitProcessCtx(Global<CtrlServer>::Get()->port(), Global<ProcessCtx>::Get()));
+  auto* client = new GrpcCtrlClient(*Global<ProcessCtx>::Get());
+  Global<CtrlClient>::SetAllocated(client);
+  Global<ResourceDesc, ForEnv>::New(GetResource(), GlobalProcessCtx::NumOfProcessPerNode());
+  Global<ResourceDesc, ForSession>::New(GetResource(), GlobalProcessCtx::NumOfProcessPerNode());
+  TestTransportWithGlobals();
   return Maybe<void>::Ok();
 }
 
@@ -344,15 +371,23 @@ Maybe<void> TestTransportOn2Machine(const std::string& first_machine_ip,
  * Try run this test exe by :
  *     ./oneflow_test_transport first_machine_ip="192.168.1.15" \
  *          second_machine_ip = "192.168.1.16" ctrl_port=12143
+ * or, for two processes of one host, run both of
+ *     ./oneflow_test_transport local_process_rank=0 ctrl_port=12143
+ *     ./oneflow_test_transport local_process_rank=1 ctrl_port=12143
  */
 DEFINE_string(first_machine_ip, "192.168.1.15", "IP address for first machine.");
 DEFINE_string(second_machine_ip, "192.168.1.16", "IP address for second machine.");
 DEFINE_int32(ctrl_port, 12143, "the control port for init CtrlServer/Client.");
+DEFINE_int64(local_process_rank, -1, "rank of this process when testing two local processes.");
 
 int main(int argc, char* argv[]) {
   using namespace oneflow;
   gflags::ParseCommandLineFlags(&argc, &argv, true);
-  CHECK_JUST(
-      TestTransportOn2Machine(FLAGS_first_machine_ip, FLAGS_second_machine_ip, FLAGS_ctrl_port));
+  if (FLAGS_local_process_rank >= 0) {
+    CHECK_JUST(TestTransportOn2LocalProcess(FLAGS_local_process_rank, FLAGS_ctrl_port));
+  } else {
+    CHECK_JUST(
+        TestTransportOn2Machine(FLAGS_first_machine_ip, FLAGS_second_machine_ip, FLAGS_ctrl_port));
+  }
   return 0;
 }
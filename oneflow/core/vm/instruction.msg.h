@@ -85,6 +85,9 @@ OBJECT_MSG_BEGIN(InstructionMsg);
   OBJECT_MSG_DEFINE_STRUCT(std::shared_ptr<const ParallelDesc>, parallel_desc);
   OBJECT_MSG_DEFINE_OPTIONAL(InstructionOperandList, operand_list);
   OBJECT_MSG_DEFINE_STRUCT(std::shared_ptr<PhyInstrOperand>, phy_instr_operand);
+  // instructions received in the same batch that this one depends on, connected by the vm
+  // without consuming mirrored objects. Used by replayed instructions captures.
+  OBJECT_MSG_DEFINE_STRUCT(std::vector<const InstructionMsg*>, pre_resolved_src_instr_msgs);
 
 
   // links
@@ -501,6 +501,31 @@ void VirtualMachine::ConsumeMirroredObjects(Id2LogicalObject* id2logical_object,
   }
 }
 
+void VirtualMachine::ConnectPreResolvedInstructions(NewInstructionList* new_instruction_list) {
+  bool has_pre_resolved_edges = false;
+  OBJECT_MSG_LIST_FOR_EACH_PTR(new_instruction_list, instruction) {
+    if (!instruction->instr_msg().pre_resolved_src_instr_msgs().empty()) {
+      has_pre_resolved_edges = true;
+      break;
+    }
+  }
+  if (!has_pre_resolved_edges) { return; }
+  // nullptr for instruction messages instantiated on more than one stream
+  HashMap<const InstructionMsg*, Instruction*> instr_msg2instruction;
+  OBJECT_MSG_LIST_FOR_EACH_PTR(new_instruction_list, instruction) {
+    for (const InstructionMsg* src_instr_msg :
+         instruction->instr_msg().pre_resolved_src_instr_msgs()) {
+      const auto& iter = instr_msg2instruction.find(src_instr_msg);
+      CHECK(iter != instr_msg2instruction.end())
+          << "pre-resolved source instruction is not received in the same batch";
+      CHECK_NOTNULL(iter->second);
+      ConnectInstruction(iter->second, instruction);
+    }
+    const auto& pair = instr_msg2instruction.emplace(&instruction->instr_msg(), instruction);
+    if (!pair.second) { pair.first->second = nullptr; }
+  }
+}
+
 void VirtualMachine::FilterReadyInstructions(NewInstructionList* new_instruction_list,
                                              /*out*/ ReadyInstructionList* ready_instruction_list) {
   OBJECT_MSG_LIST_FOR_EACH_PTR(new_instruction_list, instruction) {
@@ -651,6 +676,7 @@ void VirtualMachine::Schedule() {
     FilterAndRunInstructionsInAdvance(&tmp_pending_msg_list);
     NewInstructionList new_instruction_list;
     MakeInstructions(&tmp_pending_msg_list, /*out*/ &new_instruction_list);
+    ConnectPreResolvedInstructions(&new_instruction_list);
     ConsumeMirroredObjects(mut_id2logical_object(), &new_instruction_list);
     FilterReadyInstructions(&new_instruction_list, /*out*/ ready_instruction_list);
     new_instruction_list.MoveTo(waiting_instruction_list);
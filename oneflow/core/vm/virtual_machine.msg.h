@@ -127,6 +127,7 @@ OBJECT_MSG_BEGIN(VirtualMachine);
                              Instruction* instrution);
   void ConsumeMirroredObjects(Id2LogicalObject* id2logical_object,
                               NewInstructionList* new_instruction_list);
+  void ConnectPreResolvedInstructions(NewInstructionList* new_instruction_list);
   void FilterReadyInstructions(NewInstructionList* new_instruction_list,
                          /*out*/ ReadyInstructionList* ready_instruction_list);
   void DispatchAndPrescheduleInstructions(ReadyInstructionList* ready_instruction_list);
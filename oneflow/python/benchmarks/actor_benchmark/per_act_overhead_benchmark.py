@@ -0,0 +1,62 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+parser = argparse.ArgumentParser(description="per act overhead of actors benchmark")
+parser.add_argument("--op_num", type=int, default=200)
+parser.add_argument("--inputs_per_op", type=int, default=4)
+parser.add_argument("--iter_num", type=int, default=200)
+args = parser.parse_args()
+
+
+def main():
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+
+    # tiny blobs make kernel compute negligible, so the time is mostly per act overhead:
+    # message handling, regst bookkeeping and binding blobs to kernels
+    @flow.global_function(function_config=func_config)
+    def chain_job(x: oft.Numpy.Placeholder((1,))):
+        with flow.scope.placement("cpu", "0:0"):
+            blobs = [x] * args.inputs_per_op
+            for _ in range(args.op_num):
+                y = flow.math.add_n(blobs)
+                blobs = blobs[1:] + [y]
+            return blobs[-1]
+
+    x = np.ones((1,), dtype=np.float32)
+    # warm up
+    chain_job(x).get()
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        chain_job(x).async_get(lambda _: None)
+    chain_job(x).get()
+    elapsed = (time.perf_counter() - start) / (args.iter_num + 1)
+    print(
+        "{} ops with {} inputs: {:.3f} ms/iter, {:.2f} us/act".format(
+            args.op_num, args.inputs_per_op, elapsed * 1000, elapsed * 1e6 / args.op_num
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,93 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as tp
+
+parser = argparse.ArgumentParser(description="cpu bfloat16 mixed precision benchmark")
+parser.add_argument("--batch_size", type=int, default=256)
+parser.add_argument("--hidden_size", type=int, default=1024)
+parser.add_argument("--num_layers", type=int, default=4)
+parser.add_argument("--iter_num", type=int, default=50)
+parser.add_argument(
+    "--job_type", type=str, default="train", choices=["train", "predict"]
+)
+args = parser.parse_args()
+
+
+def make_job(enable_amp):
+    flow.clear_default_session()
+    config = flow.function_config()
+    config.default_data_type(flow.float32)
+    if enable_amp:
+        config.enable_auto_mixed_precision(True)
+        config.mixed_precision_data_type(flow.bfloat16)
+    shape = (args.batch_size, args.hidden_size)
+
+    @flow.global_function(type=args.job_type, function_config=config)
+    def mlp_job(x: tp.Numpy.Placeholder(shape)) -> tp.Numpy:
+        with flow.scope.placement("cpu", "0:0"):
+            for i in range(args.num_layers):
+                w = flow.get_variable(
+                    "w{}".format(i),
+                    shape=(args.hidden_size, args.hidden_size),
+                    initializer=flow.random_normal_initializer(stddev=0.02),
+                )
+                b = flow.get_variable(
+                    "b{}".format(i),
+                    shape=(args.hidden_size,),
+                    initializer=flow.zeros_initializer(),
+                )
+                x = flow.math.gelu(flow.nn.bias_add(flow.matmul(x, w), b))
+            out = flow.math.reduce_sum(x, axis=[1])
+            if args.job_type == "train":
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [1e-4]), momentum=0
+                ).minimize(flow.math.reduce_mean(out))
+            return out
+
+    return mlp_job
+
+
+def run(job, x):
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        job(x)
+    return time.perf_counter() - start
+
+
+def main():
+    x = np.random.randn(args.batch_size, args.hidden_size).astype(np.float32)
+    times = []
+    for enable_amp in (False, True):
+        job = make_job(enable_amp)
+        # warm up allocators
+        job(x)
+        times.append(run(job, x))
+    float_time, bfloat16_time = times
+    print("float32:  {:.3f} ms/iter".format(float_time * 1000 / args.iter_num))
+    print(
+        "bfloat16: {:.3f} ms/iter, speedup {:.2f}x".format(
+            bfloat16_time * 1000 / args.iter_num, float_time / bfloat16_time
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
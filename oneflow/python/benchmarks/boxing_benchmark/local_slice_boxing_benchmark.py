@@ -0,0 +1,76 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+parser = argparse.ArgumentParser(
+    description="cpu slice boxing copy throughput benchmark"
+)
+parser.add_argument("--cpu_device_num", type=int, default=4)
+parser.add_argument("--iter_num", type=int, default=20)
+args = parser.parse_args()
+
+# (shape, src split axis, dst split axis) of typical slice boxing between cpu devices
+CASES = [
+    ((4096, 8192), 0, 1),
+    ((8192, 4096), 1, 0),
+    ((64, 256, 56, 56), 0, 1),
+    ((32, 512, 28, 28), 1, 2),
+    ((16, 128, 64, 64), 3, 0),
+]
+
+
+def run_case(shape, src_axis, dst_axis):
+    flow.clear_default_session()
+    flow.config.cpu_device_num(args.cpu_device_num)
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+    device_ids = "0:0-{}".format(args.cpu_device_num - 1)
+
+    @flow.global_function(function_config=func_config)
+    def boxing_job(x: oft.Numpy.Placeholder(shape)):
+        with flow.scope.placement("cpu", device_ids):
+            src = flow.identity(x.with_distribute(flow.distribute.split(src_axis)))
+            dst = flow.identity(src.with_distribute(flow.distribute.split(dst_axis)))
+            return flow.math.reduce_sum(dst)
+
+    x = np.random.uniform(-1, 1, shape).astype(np.float32)
+    # warm up
+    boxing_job(x).get()
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        boxing_job(x).async_get(lambda _: None)
+    boxing_job(x).get()
+    elapsed = (time.perf_counter() - start) / (args.iter_num + 1)
+    print(
+        "shape {} split({}) -> split({}): {:.3f} ms/iter, {:.2f} GB/s".format(
+            shape, src_axis, dst_axis, elapsed * 1000, x.nbytes / elapsed / 1e9
+        )
+    )
+
+
+def main():
+    for shape, src_axis, dst_axis in CASES:
+        run_case(shape, src_axis, dst_axis)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+parser = argparse.ArgumentParser(description="cross machine slice boxing benchmark")
+parser.add_argument(
+    "--node_list", type=str, required=True, help="e.g. 192.168.1.1,192.168.1.2"
+)
+parser.add_argument("--cpu_device_num", type=int, default=4)
+parser.add_argument("--chunk_mbyte", type=int, default=0, help="0 to disable chunking")
+parser.add_argument(
+    "--src_sbp", type=str, default="partial_sum", choices=["split", "partial_sum"]
+)
+parser.add_argument("--dst_axis", type=int, default=1)
+parser.add_argument("--rows", type=int, default=4096)
+parser.add_argument("--cols", type=int, default=8192)
+parser.add_argument("--iter_num", type=int, default=50)
+args = parser.parse_args()
+
+
+def main():
+    nodes = [{"addr": addr} for addr in args.node_list.strip().split(",")]
+    assert len(nodes) == 2
+    flow.env.machine(nodes)
+    flow.config.cpu_device_num(args.cpu_device_num)
+    flow.config.slice_boxing_chunk_mbyte(args.chunk_mbyte)
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+    device_ids = "0-{}".format(args.cpu_device_num - 1)
+    shape = (args.cpu_device_num, args.rows, args.cols)
+
+    @flow.global_function(function_config=func_config)
+    def boxing_job(x: oft.Numpy.Placeholder(shape)):
+        with flow.scope.placement("cpu", "0:" + device_ids):
+            src = flow.identity(x.with_distribute(flow.distribute.split(0)))
+            if args.src_sbp == "partial_sum":
+                src = flow.math.reduce_sum(src, axis=0)
+        with flow.scope.placement("cpu", "1:" + device_ids):
+            dst = flow.identity(
+                src.with_distribute(flow.distribute.split(args.dst_axis))
+            )
+            return flow.math.reduce_sum(dst)
+
+    x = np.random.uniform(-1, 1, shape).astype(np.float32)
+    # warm up
+    boxing_job(x).get()
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        boxing_job(x).async_get(lambda _: None)
+    boxing_job(x).get()
+    elapsed = time.perf_counter() - start
+    print(
+        "src_sbp {}, chunk {} MB: {:.3f} ms/iter".format(
+            args.src_sbp, args.chunk_mbyte, elapsed * 1000 / (args.iter_num + 1)
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
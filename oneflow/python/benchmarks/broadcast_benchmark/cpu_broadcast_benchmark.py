@@ -0,0 +1,77 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+parser = argparse.ArgumentParser(description="cpu broadcast binary benchmark")
+parser.add_argument("--iter_num", type=int, default=20)
+args = parser.parse_args()
+
+# (name, x shape, broadcast operand shape, op)
+CASES = [
+    ("bias_add NC", (256, 4096), (4096,), "bias_add"),
+    ("bias_add NCHW", (32, 64, 56, 56), (64,), "bias_add"),
+    ("row", (1024, 4096), (1, 4096), "add"),
+    ("column", (1024, 4096), (1024, 1), "mul"),
+    ("scalar", (1024, 4096), (1, 1), "mul"),
+    ("attention mask", (16, 16, 128, 128), (16, 1, 1, 128), "add"),
+]
+
+
+def make_job(x_shape, b_shape, op):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+
+    @flow.global_function(function_config=func_config)
+    def broadcast_job(
+        x: oft.Numpy.Placeholder(x_shape), b: oft.Numpy.Placeholder(b_shape)
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            if op == "bias_add":
+                return flow.nn.bias_add(x, b)
+            elif op == "add":
+                return flow.math.add(x, b)
+            else:
+                return flow.math.multiply(x, b)
+
+    return broadcast_job
+
+
+def main():
+    for name, x_shape, b_shape, op in CASES:
+        job = make_job(x_shape, b_shape, op)
+        x = np.random.uniform(-1, 1, x_shape).astype(np.float32)
+        b = np.random.uniform(-1, 1, b_shape).astype(np.float32)
+        # warm up
+        job(x, b).get()
+        start = time.perf_counter()
+        for _ in range(args.iter_num):
+            job(x, b).get()
+        elapsed = (time.perf_counter() - start) / args.iter_num
+        print(
+            "{} {} {} {}: {:.3f} ms/iter, {:.2f} GB/s".format(
+                name, x_shape, op, b_shape, elapsed * 1000, 2 * x.nbytes / elapsed / 1e9
+            )
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import os
+import struct
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.core.record.record_pb2 as record_pb
+
+from ofrecord_to_columnar import convert
+
+parser = argparse.ArgumentParser(description="columnar data loader benchmark")
+parser.add_argument("--data_dir", type=str, default="./columnar_benchmark_data")
+parser.add_argument("--num_rows", type=int, default=1 << 17)
+parser.add_argument("--num_parts", type=int, default=4)
+parser.add_argument("--num_dense_columns", type=int, default=448)
+parser.add_argument("--num_sparse_columns", type=int, default=64)
+parser.add_argument("--max_sparse_length", type=int, default=8)
+parser.add_argument("--num_selected_dense_columns", type=int, default=16)
+parser.add_argument("--num_selected_sparse_columns", type=int, default=8)
+parser.add_argument("--compression", type=str, default="zlib", choices=["none", "zlib"])
+parser.add_argument("--batch_size", type=int, default=4096)
+parser.add_argument("--iter_num", type=int, default=100)
+args = parser.parse_args()
+
+
+def dense_name(i):
+    return "dense_{}".format(i)
+
+
+def sparse_name(i):
+    return "sparse_{}".format(i)
+
+
+def write_ofrecords(ofrecord_dir):
+    """Writes a click-through rate table of single value dense and varying length sparse columns."""
+    if not os.path.exists(ofrecord_dir):
+        os.makedirs(ofrecord_dir)
+    rows_per_part = args.num_rows // args.num_parts
+    for part in range(args.num_parts):
+        dense = np.random.rand(rows_per_part, args.num_dense_columns).astype(np.float32)
+        lengths = np.random.randint(
+            0, args.max_sparse_length + 1, (rows_per_part, args.num_sparse_columns)
+        )
+        path = os.path.join(ofrecord_dir, "part-{:05d}".format(part))
+        with open(path, "wb") as f:
+            for row in range(rows_per_part):
+                record = record_pb.OFRecord()
+                for i in range(args.num_dense_columns):
+                    record.feature[dense_name(i)].float_list.value.append(dense[row, i])
+                for i in range(args.num_sparse_columns):
+                    record.feature[sparse_name(i)].int64_list.value.extend(
+                        np.random.randint(0, 1 << 40, lengths[row, i]).tolist()
+                    )
+                serialized = record.SerializeToString()
+                f.write(struct.pack("q", len(serialized)) + serialized)
+
+
+def selected_columns():
+    dense_stride = args.num_dense_columns // args.num_selected_dense_columns
+    sparse_stride = args.num_sparse_columns // args.num_selected_sparse_columns
+    dense = [
+        dense_name(i * dense_stride) for i in range(args.num_selected_dense_columns)
+    ]
+    sparse = [
+        sparse_name(i * sparse_stride) for i in range(args.num_selected_sparse_columns)
+    ]
+    return dense, sparse
+
+
+def make_ofrecord_job(ofrecord_dir):
+    flow.clear_default_session()
+    dense, sparse = selected_columns()
+
+    @flow.global_function()
+    def ofrecord_job():
+        with flow.scope.placement("cpu", "0:0"):
+            ofrecord = flow.data.ofrecord_reader(
+                ofrecord_dir,
+                batch_size=args.batch_size,
+                data_part_num=args.num_parts,
+                part_name_suffix_length=5,
+            )
+            blobs = [
+                flow.data.OFRecordRawDecoder(ofrecord, name, (1,), flow.float)
+                for name in dense
+            ]
+            blobs += [
+                flow.data.OFRecordRawDecoder(
+                    ofrecord,
+                    name,
+                    (args.max_sparse_length,),
+                    flow.int64,
+                    dim1_varying_length=True,
+                    auto_zero_padding=True,
+                )
+                for name in sparse
+            ]
+            return blobs
+
+    return ofrecord_job
+
+
+def make_columnar_job(columnar_files):
+    flow.clear_default_session()
+    dense, sparse = selected_columns()
+
+    @flow.global_function()
+    def columnar_job():
+        with flow.scope.placement("cpu", "0:0"):
+            return flow.data.columnar_data_loader(
+                columnar_files,
+                dense + sparse,
+                [1] * len(dense) + [args.max_sparse_length] * len(sparse),
+                [flow.float] * len(dense) + [flow.int64] * len(sparse),
+                args.batch_size,
+            )
+
+    return columnar_job
+
+
+def run(job):
+    # warm up
+    job().get()
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        job().get()
+    return args.batch_size * args.iter_num / (time.perf_counter() - start)
+
+
+def main():
+    ofrecord_dir = os.path.join(args.data_dir, "ofrecord")
+    if not os.path.exists(ofrecord_dir):
+        write_ofrecords(ofrecord_dir)
+    ofrecord_files = sorted(
+        os.path.join(ofrecord_dir, f) for f in os.listdir(ofrecord_dir)
+    )
+    start = time.perf_counter()
+    _, columnar_files = convert(
+        ofrecord_files,
+        os.path.join(args.data_dir, "columnar"),
+        compression=args.compression,
+    )
+    print("converted in {:.1f} s".format(time.perf_counter() - start))
+    ofrecord_rows_per_sec = run(make_ofrecord_job(ofrecord_dir))
+    columnar_rows_per_sec = run(make_columnar_job(columnar_files))
+    print(
+        "reading {} of {} columns".format(
+            args.num_selected_dense_columns + args.num_selected_sparse_columns,
+            args.num_dense_columns + args.num_sparse_columns,
+        )
+    )
+    print("ofrecord: {:.0f} rows/s".format(ofrecord_rows_per_sec))
+    print(
+        "columnar: {:.0f} rows/s, speedup {:.2f}x".format(
+            columnar_rows_per_sec, columnar_rows_per_sec / ofrecord_rows_per_sec
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
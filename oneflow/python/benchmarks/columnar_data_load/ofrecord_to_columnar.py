@@ -0,0 +1,217 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+"""Converts OFRecord part files into columnar files read by flow.data.columnar_data_loader.
+
+Each part file becomes one columnar file. A feature becomes a fixed length column if it has the
+same number of values in all records of all part files, otherwise a varying length column. A
+bytes feature must hold exactly one value per record and becomes a varying length int8 column.
+The file layout is documented in oneflow/user/data/columnar_dataset.h.
+"""
+import argparse
+import os
+import struct
+import zlib
+
+import numpy as np
+import oneflow.core.common.data_type_pb2 as data_type_util
+import oneflow.core.record.record_pb2 as record_pb
+
+MAGIC_CODE = b"OFCOLUMN"
+VERSION = 1
+CHUNK_ALIGNMENT = 64
+NO_COMPRESSION = 0
+ZLIB_COMPRESSION = 1
+
+# feature kind -> (DataType, numpy dtype)
+KIND2DTYPE = {
+    "bytes_list": (data_type_util.kInt8, np.int8),
+    "float_list": (data_type_util.kFloat, np.float32),
+    "double_list": (data_type_util.kDouble, np.float64),
+    "int32_list": (data_type_util.kInt32, np.int32),
+    "int64_list": (data_type_util.kInt64, np.int64),
+}
+
+
+class Column(object):
+    def __init__(self, name, kind, row_length):
+        self.name = name
+        self.kind = kind
+        self.data_type, self.np_dtype = KIND2DTYPE[kind]
+        # 0 if rows vary in length
+        self.row_length = row_length
+
+    def values(self, record):
+        if self.name not in record.feature:
+            raise ValueError("feature {} is missing in a record".format(self.name))
+        feature = record.feature[self.name]
+        kind = feature.WhichOneof("kind")
+        if kind != self.kind:
+            raise ValueError(
+                "feature {} is both {} and {}".format(self.name, self.kind, kind)
+            )
+        if kind == "bytes_list":
+            if len(feature.bytes_list.value) != 1:
+                raise ValueError(
+                    "bytes feature {} should have exactly one value".format(self.name)
+                )
+            return np.frombuffer(feature.bytes_list.value[0], dtype=np.int8)
+        return np.asarray(getattr(feature, kind).value, dtype=self.np_dtype)
+
+
+def read_ofrecords(path):
+    with open(path, "rb") as f:
+        while True:
+            length = f.read(8)
+            if len(length) < 8:
+                return
+            record = record_pb.OFRecord()
+            record.ParseFromString(f.read(struct.unpack("q", length)[0]))
+            yield record
+
+
+def infer_columns(paths, names=None):
+    name2kind = {}
+    name2lengths = {}
+    for path in paths:
+        for record in read_ofrecords(path):
+            for name in names or record.feature.keys():
+                if name not in record.feature:
+                    raise ValueError("feature {} is missing in a record".format(name))
+                kind = record.feature[name].WhichOneof("kind")
+                if name2kind.setdefault(name, kind) != kind:
+                    raise ValueError(
+                        "feature {} is both {} and {}".format(
+                            name, name2kind[name], kind
+                        )
+                    )
+                length = len(getattr(record.feature[name], kind).value)
+                name2lengths.setdefault(name, set()).add(length)
+    columns = []
+    for name in names or sorted(name2kind.keys()):
+        lengths = name2lengths[name]
+        fixed = len(lengths) == 1 and name2kind[name] != "bytes_list"
+        columns.append(Column(name, name2kind[name], lengths.pop() if fixed else 0))
+    return columns
+
+
+class ColumnarWriter(object):
+    def __init__(self, path, columns, compression):
+        self.columns_ = columns
+        self.compression_ = compression
+        self.file_ = open(path, "wb")
+        self.file_.write(MAGIC_CODE)
+        self.offset_ = len(MAGIC_CODE)
+        self.row_group_num_rows_ = []
+        # (offset, stored size, raw size) of the chunks of each column
+        self.column2chunks_ = [[] for _ in columns]
+
+    def write_row_group(self, records):
+        for column, chunks in zip(self.columns_, self.column2chunks_):
+            rows = [column.values(record) for record in records]
+            if column.row_length > 0:
+                if any(len(row) != column.row_length for row in rows):
+                    raise ValueError("rows of {} vary in length".format(column.name))
+                raw = np.concatenate(rows).astype(column.np_dtype).tobytes()
+            else:
+                offsets = np.zeros(len(rows) + 1, dtype=np.int64)
+                np.cumsum([len(row) for row in rows], out=offsets[1:])
+                values = np.concatenate(rows).astype(column.np_dtype)
+                raw = offsets.tobytes() + values.tobytes()
+            stored = (
+                zlib.compress(raw) if self.compression_ == ZLIB_COMPRESSION else raw
+            )
+            padding = -self.offset_ % CHUNK_ALIGNMENT
+            self.file_.write(b"\0" * padding)
+            self.offset_ += padding
+            chunks.append((self.offset_, len(stored), len(raw)))
+            self.file_.write(stored)
+            self.offset_ += len(stored)
+        self.row_group_num_rows_.append(len(records))
+
+    def close(self):
+        footer = [struct.pack("<QQ", VERSION, len(self.row_group_num_rows_))]
+        footer += [struct.pack("<Q", n) for n in self.row_group_num_rows_]
+        footer.append(struct.pack("<Q", len(self.columns_)))
+        for column, chunks in zip(self.columns_, self.column2chunks_):
+            name = column.name.encode("utf-8")
+            footer.append(struct.pack("<Q", len(name)) + name)
+            footer.append(
+                struct.pack(
+                    "<iiq", column.data_type, self.compression_, column.row_length
+                )
+            )
+            footer += [struct.pack("<QQQ", *chunk) for chunk in chunks]
+        footer = b"".join(footer)
+        self.file_.write(footer + struct.pack("<Q", len(footer)) + MAGIC_CODE)
+        self.file_.close()
+
+
+def convert(paths, output_dir, names=None, row_group_size=16384, compression="zlib"):
+    compression = {"none": NO_COMPRESSION, "zlib": ZLIB_COMPRESSION}[compression]
+    columns = infer_columns(paths, names)
+    if not os.path.exists(output_dir):
+        os.makedirs(output_dir)
+    output_paths = []
+    for path in paths:
+        output_paths.append(os.path.join(output_dir, os.path.basename(path) + ".ofcol"))
+        writer = ColumnarWriter(output_paths[-1], columns, compression)
+        records = []
+        for record in read_ofrecords(path):
+            records.append(record)
+            if len(records) == row_group_size:
+                writer.write_row_group(records)
+                records = []
+        if len(records) > 0:
+            writer.write_row_group(records)
+        writer.close()
+    return columns, output_paths
+
+
+def main():
+    parser = argparse.ArgumentParser(description="convert ofrecord to columnar files")
+    parser.add_argument("--input_dir", type=str, required=True)
+    parser.add_argument("--part_name_prefix", type=str, default="part-")
+    parser.add_argument("--output_dir", type=str, required=True)
+    parser.add_argument(
+        "--columns", type=str, default=None, help="comma separated, all by default"
+    )
+    parser.add_argument("--row_group_size", type=int, default=16384)
+    parser.add_argument(
+        "--compression", type=str, default="zlib", choices=["none", "zlib"]
+    )
+    args = parser.parse_args()
+    paths = sorted(
+        os.path.join(args.input_dir, f)
+        for f in os.listdir(args.input_dir)
+        if f.startswith(args.part_name_prefix)
+    )
+    names = args.columns.split(",") if args.columns else None
+    columns, output_paths = convert(
+        paths, args.output_dir, names, args.row_group_size, args.compression
+    )
+    for column in columns:
+        print(
+            "{}: {}, row length {}".format(
+                column.name,
+                data_type_util.DataType.Name(column.data_type),
+                column.row_length if column.row_length > 0 else "varying",
+            )
+        )
+    print("wrote {} columnar files to {}".format(len(output_paths), args.output_dir))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,63 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow
+import oneflow.experimental as flow
+
+parser = argparse.ArgumentParser(description="eager elementwise fusion benchmark")
+parser.add_argument("--num_elements", type=int, default=1 << 20)
+parser.add_argument("--chain_length", type=int, default=4)
+parser.add_argument("--iter_num", type=int, default=100)
+args = parser.parse_args()
+
+
+def activation_chain(x):
+    for _ in range(args.chain_length):
+        x = flow.tanh(flow.nn.ReLU()(x * 0.5 + 0.1))
+    return x
+
+
+def run(x, enabled):
+    start = time.perf_counter()
+    with flow.elementwise_fusion(enabled):
+        for _ in range(args.iter_num):
+            y = activation_chain(x)
+            y.numpy()
+    return time.perf_counter() - start
+
+
+def main():
+    oneflow.enable_eager_execution()
+    x = flow.Tensor(np.random.randn(args.num_elements).astype(np.float32))
+    # warm up kernels and allocators
+    run(x, False)
+    run(x, True)
+    unfused_time = run(x, False)
+    fused_time = run(x, True)
+    print("ops per chain: {}".format(4 * args.chain_length))
+    print("unfused: {:.3f} ms/iter".format(unfused_time * 1000 / args.iter_num))
+    print(
+        "fused:   {:.3f} ms/iter, speedup {:.2f}x".format(
+            fused_time * 1000 / args.iter_num, unfused_time / fused_time
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
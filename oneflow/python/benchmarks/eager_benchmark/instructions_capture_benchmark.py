@@ -0,0 +1,100 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow
+import oneflow.experimental as flow
+
+parser = argparse.ArgumentParser(description="eager instructions capture benchmark")
+parser.add_argument("--batch_size", type=int, default=32)
+parser.add_argument("--hidden_size", type=int, default=64)
+parser.add_argument("--num_layers", type=int, default=8)
+parser.add_argument("--iter_num", type=int, default=200)
+args = parser.parse_args()
+
+
+class MLP(flow.nn.Module):
+    def __init__(self, hidden_size, num_layers):
+        super().__init__()
+        self.layers = flow.nn.Sequential(
+            *[flow.nn.Linear(hidden_size, hidden_size) for _ in range(num_layers)]
+        )
+        self.relu = flow.nn.ReLU()
+
+    def forward(self, x):
+        for layer in self.layers:
+            x = self.relu(layer(x))
+        return x
+
+
+def make_batches():
+    return [
+        flow.Tensor(
+            np.random.randn(args.batch_size, args.hidden_size).astype(np.float32)
+        )
+        for _ in range(args.iter_num)
+    ]
+
+
+def run_eager(model, batches):
+    # a step ends when its result is on the host, so the step time covers the
+    # vm's scheduling as well as issuing the instructions
+    step_times = []
+    for x in batches:
+        start = time.perf_counter()
+        model(x).numpy()
+        step_times.append(time.perf_counter() - start)
+    return step_times
+
+
+def run_replay(model, batches):
+    x0 = batches[0]
+    capture = flow.InstructionsCapture()
+    with capture:
+        y = model(x0)
+        capture.mark_output(y)
+    step_times = []
+    for x in batches:
+        start = time.perf_counter()
+        (y,) = capture.replay({x0: x})
+        y.numpy()
+        step_times.append(time.perf_counter() - start)
+    return step_times, capture.instruction_size
+
+
+def main():
+    oneflow.enable_eager_execution()
+    model = MLP(args.hidden_size, args.num_layers)
+    batches = make_batches()
+    # warm up kernels and allocators
+    run_eager(model, batches[:10])
+    eager_times = run_eager(model, batches)
+    replay_times, instruction_size = run_replay(model, batches)
+    eager_ms = np.median(eager_times) * 1000
+    replay_ms = np.median(replay_times) * 1000
+    print("instructions per step: {}".format(instruction_size))
+    print("step time without capture: {:.3f} ms".format(eager_ms))
+    print(
+        "step time with capture:    {:.3f} ms, speedup {:.2f}x".format(
+            replay_ms, eager_ms / replay_ms
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
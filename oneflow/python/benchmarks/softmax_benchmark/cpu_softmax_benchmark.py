@@ -0,0 +1,82 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+parser = argparse.ArgumentParser(description="cpu softmax benchmark")
+parser.add_argument("--iter_num", type=int, default=20)
+args = parser.parse_args()
+
+# (batch size, vocab size) of the output layers of language models
+SHAPES = [(32, 30522), (8, 50257), (128, 32000)]
+
+
+def make_job(shape, op):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    job_type = "train" if op == "sparse_softmax_cross_entropy_train" else "predict"
+
+    @flow.global_function(type=job_type, function_config=func_config)
+    def softmax_job(
+        x: oft.Numpy.Placeholder(shape),
+        labels: oft.Numpy.Placeholder((shape[0],), dtype=flow.int32),
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            if op == "softmax":
+                return flow.nn.softmax(x)
+            elif op == "sparse_softmax_cross_entropy":
+                return flow.nn.sparse_softmax_cross_entropy_with_logits(labels, x)
+            else:
+                bias = flow.get_variable(
+                    "bias", shape=(shape[1],), initializer=flow.zeros_initializer()
+                )
+                loss = flow.nn.sparse_softmax_cross_entropy_with_logits(
+                    labels, flow.nn.bias_add(x, bias)
+                )
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [1e-3]), momentum=0
+                ).minimize(loss)
+                return loss
+
+    return softmax_job
+
+
+def main():
+    for shape in SHAPES:
+        x = np.random.normal(0, 10, shape).astype(np.float32)
+        labels = np.random.randint(0, shape[1], (shape[0],)).astype(np.int32)
+        for op in (
+            "softmax",
+            "sparse_softmax_cross_entropy",
+            "sparse_softmax_cross_entropy_train",
+        ):
+            job = make_job(shape, op)
+            # warm up
+            job(x, labels).get()
+            start = time.perf_counter()
+            for _ in range(args.iter_num):
+                job(x, labels).get()
+            elapsed = (time.perf_counter() - start) / args.iter_num
+            print("{} {}: {:.3f} ms/iter".format(op, shape, elapsed * 1000))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,69 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+parser = argparse.ArgumentParser(description="cpu sort, arg_sort and top_k benchmark")
+parser.add_argument("--iter_num", type=int, default=10)
+parser.add_argument("--top_k", type=int, default=100)
+args = parser.parse_args()
+
+# (instance_num, instance_size) from many short rows to a single ranking over millions of items
+SHAPES = [(4096, 128), (1024, 4096), (16, 1 << 16), (1, 1 << 20), (1, 1 << 24)]
+
+
+def make_job(op_name, shape):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+
+    @flow.global_function(function_config=func_config)
+    def sort_job(x: oft.Numpy.Placeholder(shape)):
+        with flow.scope.placement("cpu", "0:0"):
+            if op_name == "sort":
+                return flow.sort(x, direction="DESCENDING")
+            elif op_name == "arg_sort":
+                return flow.argsort(x, direction="DESCENDING")
+            else:
+                return flow.math.top_k(x, k=min(args.top_k, shape[-1]))
+
+    return sort_job
+
+
+def main():
+    for op_name in ("sort", "arg_sort", "top_k"):
+        for shape in SHAPES:
+            job = make_job(op_name, shape)
+            x = np.random.uniform(-1, 1, shape).astype(np.float32)
+            # warm up
+            job(x).get()
+            start = time.perf_counter()
+            for _ in range(args.iter_num):
+                job(x).get()
+            elapsed = (time.perf_counter() - start) / args.iter_num
+            print(
+                "{} of {}: {:.3f} ms/iter, {:.1f} M elems/s".format(
+                    op_name, shape, elapsed * 1000, x.size / elapsed / 1e6
+                )
+            )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,97 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import tempfile
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as tp
+
+parser = argparse.ArgumentParser(description="summary writing overhead benchmark")
+parser.add_argument("--num_variables", type=int, default=32)
+parser.add_argument("--variable_size", type=int, default=1024 * 1024)
+parser.add_argument("--iter_num", type=int, default=50)
+args = parser.parse_args()
+
+
+def make_jobs(logdir, write_summary):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+
+    @flow.global_function(function_config=func_config)
+    def CreateWriter():
+        flow.summary.create_summary_writer(logdir)
+
+    @flow.global_function(function_config=func_config)
+    def StepJob(
+        step: tp.Numpy.Placeholder((1,), dtype=flow.int64),
+        tag: tp.Numpy.Placeholder((9,), dtype=flow.int8),
+    ) -> tp.Numpy:
+        with flow.scope.placement("cpu", "0:0"):
+            means = []
+            for i in range(args.num_variables):
+                w = flow.get_variable(
+                    "w{}".format(i),
+                    shape=(args.variable_size,),
+                    initializer=flow.random_normal_initializer(),
+                )
+                means.append(flow.math.reduce_mean(w))
+                if write_summary:
+                    # per-step histogram of every variable
+                    flow.summary.histogram(w, step, tag)
+            return flow.math.add_n(means)
+
+    @flow.global_function(function_config=func_config)
+    def FlushJob():
+        flow.summary.flush_summary_writer()
+
+    return CreateWriter, StepJob, FlushJob
+
+
+def run(write_summary):
+    with tempfile.TemporaryDirectory() as logdir:
+        create_writer, step_job, flush_job = make_jobs(logdir, write_summary)
+        create_writer()
+        tag = np.fromstring("histogram", dtype=np.int8)
+        # warm up
+        step_job(np.array([0], dtype=np.int64), tag)
+        start = time.perf_counter()
+        for i in range(args.iter_num):
+            step_job(np.array([i + 1], dtype=np.int64), tag)
+        step_time = (time.perf_counter() - start) / args.iter_num
+        start = time.perf_counter()
+        flush_job()
+        return step_time, time.perf_counter() - start
+
+
+def main():
+    baseline_time, _ = run(False)
+    summary_time, flush_time = run(True)
+    print("without summary: {:.3f} ms/step".format(baseline_time * 1000))
+    print(
+        "with {} histograms: {:.3f} ms/step, overhead {:.3f} ms/step".format(
+            args.num_variables,
+            summary_time * 1000,
+            (summary_time - baseline_time) * 1000,
+        )
+    )
+    print("final flush: {:.3f} ms".format(flush_time * 1000))
+
+
+if __name__ == "__main__":
+    main()
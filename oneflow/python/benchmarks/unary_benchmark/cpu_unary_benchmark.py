@@ -0,0 +1,81 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+
+parser = argparse.ArgumentParser(description="cpu unary elementwise benchmark")
+parser.add_argument("--elem_cnt", type=int, default=1 << 24)
+parser.add_argument("--iter_num", type=int, default=20)
+args = parser.parse_args()
+
+# op name -> (oneflow op, numpy reference in float32 or None)
+OPS = {
+    "exp": (flow.math.exp, np.exp),
+    "log": (flow.math.log, np.log),
+    "tanh": (flow.math.tanh, np.tanh),
+    "sigmoid": (flow.math.sigmoid, lambda x: 1 / (1 + np.exp(-x))),
+    "sin": (flow.math.sin, np.sin),
+    "cos": (flow.math.cos, np.cos),
+    "erf": (flow.math.erf, None),
+    "gelu": (flow.math.gelu, None),
+}
+
+
+def make_job(op):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+
+    @flow.global_function(type="predict", function_config=func_config)
+    def unary_job(x: oft.Numpy.Placeholder((args.elem_cnt,))):
+        with flow.scope.placement("cpu", "0:0"):
+            return op(x)
+
+    return unary_job
+
+
+def milliseconds(compute):
+    # warm up
+    compute()
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        compute()
+    return (time.perf_counter() - start) * 1000 / args.iter_num
+
+
+def main():
+    # log needs positive inputs, the others are sampled on the same range
+    x = np.random.uniform(0.01, 4.0, (args.elem_cnt,)).astype(np.float32)
+    for name, (op, reference) in OPS.items():
+        job = make_job(op)
+        oneflow_ms = milliseconds(lambda: job(x).get())
+        line = "{} of {} floats: oneflow {:.3f} ms".format(
+            name, args.elem_cnt, oneflow_ms
+        )
+        if reference is not None:
+            numpy_ms = milliseconds(lambda: reference(x))
+            line += ", numpy {:.3f} ms, speedup {:.2f}x".format(
+                numpy_ms, numpy_ms / oneflow_ms
+            )
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
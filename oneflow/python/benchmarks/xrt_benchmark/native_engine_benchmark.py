@@ -0,0 +1,85 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import argparse
+import time
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as tp
+
+parser = argparse.ArgumentParser(description="xrt native engine benchmark")
+parser.add_argument("--batch_size", type=int, default=256)
+parser.add_argument("--hidden_size", type=int, default=1024)
+parser.add_argument("--num_layers", type=int, default=4)
+parser.add_argument("--iter_num", type=int, default=100)
+args = parser.parse_args()
+
+
+def make_job(use_native):
+    flow.clear_default_session()
+    config = flow.function_config()
+    config.default_data_type(flow.float32)
+    config.use_xrt_native(use_native)
+    shape = (args.batch_size, args.hidden_size)
+
+    @flow.global_function(function_config=config)
+    def mlp_job(x: tp.Numpy.Placeholder(shape)) -> tp.Numpy:
+        with flow.scope.placement("cpu", "0:0"):
+            for i in range(args.num_layers):
+                w = flow.get_variable(
+                    "w{}".format(i),
+                    shape=(args.hidden_size, args.hidden_size),
+                    initializer=flow.random_normal_initializer(stddev=0.02),
+                )
+                b = flow.get_variable(
+                    "b{}".format(i),
+                    shape=(args.hidden_size,),
+                    initializer=flow.zeros_initializer(),
+                )
+                y = flow.nn.bias_add(flow.matmul(x, w), b)
+                # elementwise tail of each layer, fused into one loop by the native engine
+                x = flow.math.gelu(y) * flow.math.sigmoid(y) + x * 0.5
+            return flow.math.reduce_sum(x, axis=[1])
+
+    return mlp_job
+
+
+def run(job, x):
+    start = time.perf_counter()
+    for _ in range(args.iter_num):
+        job(x)
+    return time.perf_counter() - start
+
+
+def main():
+    x = np.random.randn(args.batch_size, args.hidden_size).astype(np.float32)
+    times = []
+    for use_native in (False, True):
+        job = make_job(use_native)
+        # warm up compilation and allocators
+        job(x)
+        times.append(run(job, x))
+    unclustered_time, native_time = times
+    print("unclustered: {:.3f} ms/iter".format(unclustered_time * 1000 / args.iter_num))
+    print(
+        "native:      {:.3f} ms/iter, speedup {:.2f}x".format(
+            native_time * 1000 / args.iter_num, unclustered_time / native_time
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
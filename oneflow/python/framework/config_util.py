@@ -167,6 +167,97 @@ def enable_numa_aware_cuda_malloc_host(val):
     sess.config_proto.resource.enable_numa_aware_cuda_malloc_host = val
 
 
+@oneflow_export("config.enable_numa_aware_cpu_actor")
+def api_enable_numa_aware_cpu_actor(val: bool = True) -> None:
+    r"""Whether or not to partition cpu compute streams among numa nodes, pin cpu actor
+    threads to the cpus of their node and bind host regst memory to the node of its producer.
+
+    Args:
+        val (bool, optional): True or False. Defaults to True.
+    """
+    return enable_if.unique([enable_numa_aware_cpu_actor, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def enable_numa_aware_cpu_actor(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.enable_numa_aware_cpu_actor = val
+
+
+@oneflow_export("config.enable_cost_aware_cpu_stream_assignment")
+def api_enable_cost_aware_cpu_stream_assignment(val: bool = True) -> None:
+    r"""Whether or not to balance cpu compute actors among cpu compute streams by their
+    estimated costs instead of round-robin, keeping producer/consumer chains on one stream
+    when it does not unbalance the streams.
+
+    Args:
+        val (bool, optional): True or False. Defaults to True.
+    """
+    return enable_if.unique([enable_cost_aware_cpu_stream_assignment, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def enable_cost_aware_cpu_stream_assignment(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.enable_cost_aware_cpu_stream_assignment = val
+
+
+@oneflow_export("config.online_regst_num_tuning_act_num")
+def api_online_regst_num_tuning_act_num(val: int) -> None:
+    r"""Grow the register number of bottleneck producers from act durations measured during
+    the first `val` acts of each actor, instead of keeping the planned register numbers.
+
+    Args:
+        val (int): number of acts measured before tuning, 0 disables the tuning
+    """
+    return enable_if.unique([online_regst_num_tuning_act_num, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def online_regst_num_tuning_act_num(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.online_regst_num_tuning_act_num = val
+
+
+@oneflow_export("config.online_regst_num_tuning_mem_mbyte")
+def api_online_regst_num_tuning_mem_mbyte(val: int) -> None:
+    r"""Set up the memory the registers added by online register number tuning may take in
+    each memory zone of a process
+
+    Args:
+        val (int): memory size in MB
+    """
+    return enable_if.unique([online_regst_num_tuning_mem_mbyte, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def online_regst_num_tuning_mem_mbyte(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.online_regst_num_tuning_mem_mbyte = val
+
+
+@oneflow_export("config.enable_transport_cross_memory_attach")
+def api_enable_transport_cross_memory_attach(val: bool = True) -> None:
+    r"""Whether or not to let eager transport read the data sent by another process of the
+    same host directly from its memory with process_vm_readv instead of through sockets.
+
+    Args:
+        val (bool, optional): True or False. Defaults to True.
+    """
+    return enable_if.unique([enable_transport_cross_memory_attach, do_nothing])(val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def enable_transport_cross_memory_attach(val):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is bool
+    sess.config_proto.resource.enable_transport_cross_memory_attach = val
+
+
 @oneflow_export("config.compute_thread_pool_size")
 def api_compute_thread_pool_size(val: int) -> None:
     r"""Set up the size of compute thread pool
@@ -498,6 +589,24 @@ def disable_group_boxing_by_dst_parallel(val=False):
     sess.config_proto.resource.disable_group_boxing_by_dst_parallel = val
 
 
+@oneflow_export("config.slice_boxing_chunk_mbyte")
+def api_slice_boxing_chunk_mbyte(val: int = 0) -> None:
+    r"""Set up the chunk size of slice boxing between machines. A blob larger than it is boxed
+    chunk by chunk, overlapping network transfer with local add/concat.
+
+    Args:
+        val (int, optional): chunk size in MB, 0 to disable chunking. Defaults to 0.
+    """
+    return enable_if.unique([slice_boxing_chunk_mbyte, do_nothing])(val=val)
+
+
+@enable_if.condition(hob.in_normal_mode & ~hob.session_initialized)
+def slice_boxing_chunk_mbyte(val=0):
+    sess = session_ctx.GetDefaultSession()
+    assert type(val) is int
+    sess.config_proto.resource.slice_boxing_chunk_mbyte = val
+
+
 @oneflow_export("config.collective_boxing.nccl_num_streams")
 def api_nccl_num_streams(val: int) -> None:
     r"""Set up the number of nccl parallel streams while use boxing
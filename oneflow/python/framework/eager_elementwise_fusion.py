@@ -0,0 +1,53 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import oneflow._oneflow_internal
+from oneflow.python.oneflow_export import oneflow_export, experimental_api
+
+
+@oneflow_export("elementwise_fusion")
+@experimental_api
+class elementwise_fusion(object):
+    r"""Context manager that defers unary elementwise ops on cpu float tensors in eager mode.
+
+    Inside the block, ops such as ``relu``, ``sigmoid``, ``exp`` or scalar add/mul are not
+    executed immediately. A chain of them is computed by a single fused kernel when its
+    result is consumed by another op or read back, e.g. by ``numpy()``. Intermediate results
+    that are never consumed are never computed.
+
+    For example:
+
+    .. code-block:: python
+
+        with flow.elementwise_fusion():
+            y = flow.sigmoid(flow.exp(x) * 2.0)
+        y.numpy()
+
+    """
+
+    def __init__(self, enabled: bool = True):
+        self._enabled = enabled
+
+    def __enter__(self):
+        self._prev_enabled = oneflow._oneflow_internal.IsEagerElementwiseFusionEnabled()
+        oneflow._oneflow_internal.SetEagerElementwiseFusionEnabled(self._enabled)
+        return self
+
+    def __exit__(self, *args):
+        oneflow._oneflow_internal.SetEagerElementwiseFusionEnabled(self._prev_enabled)
+
+    @staticmethod
+    def pending_size() -> int:
+        return oneflow._oneflow_internal.EagerElementwiseFusionPendingSize()
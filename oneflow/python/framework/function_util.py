@@ -356,10 +356,38 @@ def policy_time_line(func_desc):
     return "use_time_line_algo"
 
 
+@oneflow_function_config("static_mem_alloc_policy_white_list.policy_lifetime_packing")
+def policy_lifetime_packing(func_desc):
+    r"""A static memory allocation policy called: lifetime_packing
+
+    Args:
+        func_desc ([type]): [description]
+
+    Returns:
+        [type]: [description]
+    """
+    return "use_lifetime_packing_algo"
+
+
+@oneflow_function_config("static_mem_alloc_lifetime_packing_max_search_steps")
+def set_static_mem_alloc_lifetime_packing_max_search_steps(func_desc, value):
+    r"""Set the number of moves each mem chain may try to refine the lifetime_packing policy.
+            The plan depends on the job only, a larger value may shrink the mem blocks at the
+            cost of compile time.
+
+    Args:
+        func_desc ([type]): job function
+        value (int): number of moves
+    """
+    conf = func_desc.job_config_proto.mutable_memory_allocation_algorithm_conf()
+    conf.set_lifetime_packing_algo_max_search_steps(value)
+
+
 @oneflow_function_config("static_mem_alloc_algo_white_list.show")
 def show_static_mem_alloc_algo_white_list(func_desc):
     r"""Show configuration of  static memory allocation policy,
-          including: "use_mem_size_first_algo", "use_mutual_exclusion_first_algo", "use_time_line_algo"
+          including: "use_mem_size_first_algo", "use_mutual_exclusion_first_algo", "use_time_line_algo",
+          "use_lifetime_packing_algo"
 
     Args:
         func_desc ([type]): [description]
@@ -371,6 +399,7 @@ def show_static_mem_alloc_algo_white_list(func_desc):
         "use_mem_size_first_algo",
         "use_mutual_exclusion_first_algo",
         "use_time_line_algo",
+        "use_lifetime_packing_algo",
     ]
 
 
@@ -475,6 +504,20 @@ def set_enable_fuse_cast_scale(func_desc, value=True):
     func_desc.job_config_proto.set_enable_fuse_cast_scale(value)
 
 
+@oneflow_function_config("enable_fuse_elementwise_chain")
+def set_enable_fuse_elementwise_chain(func_desc, value=True):
+    r"""Whether enable fuse_elementwise_chain.
+            If enabled, try to fuse chains of cpu unary elementwise ops into one
+            elementwise_unary_chain op, which skips the intermediate blobs.
+            Only predict jobs are fused; training jobs ignore this option.
+
+    Args:
+        func_desc ([type]): [description]
+        value ([type]): [description]
+    """
+    func_desc.job_config_proto.set_enable_fuse_elementwise_chain(value)
+
+
 @oneflow_function_config("cudnn_conv_use_deterministic_algo_only")
 def set_cudnn_conv_use_deterministic_algo_only(func_desc, value):
     r"""Set value to cudnn conv_use_deterministic_only algorithm
@@ -508,6 +551,19 @@ def set_enable_inplace(func_desc, value=True):
     func_desc.job_config_proto.set_enable_inplace(value)
 
 
+@oneflow_function_config("recomputation_memory_budget")
+def set_recomputation_memory_budget(func_desc, value):
+    r"""Set the bytes of activations each device may keep from forward pass
+            to backward pass. If set, training jobs drop the cheapest activations
+            and recompute them in backward pass until the budget is met.
+
+    Args:
+        func_desc ([type]): job function
+        value (int): bytes per device, non-positive to disable
+    """
+    func_desc.job_config_proto.set_recomputation_memory_budget(value)
+
+
 @oneflow_function_config("enable_inplace_in_reduce_struct")
 def set_enable_inplace_in_reduce_struct(func_desc, value=True):
     print(
@@ -759,6 +815,25 @@ def set_enable_auto_mixed_precision(func_desc, value=True):
     func_desc.job_config_proto.set_enable_auto_mixed_precision(value)
 
 
+@oneflow_function_config("mixed_precision_data_type")
+def set_mixed_precision_data_type(func_desc, value):
+    r"""Set the low precision data type of auto mixed precision.
+
+    flow.float16 (default) runs the white listed ops of gpu devices in half precision,
+    it's ignored in a build without cuda. flow.bfloat16 runs the white listed ops of cpu
+    devices in bfloat16 with float accumulation.
+
+    Args:
+        func_desc ([type]): job function
+        value ([type]): data type. e.g. flow.bfloat16
+    """
+    func_desc.job_config_proto.set_mixed_precision_data_type(
+        data_type_cfg.DataType(
+            oneflow._oneflow_internal.deprecated.GetProtoDtype4OfDtype(value)
+        )
+    )
+
+
 @oneflow_function_config("enable_keep_header_only")
 def set_enable_keep_header_only(func_desc, value=True):
     r"""deprecated api.
@@ -923,6 +998,17 @@ def set_use_tensorrt(func_desc, value=True):
     func_desc.job_config_proto.mutable_xrt_config().set_use_tensorrt(value)
 
 
+@oneflow_function_config("use_xrt_native")
+def set_use_xrt_native(func_desc, value=True):
+    r"""Whether compile cpu clusters with the native xrt engine or not
+
+    Args:
+        func_desc ([type]): [description]
+        value (bool, optional): [description]. Defaults to True.
+    """
+    func_desc.job_config_proto.mutable_xrt_config().set_use_native(value)
+
+
 @oneflow_function_config("tensorrt.use_fp16")
 def set_tensorrt_use_fp16(func_desc, value=True):
     r"""Whether use tensorrt fp16  or not
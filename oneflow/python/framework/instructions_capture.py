@@ -0,0 +1,73 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+from typing import Dict, Tuple
+
+import oneflow._oneflow_internal
+from oneflow.python.framework.tensor import Tensor
+from oneflow.python.framework.tensor_tuple_util import convert_to_tensor_tuple
+from oneflow.python.oneflow_export import oneflow_export, experimental_api
+
+
+@oneflow_export("InstructionsCapture")
+@experimental_api
+class InstructionsCapture(object):
+    r"""Records the eager instructions issued inside a ``with`` block and replays them
+    without going through the op interpreter again.
+
+    The captured region is executed normally once. Tensors consumed by the region but not
+    produced in it (inputs, parameters) are the bindings of the capture; ``replay`` keeps them
+    unless they are rebound, so in-place updated parameters are seen by every replay.
+
+    For example:
+
+    .. code-block:: python
+
+        capture = flow.InstructionsCapture()
+        with capture:
+            y = model(x)
+            capture.mark_output(y)
+        for x_i in batches:
+            (y_i,) = capture.replay({x: x_i})
+
+    """
+
+    def __init__(self):
+        self._capture = oneflow._oneflow_internal.InstructionsCapture()
+
+    def __enter__(self):
+        self._capture.begin_capture()
+        return self
+
+    def __exit__(self, *args):
+        self._capture.end_capture()
+
+    def mark_output(self, *tensors: Tensor) -> None:
+        for tensor in tensors:
+            self._capture.mark_output(convert_to_tensor_tuple(tensor)[0])
+
+    def replay(self, bindings: Dict[Tensor, Tensor] = None) -> Tuple[Tensor]:
+        bindings = bindings or {}
+        captured_inputs = list(bindings.keys())
+        inputs = [bindings[x] for x in captured_inputs]
+        outputs = self._capture.replay(
+            convert_to_tensor_tuple(captured_inputs or None),
+            convert_to_tensor_tuple(inputs or None),
+        )
+        return tuple([Tensor(x) for x in outputs])
+
+    @property
+    def instruction_size(self) -> int:
+        return self._capture.instruction_size
@@ -64,6 +64,7 @@ class OfrecordReader(Module):
         shuffle_buffer_size: int = 1024,
         shuffle_after_epoch: bool = False,
         random_seed: int = -1,
+        output_serialized: bool = False,
         name: Optional[str] = None,
     ):
         super().__init__()
@@ -80,6 +81,7 @@ class OfrecordReader(Module):
             .Attr("shuffle_after_epoch", shuffle_after_epoch)
             .Attr("part_name_suffix_length", part_name_suffix_length)
             .Attr("seed", seed)
+            .Attr("output_serialized", output_serialized)
             .Build()
         )
 
@@ -273,6 +273,7 @@ def ofrecord_reader(
     random_shuffle: bool = False,
     shuffle_buffer_size: int = 1024,
     shuffle_after_epoch: bool = False,
+    output_serialized: bool = False,
     name: Optional[str] = None,
 ) -> oneflow._oneflow_internal.BlobDesc:
     r"""Get ofrecord object from ofrecord dataset.
@@ -286,6 +287,7 @@ def ofrecord_reader(
         random_shuffle (bool, optional): Determines records shuffled or not. Defaults to False.
         shuffle_buffer_size (int, optional): Shuffle buffer size. Defaults to 1024.
         shuffle_after_epoch (bool, optional): Shuffled or not after each epoch. Defaults to False.
+        output_serialized (bool, optional): Outputs the serialized records as tensor buffers instead of parsed records. The ofrecord decoders accept both, and read the features of serialized records without parsing them. Defaults to False.
         name (Optional[str], optional): Optional name. Defaults to None.
 
     Returns:
@@ -349,6 +351,7 @@ def ofrecord_reader(
         .Attr("shuffle_buffer_size", shuffle_buffer_size)
         .Attr("shuffle_after_epoch", shuffle_after_epoch)
         .Attr("part_name_suffix_length", part_name_suffix_length)
+        .Attr("output_serialized", output_serialized)
         .Build()
         .InferAndTryRun()
         .RemoteBlobList()[0]
@@ -2465,3 +2465,65 @@ def gpt_data_loader(
     )
 
     return op.InferAndTryRun().SoleOutputBlob()
+
+
+@oneflow_export("data.columnar_data_loader", "data.ColumnarDataLoader")
+def columnar_data_loader(
+    files: Union[str, Sequence[str]],
+    columns: Sequence[str],
+    row_lengths: Sequence[int],
+    dtypes: Sequence[flow.dtype],
+    batch_size: int,
+    shuffle: bool = False,
+    random_seed: Optional[int] = None,
+    name: Optional[str] = None,
+) -> Sequence[oneflow._oneflow_internal.BlobDesc]:
+    r"""Reads the selected columns of columnar files into one blob of shape
+    (batch_size, row_length) per column. Only the bytes of the selected columns are read.
+
+    Args:
+        files (Union[str, Sequence[str]]): Columnar files with the same columns, e.g. converted
+            from OFRecord by `oneflow/python/benchmarks/columnar_data_load/ofrecord_to_columnar.py`.
+        columns (Sequence[str]): Names of the columns to read.
+        row_lengths (Sequence[int]): Number of values of each row of each column. Rows of a
+            varying length column are truncated or padded with zeros to this length.
+        dtypes (Sequence[flow.dtype]): Data type of each column, must match the file.
+        batch_size (int): Batch size.
+        shuffle (bool): Whether to shuffle the order of row groups in each epoch. Defaults to False.
+        random_seed (Optional[int]): Seed of the shuffle. Defaults to None.
+        name (Optional[str]): The name for the operation. Defaults to None.
+
+    Returns:
+        Sequence[BlobDesc]: One blob per column.
+    """
+    if name is None:
+        name = id_util.UniqueStr("ColumnarDataLoader_")
+
+    if isinstance(files, str):
+        files = [files]
+
+    if not (len(columns) == len(row_lengths) == len(dtypes)):
+        raise ValueError(
+            "columns, row_lengths and dtypes should have the same length, got {}, {} and {}".format(
+                len(columns), len(row_lengths), len(dtypes)
+            )
+        )
+
+    if random_seed is None:
+        random_seed = random.randrange(sys.maxsize)
+
+    return (
+        flow.user_op_builder(name)
+        .Op("columnar_data_loader")
+        .Output("out", len(columns))
+        .Attr("files", list(files))
+        .Attr("column_names", list(columns))
+        .Attr("row_lengths", list(row_lengths))
+        .Attr("dtypes", list(dtypes))
+        .Attr("batch_size", batch_size)
+        .Attr("shuffle", shuffle)
+        .Attr("random_seed", random_seed)
+        .Build()
+        .InferAndTryRun()
+        .RemoteBlobList()
+    )
@@ -0,0 +1,81 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import unittest
+
+import numpy as np
+
+import oneflow.experimental as flow
+
+
+def _chain(x):
+    return flow.tanh(flow.nn.ReLU()(flow.exp(x) * 0.5 + 1))
+
+
+def _np_chain(x):
+    return np.tanh(np.maximum(np.exp(x) * 0.5 + 1, 0))
+
+
+@unittest.skipIf(
+    not flow.unittest.env.eager_execution_enabled(),
+    ".numpy() doesn't work in lazy mode",
+)
+class TestElementwiseFusion(flow.unittest.TestCase):
+    def test_chain_is_deferred(test_case):
+        np_x = np.random.randn(4, 1000).astype(np.float32)
+        x = flow.Tensor(np_x)
+        with flow.elementwise_fusion():
+            y = _chain(x)
+            test_case.assertTrue(flow.elementwise_fusion.pending_size() > 0)
+        test_case.assertTrue(np.allclose(y.numpy(), _np_chain(np_x), 1e-5, 1e-5))
+
+    def test_intermediate_is_consumed(test_case):
+        np_x = np.random.randn(2, 3, 5).astype(np.float32)
+        x = flow.Tensor(np_x)
+        with flow.elementwise_fusion():
+            z = flow.exp(x)
+            y = flow.tanh(z * 2)
+            w = z + flow.Tensor(np.ones((2, 3, 5), dtype=np.float32))
+        test_case.assertTrue(np.allclose(w.numpy(), np.exp(np_x) + 1, 1e-5, 1e-5))
+        test_case.assertTrue(
+            np.allclose(y.numpy(), np.tanh(np.exp(np_x) * 2), 1e-5, 1e-5)
+        )
+
+    def test_source_released(test_case):
+        np_x = np.random.randn(3, 7).astype(np.float32)
+        with flow.elementwise_fusion():
+            x = flow.Tensor(np_x)
+            y = flow.square(x) + 3
+            del x
+        test_case.assertTrue(np.allclose(y.numpy(), np.square(np_x) + 3, 1e-5, 1e-5))
+
+    def test_nan_is_propagated(test_case):
+        np_x = np.array([np.nan, -1.0, 2.0], dtype=np.float32)
+        x = flow.Tensor(np_x)
+        with flow.elementwise_fusion():
+            y = flow.nn.ReLU()(x * 2)
+        test_case.assertTrue(np.isnan(y.numpy()[0]))
+        test_case.assertTrue(np.allclose(y.numpy()[1:], np.array([0.0, 4.0])))
+
+    def test_disabled(test_case):
+        x = flow.Tensor(np.random.randn(4, 4).astype(np.float32))
+        with flow.elementwise_fusion(False):
+            y = flow.exp(x)
+            test_case.assertEqual(flow.elementwise_fusion.pending_size(), 0)
+        test_case.assertTrue(np.allclose(y.numpy(), np.exp(x.numpy()), 1e-5, 1e-5))
+
+
+if __name__ == "__main__":
+    unittest.main()
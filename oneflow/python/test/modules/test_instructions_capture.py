@@ -0,0 +1,96 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import unittest
+
+import numpy as np
+
+import oneflow.experimental as flow
+
+
+def _mlp(x, linear1, linear2):
+    return linear2(flow.nn.ReLU()(linear1(x)))
+
+
+@unittest.skipIf(
+    not flow.unittest.env.eager_execution_enabled(),
+    ".numpy() doesn't work in lazy mode",
+)
+class TestInstructionsCapture(flow.unittest.TestCase):
+    def test_replay_with_rebound_input(test_case):
+        linear1 = flow.nn.Linear(16, 32)
+        linear2 = flow.nn.Linear(32, 4)
+        x = flow.Tensor(np.random.randn(8, 16).astype(np.float32))
+        capture = flow.InstructionsCapture()
+        with capture:
+            y = _mlp(x, linear1, linear2)
+            capture.mark_output(y)
+        test_case.assertTrue(capture.instruction_size > 0)
+        for _ in range(3):
+            x_i = flow.Tensor(np.random.randn(8, 16).astype(np.float32))
+            (y_i,) = capture.replay({x: x_i})
+            test_case.assertTrue(
+                np.allclose(
+                    y_i.numpy(), _mlp(x_i, linear1, linear2).numpy(), 1e-5, 1e-5
+                )
+            )
+
+    def test_replay_with_shared_intermediates(test_case):
+        # h is internal and read by two instructions, z is both marked and read internally
+        def _diamond(x):
+            h = flow.sin(x)
+            z = flow.mul(h, h)
+            return z, flow.add(flow.cos(h), z)
+
+        x = flow.Tensor(np.random.randn(4, 8).astype(np.float32))
+        capture = flow.InstructionsCapture()
+        with capture:
+            z, y = _diamond(x)
+            capture.mark_output(y)
+            capture.mark_output(z)
+        for _ in range(3):
+            x_i = flow.Tensor(np.random.randn(4, 8).astype(np.float32))
+            y_i, z_i = capture.replay({x: x_i})
+            z_expected, y_expected = _diamond(x_i)
+            test_case.assertTrue(
+                np.allclose(y_i.numpy(), y_expected.numpy(), 1e-5, 1e-5)
+            )
+            test_case.assertTrue(
+                np.allclose(z_i.numpy(), z_expected.numpy(), 1e-5, 1e-5)
+            )
+
+    def test_replay_without_rebinding(test_case):
+        linear = flow.nn.Linear(4, 4)
+        x = flow.Tensor(np.random.randn(2, 4).astype(np.float32))
+        capture = flow.InstructionsCapture()
+        with capture:
+            y = linear(x)
+            capture.mark_output(y)
+        (y_replayed,) = capture.replay()
+        test_case.assertTrue(np.allclose(y_replayed.numpy(), y.numpy(), 1e-5, 1e-5))
+
+    def test_replay_shape_mismatch(test_case):
+        linear = flow.nn.Linear(4, 4)
+        x = flow.Tensor(np.random.randn(2, 4).astype(np.float32))
+        capture = flow.InstructionsCapture()
+        with capture:
+            y = linear(x)
+            capture.mark_output(y)
+        with test_case.assertRaises(Exception):
+            capture.replay({x: flow.Tensor(np.random.randn(3, 4).astype(np.float32))})
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,127 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import unittest
+from collections import OrderedDict
+
+import numpy as np
+import oneflow as flow
+import oneflow.core.common.data_type_pb2 as data_type_util
+from test_util import GenArgList
+import oneflow.typing as oft
+
+
+def _mlp(x, hidden_sizes):
+    for i, hidden_size in enumerate(hidden_sizes):
+        w = flow.get_variable(
+            "w{}".format(i),
+            shape=(x.shape[-1], hidden_size),
+            initializer=flow.random_normal_initializer(stddev=0.1, seed=i),
+        )
+        b = flow.get_variable(
+            "b{}".format(i),
+            shape=(hidden_size,),
+            initializer=flow.constant_initializer(0.1),
+        )
+        x = flow.math.gelu(flow.nn.bias_add(flow.matmul(x, w), b))
+    return flow.math.reduce_sum(x, axis=[1])
+
+
+def make_mlp_job(input_shape, hidden_sizes, enable_amp, job_type):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float32)
+    if enable_amp:
+        func_config.enable_auto_mixed_precision(True)
+        func_config.mixed_precision_data_type(flow.bfloat16)
+
+    @flow.global_function(type=job_type, function_config=func_config)
+    def MlpJob(x: oft.Numpy.Placeholder(input_shape)) -> oft.Numpy:
+        with flow.scope.placement("cpu", "0:0"):
+            out = _mlp(x, hidden_sizes)
+            if job_type == "train":
+                flow.optimizer.SGD(
+                    flow.optimizer.PiecewiseConstantScheduler([], [1e-3]), momentum=0
+                ).minimize(flow.math.reduce_mean(out))
+            return out
+
+    return MlpJob
+
+
+def bfloat16_cast_op_names():
+    job = [
+        job
+        for job in flow.experimental.get_job_set().job
+        if job.job_conf.job_name == "MlpJob"
+    ][0]
+    return [
+        op.name
+        for op in job.net.op
+        if op.HasField("user_conf")
+        and op.user_conf.op_type_name == "cast"
+        and op.user_conf.attr["dtype"].at_data_type == data_type_util.kBFloat16
+    ]
+
+
+def compare_with_float(input_shape, hidden_sizes, job_type):
+    x = np.random.uniform(-1, 1, input_shape).astype(np.float32)
+    outs = []
+    for enable_amp in (False, True):
+        job = make_mlp_job(input_shape, hidden_sizes, enable_amp, job_type)
+        outs.append(job(x))
+        # the matmuls of every layer take bfloat16 operands only with amp
+        cast_op_names = bfloat16_cast_op_names()
+        if enable_amp:
+            assert len(cast_op_names) >= len(hidden_sizes), cast_op_names
+        else:
+            assert len(cast_op_names) == 0, cast_op_names
+    float_out, bfloat16_out = outs
+    # bfloat16 keeps 8 significant bits, products are accumulated in float
+    assert np.allclose(bfloat16_out, float_out, rtol=2e-2, atol=2e-2)
+
+
+def cast_round_trip(input_shape):
+    flow.clear_default_session()
+
+    @flow.global_function(type="predict")
+    def CastJob(x: oft.Numpy.Placeholder(input_shape)) -> oft.Numpy:
+        with flow.scope.placement("cpu", "0:0"):
+            return flow.cast(flow.cast(x, flow.bfloat16), flow.float32)
+
+    x = np.random.uniform(-100, 100, input_shape).astype(np.float32)
+    out = CastJob(x)
+    assert np.allclose(out, x, rtol=1 / 256, atol=0)
+    # values representable in bfloat16 round trip exactly
+    exact = np.array([0, 1, -2, 0.5, 256, 1.5], dtype=np.float32)
+    exact = np.resize(exact, input_shape).astype(np.float32)
+    assert np.array_equal(CastJob(exact), exact)
+
+
+@flow.unittest.skip_unless_1n1d()
+class TestAutoMixedPrecisionBFloat16(flow.unittest.TestCase):
+    def test_cast_round_trip(test_case):
+        cast_round_trip((16, 33))
+
+    def test_mlp(test_case):
+        arg_dict = OrderedDict()
+        arg_dict["input_shape"] = [(8, 64), (3, 17)]
+        arg_dict["hidden_sizes"] = [(128, 32), (65,)]
+        arg_dict["job_type"] = ["predict", "train"]
+        for arg in GenArgList(arg_dict):
+            compare_with_float(*arg)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -272,6 +272,32 @@ def _test_multi_lbi(
     test_case.assertTrue(np.array_equal(x, r2))
 
 
+def _test_chunked_boxing_across_machines(test_case, src_sbp, dst_axis):
+    flow.clear_default_session()
+    flow.config.cpu_device_num(2)
+    flow.config.slice_boxing_chunk_mbyte(1)
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+
+    @flow.global_function(function_config=func_config)
+    def chunked_boxing_job(input_blob: oft.Numpy.Placeholder((96, 96, 96))):
+        with flow.scope.placement("cpu", "0:0-1"):
+            src = flow.identity(input_blob.with_distribute(flow.distribute.split(0)))
+            if src_sbp == "partial_sum":
+                src = flow.math.reduce_sum(src, axis=0)
+        with flow.scope.placement("cpu", "1:0-1"):
+            dst = flow.identity(src.with_distribute(flow.distribute.split(dst_axis)))
+        return dst
+
+    x = np.random.uniform(-1e-5, 1e-5, (96, 96, 96)).astype(np.float32)
+    out = chunked_boxing_job(x).get().numpy()
+    if src_sbp == "partial_sum":
+        test_case.assertTrue(np.allclose(np.sum(x, axis=0), out))
+    else:
+        test_case.assertTrue(np.array_equal(x, out))
+
+
 @flow.unittest.skip_unless_1n4d()
 class TestBoxingV2(flow.unittest.TestCase):
     @unittest.skipIf(os.getenv("ONEFLOW_TEST_CPU_ONLY"), "only test cpu cases")
@@ -348,5 +374,15 @@ class TestBoxingV2(flow.unittest.TestCase):
             _test_multi_lbi(test_case, *arg)
 
 
+@flow.unittest.skip_unless_2n1d()
+class TestSliceBoxingChunked(flow.unittest.TestCase):
+    def test_chunked_boxing_across_machines(test_case):
+        arg_dict = OrderedDict()
+        arg_dict["src_sbp"] = ["split", "partial_sum"]
+        arg_dict["dst_axis"] = [0, 1]
+        for arg in GenArgList(arg_dict):
+            _test_chunked_boxing_across_machines(test_case, *arg)
+
+
 if __name__ == "__main__":
     unittest.main()
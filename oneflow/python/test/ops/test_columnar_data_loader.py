@@ -0,0 +1,194 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import os
+import struct
+import tempfile
+import typing
+import unittest
+import zlib
+
+import numpy as np
+import oneflow as flow
+import oneflow.core.common.data_type_pb2 as data_type_util
+
+# rows of each file, in row groups of at most 8 rows
+FILE_NUM_ROWS = [20, 12]
+ROW_GROUP_SIZE = 8
+IDS_ROW_LENGTH = 3
+
+
+def _label(row):
+    return np.array([row], dtype=np.int64)
+
+
+def _dense(row):
+    return np.arange(3, dtype=np.float32) + row * 10
+
+
+def _ids(row):
+    # varying length rows, truncated or padded with zeros by the loader
+    return np.arange(row % 5, dtype=np.int8) + 1
+
+
+def _expected_rows(samples):
+    labels, dense, ids = [], [], []
+    for sample in samples:
+        row = sample % sum(FILE_NUM_ROWS)
+        labels.append(_label(row))
+        dense.append(_dense(row))
+        padded = np.zeros(IDS_ROW_LENGTH, dtype=np.int8)
+        values = _ids(row)[:IDS_ROW_LENGTH]
+        padded[: len(values)] = values
+        ids.append(padded)
+    return np.stack(labels), np.stack(dense), np.stack(ids)
+
+
+def _write_columnar_file(path, first_row, num_rows):
+    """Writes the label, dense and ids columns in the layout of
+    oneflow/user/data/columnar_dataset.h, with the ids column zlib compressed."""
+    columns = [
+        ("label", data_type_util.kInt64, 0, 1, _label),
+        ("dense", data_type_util.kFloat, 0, 3, _dense),
+        ("ids", data_type_util.kInt8, 1, 0, _ids),
+    ]
+    row_groups = [
+        list(range(begin, min(begin + ROW_GROUP_SIZE, first_row + num_rows)))
+        for begin in range(first_row, first_row + num_rows, ROW_GROUP_SIZE)
+    ]
+    with open(path, "wb") as f:
+        f.write(b"OFCOLUMN")
+        column2chunks = []
+        for _, _, compression, row_length, values in columns:
+            chunks = []
+            for rows in row_groups:
+                row_values = [values(row) for row in rows]
+                raw = np.concatenate(row_values).tobytes()
+                if row_length == 0:
+                    offsets = np.zeros(len(rows) + 1, dtype=np.int64)
+                    np.cumsum([len(v) for v in row_values], out=offsets[1:])
+                    raw = offsets.tobytes() + raw
+                stored = zlib.compress(raw) if compression == 1 else raw
+                f.write(b"\0" * (-f.tell() % 64))
+                chunks.append((f.tell(), len(stored), len(raw)))
+                f.write(stored)
+            column2chunks.append(chunks)
+        footer = [struct.pack("<QQ", 1, len(row_groups))]
+        footer += [struct.pack("<Q", len(rows)) for rows in row_groups]
+        footer.append(struct.pack("<Q", len(columns)))
+        for (name, data_type, compression, row_length, _), chunks in zip(
+            columns, column2chunks
+        ):
+            footer.append(struct.pack("<Q", len(name)) + name.encode("utf-8"))
+            footer.append(struct.pack("<iiq", data_type, compression, row_length))
+            footer += [struct.pack("<QQQ", *chunk) for chunk in chunks]
+        footer = b"".join(footer)
+        f.write(footer + struct.pack("<Q", len(footer)) + b"OFCOLUMN")
+
+
+def _write_columnar_files(data_dir):
+    files = []
+    first_row = 0
+    for i, num_rows in enumerate(FILE_NUM_ROWS):
+        files.append(os.path.join(data_dir, "part-{}.ofcol".format(i)))
+        _write_columnar_file(files[-1], first_row, num_rows)
+        first_row += num_rows
+    return files
+
+
+def _make_columnar_data_loader_func(
+    test_case, files, batch_size, device_num, shuffle=False, random_seed=None
+):
+    flow.clear_default_session()
+    flow.config.cpu_device_num(device_num)
+    func_config = flow.FunctionConfig()
+    func_config.default_logical_view(flow.scope.consistent_view())
+
+    @flow.global_function(function_config=func_config)
+    def columnar_data_loader_fn() -> typing.Tuple[
+        flow.typing.Numpy, flow.typing.Numpy, flow.typing.Numpy
+    ]:
+        with flow.scope.placement("cpu", "0:0-{}".format(device_num - 1)):
+            label, dense, ids = flow.data.columnar_data_loader(
+                files,
+                columns=["label", "dense", "ids"],
+                row_lengths=[1, 3, IDS_ROW_LENGTH],
+                dtypes=[flow.int64, flow.float, flow.int8],
+                batch_size=batch_size,
+                shuffle=shuffle,
+                random_seed=random_seed,
+            )
+            for blob in [label, dense, ids]:
+                test_case.assertEqual(blob.shape[0], batch_size)
+                if device_num > 1:
+                    test_case.assertEqual(blob.split_axis, 0)
+        return label, dense, ids
+
+    return columnar_data_loader_fn
+
+
+@unittest.skipIf(
+    flow.unittest.env.eager_execution_enabled(),
+    "columnar_data_loader is tested in lazy consistent view only",
+)
+@flow.unittest.skip_unless_1n1d()
+class TestColumnarDataLoader(flow.unittest.TestCase):
+    def _load(test_case, batch_size, batch_num, device_num, shuffle=False):
+        with tempfile.TemporaryDirectory() as data_dir:
+            files = _write_columnar_files(data_dir)
+            loader_fn = _make_columnar_data_loader_func(
+                test_case, files, batch_size, device_num, shuffle, random_seed=5
+            )
+            batches = [loader_fn() for _ in range(batch_num)]
+        return [np.concatenate(column) for column in zip(*batches)]
+
+    def test_columns_across_files_and_epochs(test_case):
+        # 48 samples cover the 32 rows of the first epoch and half of the second
+        label, dense, ids = test_case._load(batch_size=8, batch_num=6, device_num=1)
+        expected = _expected_rows(range(48))
+        test_case.assertTrue(np.array_equal(label, expected[0]))
+        test_case.assertTrue(np.array_equal(dense, expected[1]))
+        test_case.assertTrue(np.array_equal(ids, expected[2]))
+
+    def test_split_ranks_interleave_batches(test_case):
+        # rank r reads local batch b from sample (b * 2 + r) * 4, so the logical batches of 2
+        # ranks are the same as those of 1 rank
+        label, dense, ids = test_case._load(batch_size=8, batch_num=6, device_num=2)
+        expected = _expected_rows(range(48))
+        test_case.assertTrue(np.array_equal(label, expected[0]))
+        test_case.assertTrue(np.array_equal(dense, expected[1]))
+        test_case.assertTrue(np.array_equal(ids, expected[2]))
+
+    def test_shuffle(test_case):
+        num_rows = sum(FILE_NUM_ROWS)
+        label, dense, ids = test_case._load(
+            batch_size=8, batch_num=8, device_num=1, shuffle=True
+        )
+        label = label.reshape(-1)
+        epochs = [label[:num_rows], label[num_rows:]]
+        for epoch in epochs:
+            test_case.assertTrue(np.array_equal(np.sort(epoch), np.arange(num_rows)))
+        _, expected_dense, expected_ids = _expected_rows(label)
+        test_case.assertTrue(np.array_equal(dense, expected_dense))
+        test_case.assertTrue(np.array_equal(ids, expected_ids))
+        # ranks read the same shuffled order for the same seed
+        split_label, _, _ = test_case._load(
+            batch_size=8, batch_num=8, device_num=2, shuffle=True
+        )
+        test_case.assertTrue(np.array_equal(split_label.reshape(-1), label))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,64 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import unittest
+from collections import OrderedDict
+
+import numpy as np
+import oneflow as flow
+from test_util import GenArgList
+import oneflow.typing as oft
+
+
+def compare_with_numpy(test_case, enable_cost_aware, enable_numa_aware, device_name):
+    flow.clear_default_session()
+    flow.config.cpu_device_num(4)
+    flow.config.enable_cost_aware_cpu_stream_assignment(enable_cost_aware)
+    flow.config.enable_numa_aware_cpu_actor(enable_numa_aware)
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float)
+    func_config.default_logical_view(flow.scope.consistent_view())
+
+    @flow.global_function(type="predict", function_config=func_config)
+    def CpuStreamAssignmentJob(
+        a: oft.Numpy.Placeholder((64, 32)), b: oft.Numpy.Placeholder((32, 16))
+    ):
+        with flow.scope.placement("cpu", device_name):
+            x = flow.matmul(a, b)
+            y = flow.nn.relu(x)
+            z = flow.math.tanh(flow.matmul(a, b) * 0.5)
+            return y + z
+
+    a = np.random.uniform(-1, 1, (64, 32)).astype(np.float32)
+    b = np.random.uniform(-1, 1, (32, 16)).astype(np.float32)
+    of_out = CpuStreamAssignmentJob(a, b).get().numpy()
+    x = np.matmul(a, b)
+    np_out = np.maximum(x, 0) + np.tanh(x * 0.5)
+    test_case.assertTrue(np.allclose(of_out, np_out, rtol=1e-4, atol=1e-4))
+
+
+@flow.unittest.skip_unless_1n1d()
+class TestCpuStreamAssignment(flow.unittest.TestCase):
+    def test_cpu_stream_assignment(test_case):
+        arg_dict = OrderedDict()
+        arg_dict["enable_cost_aware"] = [True, False]
+        arg_dict["enable_numa_aware"] = [True, False]
+        arg_dict["device_name"] = ["0:0", "0:0-3"]
+        for arg in GenArgList(arg_dict):
+            compare_with_numpy(test_case, *arg)
+
+
+if __name__ == "__main__":
+    unittest.main()
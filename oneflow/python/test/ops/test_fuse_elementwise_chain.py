@@ -0,0 +1,79 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import unittest
+from collections import OrderedDict
+
+import numpy as np
+import oneflow as flow
+from test_util import GenArgList, type_name_to_flow_type, type_name_to_np_type
+import oneflow.typing as oft
+
+
+def compare_with_numpy(input_shape, data_type, enable_fuse, has_branch):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(type_name_to_flow_type[data_type])
+    func_config.enable_fuse_elementwise_chain(enable_fuse)
+
+    @flow.global_function(type="predict", function_config=func_config)
+    def FuseElementwiseChainJob(
+        x: oft.Numpy.Placeholder(input_shape, dtype=type_name_to_flow_type[data_type])
+    ):
+        with flow.scope.placement("cpu", "0:0"):
+            y = flow.math.exp(x) * 0.5
+            y = flow.nn.relu(y + 1)
+            z = flow.math.tanh(y)
+            if has_branch:
+                return flow.math.sigmoid(y) + flow.math.square(z)
+            return z
+
+    np_x = np.random.uniform(-1, 1, input_shape).astype(type_name_to_np_type[data_type])
+    of_out = FuseElementwiseChainJob(np_x).get().numpy()
+    np_y = np.maximum(np.exp(np_x) * 0.5 + 1, 0)
+    np_z = np.tanh(np_y)
+    if has_branch:
+        np_out = 1 / (1 + np.exp(-np_y)) + np.square(np_z)
+    else:
+        np_out = np_z
+    assert np.allclose(of_out, np_out, rtol=1e-5, atol=1e-5)
+
+    job = [
+        job
+        for job in flow.experimental.get_job_set().job
+        if job.job_conf.job_name == "FuseElementwiseChainJob"
+    ][0]
+    op_type_names = set(
+        op.user_conf.op_type_name for op in job.net.op if op.HasField("user_conf")
+    )
+    assert ("elementwise_unary_chain" in op_type_names) == enable_fuse
+    for fused_type_name in ["exp", "relu", "tanh"]:
+        assert (fused_type_name in op_type_names) != enable_fuse
+
+
+@flow.unittest.skip_unless_1n1d()
+class TestFuseElementwiseChain(flow.unittest.TestCase):
+    def test_fuse_elementwise_chain(test_case):
+        arg_dict = OrderedDict()
+        arg_dict["input_shape"] = [(5, 4, 3), (1024, 129)]
+        arg_dict["data_type"] = ["float32", "double"]
+        arg_dict["enable_fuse"] = [True, False]
+        arg_dict["has_branch"] = [True, False]
+        for arg in GenArgList(arg_dict):
+            compare_with_numpy(*arg)
+
+
+if __name__ == "__main__":
+    unittest.main()
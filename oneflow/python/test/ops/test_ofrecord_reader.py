@@ -0,0 +1,113 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import os
+import struct
+import tempfile
+import typing
+import unittest
+
+import numpy as np
+import oneflow as flow
+import oneflow.core.record.record_pb2 as record_pb
+
+NUM_RECORDS = 6
+
+
+def _dense(i):
+    return np.arange(4, dtype=np.float32) + i * 10
+
+
+def _raw(i):
+    return np.array([i, 255 - i, 7, 0], dtype=np.uint8)
+
+
+def _length_delimited(tag, data):
+    assert len(data) < 128
+    return bytes([tag, len(data)]) + data
+
+
+def _serialize_record(i):
+    record = record_pb.OFRecord()
+    record.feature["label"].int64_list.value.append(i)
+    record.feature["raw"].bytes_list.value.append(_raw(i).tobytes())
+    # the dense list is written in two halves, which parsers merge
+    halves = [record_pb.Feature(), record_pb.Feature()]
+    halves[0].float_list.value.extend(_dense(i)[:2].tolist())
+    halves[1].float_list.value.extend(_dense(i)[2:].tolist())
+    entry = _length_delimited(0x0A, b"dense") + b"".join(
+        _length_delimited(0x12, half.SerializeToString()) for half in halves
+    )
+    return record.SerializeToString() + _length_delimited(0x0A, entry)
+
+
+def _write_ofrecord_file(path):
+    with open(path, "wb") as f:
+        for i in range(NUM_RECORDS):
+            serialized = _serialize_record(i)
+            f.write(struct.pack("q", len(serialized)))
+            f.write(serialized)
+
+
+def _make_ofrecord_reader_func(data_dir, output_serialized):
+    flow.clear_default_session()
+
+    @flow.global_function()
+    def ofrecord_reader_fn() -> typing.Tuple[
+        flow.typing.Numpy, flow.typing.Numpy, flow.typing.Numpy
+    ]:
+        with flow.scope.placement("cpu", "0:0"):
+            records = flow.data.ofrecord_reader(
+                data_dir,
+                batch_size=NUM_RECORDS,
+                data_part_num=1,
+                output_serialized=output_serialized,
+            )
+            label = flow.data.OFRecordRawDecoder(
+                records, "label", shape=(1,), dtype=flow.int32
+            )
+            dense = flow.data.OFRecordRawDecoder(
+                records, "dense", shape=(4,), dtype=flow.float
+            )
+            raw = flow.data.OFRecordRawDecoder(
+                records, "raw", shape=(4,), dtype=flow.uint8
+            )
+        return label, dense, raw
+
+    return ofrecord_reader_fn
+
+
+@unittest.skipIf(
+    flow.unittest.env.eager_execution_enabled(),
+    "ofrecord_reader is tested in lazy mode only",
+)
+@flow.unittest.skip_unless_1n1d()
+class TestOFRecordReader(flow.unittest.TestCase):
+    def test_output_serialized(test_case):
+        expected_label = np.arange(NUM_RECORDS, dtype=np.int32).reshape(-1, 1)
+        expected_dense = np.stack([_dense(i) for i in range(NUM_RECORDS)])
+        expected_raw = np.stack([_raw(i) for i in range(NUM_RECORDS)])
+        with tempfile.TemporaryDirectory() as data_dir:
+            _write_ofrecord_file(os.path.join(data_dir, "part-0"))
+            for output_serialized in [False, True]:
+                reader_fn = _make_ofrecord_reader_func(data_dir, output_serialized)
+                label, dense, raw = reader_fn()
+                test_case.assertTrue(np.array_equal(label, expected_label))
+                test_case.assertTrue(np.array_equal(dense, expected_dense))
+                test_case.assertTrue(np.array_equal(raw, expected_raw))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,109 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import os
+import unittest
+from collections import OrderedDict
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as oft
+from test_util import GenArgList
+
+
+def _run_mlp(x, device_type, memory_budget):
+    flow.clear_default_session()
+    func_config = flow.FunctionConfig()
+    func_config.default_data_type(flow.float32)
+    if memory_budget is not None:
+        func_config.recomputation_memory_budget(memory_budget)
+
+    @flow.global_function(type="train", function_config=func_config)
+    def MlpJob(x: oft.Numpy.Placeholder(x.shape)):
+        with flow.scope.placement(device_type, "0:0"):
+            hidden = x
+            for i in range(3):
+                w = flow.get_variable(
+                    "w{}".format(i),
+                    shape=(x.shape[1], x.shape[1]),
+                    initializer=flow.constant_initializer(0.01 * (i + 1)),
+                )
+                hidden = flow.matmul(hidden, w)
+                hidden = flow.math.tanh(flow.nn.relu(hidden) + 1)
+            loss = flow.math.reduce_mean(hidden * hidden)
+            flow.optimizer.SGD(
+                flow.optimizer.PiecewiseConstantScheduler([], [1e-2]), momentum=0
+            ).minimize(loss)
+        return loss
+
+    losses = [MlpJob(x).get().numpy() for _ in range(3)]
+    return losses, _recomputed_op_names()
+
+
+def _recomputed_op_names():
+    # CheckpointingPass adds a recomputation op under this prefix for each dropped op
+    job = [
+        job
+        for job in flow.experimental.get_job_set().job
+        if job.job_conf.job_name == "MlpJob"
+    ][0]
+    return [
+        op.name
+        for op in job.net.op
+        if op.name.startswith("OneFlow-System-Checkpointing-Fake-Fw-Op_")
+    ]
+
+
+def compare_with_no_recomputation(device_type, memory_budget):
+    x = np.random.uniform(-1, 1, (16, 32)).astype(np.float32)
+    expected, no_budget_recomputed = _run_mlp(x, device_type, None)
+    actual, recomputed = _run_mlp(x, device_type, memory_budget)
+    for lhs, rhs in zip(expected, actual):
+        assert np.allclose(lhs, rhs, rtol=1e-5, atol=1e-5)
+    assert len(no_budget_recomputed) == 0
+    return len(recomputed)
+
+
+def check_recomputed_op_cnt(device_type):
+    recomputed_op_cnts = [
+        compare_with_no_recomputation(*arg)
+        for arg in GenArgList(_gen_arg_dict(device_type))
+    ]
+    # a smaller budget recomputes more ops, the largest one recomputes none
+    assert recomputed_op_cnts[0] > 0, recomputed_op_cnts
+    assert recomputed_op_cnts == sorted(recomputed_op_cnts, reverse=True)
+    assert recomputed_op_cnts[-1] == 0, recomputed_op_cnts
+
+
+def _gen_arg_dict(device_type):
+    arg_dict = OrderedDict()
+    arg_dict["device_type"] = [device_type]
+    # 1 byte drops every recomputable op, 1GB drops none
+    arg_dict["memory_budget"] = [1, 4096, 1 << 30]
+    return arg_dict
+
+
+@flow.unittest.skip_unless_1n1d()
+class TestRecomputationMemoryBudget(flow.unittest.TestCase):
+    def test_recomputation_memory_budget_cpu(test_case):
+        check_recomputed_op_cnt("cpu")
+
+    @unittest.skipIf(os.getenv("ONEFLOW_TEST_CPU_ONLY"), "only test cpu cases")
+    def test_recomputation_memory_budget_gpu(test_case):
+        check_recomputed_op_cnt("gpu")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,69 @@
+"""
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+import unittest
+
+import numpy as np
+import oneflow as flow
+import oneflow.typing as tp
+
+
+def make_job(x_shape, w_shape, b_shape, use_native):
+    config = flow.function_config()
+    config.default_data_type(flow.float32)
+    config.use_xla_jit(False)
+    config.use_tensorrt(False)
+    config.use_xrt_native(use_native)
+
+    @flow.global_function(function_config=config)
+    def mlp_job(
+        x: tp.Numpy.Placeholder(x_shape),
+        w: tp.Numpy.Placeholder(w_shape),
+        b: tp.Numpy.Placeholder(b_shape),
+    ) -> tp.Numpy:
+        with flow.scope.placement("cpu", "0:0"):
+            y = flow.matmul(x, w)
+            y = flow.nn.bias_add(y, b)
+            y = flow.math.gelu(y)
+            z = flow.math.sigmoid(y) * y + 0.5
+            z = flow.math.relu(z - flow.math.tanh(y))
+            z = flow.math.reduce_sum(z, axis=[1], keepdims=True)
+            return flow.math.rsqrt(z + 1.0) + flow.math.reduce_sum(y, axis=[0])
+
+    return mlp_job
+
+
+class TestNativeEngine(unittest.TestCase):
+    def _test_body(self, m, k, n):
+        x = np.random.randn(m, k).astype(np.float32)
+        w = np.random.randn(k, n).astype(np.float32)
+        b = np.random.randn(n).astype(np.float32)
+        flow.clear_default_session()
+        a = make_job(x.shape, w.shape, b.shape, False)(x, w, b)
+        flow.clear_default_session()
+        c = make_job(x.shape, w.shape, b.shape, True)(x, w, b)
+        flow.clear_default_session()
+        self.assertTrue(np.allclose(a, c, rtol=1e-03, atol=1e-04))
+
+    def test_small(self):
+        self._test_body(4, 8, 16)
+
+    def test_large(self):
+        # Large enough to be evaluated by multiple threads.
+        self._test_body(512, 256, 1024)
+
+
+if __name__ == "__main__":
+    unittest.main()
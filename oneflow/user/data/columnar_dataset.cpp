@@ -0,0 +1,302 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/data/columnar_dataset.h"
+#include "oneflow/core/thread/thread_manager.h"
+
+#include <numeric>
+#include <zlib.h>
+
+namespace oneflow {
+
+namespace data {
+
+namespace {
+
+class FooterReader final {
+ public:
+  FooterReader(const char* data, size_t size) : data_(data), size_(size), pos_(0) {}
+  ~FooterReader() = default;
+
+  template<typename T>
+  T Read() {
+    CHECK_LE(pos_ + sizeof(T), size_) << "columnar file footer is truncated";
+    T value;
+    std::memcpy(&value, data_ + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+
+  std::string ReadString(size_t length) {
+    CHECK_LE(pos_ + length, size_) << "columnar file footer is truncated";
+    std::string str(data_ + pos_, length);
+    pos_ += length;
+    return str;
+  }
+
+  bool eof() const { return pos_ == size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t pos_;
+};
+
+}  // namespace
+
+constexpr char ColumnarFile::kMagicCode[];
+constexpr size_t ColumnarFile::kChunkAlignment;
+
+ColumnarFile::ColumnarFile(const std::string& filename) : filename_(filename), num_rows_(0) {
+  data_ = std::make_unique<const MappedBuffer>(filename);
+  const char* ptr = static_cast<const char*>(data_->ptr());
+  const size_t size = data_->size();
+  const size_t trailer_size = sizeof(uint64_t) + kMagicCodeLen;
+  CHECK_GE(size, kMagicCodeLen + trailer_size) << filename << " is not a columnar file";
+  CHECK_EQ(std::memcmp(ptr, kMagicCode, kMagicCodeLen), 0)
+      << filename << " is not a columnar file";
+  CHECK_EQ(std::memcmp(ptr + size - kMagicCodeLen, kMagicCode, kMagicCodeLen), 0)
+      << filename << " is not a complete columnar file";
+  uint64_t footer_size = 0;
+  std::memcpy(&footer_size, ptr + size - trailer_size, sizeof(footer_size));
+  CHECK_LE(footer_size, size - kMagicCodeLen - trailer_size);
+  const size_t footer_offset = size - trailer_size - footer_size;
+  ParseFooter(ptr + footer_offset, footer_size, footer_offset);
+}
+
+void ColumnarFile::ParseFooter(const char* footer, size_t footer_size, size_t data_size) {
+  FooterReader reader(footer, footer_size);
+  CHECK_EQ(reader.Read<uint64_t>(), kVersion) << "unsupported version of " << filename_;
+  row_group_num_rows_.resize(reader.Read<uint64_t>());
+  for (size_t& num_rows : row_group_num_rows_) {
+    num_rows = reader.Read<uint64_t>();
+    num_rows_ += num_rows;
+  }
+  columns_.resize(reader.Read<uint64_t>());
+  FOR_RANGE(size_t, i, 0, columns_.size()) {
+    ColumnarColumnMeta* column = &columns_.at(i);
+    column->name = reader.ReadString(reader.Read<uint64_t>());
+    column->data_type = static_cast<DataType>(reader.Read<int32_t>());
+    CHECK(IsPODDataType(column->data_type))
+        << "column " << column->name << " of " << filename_ << " has invalid data type";
+    column->compression = static_cast<ColumnarCompression>(reader.Read<int32_t>());
+    CHECK(column->compression == kColumnarNoCompression
+          || column->compression == kColumnarZlibCompression)
+        << "column " << column->name << " of " << filename_ << " has invalid compression";
+    column->row_length = reader.Read<int64_t>();
+    CHECK_GE(column->row_length, 0);
+    const size_t value_size = GetSizeOfDataType(column->data_type);
+    column->chunks.resize(num_row_groups());
+    FOR_RANGE(size_t, j, 0, num_row_groups()) {
+      ColumnarChunkMeta* chunk = &column->chunks.at(j);
+      chunk->offset = reader.Read<uint64_t>();
+      chunk->stored_size = reader.Read<uint64_t>();
+      chunk->raw_size = reader.Read<uint64_t>();
+      CHECK_EQ(chunk->offset % kChunkAlignment, 0);
+      CHECK_GE(chunk->offset, kMagicCodeLen);
+      CHECK_LE(chunk->offset + chunk->stored_size, data_size);
+      if (column->compression == kColumnarNoCompression) {
+        CHECK_EQ(chunk->stored_size, chunk->raw_size);
+      }
+      const size_t num_rows = row_group_num_rows_.at(j);
+      if (column->row_length > 0) {
+        CHECK_EQ(chunk->raw_size, num_rows * column->row_length * value_size);
+      } else {
+        CHECK_GE(chunk->raw_size, (num_rows + 1) * sizeof(int64_t));
+      }
+    }
+    CHECK(column_name2index_.emplace(column->name, i).second)
+        << "duplicated column " << column->name << " in " << filename_;
+  }
+  CHECK(reader.eof()) << "columnar file footer of " << filename_ << " has trailing bytes";
+}
+
+int64_t ColumnarFile::ColumnIndex4Name(const std::string& name) const {
+  const auto it = column_name2index_.find(name);
+  if (it == column_name2index_.end()) { return -1; }
+  return it->second;
+}
+
+const char* ColumnarFile::ReadChunk(size_t column_index, size_t row_group,
+                                    std::vector<char>* buffer) const {
+  const ColumnarColumnMeta& meta = column(column_index);
+  const ColumnarChunkMeta& chunk = meta.chunks.at(row_group);
+  const char* raw = static_cast<const char*>(data_->ptr()) + chunk.offset;
+  if (meta.compression == kColumnarZlibCompression) {
+    buffer->resize(chunk.raw_size);
+    uLongf raw_size = chunk.raw_size;
+    const int ret = uncompress(reinterpret_cast<Bytef*>(buffer->data()), &raw_size,
+                               reinterpret_cast<const Bytef*>(raw), chunk.stored_size);
+    CHECK_EQ(ret, Z_OK) << "inflating column " << meta.name << " of " << filename_ << " failed";
+    CHECK_EQ(raw_size, chunk.raw_size);
+    raw = buffer->data();
+  }
+  if (meta.row_length == 0) {
+    // value offsets must cover exactly the values that follow them
+    const size_t num_rows = row_group_num_rows(row_group);
+    const int64_t* offsets = reinterpret_cast<const int64_t*>(raw);
+    const size_t values_size = chunk.raw_size - (num_rows + 1) * sizeof(int64_t);
+    CHECK_EQ(offsets[0], 0);
+    FOR_RANGE(size_t, i, 0, num_rows) { CHECK_LE(offsets[i], offsets[i + 1]); }
+    CHECK_EQ(offsets[num_rows] * GetSizeOfDataType(meta.data_type), values_size);
+  }
+  return raw;
+}
+
+ColumnarDataset::ColumnarDataset(const std::vector<std::string>& files,
+                                 const std::vector<std::string>& column_names, bool shuffle,
+                                 uint32_t seed)
+    : column_names_(column_names), shuffle_(shuffle), seed_(seed), num_rows_(0), epoch_(0) {
+  auto start = std::chrono::system_clock::now();
+  CHECK_GT(files.size(), 0);
+  CHECK_GT(column_names.size(), 0);
+  FOR_RANGE(size_t, file_index, 0, files.size()) {
+    files_.emplace_back(std::make_unique<const ColumnarFile>(files.at(file_index)));
+    const ColumnarFile& file = *files_.back();
+    std::vector<size_t> column_indices;
+    for (const std::string& name : column_names) {
+      const int64_t column_index = file.ColumnIndex4Name(name);
+      CHECK_GE(column_index, 0) << "column " << name << " not found in " << files.at(file_index);
+      if (file_index > 0) {
+        const ColumnarColumnMeta& meta = file.column(column_index);
+        const ColumnarColumnMeta& first_meta =
+            files_.front()->column(file2column_indices_.front().at(column_indices.size()));
+        CHECK_EQ(meta.data_type, first_meta.data_type)
+            << "column " << name << " of " << files.at(file_index) << " has different data type";
+        CHECK_EQ(meta.row_length, first_meta.row_length)
+            << "column " << name << " of " << files.at(file_index) << " has different row length";
+      }
+      column_indices.push_back(column_index);
+    }
+    file2column_indices_.push_back(column_indices);
+    FOR_RANGE(size_t, i, 0, file.num_row_groups()) {
+      const size_t num_rows = file.row_group_num_rows(i);
+      if (num_rows == 0) { continue; }
+      row_groups_.push_back(RowGroup{file_index, i, num_rows});
+      num_rows_ += num_rows;
+    }
+  }
+  CHECK_GT(num_rows_, 0) << "columnar dataset is empty";
+  loaded_row_group_ = row_groups_.size();
+  chunk_buffers_.resize(num_columns());
+  chunks_.resize(num_columns(), nullptr);
+  InitEpoch(0);
+  std::chrono::duration<double, std::milli> elapse = std::chrono::system_clock::now() - start;
+  LOG(INFO) << "Create columnar dataset successed, number of files: " << files_.size()
+            << ", number of row groups: " << row_groups_.size()
+            << ", number of rows: " << num_rows_ << ", number of columns: " << num_columns()
+            << ", shuffle: " << std::boolalpha << shuffle_ << ", random_seed: " << seed_
+            << ", elapsed time: " << elapse.count() << " ms";
+}
+
+DataType ColumnarDataset::column_data_type(size_t i) const {
+  return files_.front()->column(file2column_indices_.front().at(i)).data_type;
+}
+
+int64_t ColumnarDataset::column_row_length(size_t i) const {
+  return files_.front()->column(file2column_indices_.front().at(i)).row_length;
+}
+
+void ColumnarDataset::GetBatch(size_t sample_index, size_t batch_size,
+                               const std::vector<int64_t>& out_row_lengths,
+                               const std::vector<void*>& out) {
+  CHECK_EQ(out_row_lengths.size(), num_columns());
+  CHECK_EQ(out.size(), num_columns());
+  size_t out_row = 0;
+  while (out_row < batch_size) {
+    const size_t sample = sample_index + out_row;
+    const size_t epoch = sample / num_rows_;
+    if (epoch != epoch_) { InitEpoch(epoch); }
+    const size_t epoch_row = sample % num_rows_;
+    const size_t i = std::upper_bound(epoch_row_offsets_.cbegin(), epoch_row_offsets_.cend(),
+                                      epoch_row)
+                     - epoch_row_offsets_.cbegin() - 1;
+    const size_t row_group = epoch_row_groups_.at(i);
+    if (row_group != loaded_row_group_) { LoadRowGroup(row_group); }
+    const size_t num_rows =
+        std::min(batch_size - out_row, epoch_row_offsets_.at(i + 1) - epoch_row);
+    CopyRows(epoch_row - epoch_row_offsets_.at(i), num_rows, out_row, out_row_lengths, out);
+    out_row += num_rows;
+  }
+}
+
+void ColumnarDataset::InitEpoch(size_t epoch) {
+  epoch_ = epoch;
+  epoch_row_groups_.resize(row_groups_.size());
+  std::iota(epoch_row_groups_.begin(), epoch_row_groups_.end(), 0);
+  if (shuffle_) {
+    std::mt19937 gen(seed_ + epoch);
+    std::shuffle(epoch_row_groups_.begin(), epoch_row_groups_.end(), gen);
+  }
+  epoch_row_offsets_.resize(row_groups_.size() + 1);
+  epoch_row_offsets_.at(0) = 0;
+  FOR_RANGE(size_t, i, 0, row_groups_.size()) {
+    epoch_row_offsets_.at(i + 1) =
+        epoch_row_offsets_.at(i) + row_groups_.at(epoch_row_groups_.at(i)).num_rows;
+  }
+}
+
+void ColumnarDataset::LoadRowGroup(size_t row_group) {
+  const RowGroup& group = row_groups_.at(row_group);
+  const ColumnarFile& file = *files_.at(group.file_index);
+  const std::vector<size_t>& column_indices = file2column_indices_.at(group.file_index);
+  size_t num_compressed = 0;
+  for (size_t column_index : column_indices) {
+    if (file.column(column_index).compression != kColumnarNoCompression) { num_compressed += 1; }
+  }
+  const auto Load = [&](size_t i) {
+    chunks_.at(i) =
+        file.ReadChunk(column_indices.at(i), group.index_in_file, &chunk_buffers_.at(i));
+  };
+  // inflating is the only real work, spread it over columns when there is more than one
+  if (num_compressed > 1 && Global<ThreadPool>::Get() != nullptr) {
+    MultiThreadLoop(num_columns(), Load);
+  } else {
+    FOR_RANGE(size_t, i, 0, num_columns()) { Load(i); }
+  }
+  loaded_row_group_ = row_group;
+}
+
+void ColumnarDataset::CopyRows(size_t row_begin, size_t num_rows, size_t out_row,
+                               const std::vector<int64_t>& out_row_lengths,
+                               const std::vector<void*>& out) const {
+  const RowGroup& group = row_groups_.at(loaded_row_group_);
+  const ColumnarFile& file = *files_.at(group.file_index);
+  const std::vector<size_t>& column_indices = file2column_indices_.at(group.file_index);
+  FOR_RANGE(size_t, i, 0, num_columns()) {
+    const ColumnarColumnMeta& meta = file.column(column_indices.at(i));
+    const size_t value_size = GetSizeOfDataType(meta.data_type);
+    const size_t out_row_size = out_row_lengths.at(i) * value_size;
+    char* dst = static_cast<char*>(out.at(i)) + out_row * out_row_size;
+    if (meta.row_length > 0) {
+      CHECK_EQ(meta.row_length, out_row_lengths.at(i));
+      std::memcpy(dst, chunks_.at(i) + row_begin * out_row_size, num_rows * out_row_size);
+    } else {
+      const int64_t* offsets = reinterpret_cast<const int64_t*>(chunks_.at(i)) + row_begin;
+      const char* values = chunks_.at(i) + (group.num_rows + 1) * sizeof(int64_t);
+      FOR_RANGE(size_t, j, 0, num_rows) {
+        const size_t length =
+            std::min<int64_t>(offsets[j + 1] - offsets[j], out_row_lengths.at(i)) * value_size;
+        std::memcpy(dst, values + offsets[j] * value_size, length);
+        std::memset(dst + length, 0, out_row_size - length);
+        dst += out_row_size;
+      }
+    }
+  }
+}
+
+}  // namespace data
+
+}  // namespace oneflow
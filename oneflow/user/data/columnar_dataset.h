@@ -0,0 +1,158 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_USER_DATA_COLUMNAR_DATASET_H_
+#define ONEFLOW_USER_DATA_COLUMNAR_DATASET_H_
+
+#include "oneflow/core/common/util.h"
+#include "oneflow/core/common/data_type.h"
+#include "oneflow/user/data/mapped_buffer.h"
+
+namespace oneflow {
+
+namespace data {
+
+// A columnar file stores each column of a table separately so that a reader only touches the
+// bytes of the columns it selects. All integers are little-endian:
+//
+//   "OFCOLUMN"        magic code
+//   column chunks     each starts at a multiple of kChunkAlignment bytes
+//   footer
+//   uint64            footer size in bytes
+//   "OFCOLUMN"        magic code
+//
+// Rows are split into row groups and every column holds one chunk per row group. The footer is
+//
+//   uint64 version, uint64 number of row groups, uint64 number of rows of each row group,
+//   uint64 number of columns, then for each column:
+//     uint64 name length, name, int32 DataType, int32 ColumnarCompression,
+//     int64 row length (number of values of each row, 0 if rows vary in length),
+//     uint64 offset, uint64 stored size and uint64 raw size of the chunk of each row group
+//
+// The raw chunk of a fixed length column holds num_rows * row_length values. The raw chunk of a
+// varying length column holds num_rows + 1 int64 value offsets followed by the values.
+enum ColumnarCompression : int32_t {
+  kColumnarNoCompression = 0,
+  kColumnarZlibCompression = 1,
+};
+
+struct ColumnarChunkMeta {
+  uint64_t offset;
+  uint64_t stored_size;
+  uint64_t raw_size;
+};
+
+struct ColumnarColumnMeta {
+  std::string name;
+  DataType data_type;
+  ColumnarCompression compression;
+  int64_t row_length;
+  std::vector<ColumnarChunkMeta> chunks;
+};
+
+class ColumnarFile final {
+ public:
+  ColumnarFile(const std::string& filename);
+  OF_DISALLOW_COPY_AND_MOVE(ColumnarFile);
+  ~ColumnarFile() = default;
+
+  static constexpr char kMagicCode[] = "OFCOLUMN";
+  static constexpr size_t kMagicCodeLen = sizeof(kMagicCode) - 1;
+  static constexpr uint64_t kVersion = 1;
+  static constexpr size_t kChunkAlignment = 64;
+
+  size_t num_rows() const { return num_rows_; }
+  size_t num_row_groups() const { return row_group_num_rows_.size(); }
+  size_t row_group_num_rows(size_t row_group) const { return row_group_num_rows_.at(row_group); }
+  size_t num_columns() const { return columns_.size(); }
+  const ColumnarColumnMeta& column(size_t column_index) const { return columns_.at(column_index); }
+  // Returns -1 if the file has no column named `name`
+  int64_t ColumnIndex4Name(const std::string& name) const;
+
+  // Returns the raw chunk of a column in a row group. An uncompressed chunk is read in place from
+  // the mapped file, a compressed chunk is inflated into `buffer`.
+  const char* ReadChunk(size_t column_index, size_t row_group, std::vector<char>* buffer) const;
+
+ private:
+  void ParseFooter(const char* footer, size_t footer_size, size_t data_size);
+
+  std::string filename_;
+  std::unique_ptr<const MappedBuffer> data_;
+  size_t num_rows_;
+  std::vector<size_t> row_group_num_rows_;
+  std::vector<ColumnarColumnMeta> columns_;
+  HashMap<std::string, int64_t> column_name2index_;
+};
+
+// Reads selected columns of a list of columnar files with the same schema as one table.
+//
+// Samples are numbered across epochs. Each epoch visits all rows once, and the order of row groups
+// is shuffled per epoch if `shuffle` is set. Rows of a row group stay in file order, so the chunks
+// of a row group are decoded only once per epoch.
+class ColumnarDataset final {
+ public:
+  ColumnarDataset(const std::vector<std::string>& files,
+                  const std::vector<std::string>& column_names, bool shuffle, uint32_t seed);
+  OF_DISALLOW_COPY_AND_MOVE(ColumnarDataset);
+  ~ColumnarDataset() = default;
+
+  size_t num_rows() const { return num_rows_; }
+  size_t num_columns() const { return column_names_.size(); }
+  DataType column_data_type(size_t i) const;
+  int64_t column_row_length(size_t i) const;
+
+  // Reads samples [sample_index, sample_index + batch_size) of selected column i into out[i], a
+  // batch_size x out_row_lengths[i] buffer. The row length of a fixed length column must equal
+  // out_row_lengths[i], while rows of a varying length column are truncated or padded with zeros.
+  void GetBatch(size_t sample_index, size_t batch_size, const std::vector<int64_t>& out_row_lengths,
+                const std::vector<void*>& out);
+
+ private:
+  struct RowGroup {
+    size_t file_index;
+    size_t index_in_file;
+    size_t num_rows;
+  };
+
+  void InitEpoch(size_t epoch);
+  void LoadRowGroup(size_t row_group);
+  void CopyRows(size_t row_begin, size_t num_rows, size_t out_row,
+                const std::vector<int64_t>& out_row_lengths, const std::vector<void*>& out) const;
+
+  std::vector<std::string> column_names_;
+  bool shuffle_;
+  uint32_t seed_;
+  std::vector<std::unique_ptr<const ColumnarFile>> files_;
+  // index of each selected column in each file
+  std::vector<std::vector<size_t>> file2column_indices_;
+  std::vector<RowGroup> row_groups_;
+  size_t num_rows_;
+
+  // row groups in the order of the current epoch and their first sample in the epoch
+  size_t epoch_;
+  std::vector<size_t> epoch_row_groups_;
+  std::vector<size_t> epoch_row_offsets_;
+
+  // raw chunks of the selected columns in the loaded row group
+  size_t loaded_row_group_;
+  std::vector<std::vector<char>> chunk_buffers_;
+  std::vector<const char*> chunks_;
+};
+
+}  // namespace data
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_USER_DATA_COLUMNAR_DATASET_H_
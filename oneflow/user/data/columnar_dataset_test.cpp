@@ -0,0 +1,206 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/data/columnar_dataset.h"
+
+#include <zlib.h>
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+using namespace data;
+
+struct TestColumn {
+  std::string name;
+  DataType data_type;
+  ColumnarCompression compression;
+  int64_t row_length;
+  // raw chunk of each row group
+  std::vector<std::string> chunks;
+};
+
+template<typename T>
+void Append(std::string* str, T value) {
+  str->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteColumnarFile(const std::string& filename, const std::vector<size_t>& row_group_num_rows,
+                       const std::vector<TestColumn>& columns) {
+  std::string data(ColumnarFile::kMagicCode, ColumnarFile::kMagicCodeLen);
+  std::string footer;
+  Append(&footer, ColumnarFile::kVersion);
+  Append(&footer, static_cast<uint64_t>(row_group_num_rows.size()));
+  for (size_t num_rows : row_group_num_rows) { Append(&footer, static_cast<uint64_t>(num_rows)); }
+  Append(&footer, static_cast<uint64_t>(columns.size()));
+  for (const TestColumn& column : columns) {
+    Append(&footer, static_cast<uint64_t>(column.name.size()));
+    footer.append(column.name);
+    Append(&footer, static_cast<int32_t>(column.data_type));
+    Append(&footer, static_cast<int32_t>(column.compression));
+    Append(&footer, column.row_length);
+    for (const std::string& raw : column.chunks) {
+      std::string stored = raw;
+      if (column.compression == kColumnarZlibCompression) {
+        uLongf stored_size = compressBound(raw.size());
+        stored.resize(stored_size);
+        CHECK_EQ(compress(reinterpret_cast<Bytef*>(&stored[0]), &stored_size,
+                          reinterpret_cast<const Bytef*>(raw.data()), raw.size()),
+                 Z_OK);
+        stored.resize(stored_size);
+      }
+      data.resize((data.size() + ColumnarFile::kChunkAlignment - 1)
+                  / ColumnarFile::kChunkAlignment * ColumnarFile::kChunkAlignment);
+      Append(&footer, static_cast<uint64_t>(data.size()));
+      Append(&footer, static_cast<uint64_t>(stored.size()));
+      Append(&footer, static_cast<uint64_t>(raw.size()));
+      data.append(stored);
+    }
+  }
+  data.append(footer);
+  Append(&data, static_cast<uint64_t>(footer.size()));
+  data.append(ColumnarFile::kMagicCode, ColumnarFile::kMagicCodeLen);
+  std::ofstream stream(filename, std::ios::binary);
+  stream.write(data.data(), data.size());
+  CHECK(stream.good());
+}
+
+template<typename T>
+std::string FixedChunk(size_t row_begin, size_t num_rows, int64_t row_length,
+                       const std::function<T(size_t row, int64_t i)>& Value) {
+  std::vector<T> values;
+  FOR_RANGE(size_t, row, row_begin, row_begin + num_rows) {
+    FOR_RANGE(int64_t, i, 0, row_length) { values.push_back(Value(row, i)); }
+  }
+  return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template<typename T>
+std::string VaryingChunk(size_t row_begin, size_t num_rows,
+                         const std::function<std::vector<T>(size_t row)>& Values) {
+  std::vector<int64_t> offsets(1, 0);
+  std::vector<T> values;
+  FOR_RANGE(size_t, row, row_begin, row_begin + num_rows) {
+    const std::vector<T> row_values = Values(row);
+    values.insert(values.end(), row_values.begin(), row_values.end());
+    offsets.push_back(values.size());
+  }
+  return std::string(reinterpret_cast<const char*>(offsets.data()),
+                     offsets.size() * sizeof(int64_t))
+         + std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+int32_t Label(size_t row, int64_t i) { return row; }
+float Dense(size_t row, int64_t i) { return row * 13 + i; }
+std::vector<int64_t> Sparse(size_t row) {
+  std::vector<int64_t> values;
+  FOR_RANGE(size_t, i, 0, row % 6) { values.push_back(row * 10 + i); }
+  return values;
+}
+
+// Writes rows [0, 17) and [17, 40) into two files of the same columns but in different order.
+std::vector<std::string> WriteTestFiles() {
+  const std::vector<std::vector<size_t>> file2row_group_num_rows = {{5, 0, 12}, {9, 9, 5}};
+  std::vector<std::string> files;
+  size_t row = 0;
+  FOR_RANGE(size_t, file_index, 0, file2row_group_num_rows.size()) {
+    const std::vector<size_t>& row_group_num_rows = file2row_group_num_rows.at(file_index);
+    std::vector<TestColumn> columns = {
+        {"label", kInt32, kColumnarNoCompression, 1, {}},
+        {"dense", kFloat, kColumnarZlibCompression, 13, {}},
+        {"sparse", kInt64, kColumnarZlibCompression, 0, {}},
+        {"unused", kFloat, kColumnarNoCompression, 100, {}},
+    };
+    for (size_t num_rows : row_group_num_rows) {
+      columns.at(0).chunks.push_back(FixedChunk<int32_t>(row, num_rows, 1, Label));
+      columns.at(1).chunks.push_back(FixedChunk<float>(row, num_rows, 13, Dense));
+      columns.at(2).chunks.push_back(VaryingChunk<int64_t>(row, num_rows, Sparse));
+      columns.at(3).chunks.push_back(FixedChunk<float>(row, num_rows, 100, Dense));
+      row += num_rows;
+    }
+    if (file_index == 1) { std::reverse(columns.begin(), columns.end()); }
+    files.push_back(::testing::TempDir() + "columnar_dataset_test_" + std::to_string(file_index));
+    WriteColumnarFile(files.back(), row_group_num_rows, columns);
+  }
+  return files;
+}
+
+void RemoveFiles(const std::vector<std::string>& files) {
+  for (const std::string& file : files) { std::remove(file.c_str()); }
+}
+
+}  // namespace
+
+TEST(ColumnarDataset, read_selected_columns) {
+  const std::vector<std::string> files = WriteTestFiles();
+  ColumnarDataset dataset(files, {"sparse", "label", "dense"}, false, 0);
+  ASSERT_EQ(dataset.num_rows(), 40);
+  ASSERT_EQ(dataset.column_data_type(0), kInt64);
+  ASSERT_EQ(dataset.column_row_length(0), 0);
+  ASSERT_EQ(dataset.column_row_length(2), 13);
+  const size_t batch_size = 7;
+  const int64_t sparse_length = 4;
+  std::vector<int64_t> sparse(batch_size * sparse_length);
+  std::vector<int32_t> label(batch_size);
+  std::vector<float> dense(batch_size * 13);
+  // crosses row groups, files and the end of the epoch
+  for (size_t sample_index = 0; sample_index < 100; sample_index += batch_size) {
+    dataset.GetBatch(sample_index, batch_size, {sparse_length, 1, 13},
+                     {sparse.data(), label.data(), dense.data()});
+    FOR_RANGE(size_t, i, 0, batch_size) {
+      const size_t row = (sample_index + i) % 40;
+      ASSERT_EQ(label.at(i), row);
+      FOR_RANGE(int64_t, j, 0, 13) { ASSERT_EQ(dense.at(i * 13 + j), Dense(row, j)); }
+      const std::vector<int64_t> values = Sparse(row);
+      FOR_RANGE(int64_t, j, 0, sparse_length) {
+        const int64_t expected = j < values.size() ? values.at(j) : 0;
+        ASSERT_EQ(sparse.at(i * sparse_length + j), expected);
+      }
+    }
+  }
+  RemoveFiles(files);
+}
+
+TEST(ColumnarDataset, shuffle_row_groups) {
+  const std::vector<std::string> files = WriteTestFiles();
+  ColumnarDataset dataset(files, {"label"}, true, 7);
+  std::vector<std::vector<int32_t>> epoch2labels;
+  FOR_RANGE(size_t, epoch, 0, 3) {
+    std::vector<int32_t> labels(40);
+    dataset.GetBatch(epoch * 40, 40, {1}, {labels.data()});
+    std::vector<int32_t> sorted = labels;
+    std::sort(sorted.begin(), sorted.end());
+    FOR_RANGE(int32_t, row, 0, 40) { ASSERT_EQ(sorted.at(row), row); }
+    // rows of a row group stay in order
+    size_t num_jumps = 0;
+    FOR_RANGE(size_t, i, 1, 40) { num_jumps += (labels.at(i) != labels.at(i - 1) + 1); }
+    ASSERT_LT(num_jumps, 5);
+    epoch2labels.push_back(labels);
+  }
+  ASSERT_TRUE(epoch2labels.at(0) != epoch2labels.at(1)
+              || epoch2labels.at(1) != epoch2labels.at(2));
+  // the order only depends on the seed and the epoch
+  ColumnarDataset same_seed_dataset(files, {"label"}, true, 7);
+  std::vector<int32_t> labels(40);
+  same_seed_dataset.GetBatch(80, 40, {1}, {labels.data()});
+  ASSERT_TRUE(labels == epoch2labels.at(2));
+  RemoveFiles(files);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
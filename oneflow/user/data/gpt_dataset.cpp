@@ -15,14 +15,6 @@ limitations under the License.
 */
 #include "oneflow/user/data/gpt_dataset.h"
 
-#ifdef __linux__
-#include <fcntl.h>
-#include <stdio.h>
-#include <errno.h>
-#include <sys/stat.h>
-#include <sys/mman.h>
-#endif
-
 namespace oneflow {
 
 namespace data {
@@ -120,28 +112,6 @@ MegatronGPTIndex::MegatronGPTIndex(const std::string& index_file_path) {
             << " ms";
 }
 
-MappedBuffer::MappedBuffer(const std::string& filename) : mapped_(nullptr), size_(0) {
-#ifdef __linux__
-  int fd = open(filename.c_str(), O_RDONLY);
-  CHECK(fd != -1) << "open " << filename << " failed: " << strerror(errno);
-
-  struct stat s;
-  CHECK(fstat(fd, &s) != -1) << "stat " << filename << " failed: " << strerror(errno);
-  size_ = s.st_size;
-
-  mapped_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
-  CHECK(mapped_ != MAP_FAILED) << "mmap " << filename << " failed: " << strerror(errno);
-
-  close(fd);
-#endif
-}
-
-MappedBuffer::~MappedBuffer() {
-#ifdef __linux__
-  CHECK(munmap(mapped_, size_) == 0) << "munmap failed";
-#endif
-}
-
 MegatronGPTMMapDataset::MegatronGPTMMapDataset(const std::string& data_file_prefix, size_t seq_len,
                                                size_t label_len, size_t num_samples,
                                                const std::vector<int64_t>& split_sizes,
@@ -30,7 +30,7 @@ class OFRecordDataReader final : public DataReader<TensorBuffer> {
  public:
   OFRecordDataReader(user_op::KernelInitContext* ctx) : DataReader<TensorBuffer>(ctx) {
     loader_.reset(new OFRecordDataset(ctx));
-    parser_.reset(new OFRecordParser());
+    parser_.reset(new OFRecordParser(ctx->Attr<bool>("output_serialized")));
     if (ctx->Attr<bool>("random_shuffle")) {
       loader_.reset(new RandomShuffleDataset<TensorBuffer>(ctx, std::move(loader_)));
     }
@@ -28,6 +28,7 @@ limitations under the License.
 #include "oneflow/user/image/image_util.h"
 #include "oneflow/core/job/resource_desc.h"
 #include "oneflow/core/job/global_for.h"
+#include "oneflow/core/record/ofrecord_scanner.h"
 #include <opencv2/opencv.hpp>
 
 namespace oneflow {
@@ -45,16 +46,19 @@ using BaseLoadTargetPtrList = BaseDataset::LoadTargetPtrList;
 
 namespace {
 
-void DecodeImageFromOFRecord(const OFRecord& record, const std::string& feature_name,
-                             const std::string& color_space, TensorBuffer* out) {
-  auto image_feature_it = record.feature().find(feature_name);
-  CHECK(image_feature_it != record.feature().end());
-  const Feature& image_feature = image_feature_it->second;
+void DecodeImageFromOFRecord(const char* record, size_t record_size,
+                             const std::string& feature_name, const std::string& color_space,
+                             TensorBuffer* out) {
+  SerializedFeature image_feature;
+  CHECK(FindSerializedFeature(record, record_size, feature_name, &image_feature));
   CHECK(image_feature.has_bytes_list());
-  CHECK(image_feature.bytes_list().value_size() == 1);
-  const std::string& src_data = image_feature.bytes_list().value(0);
-  cv::Mat image = cv::imdecode(cv::Mat(1, src_data.size(), CV_8UC1, (void*)(src_data.data())),
-                               cv::IMREAD_COLOR);
+  CHECK(image_feature.value_size() == 1);
+  cv::Mat image;
+  // the encoded image is decoded where it is in the serialized record
+  image_feature.ForEachBytesValue([&](const char* src_data, size_t src_size) {
+    image = cv::imdecode(cv::Mat(1, src_size, CV_8UC1, const_cast<char*>(src_data)),
+                         cv::IMREAD_COLOR);
+  });
   int W = image.cols;
   int H = image.rows;
 
@@ -73,18 +77,14 @@ void DecodeImageFromOFRecord(const OFRecord& record, const std::string& feature_
   memcpy(out->mut_data<uint8_t>(), image.ptr(), image_shape.elem_cnt());
 }
 
-void DecodeLabelFromFromOFRecord(const OFRecord& record, const std::string& feature_name,
-                                 TensorBuffer* out) {
-  auto label_feature_it = record.feature().find(feature_name);
-  CHECK(label_feature_it != record.feature().end());
-  const Feature& label_feature = label_feature_it->second;
+void DecodeLabelFromFromOFRecord(const char* record, size_t record_size,
+                                 const std::string& feature_name, TensorBuffer* out) {
+  SerializedFeature label_feature;
+  CHECK(FindSerializedFeature(record, record_size, feature_name, &label_feature));
   out->Resize(Shape({1}), DataType::kInt32);
-  if (label_feature.has_int32_list()) {
-    CHECK_EQ(label_feature.int32_list().value_size(), 1);
-    *out->mut_data<int32_t>() = label_feature.int32_list().value(0);
-  } else if (label_feature.has_int64_list()) {
-    CHECK_EQ(label_feature.int64_list().value_size(), 1);
-    *out->mut_data<int32_t>() = label_feature.int64_list().value(0);
+  if (label_feature.kind_case() == Feature::kInt32List
+      || label_feature.kind_case() == Feature::kInt64List) {
+    CHECK_EQ(label_feature.CopyValues<int32_t>(out->mut_data<int32_t>(), 1), 1);
   } else {
     UNIMPLEMENTED();
   }
@@ -117,15 +117,16 @@ void DecodeWorker(const std::string image_feature_name, const std::string label_
     auto receive_status = in_buffer->Receive(&serialized_record);
     if (receive_status == kBufferStatusErrorClosed) { break; }
     CHECK(receive_status == kBufferStatusSuccess);
-    OFRecord record;
-    CHECK(record.ParseFromArray(serialized_record->data<char>(),
-                                serialized_record->shape().elem_cnt()));
+    // the two features are located in the serialized record instead of parsing all of it
+    const char* record = serialized_record->data<char>();
+    const size_t record_size = serialized_record->shape().elem_cnt();
     std::shared_ptr<ImageClassificationDataInstance> instance(
         new ImageClassificationDataInstance());
     instance->image.reset(new TensorBuffer());
-    DecodeImageFromOFRecord(record, image_feature_name, color_space, instance->image.get());
+    DecodeImageFromOFRecord(record, record_size, image_feature_name, color_space,
+                            instance->image.get());
     instance->label.reset(new TensorBuffer());
-    DecodeLabelFromFromOFRecord(record, label_feature_name, instance->label.get());
+    DecodeLabelFromFromOFRecord(record, record_size, label_feature_name, instance->label.get());
     auto send_status = out_buffer->Send(instance);
     if (send_status == kBufferStatusErrorClosed) { break; }
     CHECK(send_status == kBufferStatusSuccess);
@@ -50,21 +50,45 @@ struct CopyTensor<DeviceType::kGPU, T, U> {
    CopyTensor<device_type, OF_PP_PAIR_FIRST(in_type_pair),                            \
               OF_PP_PAIR_FIRST(out_type_pair)>::Call},
 
+using CopyTensorFn = std::function<void(DeviceCtx*, const Tensor*, Tensor*)>;
+using CastCaseHandler = std::map<std::pair<DataType, DataType>, CopyTensorFn>;
+
+template<DeviceType device_type>
+void AddBFloat16CaseHandler(CastCaseHandler* case_handler) {}
+
+// bfloat16 kernels are only available on cpu
+template<>
+void AddBFloat16CaseHandler<DeviceType::kCPU>(CastCaseHandler* case_handler) {
+  constexpr DeviceType device_type = DeviceType::kCPU;
+  case_handler->insert({
+      // clang-format off
+      OF_PP_SEQ_PRODUCT_FOR_EACH_TUPLE(MAKE_CASE_HANDLER_ENTRY, POD_DATA_TYPE_SEQ, BFLOAT16_DATA_TYPE_SEQ)
+      OF_PP_SEQ_PRODUCT_FOR_EACH_TUPLE(MAKE_CASE_HANDLER_ENTRY, BFLOAT16_DATA_TYPE_SEQ, POD_DATA_TYPE_SEQ)
+      MAKE_CASE_HANDLER_ENTRY((bfloat16, DataType::kBFloat16), (bfloat16, DataType::kBFloat16))
+      // clang-format on
+  });
+}
+
 template<DeviceType device_type>
 struct CastUtil final {
   static void SwitchCopyTensor(const std::pair<DataType, DataType>& key, DeviceCtx* ctx,
                                const Tensor* src, Tensor* dst) {
-    static const std::map<std::pair<DataType, DataType>,
-                          std::function<void(DeviceCtx*, const Tensor*, Tensor*)>>
-        case_handler{
-            // clang-format off
-          OF_PP_SEQ_PRODUCT_FOR_EACH_TUPLE(MAKE_CASE_HANDLER_ENTRY, POD_DATA_TYPE_SEQ, POD_DATA_TYPE_SEQ)
-          MAKE_CASE_HANDLER_ENTRY((float, DataType::kFloat), (float16, DataType::kFloat16))
-          MAKE_CASE_HANDLER_ENTRY((float16, DataType::kFloat16), (float, DataType::kFloat))
-            // clang-format on
-        };
+    static const CastCaseHandler case_handler = MakeCaseHandler();
     case_handler.at(key)(ctx, src, dst);
   }
+
+ private:
+  static CastCaseHandler MakeCaseHandler() {
+    CastCaseHandler case_handler{
+        // clang-format off
+      OF_PP_SEQ_PRODUCT_FOR_EACH_TUPLE(MAKE_CASE_HANDLER_ENTRY, POD_DATA_TYPE_SEQ, POD_DATA_TYPE_SEQ)
+      MAKE_CASE_HANDLER_ENTRY((float, DataType::kFloat), (float16, DataType::kFloat16))
+      MAKE_CASE_HANDLER_ENTRY((float16, DataType::kFloat16), (float, DataType::kFloat))
+        // clang-format on
+    };
+    AddBFloat16CaseHandler<device_type>(&case_handler);
+    return case_handler;
+  }
 };
 
 template<DeviceType device_type>
@@ -0,0 +1,93 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/framework.h"
+#include "oneflow/user/data/columnar_dataset.h"
+
+namespace oneflow {
+
+namespace {
+
+class ColumnarDataLoader final : public user_op::OpKernelState {
+ public:
+  explicit ColumnarDataLoader(user_op::KernelInitContext* ctx) : batch_cnt_(0) {
+    const auto& column_names = ctx->Attr<std::vector<std::string>>("column_names");
+    dataset_ = std::make_unique<data::ColumnarDataset>(
+        ctx->Attr<std::vector<std::string>>("files"), column_names, ctx->Attr<bool>("shuffle"),
+        ctx->Attr<int64_t>("random_seed"));
+    row_lengths_ = ctx->Attr<std::vector<int64_t>>("row_lengths");
+    FOR_RANGE(size_t, i, 0, column_names.size()) {
+      const DataType data_type = ctx->TensorDesc4ArgNameAndIndex("out", i)->data_type();
+      CHECK_EQ(dataset_->column_data_type(i), data_type)
+          << "column " << column_names.at(i) << " is stored as "
+          << DataType_Name(dataset_->column_data_type(i)) << " but read as "
+          << DataType_Name(data_type);
+      const int64_t row_length = dataset_->column_row_length(i);
+      CHECK(row_length == 0 || row_length == row_lengths_.at(i))
+          << "column " << column_names.at(i) << " has " << row_length << " values per row but "
+          << row_lengths_.at(i) << " are read";
+    }
+    parallel_id_ = ctx->parallel_ctx().parallel_id();
+    parallel_num_ = ctx->parallel_ctx().parallel_num();
+    batch_size_ = ctx->TensorDesc4ArgNameAndIndex("out", 0)->shape().At(0);
+  }
+  ~ColumnarDataLoader() = default;
+
+  void NextBatch(user_op::KernelComputeContext* ctx) {
+    std::vector<void*> out;
+    FOR_RANGE(size_t, i, 0, row_lengths_.size()) {
+      out.push_back(ctx->Tensor4ArgNameAndIndex("out", i)->mut_dptr());
+    }
+    // batches of all ranks take consecutive samples
+    const size_t sample_index = (batch_cnt_ * parallel_num_ + parallel_id_) * batch_size_;
+    dataset_->GetBatch(sample_index, batch_size_, row_lengths_, out);
+    batch_cnt_ += 1;
+  }
+
+ private:
+  std::unique_ptr<data::ColumnarDataset> dataset_;
+  std::vector<int64_t> row_lengths_;
+  size_t parallel_id_;
+  size_t parallel_num_;
+  size_t batch_size_;
+  size_t batch_cnt_;
+};
+
+}  // namespace
+
+class ColumnarDataLoaderKernel final : public user_op::OpKernel {
+ public:
+  ColumnarDataLoaderKernel() = default;
+  ~ColumnarDataLoaderKernel() override = default;
+
+  std::shared_ptr<user_op::OpKernelState> CreateOpKernelState(
+      user_op::KernelInitContext* ctx) const override {
+    std::shared_ptr<ColumnarDataLoader> loader(new ColumnarDataLoader(ctx));
+    return loader;
+  }
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx, user_op::OpKernelState* state) const override {
+    auto* loader = dynamic_cast<ColumnarDataLoader*>(state);
+    loader->NextBatch(ctx);
+  }
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+};
+
+REGISTER_USER_KERNEL("columnar_data_loader")
+    .SetCreateFn<ColumnarDataLoaderKernel>()
+    .SetIsMatchedHob(user_op::HobDeviceTag() == "cpu");
+
+}  // namespace oneflow
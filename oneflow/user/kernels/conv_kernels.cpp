@@ -486,6 +486,104 @@ REGISTER_CONV_KERNEL(conv1d, double, 1);
 REGISTER_CONV_KERNEL(conv2d, double, 2);
 REGISTER_CONV_KERNEL(conv3d, double, 3);
 
+int64_t CalcElemNumOfBiasMul(const ShapeView& out_shape, const int32_t idx_offset) {
+  int64_t bias_mul_cnt = 1;
+  for (int64_t i = 0; i < out_shape.NumAxes() - 2; ++i) {
+    bias_mul_cnt *= out_shape.At(idx_offset + i);
+  }
+  return bias_mul_cnt;
+}
+
+// Converts the bfloat16 operands to float, runs the float im2col and gemm and rounds the output
+// back to bfloat16 once.
+template<size_t NDims>
+class ConvCpuBFloat16Kernel final : public user_op::OpKernel {
+ public:
+  ConvCpuBFloat16Kernel() = default;
+  ~ConvCpuBFloat16Kernel() = default;
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+
+  std::shared_ptr<user_op::OpKernelState> CreateOpKernelState(
+      user_op::KernelInitContext* ctx) const {
+    return CreateConvOpKernelState<float>(ctx, "in", "out", "weight");
+  }
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx, user_op::OpKernelState* state) const override {
+    const user_op::Tensor* in = ctx->Tensor4ArgNameAndIndex("in", 0);
+    const user_op::Tensor* weight = ctx->Tensor4ArgNameAndIndex("weight", 0);
+    const user_op::Tensor* bias = ctx->Tensor4ArgNameAndIndex("bias", 0);
+    user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
+    user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+    auto* conv_state = dynamic_cast<ConvOpKernelState<float>*>(state);
+    CHECK_NOTNULL(conv_state);
+    conv_state->Update(in->shape(), out->shape());
+    const int32_t idx_offset = conv_state->idx_offset_;
+
+    float* in_dptr = tmp_buffer->mut_dptr<float>();
+    float* weight_dptr = in_dptr + in->shape().elem_cnt();
+    float* out_dptr = weight_dptr + weight->shape().elem_cnt();
+    float* col_buf_dptr = out_dptr + out->shape().elem_cnt();
+    float* bias_dptr =
+        col_buf_dptr + CalcElemNumOfColBuf(out->shape(), weight->shape(), idx_offset);
+    float* bias_mul_dptr = nullptr;
+    ConvertBFloat16ToFloat(in->shape().elem_cnt(), in->dptr<bfloat16>(), in_dptr);
+    ConvertBFloat16ToFloat(weight->shape().elem_cnt(), weight->dptr<bfloat16>(), weight_dptr);
+    if (bias != nullptr) {
+      ConvertBFloat16ToFloat(bias->shape().elem_cnt(), bias->dptr<bfloat16>(), bias_dptr);
+      bias_mul_dptr = bias_dptr + bias->shape().elem_cnt();
+      InitBiasMulBuf(bias_mul_dptr, CalcElemNumOfBiasMul(out->shape(), idx_offset));
+    }
+    const int64_t in_img_elem_cnt = in->shape().Count(1);
+    const int64_t out_img_elem_cnt = out->shape().Count(1);
+    const int64_t filter = conv_state->weight_5d_shape_.At(0);
+    const int64_t out_img_size = conv_state->out_5d_shape_.Count(idx_offset, idx_offset + 3);
+    for (int64_t i = 0; i < in->shape().At(0); ++i) {
+      float* out_img_dptr = out_dptr + i * out_img_elem_cnt;
+      conv_state->im2col_func_(in_dptr + i * in_img_elem_cnt, ShapeView(conv_state->in_5d_shape_),
+                               ShapeView(conv_state->weight_5d_shape_),
+                               ShapeView(conv_state->out_5d_shape_), conv_state->strides_3d_.data(),
+                               conv_state->dilation_rate_3d_.data(),
+                               conv_state->padding_before_3d_.data(), col_buf_dptr);
+      conv_state->forward_func_(CblasNoTrans, CblasNoTrans, filter, out_img_size,
+                                conv_state->weight_5d_shape_.Count(1), 1.f, weight_dptr,
+                                col_buf_dptr, 0.f, out_img_dptr);
+      if (bias != nullptr) {
+        conv_state->forward_func_(CblasNoTrans, CblasNoTrans, filter, out_img_size, 1, 1.f,
+                                  bias_dptr, bias_mul_dptr, 1.f, out_img_dptr);
+      }
+    }
+    ConvertFloatToBFloat16(out->shape().elem_cnt(), out_dptr, out->mut_dptr<bfloat16>());
+  }
+};
+
+#define REGISTER_CONV_BFLOAT16_KERNEL(op_name, ndims)                                      \
+  REGISTER_USER_KERNEL(#op_name)                                                           \
+      .SetCreateFn<ConvCpuBFloat16Kernel<ndims>>()                                         \
+      .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")                                  \
+                       & (user_op::HobAttr<int32_t>("groups") == 1)                        \
+                       & (user_op::HobDataType("in", 0) == DataType::kBFloat16))           \
+      .SetInferTmpSizeFn([](user_op::InferContext* ctx) -> size_t {                        \
+        const auto& in_shape = ctx->TensorDesc4ArgNameAndIndex("in", 0)->shape();          \
+        const auto& out_shape = ctx->TensorDesc4ArgNameAndIndex("out", 0)->shape();        \
+        const auto& weight_shape = ctx->TensorDesc4ArgNameAndIndex("weight", 0)->shape();  \
+        const int32_t idx_offset = IdxOffset(ctx->Attr<std::string>("data_format"));       \
+        int64_t elem_cnt = in_shape.elem_cnt() + weight_shape.elem_cnt()                   \
+                           + out_shape.elem_cnt()                                          \
+                           + CalcElemNumOfColBuf(out_shape, weight_shape, idx_offset);     \
+        const auto* bias = ctx->TensorDesc4ArgNameAndIndex("bias", 0);                     \
+        if (bias != nullptr) {                                                             \
+          elem_cnt += bias->shape().elem_cnt()                                             \
+                      + CalcElemNumOfBiasMul(ShapeView(out_shape), idx_offset);            \
+        }                                                                                  \
+        return elem_cnt * sizeof(float);                                                   \
+      })
+
+REGISTER_CONV_BFLOAT16_KERNEL(conv1d, 1);
+REGISTER_CONV_BFLOAT16_KERNEL(conv2d, 2);
+REGISTER_CONV_BFLOAT16_KERNEL(conv3d, 3);
+
 template<typename T>
 class ConvDataGradCpuKernel final : public user_op::OpKernel {
  public:
@@ -0,0 +1,435 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/kernels/cpu_sort_util.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/common/data_type.h"
+#include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/core/thread/thread_pool.h"
+
+namespace oneflow {
+
+namespace {
+
+constexpr int32_t kRadixBits = 8;
+constexpr int32_t kRadixSize = 1 << kRadixBits;
+// instances shorter than this are sorted by comparison
+constexpr int64_t kRadixSortMinSize = 256;
+// instances at least this long are sorted by all threads one after another
+constexpr int64_t kParallelSortMinSize = 1 << 16;
+constexpr int64_t kParallelSortMinPartSize = 1 << 14;
+// top k keeps a heap of the k best keys so far if k is at most this, and partitions otherwise
+constexpr int32_t kHeapTopKMaxK = 256;
+
+// Order-preserving unsigned images of keys
+template<typename T>
+struct RadixKey;
+
+template<>
+struct RadixKey<int32_t> {
+  using U = uint32_t;
+  static U Encode(int32_t x) { return static_cast<U>(x) ^ 0x80000000U; }
+  static int32_t Decode(U u) { return static_cast<int32_t>(u ^ 0x80000000U); }
+};
+
+template<>
+struct RadixKey<int64_t> {
+  using U = uint64_t;
+  static U Encode(int64_t x) { return static_cast<U>(x) ^ 0x8000000000000000ULL; }
+  static int64_t Decode(U u) { return static_cast<int64_t>(u ^ 0x8000000000000000ULL); }
+};
+
+template<typename T, typename UT>
+struct FloatingRadixKey {
+  using U = UT;
+  static constexpr U kSignBit = static_cast<U>(1) << (sizeof(U) * 8 - 1);
+  static U Encode(T x) {
+    U u;
+    std::memcpy(&u, &x, sizeof(U));
+    return (u & kSignBit) ? ~u : (u | kSignBit);
+  }
+  static T Decode(U u) {
+    u = (u & kSignBit) ? (u ^ kSignBit) : ~u;
+    T x;
+    std::memcpy(&x, &u, sizeof(U));
+    return x;
+  }
+};
+
+template<>
+struct RadixKey<float> : public FloatingRadixKey<float, uint32_t> {};
+
+template<>
+struct RadixKey<double> : public FloatingRadixKey<double, uint64_t> {};
+
+// Calls Handler with [begin, end) ranges of `n` units, on the threads of Global<ThreadPool> if
+// there are at least two parts of `min_part_size` units
+void ForEachPart(int64_t n, int64_t min_part_size,
+                 const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  int64_t part_num = 1;
+  if (Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(), n / min_part_size);
+  }
+  if (part_num <= 1) {
+    Handler(0, n);
+    return;
+  }
+  BalancedSplitter bs(n, part_num);
+  MultiThreadLoop(part_num, [&](size_t part_id) {
+    const Range range = bs.At(part_id);
+    Handler(range.begin(), range.end());
+  });
+}
+
+int64_t GetParallelSortPartNum(int64_t n) {
+  if (n < kParallelSortMinSize || Global<ThreadPool>::Get() == nullptr) { return 1; }
+  return std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(), n / kParallelSortMinPartSize);
+}
+
+// Sorts `n` keys, and their `values` if not null, with `keys_tmp` and `values_tmp` of the same
+// size as buffers. The sorted keys and values end up in `keys` and `values`.
+template<typename U>
+void RadixSort(int64_t n, U* keys, U* keys_tmp, int32_t* values, int32_t* values_tmp) {
+  constexpr int32_t kPassNum = sizeof(U) * 8 / kRadixBits;
+  int64_t digit_cnts[kPassNum][kRadixSize] = {};
+  FOR_RANGE(int64_t, i, 0, n) {
+    const U key = keys[i];
+    FOR_RANGE(int32_t, pass, 0, kPassNum) {
+      digit_cnts[pass][(key >> (pass * kRadixBits)) & (kRadixSize - 1)] += 1;
+    }
+  }
+  U* src = keys;
+  U* dst = keys_tmp;
+  int32_t* src_values = values;
+  int32_t* dst_values = values_tmp;
+  FOR_RANGE(int32_t, pass, 0, kPassNum) {
+    const int64_t* cnts = digit_cnts[pass];
+    // skips the pass if all keys have the same digit
+    if (std::any_of(cnts, cnts + kRadixSize, [&](int64_t cnt) { return cnt == n; })) { continue; }
+    int64_t offsets[kRadixSize];
+    int64_t offset = 0;
+    FOR_RANGE(int32_t, digit, 0, kRadixSize) {
+      offsets[digit] = offset;
+      offset += cnts[digit];
+    }
+    const int32_t shift = pass * kRadixBits;
+    FOR_RANGE(int64_t, i, 0, n) {
+      const int64_t pos = offsets[(src[i] >> shift) & (kRadixSize - 1)]++;
+      dst[pos] = src[i];
+      if (values != nullptr) { dst_values[pos] = src_values[i]; }
+    }
+    std::swap(src, dst);
+    std::swap(src_values, dst_values);
+  }
+  if (src != keys) {
+    std::copy(src, src + n, keys);
+    if (values != nullptr) { std::copy(src_values, src_values + n, values); }
+  }
+}
+
+// RadixSort of one large instance by `part_num` threads. Each thread counts and scatters its
+// own chunk, and the offsets of a digit are laid out in the order of the chunks, which keeps
+// the sort stable.
+template<typename U>
+void ParallelRadixSort(int64_t n, int64_t part_num, U* keys, U* keys_tmp, int32_t* values,
+                       int32_t* values_tmp) {
+  constexpr int32_t kPassNum = sizeof(U) * 8 / kRadixBits;
+  BalancedSplitter bs(n, part_num);
+  std::vector<std::array<int64_t, kRadixSize>> part_offsets(part_num);
+  U* src = keys;
+  U* dst = keys_tmp;
+  int32_t* src_values = values;
+  int32_t* dst_values = values_tmp;
+  FOR_RANGE(int32_t, pass, 0, kPassNum) {
+    const int32_t shift = pass * kRadixBits;
+    MultiThreadLoop(part_num, [&](size_t part_id) {
+      const Range range = bs.At(part_id);
+      std::array<int64_t, kRadixSize>& cnts = part_offsets.at(part_id);
+      cnts.fill(0);
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        cnts[(src[i] >> shift) & (kRadixSize - 1)] += 1;
+      }
+    });
+    bool is_same_digit = false;
+    int64_t offset = 0;
+    FOR_RANGE(int32_t, digit, 0, kRadixSize) {
+      int64_t digit_cnt = 0;
+      for (auto& offsets : part_offsets) {
+        const int64_t cnt = offsets[digit];
+        offsets[digit] = offset;
+        offset += cnt;
+        digit_cnt += cnt;
+      }
+      if (digit_cnt == n) { is_same_digit = true; }
+    }
+    if (is_same_digit) { continue; }
+    MultiThreadLoop(part_num, [&](size_t part_id) {
+      const Range range = bs.At(part_id);
+      std::array<int64_t, kRadixSize>& offsets = part_offsets.at(part_id);
+      FOR_RANGE(int64_t, i, range.begin(), range.end()) {
+        const int64_t pos = offsets[(src[i] >> shift) & (kRadixSize - 1)]++;
+        dst[pos] = src[i];
+        if (values != nullptr) { dst_values[pos] = src_values[i]; }
+      }
+    });
+    std::swap(src, dst);
+    std::swap(src_values, dst_values);
+  }
+  if (src != keys) {
+    MultiThreadLoop(part_num, [&](size_t part_id) {
+      const Range range = bs.At(part_id);
+      std::copy(src + range.begin(), src + range.end(), keys + range.begin());
+      if (values != nullptr) {
+        std::copy(src_values + range.begin(), src_values + range.end(), values + range.begin());
+      }
+    });
+  }
+}
+
+// Radix sorts each instance of `in` into the encoded `keys` and, if `indices` is not null, the
+// indices of the sorted keys into `indices`
+template<typename T>
+void RadixSortInstances(const T* in, int32_t instance_num, int32_t instance_size,
+                        bool is_descending, typename RadixKey<T>::U* keys,
+                        typename RadixKey<T>::U* keys_tmp, int32_t* indices,
+                        int32_t* indices_tmp) {
+  using U = typename RadixKey<T>::U;
+  const auto Encode = [&](int64_t begin, int64_t end) {
+    FOR_RANGE(int64_t, i, begin, end) {
+      // -0 and +0 are equal keys whose order is told by their indices
+      const T x = (indices != nullptr && in[i] == GetZeroVal<T>()) ? GetZeroVal<T>() : in[i];
+      const U key = RadixKey<T>::Encode(x);
+      keys[i] = is_descending ? ~key : key;
+    }
+    if (indices != nullptr) {
+      FOR_RANGE(int64_t, i, begin, end) { indices[i] = i % instance_size; }
+    }
+  };
+  const int64_t part_num = GetParallelSortPartNum(instance_size);
+  if (part_num > 1) {
+    FOR_RANGE(int64_t, i, 0, instance_num) {
+      const int64_t offset = i * instance_size;
+      ForEachPart(instance_size, kParallelSortMinPartSize, [&](int64_t begin, int64_t end) {
+        Encode(offset + begin, offset + end);
+      });
+      ParallelRadixSort<U>(instance_size, part_num, keys + offset, keys_tmp + offset,
+                           indices == nullptr ? nullptr : indices + offset,
+                           indices_tmp == nullptr ? nullptr : indices_tmp + offset);
+    }
+  } else {
+    const int64_t min_part_instance_num =
+        std::max<int64_t>(kParallelSortMinPartSize / instance_size, 1);
+    ForEachPart(instance_num, min_part_instance_num, [&](int64_t begin, int64_t end) {
+      Encode(begin * instance_size, end * instance_size);
+      FOR_RANGE(int64_t, i, begin, end) {
+        const int64_t offset = i * instance_size;
+        RadixSort<U>(instance_size, keys + offset, keys_tmp + offset,
+                     indices == nullptr ? nullptr : indices + offset,
+                     indices_tmp == nullptr ? nullptr : indices_tmp + offset);
+      }
+    });
+  }
+}
+
+// The indices of the k best keys pushed, best first. A key is better than another if it is
+// greater, or equal and with a smaller index.
+template<typename T>
+class TopKHeap final {
+ public:
+  TopKHeap(const T* in, int32_t k) : is_better_{in}, k_(k) { heap_.reserve(k); }
+
+  void Push(int32_t index) {
+    if (heap_.size() < k_) {
+      heap_.push_back(index);
+      std::push_heap(heap_.begin(), heap_.end(), is_better_);
+    } else if (is_better_(index, heap_.front())) {
+      // the front of the heap is the worst of the k best keys so far
+      std::pop_heap(heap_.begin(), heap_.end(), is_better_);
+      heap_.back() = index;
+      std::push_heap(heap_.begin(), heap_.end(), is_better_);
+    }
+  }
+  const std::vector<int32_t>& SortedIndices() {
+    std::sort_heap(heap_.begin(), heap_.end(), is_better_);
+    return heap_;
+  }
+
+ private:
+  struct IsBetter {
+    const T* in;
+    bool operator()(int32_t lhs, int32_t rhs) const {
+      const T l = in[lhs];
+      const T r = in[rhs];
+      return l == r ? lhs < rhs : l > r;
+    }
+  };
+
+  IsBetter is_better_;
+  size_t k_;
+  std::vector<int32_t> heap_;
+};
+
+}  // namespace
+
+template<typename T>
+size_t CpuSortUtil<T>::GetSortTmpBufferSize(int64_t elem_cnt) {
+  return 2 * elem_cnt * sizeof(typename RadixKey<T>::U);
+}
+
+template<typename T>
+size_t CpuSortUtil<T>::GetArgSortTmpBufferSize(int64_t elem_cnt) {
+  return 2 * elem_cnt * sizeof(typename RadixKey<T>::U) + elem_cnt * sizeof(int32_t);
+}
+
+template<typename T>
+size_t CpuSortUtil<T>::GetTopKTmpBufferSize(int32_t instance_num, int32_t instance_size,
+                                            int32_t k) {
+  // k of one and the heap path of small k need no buffer
+  if (k <= kHeapTopKMaxK) { return 0; }
+  return static_cast<int64_t>(instance_num) * instance_size * sizeof(int32_t);
+}
+
+template<typename T>
+void CpuSortUtil<T>::Sort(const T* in, int32_t instance_num, int32_t instance_size,
+                          bool is_descending, void* tmp_buffer, T* out) {
+  const int64_t elem_cnt = static_cast<int64_t>(instance_num) * instance_size;
+  if (instance_size < kRadixSortMinSize) {
+    std::copy(in, in + elem_cnt, out);
+    const int64_t min_part_instance_num =
+        std::max<int64_t>(kParallelSortMinPartSize / std::max(instance_size, 1), 1);
+    ForEachPart(instance_num, min_part_instance_num, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        T* out_i = out + i * instance_size;
+        if (is_descending) {
+          std::sort(out_i, out_i + instance_size, std::greater<T>());
+        } else {
+          std::sort(out_i, out_i + instance_size, std::less<T>());
+        }
+      }
+    });
+    return;
+  }
+  using U = typename RadixKey<T>::U;
+  U* keys = static_cast<U*>(tmp_buffer);
+  RadixSortInstances<T>(in, instance_num, instance_size, is_descending, keys, keys + elem_cnt,
+                        nullptr, nullptr);
+  ForEachPart(elem_cnt, kParallelSortMinPartSize, [&](int64_t begin, int64_t end) {
+    FOR_RANGE(int64_t, i, begin, end) {
+      out[i] = RadixKey<T>::Decode(is_descending ? ~keys[i] : keys[i]);
+    }
+  });
+}
+
+template<typename T>
+void CpuSortUtil<T>::ArgSort(const T* in, int32_t instance_num, int32_t instance_size,
+                             bool is_descending, void* tmp_buffer, int32_t* out) {
+  if (instance_size < kRadixSortMinSize) {
+    const int64_t min_part_instance_num =
+        std::max<int64_t>(kParallelSortMinPartSize / std::max(instance_size, 1), 1);
+    ForEachPart(instance_num, min_part_instance_num, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const T* in_i = in + i * instance_size;
+        int32_t* out_i = out + i * instance_size;
+        std::iota(out_i, out_i + instance_size, 0);
+        std::sort(out_i, out_i + instance_size, [&](const int32_t lhs, const int32_t rhs) {
+          const T l = in_i[lhs];
+          const T r = in_i[rhs];
+          if (l == r) { return lhs < rhs; }
+          return is_descending ? l > r : l < r;
+        });
+      }
+    });
+    return;
+  }
+  using U = typename RadixKey<T>::U;
+  const int64_t elem_cnt = static_cast<int64_t>(instance_num) * instance_size;
+  U* keys = static_cast<U*>(tmp_buffer);
+  int32_t* indices_tmp = reinterpret_cast<int32_t*>(keys + 2 * elem_cnt);
+  RadixSortInstances<T>(in, instance_num, instance_size, is_descending, keys, keys + elem_cnt,
+                        out, indices_tmp);
+}
+
+template<typename T>
+void CpuSortUtil<T>::TopK(const T* in, int32_t instance_num, int32_t instance_size, int32_t k,
+                          bool sorted, int32_t* indices_buffer, int32_t* out) {
+  if (k <= 0) { return; }
+  const int64_t min_part_instance_num =
+      std::max<int64_t>(kParallelSortMinPartSize / std::max(instance_size, 1), 1);
+  if (k == 1) {
+    ForEachPart(instance_num, min_part_instance_num, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const T* in_i = in + i * instance_size;
+        out[i] = std::distance(in_i, std::max_element(in_i, in_i + instance_size));
+      }
+    });
+  } else if (k <= kHeapTopKMaxK) {
+    const int64_t part_num = GetParallelSortPartNum(instance_size);
+    if (part_num > 1) {
+      // each thread selects the top k of its chunk, and the top k are selected from those
+      BalancedSplitter bs(instance_size, part_num);
+      std::vector<std::vector<int32_t>> part_indices(part_num);
+      FOR_RANGE(int64_t, i, 0, instance_num) {
+        const T* in_i = in + i * instance_size;
+        MultiThreadLoop(part_num, [&](size_t part_id) {
+          const Range range = bs.At(part_id);
+          TopKHeap<T> heap(in_i, k);
+          FOR_RANGE(int64_t, j, range.begin(), range.end()) { heap.Push(j); }
+          part_indices.at(part_id) = heap.SortedIndices();
+        });
+        TopKHeap<T> heap(in_i, k);
+        for (const auto& indices : part_indices) {
+          for (int32_t index : indices) { heap.Push(index); }
+        }
+        const std::vector<int32_t>& indices = heap.SortedIndices();
+        std::copy(indices.begin(), indices.end(), out + i * k);
+      }
+    } else {
+      ForEachPart(instance_num, min_part_instance_num, [&](int64_t begin, int64_t end) {
+        FOR_RANGE(int64_t, i, begin, end) {
+          TopKHeap<T> heap(in + i * instance_size, k);
+          FOR_RANGE(int32_t, j, 0, instance_size) { heap.Push(j); }
+          const std::vector<int32_t>& indices = heap.SortedIndices();
+          std::copy(indices.begin(), indices.end(), out + i * k);
+        }
+      });
+    }
+  } else {
+    CHECK_NOTNULL(indices_buffer);
+    ForEachPart(instance_num, min_part_instance_num, [&](int64_t begin, int64_t end) {
+      FOR_RANGE(int64_t, i, begin, end) {
+        const T* in_i = in + i * instance_size;
+        int32_t* indices_i = indices_buffer + i * instance_size;
+        std::iota(indices_i, indices_i + instance_size, 0);
+        const auto IsBetter = [&](const int32_t lhs, const int32_t rhs) {
+          const T l = in_i[lhs];
+          const T r = in_i[rhs];
+          return l == r ? lhs < rhs : l > r;
+        };
+        std::nth_element(indices_i, indices_i + k, indices_i + instance_size, IsBetter);
+        if (sorted) { std::sort(indices_i, indices_i + k, IsBetter); }
+        std::copy(indices_i, indices_i + k, out + i * k);
+      }
+    });
+  }
+}
+
+#define INSTANTIATE_CPU_SORT_UTIL(cpp_data_type, data_type) \
+  template struct CpuSortUtil<cpp_data_type>;
+
+OF_PP_FOR_EACH_TUPLE(INSTANTIATE_CPU_SORT_UTIL, FLOATING_DATA_TYPE_SEQ INDEX_DATA_TYPE_SEQ)
+
+#undef INSTANTIATE_CPU_SORT_UTIL
+
+}  // namespace oneflow
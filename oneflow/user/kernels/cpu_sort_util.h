@@ -0,0 +1,48 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_USER_KERNELS_CPU_SORT_UTIL_H_
+#define ONEFLOW_USER_KERNELS_CPU_SORT_UTIL_H_
+
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+// Sorting of the last axis of cpu tensors, shared by the sort, arg_sort and top_k kernels.
+//
+// Instances are sorted with a stable LSD radix sort on order-preserving unsigned images of the
+// keys. Many small instances are spread over Global<ThreadPool>; a large instance is sorted by
+// all threads, each thread scattering its own chunk of the keys in every radix pass.
+template<typename T>
+struct CpuSortUtil {
+  static size_t GetSortTmpBufferSize(int64_t elem_cnt);
+  static size_t GetArgSortTmpBufferSize(int64_t elem_cnt);
+  // Zero for the k which TopK selects without indices_buffer
+  static size_t GetTopKTmpBufferSize(int32_t instance_num, int32_t instance_size, int32_t k);
+
+  static void Sort(const T* in, int32_t instance_num, int32_t instance_size, bool is_descending,
+                   void* tmp_buffer, T* out);
+  // Equal keys keep their ascending indices whatever the direction
+  static void ArgSort(const T* in, int32_t instance_num, int32_t instance_size,
+                      bool is_descending, void* tmp_buffer, int32_t* out);
+  // The indices of the k largest keys of each instance, equal keys by ascending indices.
+  // `indices_buffer` has GetTopKTmpBufferSize bytes and may be null when that is zero.
+  static void TopK(const T* in, int32_t instance_num, int32_t instance_size, int32_t k,
+                   bool sorted, int32_t* indices_buffer, int32_t* out);
+};
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_USER_KERNELS_CPU_SORT_UTIL_H_
@@ -0,0 +1,81 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/kernels/cpu_sort_util.h"
+#include "oneflow/core/thread/thread_pool.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+template<typename T>
+void TestCpuSort(int32_t instance_num, int32_t instance_size, bool is_descending, int32_t k) {
+  const int64_t elem_cnt = static_cast<int64_t>(instance_num) * instance_size;
+  std::mt19937 generator(elem_cnt);
+  std::vector<T> in(elem_cnt);
+  // few distinct keys, so that the order of equal keys is checked
+  for (T& x : in) { x = static_cast<T>(static_cast<int64_t>(generator() % 1000) - 500) / 4; }
+  std::vector<char> tmp_buffer(CpuSortUtil<T>::GetArgSortTmpBufferSize(elem_cnt));
+  std::vector<int32_t> indices_buffer(
+      CpuSortUtil<T>::GetTopKTmpBufferSize(instance_num, instance_size, k) / sizeof(int32_t));
+  std::vector<T> sorted(elem_cnt);
+  std::vector<int32_t> arg_sorted(elem_cnt);
+  std::vector<int32_t> top_k(static_cast<int64_t>(instance_num) * k);
+  CpuSortUtil<T>::Sort(in.data(), instance_num, instance_size, is_descending, tmp_buffer.data(),
+                       sorted.data());
+  CpuSortUtil<T>::ArgSort(in.data(), instance_num, instance_size, is_descending,
+                          tmp_buffer.data(), arg_sorted.data());
+  CpuSortUtil<T>::TopK(in.data(), instance_num, instance_size, k, true,
+                       indices_buffer.empty() ? nullptr : indices_buffer.data(), top_k.data());
+  FOR_RANGE(int64_t, i, 0, instance_num) {
+    const T* in_i = in.data() + i * instance_size;
+    std::vector<int32_t> expected(instance_size);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(expected.begin(), expected.end(), [&](int32_t lhs, int32_t rhs) {
+      if (in_i[lhs] == in_i[rhs]) { return lhs < rhs; }
+      return is_descending ? in_i[lhs] > in_i[rhs] : in_i[lhs] < in_i[rhs];
+    });
+    FOR_RANGE(int64_t, j, 0, instance_size) {
+      ASSERT_EQ(arg_sorted.at(i * instance_size + j), expected.at(j));
+      ASSERT_EQ(sorted.at(i * instance_size + j), in_i[expected.at(j)]);
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [&](int32_t lhs, int32_t rhs) { return in_i[lhs] > in_i[rhs]; });
+    FOR_RANGE(int64_t, j, 0, k) { ASSERT_EQ(top_k.at(i * k + j), expected.at(j)); }
+  }
+}
+
+}  // namespace
+
+TEST(CpuSortUtil, sort_many_instances) {
+  TestCpuSort<float>(16, 100, false, 5);
+  TestCpuSort<double>(16, 1000, true, 1);
+  TestCpuSort<int32_t>(8, 3000, false, 300);
+  TestCpuSort<int64_t>(8, 3000, true, 17);
+}
+
+TEST(CpuSortUtil, sort_large_instance_on_thread_pool) {
+  Global<ThreadPool>::New(4);
+  TestCpuSort<float>(1, 1 << 18, true, 64);
+  TestCpuSort<int64_t>(2, 100000, false, 1000);
+  TestCpuSort<double>(64, 4096, false, 16);
+  Global<ThreadPool>::Delete();
+}
+
+}  // namespace test
+
+}  // namespace oneflow
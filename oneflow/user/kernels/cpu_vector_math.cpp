@@ -0,0 +1,347 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/kernels/cpu_vector_math.h"
+#include "oneflow/core/common/platform.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__)
+#define OF_CPU_VECTOR_MATH_WITH_VECTOR_EXTENSIONS
+#if defined(OF_PLATFORM_IS_X86)
+#define OF_CPU_VECTOR_MATH_WITH_X86_DISPATCH
+#endif
+#endif
+
+namespace oneflow {
+
+namespace cpu_vector_math {
+
+namespace {
+
+#ifdef OF_CPU_VECTOR_MATH_WITH_VECTOR_EXTENSIONS
+
+// Everything called by the entries below is force inlined, so that it is compiled for the
+// instruction set of the entry it ends up in. No vector ever crosses a call, so the warnings on
+// the ABI of wide vector arguments do not apply.
+#define OF_VECTOR_MATH_INLINE inline __attribute__((always_inline))
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+template<int N>
+struct VectorTypes;
+
+template<>
+struct VectorTypes<4> {
+  typedef float F __attribute__((vector_size(16)));
+  typedef int32_t I __attribute__((vector_size(16)));
+};
+
+template<>
+struct VectorTypes<8> {
+  typedef float F __attribute__((vector_size(32)));
+  typedef int32_t I __attribute__((vector_size(32)));
+};
+
+template<>
+struct VectorTypes<16> {
+  typedef float F __attribute__((vector_size(64)));
+  typedef int32_t I __attribute__((vector_size(64)));
+};
+
+constexpr int32_t kSignMask = std::numeric_limits<int32_t>::min();
+constexpr int32_t kInfBits = 0x7f800000;
+// 1.5 * 2^23, adding it to a float of magnitude below 2^22 rounds the float to an integer which
+// ends up in the low bits of the sum
+constexpr float kRoundMagic = 12582912.f;
+constexpr int32_t kRoundMagicBits = 0x4B400000;
+constexpr float kExpMaxX = 88.7228394f;
+constexpr float kExpMinX = -103.972084f;
+
+// Polynomial and range reduction constants come from Cephes.
+template<int N>
+struct VectorMath {
+  using F = typename VectorTypes<N>::F;
+  using I = typename VectorTypes<N>::I;
+
+  static OF_VECTOR_MATH_INLINE F Splat(float val) { return F{} + val; }
+
+  static OF_VECTOR_MATH_INLINE F Abs(const F& x) { return (F)((I)x & ~kSignMask); }
+
+  static OF_VECTOR_MATH_INLINE I IsNan(const F& x) { return ((I)x & ~kSignMask) > kInfBits; }
+
+  // |x| with the sign of y
+  static OF_VECTOR_MATH_INLINE F CopySign(const F& x, const F& y) {
+    return (F)(((I)x & ~kSignMask) | ((I)y & kSignMask));
+  }
+
+  static OF_VECTOR_MATH_INLINE F Exp(const F& x) {
+    F clamped = x < kExpMinX ? Splat(kExpMinX) : x;
+    clamped = clamped > kExpMaxX ? Splat(kExpMaxX) : clamped;
+    // exp(x) = 2^n * exp(r), where n = round(x / ln2) and |r| <= ln2 / 2
+    const F t = clamped * 1.44269504088896341f + kRoundMagic;
+    const F fn = t - kRoundMagic;
+    const I n = (I)t - kRoundMagicBits;
+    F r = clamped - fn * 0.693359375f;
+    r = r - fn * -2.12194440e-4f;
+    F p = 1.9875691500e-4f * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * (r * r) + r + 1.f;
+    // n is in [-150, 128], 2^n is applied in two steps to keep both exponents normal
+    const I n1 = n >> 1;
+    const I n2 = n - n1;
+    F y = p * (F)((n1 + 127) << 23) * (F)((n2 + 127) << 23);
+    y = x > kExpMaxX ? Splat(std::numeric_limits<float>::infinity()) : y;
+    y = x < kExpMinX ? Splat(0.f) : y;
+    return IsNan(x) ? x : y;
+  }
+
+  static OF_VECTOR_MATH_INLINE F Log(const F& x) {
+    // denormals are scaled by 2^23 to have an exponent
+    const I is_denormal = x < std::numeric_limits<float>::min();
+    const F scaled = is_denormal ? x * 8388608.f : x;
+    const I bits = (I)scaled;
+    I e = ((bits >> 23) & 0xff) - 126;
+    e = is_denormal ? e - 23 : e;
+    // log(x) = e * ln2 + log(m), where m is in [sqrt(0.5), sqrt(2))
+    F m = (F)((bits & 0x007fffff) | 0x3f000000);
+    F fe = (F)(e + kRoundMagicBits) - kRoundMagic;
+    const I is_small = m < 0.707106781186547524f;
+    fe = is_small ? fe - 1.f : fe;
+    m = is_small ? m + m - 1.f : m - 1.f;
+    const F z = m * m;
+    F p = 7.0376836292e-2f * m - 1.1514610310e-1f;
+    p = p * m + 1.1676998740e-1f;
+    p = p * m - 1.2420140846e-1f;
+    p = p * m + 1.4249322787e-1f;
+    p = p * m - 1.6668057665e-1f;
+    p = p * m + 2.0000714765e-1f;
+    p = p * m - 2.4999993993e-1f;
+    p = p * m + 3.3333331174e-1f;
+    F y = p * m * z + fe * -2.12194440e-4f - 0.5f * z;
+    y = m + y + fe * 0.693359375f;
+    // nan and inf map to themselves, negatives and -inf to nan, zeros to -inf
+    y = ((I)x & ~kSignMask) >= kInfBits ? x : y;
+    y = x < 0.f ? Splat(std::numeric_limits<float>::quiet_NaN()) : y;
+    return ((I)x & ~kSignMask) == 0 ? Splat(-std::numeric_limits<float>::infinity()) : y;
+  }
+
+  static OF_VECTOR_MATH_INLINE F Tanh(const F& x) {
+    const F ax = Abs(x);
+    const F z = x * x;
+    F p = -5.70498872745e-3f * z + 2.06390887954e-2f;
+    p = p * z - 5.37397155531e-2f;
+    p = p * z + 1.33314422036e-1f;
+    p = p * z - 3.33332819422e-1f;
+    const F small = p * z * x + x;
+    const F large = CopySign(1.f - 2.f / (Exp(ax + ax) + 1.f), x);
+    return ax < 0.625f ? small : large;
+  }
+
+  static OF_VECTOR_MATH_INLINE F Sigmoid(const F& x) { return 1.f / (1.f + Exp(-x)); }
+
+  // erf(x) for |x| < 1
+  static OF_VECTOR_MATH_INLINE F SmallErf(const F& x) {
+    const F z = x * x;
+    F p = 7.853861353153693e-5f * z - 8.010193625184903e-4f;
+    p = p * z + 5.188327685732524e-3f;
+    p = p * z - 2.685381193529856e-2f;
+    p = p * z + 1.128358514861418e-1f;
+    p = p * z - 3.761262582423300e-1f;
+    p = p * z + 1.128379165726710f;
+    return x * p;
+  }
+
+  // erfc(ax) for ax >= 1 with the erfc of Numerical Recipes, whose relative error is below 1.2e-7
+  static OF_VECTOR_MATH_INLINE F LargeErfc(const F& ax) {
+    const F t = 1.f / (1.f + 0.5f * ax);
+    F q = 0.17087277f * t - 0.82215223f;
+    q = q * t + 1.48851587f;
+    q = q * t - 1.13520398f;
+    q = q * t + 0.27886807f;
+    q = q * t - 0.18628806f;
+    q = q * t + 0.09678418f;
+    q = q * t + 0.37409196f;
+    q = q * t + 1.00002368f;
+    q = q * t - 1.26551223f;
+    return t * Exp(q - ax * ax);
+  }
+
+  static OF_VECTOR_MATH_INLINE F Erf(const F& x) {
+    const F ax = Abs(x);
+    const F y = ax < 1.f ? SmallErf(x) : CopySign(1.f - LargeErfc(ax), x);
+    return IsNan(x) ? x : y;
+  }
+
+  // sin(z) and cos(z) for |z| <= pi / 4
+  static OF_VECTOR_MATH_INLINE F SmallSin(const F& z) {
+    const F zz = z * z;
+    F p = -1.9515295891e-4f * zz + 8.3321608736e-3f;
+    p = p * zz - 1.6666654611e-1f;
+    return p * zz * z + z;
+  }
+
+  static OF_VECTOR_MATH_INLINE F SmallCos(const F& z) {
+    const F zz = z * z;
+    F p = 2.443315711809948e-5f * zz - 1.388731625493765e-3f;
+    p = p * zz + 4.166664568298827e-2f;
+    return p * zz * zz - 0.5f * zz + 1.f;
+  }
+
+  // sin(x) if is_cos is false and cos(x) otherwise. |x| is reduced to z = |x| - q * pi / 2 with
+  // |z| <= pi / 4, pi / 2 being split in three parts so that q times the first part is exact.
+  static OF_VECTOR_MATH_INLINE F SinOrCos(const F& x, bool is_cos) {
+    const F ax = Abs(x);
+    const F t = ax * 0.636619772367581343f + kRoundMagic;
+    const F fq = t - kRoundMagic;
+    F z = ax - fq * 1.5703125f;
+    z = z - fq * 4.837512969970703125e-4f;
+    z = z - fq * 7.54978995489188216e-8f;
+    // cos(|x|) = sin(|x| + pi / 2), and sin(z + q * pi / 2) is sin(z), cos(z), -sin(z) and
+    // -cos(z) for q % 4 in 0, 1, 2 and 3
+    const I q = ((I)t - kRoundMagicBits) + (is_cos ? 1 : 0);
+    F y = (q & 1) != 0 ? SmallCos(z) : SmallSin(z);
+    y = (F)((I)y ^ ((q & 2) << 30));
+    return is_cos ? y : (F)((I)y ^ ((I)x & kSignMask));
+  }
+
+  static OF_VECTOR_MATH_INLINE F Sin(const F& x) { return SinOrCos(x, false); }
+
+  static OF_VECTOR_MATH_INLINE F Cos(const F& x) { return SinOrCos(x, true); }
+
+  static OF_VECTOR_MATH_INLINE F Gelu(const F& x) {
+    // 1 + erf(u) is computed as erfc(-u) for u <= -1 to avoid the cancellation
+    const F u = x * 0.707106781186547524f;
+    const F au = Abs(u);
+    const F erfc = LargeErfc(au);
+    F one_plus_erf = u < 0.f ? erfc : 2.f - erfc;
+    one_plus_erf = au < 1.f ? 1.f + SmallErf(u) : one_plus_erf;
+    return 0.5f * x * one_plus_erf;
+  }
+};
+
+#define DEFINE_VECTOR_MATH_OP(func)                                            \
+  template<int N>                                                              \
+  struct func##Op {                                                            \
+    static OF_VECTOR_MATH_INLINE void Compute(typename VectorTypes<N>::F* x) { \
+      *x = VectorMath<N>::func(*x);                                            \
+    }                                                                          \
+  };
+
+DEFINE_VECTOR_MATH_OP(Exp)
+DEFINE_VECTOR_MATH_OP(Log)
+DEFINE_VECTOR_MATH_OP(Tanh)
+DEFINE_VECTOR_MATH_OP(Sigmoid)
+DEFINE_VECTOR_MATH_OP(Erf)
+DEFINE_VECTOR_MATH_OP(Sin)
+DEFINE_VECTOR_MATH_OP(Cos)
+DEFINE_VECTOR_MATH_OP(Gelu)
+
+#undef DEFINE_VECTOR_MATH_OP
+
+template<template<int> class Op, int N>
+OF_VECTOR_MATH_INLINE void Apply(int64_t n, const float* x, float* y) {
+  using F = typename VectorTypes<N>::F;
+  int64_t i = 0;
+  for (; i + N <= n; i += N) {
+    F v;
+    std::memcpy(&v, x + i, sizeof(F));
+    Op<N>::Compute(&v);
+    std::memcpy(y + i, &v, sizeof(F));
+  }
+  if (i < n) {
+    // the tail is computed in a zero padded vector
+    F v = {};
+    std::memcpy(&v, x + i, (n - i) * sizeof(float));
+    Op<N>::Compute(&v);
+    std::memcpy(y + i, &v, (n - i) * sizeof(float));
+  }
+}
+
+template<template<int> class Op>
+void ApplyWithBaseline(int64_t n, const float* x, float* y) {
+  Apply<Op, 4>(n, x, y);
+}
+
+#ifdef OF_CPU_VECTOR_MATH_WITH_X86_DISPATCH
+
+template<template<int> class Op>
+__attribute__((target("avx2,fma"))) void ApplyWithAvx2(int64_t n, const float* x, float* y) {
+  Apply<Op, 8>(n, x, y);
+}
+
+template<template<int> class Op>
+__attribute__((target("avx512f"))) void ApplyWithAvx512(int64_t n, const float* x, float* y) {
+  Apply<Op, 16>(n, x, y);
+}
+
+#endif  // OF_CPU_VECTOR_MATH_WITH_X86_DISPATCH
+
+using ApplyFn = void (*)(int64_t, const float*, float*);
+
+template<template<int> class Op>
+ApplyFn ChooseApplyFn() {
+#ifdef OF_CPU_VECTOR_MATH_WITH_X86_DISPATCH
+  if (__builtin_cpu_supports("avx512f")) { return &ApplyWithAvx512<Op>; }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return &ApplyWithAvx2<Op>;
+  }
+#endif  // OF_CPU_VECTOR_MATH_WITH_X86_DISPATCH
+  return &ApplyWithBaseline<Op>;
+}
+
+#define DEFINE_CPU_VECTOR_MATH_FUNC(func)                       \
+  void func(int64_t n, const float* x, float* y) {              \
+    static const ApplyFn ApplyFunc = ChooseApplyFn<func##Op>(); \
+    ApplyFunc(n, x, y);                                         \
+  }
+
+#else
+
+float ScalarExp(float x) { return std::exp(x); }
+float ScalarLog(float x) { return std::log(x); }
+float ScalarTanh(float x) { return std::tanh(x); }
+float ScalarSigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+float ScalarErf(float x) { return std::erf(x); }
+float ScalarSin(float x) { return std::sin(x); }
+float ScalarCos(float x) { return std::cos(x); }
+float ScalarGelu(float x) { return 0.5f * x * (1.f + std::erf(x * 0.707106781186547524f)); }
+
+#define DEFINE_CPU_VECTOR_MATH_FUNC(func)                          \
+  void func(int64_t n, const float* x, float* y) {                 \
+    for (int64_t i = 0; i < n; ++i) { y[i] = Scalar##func(x[i]); } \
+  }
+
+#endif  // OF_CPU_VECTOR_MATH_WITH_VECTOR_EXTENSIONS
+
+}  // namespace
+
+DEFINE_CPU_VECTOR_MATH_FUNC(Exp)
+DEFINE_CPU_VECTOR_MATH_FUNC(Log)
+DEFINE_CPU_VECTOR_MATH_FUNC(Tanh)
+DEFINE_CPU_VECTOR_MATH_FUNC(Sigmoid)
+DEFINE_CPU_VECTOR_MATH_FUNC(Erf)
+DEFINE_CPU_VECTOR_MATH_FUNC(Sin)
+DEFINE_CPU_VECTOR_MATH_FUNC(Cos)
+DEFINE_CPU_VECTOR_MATH_FUNC(Gelu)
+
+}  // namespace cpu_vector_math
+
+}  // namespace oneflow
@@ -0,0 +1,44 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_USER_KERNELS_CPU_VECTOR_MATH_H_
+#define ONEFLOW_USER_KERNELS_CPU_VECTOR_MATH_H_
+
+#include <cstdint>
+
+namespace oneflow {
+
+// Transcendental functions over float arrays for cpu kernels. Each computes y[i] = f(x[i]) for
+// i in [0, n) with the widest vector instructions the cpu supports (AVX-512, AVX2 or the baseline
+// of the target), chosen at runtime, and with std:: math on compilers without vector extensions.
+// x and y may be the same array. Results are within 2 ulps of std:: math, except on the negative
+// tail of gelu, where the relative error grows to 1e-5 as gelu vanishes, and for sin and cos,
+// whose absolute error is below 1e-7 for |x| <= 8192 and which are not meant for larger |x|.
+namespace cpu_vector_math {
+
+void Exp(int64_t n, const float* x, float* y);
+void Log(int64_t n, const float* x, float* y);
+void Tanh(int64_t n, const float* x, float* y);
+void Sigmoid(int64_t n, const float* x, float* y);
+void Erf(int64_t n, const float* x, float* y);
+void Sin(int64_t n, const float* x, float* y);
+void Cos(int64_t n, const float* x, float* y);
+void Gelu(int64_t n, const float* x, float* y);
+
+}  // namespace cpu_vector_math
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_USER_KERNELS_CPU_VECTOR_MATH_H_
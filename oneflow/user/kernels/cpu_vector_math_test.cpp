@@ -0,0 +1,144 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/kernels/cpu_vector_math.h"
+#include "oneflow/core/common/util.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+using VectorMathFn = void (*)(int64_t, const float*, float*);
+
+struct VectorMathCase {
+  std::string name;
+  VectorMathFn Compute;
+  std::function<double(double)> Reference;
+};
+
+const std::vector<VectorMathCase>& VectorMathCases() {
+  static const std::vector<VectorMathCase> cases = {
+      {"exp", &cpu_vector_math::Exp, [](double x) { return std::exp(x); }},
+      {"log", &cpu_vector_math::Log, [](double x) { return std::log(x); }},
+      {"tanh", &cpu_vector_math::Tanh, [](double x) { return std::tanh(x); }},
+      {"sigmoid", &cpu_vector_math::Sigmoid, [](double x) { return 1.0 / (1.0 + std::exp(-x)); }},
+      {"erf", &cpu_vector_math::Erf, [](double x) { return std::erf(x); }},
+      {"gelu", &cpu_vector_math::Gelu,
+       [](double x) { return 0.5 * x * std::erfc(-x * std::sqrt(0.5)); }},
+  };
+  return cases;
+}
+
+// Returns the max error of fn on [low, high] in ulps of the float result.
+double MaxUlpError(const VectorMathCase& c, float low, float high) {
+  const int64_t elem_cnt = (1 << 20) + 7;
+  std::vector<float> x(elem_cnt);
+  std::vector<float> y(elem_cnt);
+  FOR_RANGE(int64_t, i, 0, elem_cnt) { x[i] = low + (high - low) * i / (elem_cnt - 1); }
+  c.Compute(elem_cnt, x.data(), y.data());
+  double max_ulp_error = 0;
+  FOR_RANGE(int64_t, i, 0, elem_cnt) {
+    const float expected = static_cast<float>(c.Reference(x[i]));
+    if (std::isinf(expected) && expected == y[i]) { continue; }
+    const double ulp =
+        std::max<double>(std::abs(expected) * std::numeric_limits<float>::epsilon(),
+                         std::numeric_limits<float>::denorm_min());
+    max_ulp_error = std::max(max_ulp_error, std::abs(y[i] - c.Reference(x[i])) / ulp);
+  }
+  return max_ulp_error;
+}
+
+const VectorMathCase& Case4Name(const std::string& name) {
+  for (const auto& c : VectorMathCases()) {
+    if (c.name == name) { return c; }
+  }
+  UNIMPLEMENTED();
+}
+
+}  // namespace
+
+TEST(CpuVectorMath, accuracy) {
+  ASSERT_LE(MaxUlpError(Case4Name("exp"), -100.0f, 88.0f), 2.0);
+  ASSERT_LE(MaxUlpError(Case4Name("log"), 1e-44f, 1e-30f), 2.0);
+  ASSERT_LE(MaxUlpError(Case4Name("log"), 1e-3f, 1e6f), 2.0);
+  ASSERT_LE(MaxUlpError(Case4Name("tanh"), -12.0f, 12.0f), 2.0);
+  ASSERT_LE(MaxUlpError(Case4Name("sigmoid"), -80.0f, 20.0f), 2.0);
+  ASSERT_LE(MaxUlpError(Case4Name("erf"), -6.0f, 6.0f), 2.0);
+  ASSERT_LE(MaxUlpError(Case4Name("gelu"), -3.0f, 10.0f), 16.0);
+  ASSERT_LE(MaxUlpError(Case4Name("gelu"), -10.0f, 10.0f), 1e-5 / 1.2e-7);
+}
+
+TEST(CpuVectorMath, special_values) {
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<float> x = {0.0f, -0.0f, inf, -inf, nan, -200.0f};
+  std::vector<float> y(x.size());
+  for (const auto& c : VectorMathCases()) {
+    c.Compute(x.size(), x.data(), y.data());
+    FOR_RANGE(size_t, i, 0, x.size()) {
+      const float expected = static_cast<float>(c.Reference(x.at(i)));
+      if (std::isnan(expected)) {
+        ASSERT_TRUE(std::isnan(y.at(i))) << c.name << "(" << x.at(i) << ")";
+      } else {
+        ASSERT_EQ(y.at(i), expected) << c.name << "(" << x.at(i) << ")";
+      }
+    }
+  }
+}
+
+TEST(CpuVectorMath, tail_and_in_place) {
+  std::vector<float> x(37);
+  FOR_RANGE(size_t, i, 0, x.size()) { x[i] = 0.25f * i + 0.125f; }
+  for (const auto& c : VectorMathCases()) {
+    std::vector<float> expected(x.size());
+    c.Compute(x.size(), x.data(), expected.data());
+    FOR_RANGE(int64_t, n, 0, x.size()) {
+      std::vector<float> y(x.begin(), x.end());
+      c.Compute(n, y.data(), y.data());
+      FOR_RANGE(int64_t, i, 0, n) { ASSERT_EQ(y[i], expected[i]) << c.name; }
+      FOR_RANGE(int64_t, i, n, x.size()) { ASSERT_EQ(y[i], x[i]) << c.name; }
+    }
+  }
+}
+
+TEST(CpuVectorMath, sin_and_cos) {
+  const int64_t elem_cnt = (1 << 22) + 7;
+  std::vector<float> x(elem_cnt);
+  std::vector<float> sin(elem_cnt);
+  std::vector<float> cos(elem_cnt);
+  FOR_RANGE(int64_t, i, 0, elem_cnt) { x[i] = -8192.0f + 16384.0 * i / (elem_cnt - 1); }
+  cpu_vector_math::Sin(elem_cnt, x.data(), sin.data());
+  cpu_vector_math::Cos(elem_cnt, x.data(), cos.data());
+  FOR_RANGE(int64_t, i, 0, elem_cnt) {
+    ASSERT_NEAR(sin[i], std::sin(static_cast<double>(x[i])), 1e-7) << x[i];
+    ASSERT_NEAR(cos[i], std::cos(static_cast<double>(x[i])), 1e-7) << x[i];
+  }
+  const float inf = std::numeric_limits<float>::infinity();
+  const std::vector<float> special = {0.0f, inf, -inf, std::numeric_limits<float>::quiet_NaN()};
+  cpu_vector_math::Sin(special.size(), special.data(), sin.data());
+  cpu_vector_math::Cos(special.size(), special.data(), cos.data());
+  ASSERT_EQ(sin[0], 0.0f);
+  ASSERT_EQ(cos[0], 1.0f);
+  FOR_RANGE(size_t, i, 1, special.size()) {
+    ASSERT_TRUE(std::isnan(sin[i]));
+    ASSERT_TRUE(std::isnan(cos[i]));
+  }
+}
+
+}  // namespace test
+
+}  // namespace oneflow
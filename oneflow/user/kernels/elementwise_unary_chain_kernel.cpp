@@ -0,0 +1,123 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/framework.h"
+#include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/user/kernels/elementwise_unary_chain_kernel.h"
+#include "oneflow/user/kernels/math_unary_elementwise_func.h"
+
+namespace oneflow {
+
+namespace {
+
+// Elements of a block stay in L1 while every op of the chain is applied to them, so the whole
+// chain costs a single pass over memory.
+constexpr int64_t kChainBlockSize = 1024;
+constexpr int64_t kChainParallelThreshold = 64 * kChainBlockSize;
+
+template<typename T>
+using UnaryBlockFn = void (*)(T* buf, int64_t n, T scalar);
+
+template<template<typename> class UnaryFunctor, typename T>
+void MathUnaryBlock(T* buf, int64_t n, T) {
+  UnaryFunctorCpuUtil<UnaryFunctor, T>::Forward(n, buf, buf);
+}
+
+template<typename T>
+void ReluBlock(T* buf, int64_t n, T) {
+  // same as the relu kernel, NaN is propagated
+  for (int64_t i = 0; i < n; ++i) { buf[i] = std::max(buf[i], GetZeroVal<T>()); }
+}
+
+template<typename T>
+void ScalarAddBlock(T* buf, int64_t n, T scalar) {
+  for (int64_t i = 0; i < n; ++i) { buf[i] += scalar; }
+}
+
+template<typename T>
+void ScalarMulBlock(T* buf, int64_t n, T scalar) {
+  for (int64_t i = 0; i < n; ++i) { buf[i] *= scalar; }
+}
+
+#define MAKE_MATH_UNARY_BLOCK_FN_ENTRY(op_type_name, func_prefix) \
+  {op_type_name, &MathUnaryBlock<OF_PP_CAT(func_prefix, Functor), T>},
+
+template<typename T>
+const HashMap<std::string, UnaryBlockFn<T>>& OpTypeName2UnaryBlockFn() {
+  static const HashMap<std::string, UnaryBlockFn<T>> op_type_name2fn = {
+      OF_PP_FOR_EACH_TUPLE(MAKE_MATH_UNARY_BLOCK_FN_ENTRY, MATH_UNARY_ELEMENTWISE_FUNC_SEQ)
+      {"relu", &ReluBlock<T>},
+      {"scalar_add", &ScalarAddBlock<T>},
+      {"scalar_mul", &ScalarMulBlock<T>},
+  };
+  return op_type_name2fn;
+}
+
+#undef MAKE_MATH_UNARY_BLOCK_FN_ENTRY
+
+template<typename T>
+class ElementwiseUnaryChainCpuKernel final : public user_op::OpKernel {
+ public:
+  ElementwiseUnaryChainCpuKernel() = default;
+  ~ElementwiseUnaryChainCpuKernel() = default;
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* x = ctx->Tensor4ArgNameAndIndex("x", 0);
+    user_op::Tensor* y = ctx->Tensor4ArgNameAndIndex("y", 0);
+    const auto& op_type_names = ctx->Attr<std::vector<std::string>>("op_type_names");
+    const auto& scalars = ctx->Attr<std::vector<float>>("scalars");
+    std::vector<UnaryBlockFn<T>> fns;
+    fns.reserve(op_type_names.size());
+    for (const auto& op_type_name : op_type_names) {
+      fns.push_back(OpTypeName2UnaryBlockFn<T>().at(op_type_name));
+    }
+    const T* x_ptr = x->dptr<T>();
+    T* y_ptr = y->mut_dptr<T>();
+    const int64_t elem_cnt = x->shape().elem_cnt();
+    const int64_t block_num = RoundUp(elem_cnt, kChainBlockSize) / kChainBlockSize;
+    auto ComputeBlock = [&](size_t block_id) {
+      const int64_t offset = block_id * kChainBlockSize;
+      const int64_t n = std::min(kChainBlockSize, elem_cnt - offset);
+      T* buf = y_ptr + offset;
+      if (buf != x_ptr + offset) { std::copy(x_ptr + offset, x_ptr + offset + n, buf); }
+      FOR_RANGE(size_t, i, 0, fns.size()) { fns.at(i)(buf, n, static_cast<T>(scalars.at(i))); }
+    };
+    if (elem_cnt >= kChainParallelThreshold) {
+      MultiThreadLoop(block_num, ComputeBlock);
+    } else {
+      FOR_RANGE(int64_t, block_id, 0, block_num) { ComputeBlock(block_id); }
+    }
+  }
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+};
+
+}  // namespace
+
+bool IsElementwiseUnaryChainFusible(const std::string& op_type_name) {
+  return OpTypeName2UnaryBlockFn<float>().find(op_type_name)
+         != OpTypeName2UnaryBlockFn<float>().end();
+}
+
+#define REGISTER_ELEMENTWISE_UNARY_CHAIN_CPU_KERNEL(dtype)                     \
+  REGISTER_USER_KERNEL("elementwise_unary_chain")                              \
+      .SetCreateFn<ElementwiseUnaryChainCpuKernel<dtype>>()                    \
+      .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")                      \
+                       & (user_op::HobDataType("y", 0) == GetDataType<dtype>::value))
+
+REGISTER_ELEMENTWISE_UNARY_CHAIN_CPU_KERNEL(float);
+REGISTER_ELEMENTWISE_UNARY_CHAIN_CPU_KERNEL(double);
+
+}  // namespace oneflow
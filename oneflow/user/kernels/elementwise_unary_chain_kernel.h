@@ -0,0 +1,29 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_USER_KERNELS_ELEMENTWISE_UNARY_CHAIN_KERNEL_H_
+#define ONEFLOW_USER_KERNELS_ELEMENTWISE_UNARY_CHAIN_KERNEL_H_
+
+#include <string>
+
+namespace oneflow {
+
+// Whether an op of op_type_name with a single input and output can be composed into an
+// elementwise_unary_chain op on cpu.
+bool IsElementwiseUnaryChainFusible(const std::string& op_type_name);
+
+}  // namespace oneflow
+
+#endif  // ONEFLOW_USER_KERNELS_ELEMENTWISE_UNARY_CHAIN_KERNEL_H_
@@ -14,9 +14,29 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
+#include "oneflow/user/kernels/cpu_vector_math.h"
 
 namespace oneflow {
 
+namespace {
+
+template<typename T>
+void GeluForward(int64_t elem_cnt, const T* in_ptr, T* out_ptr) {
+  using ComputeType = typename GetComputeType<T>::type;
+  ComputeType inv_sqrt2 = std::sqrt(0.5);
+  FOR_RANGE(int64_t, i, 0, elem_cnt) {
+    const ComputeType x = in_ptr[i];
+    out_ptr[i] = 0.5 * x * (1.0 + std::erf(inv_sqrt2 * x));
+  }
+}
+
+template<>
+void GeluForward<float>(int64_t elem_cnt, const float* in_ptr, float* out_ptr) {
+  cpu_vector_math::Gelu(elem_cnt, in_ptr, out_ptr);
+}
+
+}  // namespace
+
 template<typename T>
 class CpuGeluKernel final : public user_op::OpKernel {
  public:
@@ -27,13 +47,7 @@ class CpuGeluKernel final : public user_op::OpKernel {
   void Compute(user_op::KernelComputeContext* ctx) const override {
     const user_op::Tensor* in = ctx->Tensor4ArgNameAndIndex("in", 0);
     user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
-    const int32_t elem_cnt = in->shape().elem_cnt();
-    const T* in_ptr = in->dptr<T>();
-    T* out_ptr = out->mut_dptr<T>();
-    T inv_sqrt2 = std::sqrt(0.5);
-    FOR_RANGE(int32_t, i, 0, elem_cnt) {
-      out_ptr[i] = 0.5 * in_ptr[i] * (1.0 + std::erf(inv_sqrt2 * in_ptr[i]));
-    }
+    GeluForward<T>(in->shape().elem_cnt(), in->dptr<T>(), out->mut_dptr<T>());
   };
 
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -46,6 +60,7 @@ class CpuGeluKernel final : public user_op::OpKernel {
 
 REGISTER_CPU_GELU_KERNEL(float)
 REGISTER_CPU_GELU_KERNEL(double)
+REGISTER_CPU_GELU_KERNEL(bfloat16)
 
 template<typename T>
 class CpuGeluGradKernel final : public user_op::OpKernel {
@@ -58,17 +73,19 @@ class CpuGeluGradKernel final : public user_op::OpKernel {
     const user_op::Tensor* x = ctx->Tensor4ArgNameAndIndex("x", 0);
     const user_op::Tensor* dy = ctx->Tensor4ArgNameAndIndex("dy", 0);
     user_op::Tensor* dx = ctx->Tensor4ArgNameAndIndex("dx", 0);
-    const int32_t elem_cnt = x->shape().elem_cnt();
+    const int64_t elem_cnt = x->shape().elem_cnt();
     const T* x_ptr = x->dptr<T>();
     const T* dy_ptr = dy->dptr<T>();
     T* dx_ptr = dx->mut_dptr<T>();
-    T inv_sqrt2 = std::sqrt(0.5);
-    T coef = std::sqrt(2.0 / std::acos(-1.0));
-    FOR_RANGE(int32_t, i, 0, elem_cnt) {
+    using ComputeType = typename GetComputeType<T>::type;
+    ComputeType inv_sqrt2 = std::sqrt(0.5);
+    ComputeType coef = std::sqrt(2.0 / std::acos(-1.0));
+    FOR_RANGE(int64_t, i, 0, elem_cnt) {
+      const ComputeType x_val = x_ptr[i];
       dx_ptr[i] = 0.5
-                  * (1.0 + std::erf(inv_sqrt2 * x_ptr[i])
-                     + x_ptr[i] * coef * std::exp(-0.5 * x_ptr[i] * x_ptr[i]))
-                  * dy_ptr[i];
+                  * (1.0 + std::erf(inv_sqrt2 * x_val)
+                     + x_val * coef * std::exp(-0.5 * x_val * x_val))
+                  * static_cast<ComputeType>(dy_ptr[i]);
     }
   };
 
@@ -83,5 +100,6 @@ class CpuGeluGradKernel final : public user_op::OpKernel {
 
 REGISTER_CPU_GELU_GRAD_KERNEL(float)
 REGISTER_CPU_GELU_GRAD_KERNEL(double)
+REGISTER_CPU_GELU_GRAD_KERNEL(bfloat16)
 
 }  // namespace oneflow
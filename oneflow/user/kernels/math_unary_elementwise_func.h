@@ -29,6 +29,7 @@ limitations under the License.
 #else
 
 #include <cmath>
+#include "oneflow/user/kernels/cpu_vector_math.h"
 #define MATH_FUNC_F(name, x) std::name(x)
 #define MATH_FUNC_D(name, x) std::name(x)
 
@@ -990,6 +991,35 @@ struct TanhFunctor<half> {
 
 #endif
 
+#if !defined(__CUDACC__)
+
+// Computes y[i] = UnaryFunctor<T>::Forward(x[i]) for i in [0, n) on cpu, with cpu_vector_math
+// for the float functors it has.
+template<template<typename> class UnaryFunctor, typename T>
+struct UnaryFunctorCpuUtil {
+  static void Forward(int64_t n, const T* x, T* y) {
+    for (int64_t i = 0; i < n; ++i) { y[i] = UnaryFunctor<T>::Forward(x[i]); }
+  }
+};
+
+#define SPECIALIZE_VECTORIZED_UNARY_FUNCTOR_CPU_UTIL(func_prefix) \
+  template<>                                                      \
+  struct UnaryFunctorCpuUtil<func_prefix##Functor, float> {       \
+    static void Forward(int64_t n, const float* x, float* y) {    \
+      cpu_vector_math::func_prefix(n, x, y);                      \
+    }                                                             \
+  };
+
+SPECIALIZE_VECTORIZED_UNARY_FUNCTOR_CPU_UTIL(Exp)
+SPECIALIZE_VECTORIZED_UNARY_FUNCTOR_CPU_UTIL(Log)
+SPECIALIZE_VECTORIZED_UNARY_FUNCTOR_CPU_UTIL(Tanh)
+SPECIALIZE_VECTORIZED_UNARY_FUNCTOR_CPU_UTIL(Sigmoid)
+SPECIALIZE_VECTORIZED_UNARY_FUNCTOR_CPU_UTIL(Erf)
+
+#undef SPECIALIZE_VECTORIZED_UNARY_FUNCTOR_CPU_UTIL
+
+#endif  // !defined(__CUDACC__)
+
 }  // namespace oneflow
 
 #endif  // ONEFLOW_USER_KERNELS_MATH_UNARY_ELEMENTWISE_FUNC_H_
@@ -14,10 +14,30 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
+#include "oneflow/core/thread/thread_manager.h"
 #include "oneflow/user/kernels/math_unary_elementwise_func.h"
 
 namespace oneflow {
 
+namespace {
+
+constexpr int64_t kParallelChunkSize = 32768;
+
+// Large tensors are split into chunks computed on the thread pool.
+void ForEachChunk(int64_t n, const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  const int64_t chunk_num = RoundUp(n, kParallelChunkSize) / kParallelChunkSize;
+  if (chunk_num <= 1 || Global<ThreadPool>::Get() == nullptr) {
+    Handler(0, n);
+    return;
+  }
+  MultiThreadLoop(chunk_num, [&](size_t chunk_id) {
+    const int64_t begin = chunk_id * kParallelChunkSize;
+    Handler(begin, std::min(begin + kParallelChunkSize, n));
+  });
+}
+
+}  // namespace
+
 template<template<typename> class UnaryFunctor, typename T>
 class MathUnaryElementwiseCpuKernel final : public user_op::OpKernel {
  public:
@@ -30,9 +50,10 @@ class MathUnaryElementwiseCpuKernel final : public user_op::OpKernel {
     user_op::Tensor* tensor_y = ctx->Tensor4ArgNameAndIndex("y", 0);
     const T* x = tensor_x->dptr<T>();
     T* y = tensor_y->mut_dptr<T>();
-    int64_t n = tensor_x->shape().elem_cnt();
-    CHECK_LE(n, GetMaxVal<int32_t>() / 2);
-    for (int32_t i = 0; i < n; ++i) { y[i] = UnaryFunctor<T>::Forward(x[i]); }
+    const int64_t n = tensor_x->shape().elem_cnt();
+    ForEachChunk(n, [&](int64_t begin, int64_t end) {
+      UnaryFunctorCpuUtil<UnaryFunctor, T>::Forward(end - begin, x + begin, y + begin);
+    });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -52,9 +73,10 @@ class MathUnaryElementwiseGradCpuKernel final : public user_op::OpKernel {
     const T* x = tensor_x->dptr<T>();
     const T* dy = tensor_dy->dptr<T>();
     T* dx = tensor_dx->mut_dptr<T>();
-    int64_t n = tensor_x->shape().elem_cnt();
-    CHECK_LE(n, GetMaxVal<int32_t>() / 2);
-    for (int32_t i = 0; i < n; ++i) { dx[i] = UnaryFunctor<T>::Backward(x[i], dy[i]); }
+    const int64_t n = tensor_x->shape().elem_cnt();
+    ForEachChunk(n, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) { dx[i] = UnaryFunctor<T>::Backward(x[i], dy[i]); }
+    });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -380,4 +380,133 @@ REGISTER_BROADCAST_MATMUL_GRAD_B_KERNEL(DeviceType::kGPU, double);
 REGISTER_BROADCAST_MATMUL_GRAD_B_KERNEL(DeviceType::kGPU, float16);
 #endif
 
+namespace {
+
+struct CpuBFloat16GemmParam {
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  int64_t batch_size;
+  int64_t m;
+  int64_t n;
+  int64_t k;
+};
+
+CpuBFloat16GemmParam GetMatmulGemmParam(user_op::KernelComputeContext* ctx) {
+  const user_op::Tensor* a = ctx->Tensor4ArgNameAndIndex("a", 0);
+  const user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+  const int32_t num_axes = a->shape().NumAxes();
+  CpuBFloat16GemmParam param{};
+  param.trans_a = ctx->Attr<bool>("transpose_a") ? CblasTrans : CblasNoTrans;
+  param.trans_b = ctx->Attr<bool>("transpose_b") ? CblasTrans : CblasNoTrans;
+  param.batch_size = a->shape().Count(0, num_axes - 2);
+  std::tie(param.m, param.n, param.k) = CalcMNK(a->shape(), out->shape(), param.trans_a);
+  return param;
+}
+
+CpuBFloat16GemmParam GetBroadcastMatmulGemmParam(user_op::KernelComputeContext* ctx) {
+  CHECK(!ctx->Attr<bool>("transpose_a"));
+  const user_op::Tensor* a = ctx->Tensor4ArgNameAndIndex("a", 0);
+  const user_op::Tensor* b = ctx->Tensor4ArgNameAndIndex("b", 0);
+  CHECK_EQ(b->shape().NumAxes(), 2);
+  CpuBFloat16GemmParam param{};
+  param.trans_a = CblasNoTrans;
+  param.trans_b = ctx->Attr<bool>("transpose_b") ? CblasTrans : CblasNoTrans;
+  param.batch_size = 1;
+  param.m = a->shape().Count(0, a->shape().NumAxes() - 1);
+  param.k = a->shape().At(a->shape().NumAxes() - 1);
+  param.n = param.trans_b == CblasTrans ? b->shape().At(0) : b->shape().At(1);
+  CHECK_EQ(param.k, param.trans_b == CblasTrans ? b->shape().At(1) : b->shape().At(0));
+  return param;
+}
+
+CpuBFloat16GemmParam GetBroadcastMatmulGradBGemmParam(user_op::KernelComputeContext* ctx) {
+  const user_op::Tensor* a = ctx->Tensor4ArgNameAndIndex("a", 0);
+  const user_op::Tensor* b = ctx->Tensor4ArgNameAndIndex("b", 0);
+  CHECK_EQ(a->shape().NumAxes(), b->shape().NumAxes());
+  CpuBFloat16GemmParam param{};
+  param.trans_a = CblasTrans;
+  param.trans_b = CblasNoTrans;
+  param.batch_size = 1;
+  param.k = a->shape().Count(0, a->shape().NumAxes() - 1);
+  CHECK_EQ(b->shape().Count(0, b->shape().NumAxes() - 1), param.k);
+  param.m = a->shape().At(a->shape().NumAxes() - 1);
+  param.n = b->shape().At(b->shape().NumAxes() - 1);
+  return param;
+}
+
+size_t InferCpuBFloat16GemmTmpSize(user_op::InferContext* ctx) {
+  const int64_t elem_cnt = ctx->TensorDesc4ArgNameAndIndex("a", 0)->shape().elem_cnt()
+                           + ctx->TensorDesc4ArgNameAndIndex("b", 0)->shape().elem_cnt()
+                           + ctx->TensorDesc4ArgNameAndIndex("out", 0)->shape().elem_cnt();
+  return elem_cnt * sizeof(float);
+}
+
+}  // namespace
+
+// Converts the bfloat16 operands to float, multiplies and accumulates them with the float gemm
+// and rounds the result back to bfloat16 once.
+template<CpuBFloat16GemmParam (*GetGemmParam)(user_op::KernelComputeContext*)>
+class CpuBFloat16GemmKernel final : public user_op::OpKernel {
+ public:
+  CpuBFloat16GemmKernel() = default;
+  ~CpuBFloat16GemmKernel() = default;
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* a = ctx->Tensor4ArgNameAndIndex("a", 0);
+    const user_op::Tensor* b = ctx->Tensor4ArgNameAndIndex("b", 0);
+    user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+    user_op::Tensor* tmp_buffer = ctx->Tensor4ArgNameAndIndex("tmp_buffer", 0);
+    const int64_t a_elem_cnt = a->shape().elem_cnt();
+    const int64_t b_elem_cnt = b->shape().elem_cnt();
+    const int64_t out_elem_cnt = out->shape().elem_cnt();
+    float* a_float = tmp_buffer->mut_dptr<float>();
+    float* b_float = a_float + a_elem_cnt;
+    float* out_float = b_float + b_elem_cnt;
+    ConvertBFloat16ToFloat(a_elem_cnt, a->dptr<bfloat16>(), a_float);
+    ConvertBFloat16ToFloat(b_elem_cnt, b->dptr<bfloat16>(), b_float);
+    double beta = 0.0;
+    if (ctx->has_input("_add_to_output", 0)) {
+      const user_op::Tensor* add_to_output = ctx->Tensor4ArgNameAndIndex("_add_to_output", 0);
+      CHECK_EQ(add_to_output->data_type(), out->data_type());
+      CHECK_EQ(add_to_output->shape(), out->shape());
+      ConvertBFloat16ToFloat(out_elem_cnt, add_to_output->dptr<bfloat16>(), out_float);
+      beta = 1.0;
+    }
+    const CpuBFloat16GemmParam param = GetGemmParam(ctx);
+    const double alpha = ctx->Attr<double>("alpha");
+    if (param.batch_size == 1) {
+      NewKernelUtil<DeviceType::kCPU>::OFGemm(ctx->device_ctx(), param.trans_a, param.trans_b,
+                                              param.m, param.n, param.k, alpha, a_float, b_float,
+                                              beta, out_float);
+    } else {
+      NewKernelUtil<DeviceType::kCPU>::OFBatchedGemm(
+          ctx->device_ctx(), param.trans_a, param.trans_b, param.batch_size, param.m, param.n,
+          param.k, alpha, a_float, b_float, beta, out_float);
+    }
+    ConvertFloatToBFloat16(out_elem_cnt, out_float, out->mut_dptr<bfloat16>());
+  }
+};
+
+#define REGISTER_CPU_BFLOAT16_GEMM_KERNEL(op_type_name, get_gemm_param)                         \
+  REGISTER_USER_KERNEL(op_type_name)                                                            \
+      .SetCreateFn<CpuBFloat16GemmKernel<get_gemm_param>>()                                     \
+      .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")                                       \
+                       & (user_op::HobDataType("a", 0) == DataType::kBFloat16))                 \
+      .SetInferTmpSizeFn(InferCpuBFloat16GemmTmpSize)                                           \
+      .SetInplaceProposalFn([](const user_op::InferContext& ctx,                                \
+                               user_op::AddInplaceArgPair AddInplaceArgPairFn) -> Maybe<void> { \
+        if (ctx.has_input("_add_to_output", 0)) {                                               \
+          OF_RETURN_IF_ERROR(AddInplaceArgPairFn("out", 0, "_add_to_output", 0, true));         \
+        }                                                                                       \
+        return Maybe<void>::Ok();                                                               \
+      })
+
+REGISTER_CPU_BFLOAT16_GEMM_KERNEL("matmul", GetMatmulGemmParam);
+REGISTER_CPU_BFLOAT16_GEMM_KERNEL("batch_matmul", GetMatmulGemmParam);
+REGISTER_CPU_BFLOAT16_GEMM_KERNEL("broadcast_matmul", GetBroadcastMatmulGemmParam);
+REGISTER_CPU_BFLOAT16_GEMM_KERNEL("broadcast_matmul_grad_b", GetBroadcastMatmulGradBGemmParam);
+
 }  // namespace oneflow
@@ -41,6 +41,30 @@ class MultiplyKernel final : public user_op::OpKernel {
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
 
+class MultiplyCpuBFloat16Kernel final : public user_op::OpKernel {
+ public:
+  MultiplyCpuBFloat16Kernel() = default;
+  ~MultiplyCpuBFloat16Kernel() override = default;
+
+ private:
+  void Compute(user_op::KernelComputeContext* ctx) const override {
+    const user_op::Tensor* x = ctx->Tensor4ArgNameAndIndex("x", 0);
+    const user_op::Tensor* y = ctx->Tensor4ArgNameAndIndex("y", 0);
+    user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
+    const int64_t elem_cnt = x->shape().elem_cnt();
+    CHECK_EQ(y->shape().elem_cnt(), elem_cnt);
+    CHECK_EQ(out->shape().elem_cnt(), elem_cnt);
+    const bfloat16* x_ptr = x->dptr<bfloat16>();
+    const bfloat16* y_ptr = y->dptr<bfloat16>();
+    bfloat16* out_ptr = out->mut_dptr<bfloat16>();
+    FOR_RANGE(int64_t, i, 0, elem_cnt) {
+      out_ptr[i] = static_cast<float>(x_ptr[i]) * static_cast<float>(y_ptr[i]);
+    }
+  }
+
+  bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
+};
+
 }  // namespace
 
 #define REGISTER_MULTIPLY_KERNEL(device, dtype_pair)                                            \
@@ -58,4 +82,14 @@ OF_PP_SEQ_PRODUCT_FOR_EACH_TUPLE(REGISTER_MULTIPLY_KERNEL, DEVICE_TYPE_SEQ,
                                  ARITHMETIC_DATA_TYPE_SEQ)
 #undef REGISTER_MULTIPLY_KERNEL
 
+REGISTER_USER_KERNEL("multiply")
+    .SetCreateFn<MultiplyCpuBFloat16Kernel>()
+    .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")
+                     & (user_op::HobDataType("x", 0) == DataType::kBFloat16))
+    .SetInplaceProposalFn([](const user_op::InferContext&,
+                             user_op::AddInplaceArgPair AddInplaceArgPairFn) -> Maybe<void> {
+      OF_RETURN_IF_ERROR(AddInplaceArgPairFn("out", 0, "x", 0, true));
+      return Maybe<void>::Ok();
+    });
+
 }  // namespace oneflow
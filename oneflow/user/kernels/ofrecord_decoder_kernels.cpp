@@ -19,6 +19,7 @@ limitations under the License.
 #include "oneflow/core/common/tensor_buffer.h"
 #include "oneflow/core/kernel/new_kernel_util.h"
 #include "oneflow/core/kernel/kernel_util.h"
+#include "oneflow/core/record/ofrecord_scanner.h"
 #include "oneflow/core/thread/thread_manager.h"
 #include "oneflow/user/image/random_crop_generator.h"
 #include "oneflow/user/image/image_util.h"
@@ -68,6 +69,63 @@ void DecodeOneRawOFRecord(const Feature& feature, T* dptr, int64_t sample_elem_c
   }
 }
 
+template<typename T>
+void DecodeOneRawSerializedFeature(const SerializedFeature& feature, T* dptr,
+                                   int64_t sample_elem_cnt, bool dim1_varying_length,
+                                   bool auto_zero_padding) {
+  if (feature.has_bytes_list()) {
+    CHECK_EQ(feature.value_size(), 1);
+    feature.ForEachBytesValue([&](const char* data, size_t size) {
+      sample_elem_cnt = std::min<int64_t>(sample_elem_cnt, size);
+      CopyElem<int8_t, T>(reinterpret_cast<const int8_t*>(data), dptr, sample_elem_cnt);
+    });
+  } else if (feature.kind_case() == Feature::kFloatList
+             || feature.kind_case() == Feature::kDoubleList
+             || feature.kind_case() == Feature::kInt32List
+             || feature.kind_case() == Feature::kInt64List) {
+    const int64_t value_size = feature.CopyValues<T>(dptr, sample_elem_cnt);
+    const int64_t padding_elem_num = auto_zero_padding ? sample_elem_cnt - value_size : 0;
+    if (dim1_varying_length || auto_zero_padding) {
+      CHECK_LE(value_size, sample_elem_cnt);
+    } else {
+      CHECK_EQ(sample_elem_cnt, value_size);
+    }
+    if (padding_elem_num > 0) {
+      std::memset(dptr + value_size, 0, padding_elem_num * sizeof(T));
+    }
+  } else {
+    UNIMPLEMENTED();
+  }
+}
+
+SerializedFeature FindSerializedFeatureOrDie(const TensorBuffer& record, const std::string& name) {
+  SerializedFeature feature;
+  CHECK(FindSerializedFeature(record.data<char>(), record.nbytes(), name, &feature))
+      << "Field " << name << " not found";
+  return feature;
+}
+
+// Calls Handler with the only value of bytes list `name` of the i-th record of `in`, which holds
+// OFRecord or serialized records in tensor buffers.
+void ForBytesValue0(const user_op::Tensor* in, int64_t i, const std::string& name,
+                    const std::function<void(const char* data, size_t size)>& Handler) {
+  if (in->data_type() == DataType::kTensorBuffer) {
+    const SerializedFeature feature = FindSerializedFeatureOrDie(in->dptr<TensorBuffer>()[i], name);
+    CHECK(feature.has_bytes_list());
+    CHECK_EQ(feature.value_size(), 1);
+    feature.ForEachBytesValue(Handler);
+  } else {
+    const OFRecord& record = in->dptr<OFRecord>()[i];
+    auto it = record.feature().find(name);
+    CHECK(it != record.feature().end()) << "Field " << name << " not found";
+    const Feature& feature = it->second;
+    CHECK(feature.has_bytes_list());
+    CHECK_EQ(feature.bytes_list().value_size(), 1);
+    const std::string& value0 = feature.bytes_list().value(0);
+    Handler(value0.data(), value0.size());
+  }
+}
+
 }  // namespace
 
 template<typename T>
@@ -84,13 +142,24 @@ class OFRecordRawDecoderKernel final : public user_op::OpKernel {
     int64_t record_num = in_blob->shape().At(0);
     int64_t sample_elem_cnt = out_blob->shape().Count(1);
     CHECK(record_num > 0);
-    const OFRecord* records = in_blob->dptr<OFRecord>();
     T* out_dptr = out_blob->mut_dptr<T>();
     const std::string& name = ctx->Attr<std::string>("name");
 
     bool auto_zero_padding = ctx->Attr<bool>("auto_zero_padding");
     bool dim1_varying_length = ctx->Attr<bool>("dim1_varying_length");
 
+    if (in_blob->data_type() == DataType::kTensorBuffer) {
+      // the feature is read where it is in the serialized record
+      const TensorBuffer* records = in_blob->dptr<TensorBuffer>();
+      MultiThreadLoop(record_num, [&](size_t i) {
+        T* dptr = out_dptr + i * sample_elem_cnt;
+        const SerializedFeature feature = FindSerializedFeatureOrDie(records[i], name);
+        DecodeOneRawSerializedFeature(feature, dptr, sample_elem_cnt, auto_zero_padding,
+                                      dim1_varying_length);
+      });
+      return;
+    }
+    const OFRecord* records = in_blob->dptr<OFRecord>();
     MultiThreadLoop(record_num, [&](size_t i) {
       const OFRecord& record = *(records + i);
       T* dptr = out_dptr + i * sample_elem_cnt;
@@ -103,11 +172,12 @@ class OFRecordRawDecoderKernel final : public user_op::OpKernel {
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
 
-#define REGISTER_RAW_DECODER_KERNEL(dtype)                                      \
-  REGISTER_USER_KERNEL("ofrecord_raw_decoder")                                  \
-      .SetCreateFn<OFRecordRawDecoderKernel<dtype>>()                           \
-      .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")                       \
-                       & (user_op::HobDataType("in", 0) == DataType::kOFRecord) \
+#define REGISTER_RAW_DECODER_KERNEL(dtype)                                               \
+  REGISTER_USER_KERNEL("ofrecord_raw_decoder")                                           \
+      .SetCreateFn<OFRecordRawDecoderKernel<dtype>>()                                    \
+      .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")                                \
+                       & ((user_op::HobDataType("in", 0) == DataType::kOFRecord)         \
+                          | (user_op::HobDataType("in", 0) == DataType::kTensorBuffer))  \
                        & (user_op::HobDataType("out", 0) == GetDataType<dtype>::value));
 
 REGISTER_RAW_DECODER_KERNEL(char)
@@ -128,23 +198,16 @@ class OFRecordBytesDecoderKernel final : public user_op::OpKernel {
     const user_op::Tensor* in = ctx->Tensor4ArgNameAndIndex("in", 0);
     user_op::Tensor* out = ctx->Tensor4ArgNameAndIndex("out", 0);
     CHECK_EQ(out->shape(), in->shape());
-    CHECK_EQ(in->data_type(), DataType::kOFRecord);
     CHECK_EQ(out->data_type(), DataType::kTensorBuffer);
     const int64_t num_instances = in->shape().elem_cnt();
-    const auto* records = in->dptr<OFRecord>();
     auto* buffers = out->mut_dptr<TensorBuffer>();
     const std::string& name = ctx->Attr<std::string>("name");
     MultiThreadLoop(num_instances, [&](size_t i) {
-      const OFRecord& record = *(records + i);
       TensorBuffer* buffer = buffers + i;
-      auto it = record.feature().find(name);
-      CHECK(it != record.feature().end()) << "Field " << name << " not found";
-      const Feature& feature = it->second;
-      CHECK(feature.has_bytes_list());
-      CHECK_EQ(feature.bytes_list().value_size(), 1);
-      const int64_t size = feature.bytes_list().value(0).size();
-      buffer->Resize(Shape({size}), DataType::kUInt8);
-      memcpy(buffer->mut_data(), feature.bytes_list().value(0).data(), size);
+      ForBytesValue0(in, i, name, [&](const char* data, size_t size) {
+        buffer->Resize(Shape({static_cast<int64_t>(size)}), DataType::kUInt8);
+        memcpy(buffer->mut_data(), data, size);
+      });
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -153,24 +216,18 @@ class OFRecordBytesDecoderKernel final : public user_op::OpKernel {
 REGISTER_USER_KERNEL("ofrecord_bytes_decoder")
     .SetCreateFn<OFRecordBytesDecoderKernel>()
     .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")
-                     & (user_op::HobDataType("in", 0) == DataType::kOFRecord)
+                     & ((user_op::HobDataType("in", 0) == DataType::kOFRecord)
+                        | (user_op::HobDataType("in", 0) == DataType::kTensorBuffer))
                      & (user_op::HobDataType("out", 0) == DataType::kTensorBuffer));
 
 namespace {
 
-void DecodeRandomCropImageFromOneRecord(const OFRecord& record, TensorBuffer* buffer,
-                                        const std::string& name, const std::string& color_space,
-                                        RandomCropGenerator* random_crop_gen) {
-  CHECK(record.feature().find(name) != record.feature().end()) << "Field " << name << " not found";
-  const Feature& feature = record.feature().at(name);
-  CHECK(feature.has_bytes_list());
-  CHECK(feature.bytes_list().value_size() == 1);
-  const std::string& src_data = feature.bytes_list().value(0);
-
-  // cv::_InputArray image_data(src_data.data(), src_data.size());
+void DecodeRandomCropImage(const char* src_data, size_t src_size, TensorBuffer* buffer,
+                           const std::string& color_space, RandomCropGenerator* random_crop_gen) {
+  // cv::_InputArray image_data(src_data, src_size);
   // cv::Mat image = cv::imdecode(image_data, cv::IMREAD_ANYCOLOR);
   cv::Mat image =
-      cv::imdecode(cv::Mat(1, src_data.size(), CV_8UC1, (void*)(src_data.data())),  // NOLINT
+      cv::imdecode(cv::Mat(1, src_size, CV_8UC1, (void*)(src_data)),  // NOLINT
                    ImageUtil::IsColor(color_space) ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
   int W = image.cols;
   int H = image.rows;
@@ -232,16 +289,16 @@ class OFRecordImageDecoderRandomCropKernel final : public user_op::OpKernel {
     CHECK(record_num > 0);
     user_op::Tensor* in_blob = ctx->Tensor4ArgNameAndIndex("in", 0);
     CHECK_EQ(out_blob->shape(), in_blob->shape());
-    const OFRecord* records = in_blob->dptr<OFRecord>();
     TensorBuffer* buffers = out_blob->mut_dptr<TensorBuffer>();
     const std::string& name = ctx->Attr<std::string>("name");
     const std::string& color_space = ctx->Attr<std::string>("color_space");
 
     MultiThreadLoop(record_num, [&](size_t i) {
-      const OFRecord& record = *(records + i);
       TensorBuffer* buffer = buffers + i;
       RandomCropGenerator* gen = crop_window_generators->GetGenerator(i);
-      DecodeRandomCropImageFromOneRecord(record, buffer, name, color_space, gen);
+      ForBytesValue0(in_blob, i, name, [&](const char* data, size_t size) {
+        DecodeRandomCropImage(data, size, buffer, color_space, gen);
+      });
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -250,7 +307,8 @@ class OFRecordImageDecoderRandomCropKernel final : public user_op::OpKernel {
 REGISTER_USER_KERNEL("ofrecord_image_decoder_random_crop")
     .SetCreateFn<OFRecordImageDecoderRandomCropKernel>()
     .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")
-                     & (user_op::HobDataType("in", 0) == DataType::kOFRecord)
+                     & ((user_op::HobDataType("in", 0) == DataType::kOFRecord)
+                        | (user_op::HobDataType("in", 0) == DataType::kTensorBuffer))
                      & (user_op::HobDataType("out", 0) == DataType::kTensorBuffer));
 
 class OFRecordImageDecoderKernel final : public user_op::OpKernel {
@@ -265,15 +323,15 @@ class OFRecordImageDecoderKernel final : public user_op::OpKernel {
     CHECK(record_num > 0);
     user_op::Tensor* in_blob = ctx->Tensor4ArgNameAndIndex("in", 0);
     CHECK_EQ(out_blob->shape(), in_blob->shape());
-    const OFRecord* records = in_blob->dptr<OFRecord>();
     TensorBuffer* buffers = out_blob->mut_dptr<TensorBuffer>();
     const std::string& name = ctx->Attr<std::string>("name");
     const std::string& color_space = ctx->Attr<std::string>("color_space");
 
     MultiThreadLoop(record_num, [&](size_t i) {
-      const OFRecord& record = *(records + i);
       TensorBuffer* buffer = buffers + i;
-      DecodeRandomCropImageFromOneRecord(record, buffer, name, color_space, nullptr);
+      ForBytesValue0(in_blob, i, name, [&](const char* data, size_t size) {
+        DecodeRandomCropImage(data, size, buffer, color_space, nullptr);
+      });
     });
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
@@ -282,7 +340,8 @@ class OFRecordImageDecoderKernel final : public user_op::OpKernel {
 REGISTER_USER_KERNEL("ofrecord_image_decoder")
     .SetCreateFn<OFRecordImageDecoderKernel>()
     .SetIsMatchedHob((user_op::HobDeviceTag() == "cpu")
-                     & (user_op::HobDataType("in", 0) == DataType::kOFRecord)
+                     & ((user_op::HobDataType("in", 0) == DataType::kOFRecord)
+                        | (user_op::HobDataType("in", 0) == DataType::kTensorBuffer))
                      & (user_op::HobDataType("out", 0) == DataType::kTensorBuffer));
 
 }  // namespace oneflow
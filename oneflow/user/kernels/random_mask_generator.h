@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "oneflow/core/common/data_type.h"
 #include "oneflow/core/device/device_context.h"
+#include "oneflow/core/kernel/philox_random.h"
 #ifdef WITH_CUDA
 #include <curand.h>
 #include <curand_kernel.h>
@@ -32,13 +33,13 @@ template<>
 class RandomMaskGenerator<DeviceType::kCPU> final {
  public:
   OF_DISALLOW_COPY_AND_MOVE(RandomMaskGenerator);
-  RandomMaskGenerator(int64_t seed) : mt19937_generator_(seed) {}
+  RandomMaskGenerator(int64_t seed) : philox_random_(seed) {}
   ~RandomMaskGenerator() {}
 
   void Generate(DeviceCtx* device_ctx, int64_t n, float rate, int8_t* mask);
 
  private:
-  std::mt19937 mt19937_generator_;
+  PhiloxRandom philox_random_;
 };
 
 #ifdef WITH_CUDA
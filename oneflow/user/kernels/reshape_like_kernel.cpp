@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/core/framework/framework.h"
+#include "oneflow/core/framework/op_kernel_infer_cache.h"
 #include "oneflow/user/kernels/copy_data_content_kernel.h"
 
 namespace oneflow {
@@ -33,4 +34,19 @@ REGISTER_RESHAPE_LIKE_KERNEL(kCPU)
 REGISTER_RESHAPE_LIKE_KERNEL(kGPU)
 #endif
 
+namespace {
+
+// The out shape is the like shape, `in` only has to match its elem cnt. reshape_like is the grad
+// of reshape for dynamic inputs, so this takes one cache entry per elem cnt instead of one per
+// dynamic `in` shape.
+Shape ReshapeLikeInferCacheShapeBucket(const std::string& arg_name, int32_t arg_index,
+                                       const Shape& shape) {
+  if (arg_name == "in") { return Shape({shape.elem_cnt()}); }
+  return shape;
+}
+
+}  // namespace
+
+REGISTER_OP_KERNEL_INFER_CACHE_SHAPE_BUCKET_FN("reshape_like", ReshapeLikeInferCacheShapeBucket);
+
 }  // namespace oneflow
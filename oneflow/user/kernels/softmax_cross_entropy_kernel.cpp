@@ -15,10 +15,39 @@ limitations under the License.
 */
 #include "oneflow/user/kernels/softmax_cross_entropy_kernel.h"
 #include "oneflow/core/kernel/kernel_util.cuh"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 namespace user_op {
 
+namespace {
+
+constexpr int64_t kParallelMinPartSize = 32768;
+
+// Calls Handler with [begin, end) ranges of rows, on the threads of Global<ThreadPool> if there
+// are enough elements
+void ForEachRowRange(const int64_t num_instances, const int64_t num_classes,
+                     const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  int64_t part_num = 1;
+  if (Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(),
+                                 num_instances * num_classes / kParallelMinPartSize);
+    part_num = std::min(part_num, num_instances);
+  }
+  if (part_num <= 1) {
+    Handler(0, num_instances);
+    return;
+  }
+  BalancedSplitter bs(num_instances, part_num);
+  MultiThreadLoop(part_num, [&](size_t part_id) {
+    const Range range = bs.At(part_id);
+    Handler(range.begin(), range.end());
+  });
+}
+
+}  // namespace
+
 template<typename T>
 struct CrossEntropyKernelUtil<DeviceType::kCPU, T> {
   static void ComputeEntropy(DeviceCtx* ctx, const int64_t num_instances, const int64_t num_classes,
@@ -35,13 +64,42 @@ struct CrossEntropyKernelUtil<DeviceType::kCPU, T> {
     }
   }
 
+  static void ComputeProbAndEntropy(DeviceCtx* ctx, const int64_t num_instances,
+                                    const int64_t num_classes, const T* x, const T* labels,
+                                    T* prob, T* y, void* temp_storage,
+                                    const size_t temp_storage_bytes) {
+    // the log normalizers of the rows are written to y and turned into the entropy in place:
+    // -Sum_j(label_j * log(prob_j)) = Sum_j(label_j * (log_sum_exp - x_j)), which neither reads
+    // prob back nor takes a log per element
+    SoftmaxKernelUtil<DeviceType::kCPU, T>::ComputeProbAndLogSumExp(
+        ctx, num_instances, num_classes, x, prob, y, temp_storage, temp_storage_bytes);
+    ForEachRowRange(num_instances, num_classes, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const T* row_x = x + i * num_classes;
+        const T* row_labels = labels + i * num_classes;
+        const T log_sum_exp = y[i];
+        T entropy = 0;
+        for (int64_t j = 0; j < num_classes; ++j) {
+          entropy += row_labels[j] * (log_sum_exp - row_x[j]);
+        }
+        y[i] = entropy;
+      }
+    });
+  }
+
   static void ComputeDiffWithSoftmax(DeviceCtx* ctx, const int64_t elem_cnt,
                                      const int64_t num_classes, const T* prob, const T* labels,
                                      const T* dy, T* dx) {
-    FOR_RANGE(int64_t, i, 0, elem_cnt) {
-      const int32_t row_id = i / num_classes;
-      dx[i] = dy[row_id] * (prob[i] - labels[i]);
-    }
+    if (elem_cnt == 0) { return; }
+    ForEachRowRange(elem_cnt / num_classes, num_classes, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const int64_t offset = i * num_classes;
+        const T row_dy = dy[i];
+        for (int64_t j = offset; j < offset + num_classes; ++j) {
+          dx[j] = row_dy * (prob[j] - labels[j]);
+        }
+      }
+    });
   }
 };
 
@@ -107,6 +107,15 @@ struct CrossEntropyKernelUtil<DeviceType::kGPU, T> {
                         ctx->cuda_stream()>>>(num_instances, num_classes, x, labels, y);
   }
 
+  static void ComputeProbAndEntropy(DeviceCtx* ctx, const int64_t num_instances,
+                                    const int64_t num_classes, const T* x, const T* labels,
+                                    T* prob, T* y, void* temp_storage,
+                                    const size_t temp_storage_bytes) {
+    SoftmaxKernelUtil<DeviceType::kGPU, T>::ComputeProb(ctx, num_instances, num_classes, x, prob,
+                                                        temp_storage, temp_storage_bytes);
+    ComputeEntropy(ctx, num_instances, num_classes, prob, labels, y);
+  }
+
   static void ComputeDiffWithSoftmax(DeviceCtx* ctx, const int64_t elem_cnt,
                                      const int64_t num_classes, const T* prob, const T* labels,
                                      const T* dy, T* dx) {
@@ -126,6 +135,15 @@ struct CrossEntropyKernelUtil<DeviceType::kGPU, float16> {
         reinterpret_cast<const half*>(labels), reinterpret_cast<half*>(y));
   }
 
+  static void ComputeProbAndEntropy(DeviceCtx* ctx, const int64_t num_instances,
+                                    const int64_t num_classes, const float16* x,
+                                    const float16* labels, float16* prob, float16* y,
+                                    void* temp_storage, const size_t temp_storage_bytes) {
+    SoftmaxKernelUtil<DeviceType::kGPU, float16>::ComputeProb(
+        ctx, num_instances, num_classes, x, prob, temp_storage, temp_storage_bytes);
+    ComputeEntropy(ctx, num_instances, num_classes, prob, labels, y);
+  }
+
   static void ComputeDiffWithSoftmax(DeviceCtx* ctx, const int64_t elem_cnt,
                                      const int64_t num_classes, const float16* prob,
                                      const float16* labels, const float16* dy, float16* dx) {
@@ -23,6 +23,12 @@ template<DeviceType device_type, typename T>
 struct CrossEntropyKernelUtil {
   static void ComputeEntropy(DeviceCtx* ctx, const int64_t num_instances, const int64_t num_classes,
                              const T* x, const T* labels, T* y);
+  // prob = softmax(x) and y = the entropy of prob against labels. The cpu version takes the
+  // entropy from the logits and the log normalizers of their rows instead of the log of prob.
+  static void ComputeProbAndEntropy(DeviceCtx* ctx, const int64_t num_instances,
+                                    const int64_t num_classes, const T* x, const T* labels,
+                                    T* prob, T* y, void* temp_storage,
+                                    const size_t temp_storage_bytes);
   static void ComputeDiffWithSoftmax(DeviceCtx* ctx, const int64_t elem_cnt,
                                      const int64_t num_classes, const T* prob, const T* labels,
                                      const T* dy, T* dx);
@@ -44,12 +50,10 @@ class SoftmaxCrossEntropyKernel final : public user_op::OpKernel {
     const auto num_axes = label->shape().NumAxes();
     const int64_t num_instances = label->shape().Count(0, num_axes - 1);
     const int64_t num_classes = label->shape().At(num_axes - 1);
-    SoftmaxKernelUtil<device_type, T>::ComputeProb(
-        ctx->device_ctx(), num_instances, num_classes, prediction->dptr<T>(), prob->mut_dptr<T>(),
-        tmp_buffer->mut_dptr(), tmp_buffer->shape().elem_cnt());
-    CrossEntropyKernelUtil<device_type, T>::ComputeEntropy(ctx->device_ctx(), num_instances,
-                                                           num_classes, prob->dptr<T>(),
-                                                           label->dptr<T>(), out->mut_dptr<T>());
+    CrossEntropyKernelUtil<device_type, T>::ComputeProbAndEntropy(
+        ctx->device_ctx(), num_instances, num_classes, prediction->dptr<T>(), label->dptr<T>(),
+        prob->mut_dptr<T>(), out->mut_dptr<T>(), tmp_buffer->mut_dptr(),
+        tmp_buffer->shape().elem_cnt());
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
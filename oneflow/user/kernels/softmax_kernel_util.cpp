@@ -14,25 +14,142 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/user/kernels/softmax_kernel_util.h"
-#include "oneflow/core/ndarray/ndarray_util.h"
+#include "oneflow/user/kernels/cpu_vector_math.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 
 namespace {
 
+// A row is processed in blocks small enough to stay in L1 between the passes over a block.
+constexpr int64_t kBlockSize = 1024;
+constexpr int64_t kParallelMinPartSize = 32768;
+// Reductions are carried in independent lanes, which the compiler vectorizes without
+// reassociating floating point additions.
+constexpr int64_t kLaneNum = 8;
+
+int64_t GetBlockNum(int64_t w) { return RoundUp(w, kBlockSize) / kBlockSize; }
+
 template<typename T>
 size_t GetProbTmpSize(int64_t n, int64_t w) {
-  return GetCudaAlignedSize(n * sizeof(T));
+  return GetCudaAlignedSize(n * GetBlockNum(w) * sizeof(T));
+}
+
+// Rows are split into parts computed on the thread pool when there is enough work.
+void ForEachRowRange(int64_t n, int64_t w,
+                     const std::function<void(int64_t begin, int64_t end)>& Handler) {
+  int64_t part_num = 1;
+  if (Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(),
+                                 std::min<int64_t>(n, n * w / kParallelMinPartSize));
+  }
+  if (part_num <= 1) {
+    Handler(0, n);
+    return;
+  }
+  BalancedSplitter bs(n, part_num);
+  MultiThreadLoop(part_num, [&](size_t part_id) {
+    const Range range = bs.At(part_id);
+    Handler(range.begin(), range.end());
+  });
+}
+
+template<typename T>
+T Max(int64_t n, const T* x) {
+  T lane_max[kLaneNum];
+  std::fill(lane_max, lane_max + kLaneNum, -std::numeric_limits<T>::infinity());
+  int64_t i = 0;
+  for (; i + kLaneNum <= n; i += kLaneNum) {
+    for (int64_t j = 0; j < kLaneNum; ++j) {
+      lane_max[j] = x[i + j] > lane_max[j] ? x[i + j] : lane_max[j];
+    }
+  }
+  for (; i < n; ++i) { lane_max[0] = x[i] > lane_max[0] ? x[i] : lane_max[0]; }
+  return *std::max_element(lane_max, lane_max + kLaneNum);
+}
+
+template<typename T>
+T SumLanes(const T* lane_sum) {
+  T sum = 0;
+  for (int64_t j = 0; j < kLaneNum; ++j) { sum += lane_sum[j]; }
+  return sum;
 }
 
 template<typename T>
-size_t GetDiffTmpSize(int64_t n, int64_t w) {
-  return GetCudaAlignedSize(n * sizeof(T));
+T Sum(int64_t n, const T* x) {
+  T lane_sum[kLaneNum] = {0};
+  int64_t i = 0;
+  for (; i + kLaneNum <= n; i += kLaneNum) {
+    for (int64_t j = 0; j < kLaneNum; ++j) { lane_sum[j] += x[i + j]; }
+  }
+  for (; i < n; ++i) { lane_sum[0] += x[i]; }
+  return SumLanes(lane_sum);
 }
 
 template<typename T>
-size_t GetReduceTempStorageSize(int64_t n, int64_t w) {
-  return GetCudaAlignedSize(n * w * sizeof(T));
+T Dot(int64_t n, const T* x, const T* y) {
+  T lane_sum[kLaneNum] = {0};
+  int64_t i = 0;
+  for (; i + kLaneNum <= n; i += kLaneNum) {
+    for (int64_t j = 0; j < kLaneNum; ++j) { lane_sum[j] += x[i + j] * y[i + j]; }
+  }
+  for (; i < n; ++i) { lane_sum[0] += x[i] * y[i]; }
+  return SumLanes(lane_sum);
+}
+
+template<typename T>
+void InplaceExp(int64_t n, T* x) {
+  for (int64_t i = 0; i < n; ++i) { x[i] = std::exp(x[i]); }
+}
+
+template<>
+void InplaceExp<float>(int64_t n, float* x) {
+  cpu_vector_math::Exp(n, x, x);
+}
+
+// Online softmax of a row: each block is exponentiated against the running max of the row so far
+// and the running sum is rescaled whenever the max grows, so that in is read once and exp is taken
+// once per element. The second pass brings every block to the final max and normalizes it.
+// Returns the log normalizer of the row, log(Sum_j(exp(in[j]))).
+template<typename T>
+T SoftmaxRow(int64_t w, const T* in, T* prob, T* block_max) {
+  T row_max = -std::numeric_limits<T>::infinity();
+  T row_sum = 0;
+  for (int64_t begin = 0, k = 0; begin < w; begin += kBlockSize, ++k) {
+    const int64_t len = std::min(kBlockSize, w - begin);
+    const T max = Max(len, in + begin);
+    if (max > row_max) {
+      row_sum *= std::exp(row_max - max);
+      row_max = max;
+    }
+    for (int64_t j = begin; j < begin + len; ++j) { prob[j] = in[j] - row_max; }
+    InplaceExp(len, prob + begin);
+    row_sum += Sum(len, prob + begin);
+    block_max[k] = row_max;
+  }
+  const T inv_sum = static_cast<T>(1) / row_sum;
+  for (int64_t begin = 0, k = 0; begin < w; begin += kBlockSize, ++k) {
+    const T scale = std::exp(block_max[k] - row_max) * inv_sum;
+    const int64_t end = std::min(begin + kBlockSize, w);
+    for (int64_t j = begin; j < end; ++j) { prob[j] *= scale; }
+  }
+  return row_max + std::log(row_sum);
+}
+
+template<typename T>
+void ComputeProbRows(const int64_t n, const int64_t w, const T* in, T* prob, T* log_sum_exp,
+                     void* temp_storage, const size_t temp_storage_bytes) {
+  CHECK_GE(temp_storage_bytes, GetProbTmpSize<T>(n, w));
+  const int64_t block_num = GetBlockNum(w);
+  T* block_max = reinterpret_cast<T*>(temp_storage);
+  ForEachRowRange(n, w, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const T row_log_sum_exp =
+          SoftmaxRow(w, in + i * w, prob + i * w, block_max + i * block_num);
+      if (log_sum_exp != nullptr) { log_sum_exp[i] = row_log_sum_exp; }
+    }
+  });
 }
 
 }  // namespace
@@ -40,67 +157,35 @@ size_t GetReduceTempStorageSize(int64_t n, int64_t w) {
 template<typename T>
 struct SoftmaxKernelUtil<DeviceType::kCPU, T> {
   static size_t GetComputeProbTempStorageSizeInBytes(int64_t n, int64_t w) {
-    return GetProbTmpSize<T>(n, w) + GetReduceTempStorageSize<T>(n, w);
+    return GetProbTmpSize<T>(n, w);
   }
 
-  static size_t GetComputeDiffTempStorageSizeInBytes(int64_t n, int64_t w) {
-    return GetDiffTmpSize<T>(n, w) + GetReduceTempStorageSize<T>(n, w);
-  }
+  static size_t GetComputeDiffTempStorageSizeInBytes(int64_t n, int64_t w) { return 0; }
 
   static void ComputeProb(DeviceCtx* ctx, const int64_t n, const int64_t w, const T* in, T* prob,
                           void* temp_storage, const size_t temp_storage_bytes) {
-    auto Val = NdarrayUtil<DeviceType::kCPU, T>::GetValNdarrayBuilder();
-    auto Var = NdarrayUtil<DeviceType::kCPU, T>::GetVarNdarrayBuilder();
-    const size_t min_temp_storage_bytes =
-        SoftmaxKernelUtil<DeviceType::kCPU, T>::GetComputeProbTempStorageSizeInBytes(n, w);
-    CHECK_GE(temp_storage_bytes, min_temp_storage_bytes);
-    const size_t reduce_temp_storage_bytes = GetReduceTempStorageSize<T>(n, w);
-    T* reduce_storage = reinterpret_cast<T*>(temp_storage);
-    auto reduce_storage_var =
-        Var({static_cast<int64_t>(reduce_temp_storage_bytes / sizeof(T))}, reduce_storage);
-    T* tmp = reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(temp_storage)
-                                  + reduce_temp_storage_bytes);
-    // max | tmp[i] = Max_j(in[i][j])
-    NdarrayUtil<DeviceType::kCPU, T>::ReduceMax(ctx, Var({n, 1}, tmp), Val({n, w}, in),
-                                                reduce_storage_var);
-    // sub | prob[i][j] = in[i][j] - tmp[i]
-    NdarrayUtil<DeviceType::kCPU, T>::BroadcastSub(ctx, Var({n, w}, prob), Val({n, w}, in),
-                                                   Val({n, 1}, tmp));
-    // exp | prob[i][j] = exp(prob[i][j])
-    NdarrayUtil<DeviceType::kCPU, T>::InplaceExp(ctx, Var({n, w}, prob));
-    // sum | tmp[i] = Sum_j(prob[i][j])
-    NdarrayUtil<DeviceType::kCPU, T>::ReduceSum(ctx, Var({n, 1}, tmp), Val({n, w}, prob),
-                                                reduce_storage_var);
-    // div | prob[i][j] /= tmp[i]
-    NdarrayUtil<DeviceType::kCPU, T>::InplaceBroadcastDiv(ctx, Var({n, w}, prob), Val({n, 1}, tmp));
+    ComputeProbRows<T>(n, w, in, prob, nullptr, temp_storage, temp_storage_bytes);
+  }
+
+  static void ComputeProbAndLogSumExp(DeviceCtx* ctx, const int64_t n, const int64_t w,
+                                      const T* in, T* prob, T* log_sum_exp, void* temp_storage,
+                                      const size_t temp_storage_bytes) {
+    ComputeProbRows<T>(n, w, in, prob, log_sum_exp, temp_storage, temp_storage_bytes);
   }
 
   static void ComputeDiff(DeviceCtx* ctx, const int64_t n, const int64_t w, const T* dy,
                           const T* out, T* dx, void* temp_storage,
                           const size_t temp_storage_bytes) {
-    auto Val = NdarrayUtil<DeviceType::kCPU, T>::GetValNdarrayBuilder();
-    auto Var = NdarrayUtil<DeviceType::kCPU, T>::GetVarNdarrayBuilder();
-    const size_t min_temp_storage_bytes =
-        SoftmaxKernelUtil<DeviceType::kCPU, T>::GetComputeProbTempStorageSizeInBytes(n, w);
-    CHECK_GE(temp_storage_bytes, min_temp_storage_bytes);
-    const size_t reduce_temp_storage_bytes = GetReduceTempStorageSize<T>(n, w);
-    T* reduce_storage = reinterpret_cast<T*>(temp_storage);
-    auto reduce_storage_var =
-        Var({static_cast<int64_t>(reduce_temp_storage_bytes / sizeof(T))}, reduce_storage);
-    T* sum_vec = reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(temp_storage)
-                                      + reduce_temp_storage_bytes);
-    // it's safe to use dx as tmp
-    // dot product | get dot product sum_vec[i] from out[i] * dy[i]
-    T* tmp = dx;
-    NdarrayUtil<DeviceType::kCPU, T>::Mul(ctx, Var({n * w}, tmp), Val({n * w}, out),
-                                          Val({n * w}, dy));
-    NdarrayUtil<DeviceType::kCPU, T>::ReduceSum(ctx, Var({n, 1}, sum_vec), Val({n, w}, tmp),
-                                                reduce_storage_var);
-    // sub | dx[i][j] = dy[i][j] - sum_vec[i]
-    NdarrayUtil<DeviceType::kCPU, T>::BroadcastSub(ctx, Var({n, w}, dx), Val({n, w}, dy),
-                                                   Val({n, 1}, sum_vec));
-    // elementwise multiplication | dx[i][j] *= out[i][j]
-    NdarrayUtil<DeviceType::kCPU, T>::InplaceMul(ctx, Var({n * w}, dx), Val({n * w}, out));
+    // dx[i][j] = (dy[i][j] - Sum_k(dy[i][k] * out[i][k])) * out[i][j]
+    ForEachRowRange(n, w, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const T* row_dy = dy + i * w;
+        const T* row_out = out + i * w;
+        T* row_dx = dx + i * w;
+        const T dot = Dot(w, row_dy, row_out);
+        for (int64_t j = 0; j < w; ++j) { row_dx[j] = (row_dy[j] - dot) * row_out[j]; }
+      }
+    });
   }
 };
 
@@ -26,6 +26,12 @@ struct SoftmaxKernelUtil {
   static size_t GetComputeDiffTempStorageSizeInBytes(int64_t n, int64_t w);
   static void ComputeProb(DeviceCtx* ctx, int64_t n, int64_t w, const T* in, T* prob,
                           void* temp_storage, size_t temp_storage_bytes);
+  // Same as ComputeProb, and also writes the log normalizer of each row to log_sum_exp, so that
+  // log(prob[i][j]) == in[i][j] - log_sum_exp[i] is known without taking the log of prob. Only
+  // implemented on cpu.
+  static void ComputeProbAndLogSumExp(DeviceCtx* ctx, int64_t n, int64_t w, const T* in, T* prob,
+                                      T* log_sum_exp, void* temp_storage,
+                                      size_t temp_storage_bytes);
   static void ComputeDiff(DeviceCtx* ctx, int64_t n, int64_t w, const T* dy, const T* out, T* dx,
                           void* temp_storage, size_t temp_storage_bytes);
 };
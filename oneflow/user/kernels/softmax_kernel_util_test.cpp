@@ -0,0 +1,158 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/kernels/softmax_kernel_util.h"
+#include "oneflow/user/kernels/sparse_cross_entropy_kernel_util.h"
+#include "oneflow/core/thread/thread_pool.h"
+
+namespace oneflow {
+
+namespace test {
+
+namespace {
+
+std::vector<float> RandomLogits(int64_t n, int64_t w, float scale) {
+  std::mt19937 generator(n * w);
+  std::normal_distribution<float> random_distribution(0.0f, scale);
+  std::vector<float> logits(n * w);
+  for (float& x : logits) { x = random_distribution(generator); }
+  if (n > 1) {
+    // the max of the second row grows block by block
+    for (int64_t j = 0; j < w; ++j) { logits[w + j] = 0.01f * j; }
+  }
+  return logits;
+}
+
+void NaiveSoftmax(int64_t n, int64_t w, const float* in, std::vector<double>* prob,
+                  std::vector<double>* log_sum_exp) {
+  prob->resize(n * w);
+  log_sum_exp->resize(n);
+  FOR_RANGE(int64_t, i, 0, n) {
+    const float* row = in + i * w;
+    const double max = *std::max_element(row, row + w);
+    double sum = 0;
+    FOR_RANGE(int64_t, j, 0, w) { sum += std::exp(row[j] - max); }
+    FOR_RANGE(int64_t, j, 0, w) { prob->at(i * w + j) = std::exp(row[j] - max) / sum; }
+    log_sum_exp->at(i) = max + std::log(sum);
+  }
+}
+
+void ExpectNear(const std::vector<float>& actual, const std::vector<double>& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  FOR_RANGE(size_t, i, 0, actual.size()) {
+    ASSERT_NEAR(actual[i], expected[i], 1e-30 + 1e-5 * std::abs(expected[i])) << "at " << i;
+  }
+}
+
+std::vector<float> ComputeProb(int64_t n, int64_t w, const std::vector<float>& in,
+                               std::vector<float>* log_sum_exp) {
+  std::vector<float> prob(n * w);
+  log_sum_exp->resize(n);
+  const size_t temp_storage_bytes =
+      SoftmaxKernelUtil<DeviceType::kCPU, float>::GetComputeProbTempStorageSizeInBytes(n, w);
+  std::vector<char> temp_storage(temp_storage_bytes);
+  SoftmaxKernelUtil<DeviceType::kCPU, float>::ComputeProbAndLogSumExp(
+      nullptr, n, w, in.data(), prob.data(), log_sum_exp->data(), temp_storage.data(),
+      temp_storage_bytes);
+  return prob;
+}
+
+}  // namespace
+
+TEST(SoftmaxKernelUtil, prob_and_log_sum_exp) {
+  const std::vector<std::pair<int64_t, int64_t>> shapes = {
+      {3, 1}, {5, 1000}, {7, 3001}, {4, 30522}};
+  for (const auto& shape : shapes) {
+    const int64_t n = shape.first;
+    const int64_t w = shape.second;
+    const std::vector<float> in = RandomLogits(n, w, 10.0f);
+    std::vector<float> log_sum_exp;
+    const std::vector<float> prob = ComputeProb(n, w, in, &log_sum_exp);
+    std::vector<double> expected_prob;
+    std::vector<double> expected_log_sum_exp;
+    NaiveSoftmax(n, w, in.data(), &expected_prob, &expected_log_sum_exp);
+    ExpectNear(prob, expected_prob);
+    ExpectNear(log_sum_exp, expected_log_sum_exp);
+  }
+}
+
+TEST(SoftmaxKernelUtil, diff) {
+  const int64_t n = 6;
+  const int64_t w = 2049;
+  const std::vector<float> in = RandomLogits(n, w, 3.0f);
+  const std::vector<float> dy = RandomLogits(n, w, 1.0f);
+  std::vector<float> log_sum_exp;
+  const std::vector<float> out = ComputeProb(n, w, in, &log_sum_exp);
+  std::vector<float> dx(n * w);
+  SoftmaxKernelUtil<DeviceType::kCPU, float>::ComputeDiff(nullptr, n, w, dy.data(), out.data(),
+                                                          dx.data(), nullptr, 0);
+  FOR_RANGE(int64_t, i, 0, n) {
+    double dot = 0;
+    FOR_RANGE(int64_t, j, 0, w) { dot += static_cast<double>(dy[i * w + j]) * out[i * w + j]; }
+    FOR_RANGE(int64_t, j, 0, w) {
+      const double expected = (dy[i * w + j] - dot) * out[i * w + j];
+      ASSERT_NEAR(dx[i * w + j], expected, 1e-6 * (std::abs(expected) + out[i * w + j]));
+    }
+  }
+}
+
+TEST(SoftmaxKernelUtil, sparse_cross_entropy) {
+  const int64_t n = 9;
+  const int64_t w = 5000;
+  const std::vector<float> in = RandomLogits(n, w, 10.0f);
+  std::vector<int32_t> labels(n);
+  FOR_RANGE(int64_t, i, 0, n) { labels[i] = (i * 977) % w; }
+  std::vector<float> out;
+  std::vector<float> prob = ComputeProb(n, w, in, &out);
+  user_op::SparseCrossEntropyKernelUtil<DeviceType::kCPU, float, int32_t>::
+      ComputeEntropyWithLogSumExp(nullptr, n, w, w, 0, in.data(), labels.data(), out.data(),
+                                  out.data());
+  std::vector<double> expected_prob;
+  std::vector<double> expected_log_sum_exp;
+  NaiveSoftmax(n, w, in.data(), &expected_prob, &expected_log_sum_exp);
+  FOR_RANGE(int64_t, i, 0, n) {
+    const double expected = expected_log_sum_exp[i] - in[i * w + labels[i]];
+    ASSERT_NEAR(out[i], expected, 1e-5 * (1.0 + std::abs(expected_log_sum_exp[i])));
+  }
+  // the grad kernel computes prediction_diff in place of prob
+  const std::vector<float> dy = RandomLogits(1, n, 1.0f);
+  const std::vector<float> original_prob = prob;
+  user_op::SparseCrossEntropyKernelUtil<DeviceType::kCPU, float, int32_t>::ComputeDiffWithSoftmax(
+      nullptr, n * w, w, w, 0, prob.data(), labels.data(), dy.data(), prob.data());
+  FOR_RANGE(int64_t, i, 0, n) {
+    FOR_RANGE(int64_t, j, 0, w) {
+      const float p = original_prob[i * w + j];
+      ASSERT_EQ(prob[i * w + j], dy[i] * (j == labels[i] ? p - 1 : p));
+    }
+  }
+}
+
+TEST(SoftmaxKernelUtil, independent_of_thread_num) {
+  const int64_t n = 37;
+  const int64_t w = 10000;
+  const std::vector<float> in = RandomLogits(n, w, 10.0f);
+  std::vector<float> serial_log_sum_exp;
+  const std::vector<float> serial = ComputeProb(n, w, in, &serial_log_sum_exp);
+  Global<ThreadPool>::New(4);
+  std::vector<float> parallel_log_sum_exp;
+  const std::vector<float> parallel = ComputeProb(n, w, in, &parallel_log_sum_exp);
+  Global<ThreadPool>::Delete();
+  ASSERT_TRUE(serial == parallel);
+  ASSERT_TRUE(serial_log_sum_exp == parallel_log_sum_exp);
+}
+
+}  // namespace test
+
+}  // namespace oneflow
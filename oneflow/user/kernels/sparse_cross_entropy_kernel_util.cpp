@@ -15,10 +15,18 @@ limitations under the License.
 */
 #include "oneflow/user/kernels/sparse_cross_entropy_kernel_util.h"
 #include "oneflow/core/kernel/kernel_util.cuh"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
 
 namespace oneflow {
 namespace user_op {
 
+namespace {
+
+constexpr int64_t kParallelMinPartSize = 32768;
+
+}  // namespace
+
 template<typename T, typename K>
 struct SparseCrossEntropyKernelUtil<DeviceType::kCPU, T, K> {
   static void ComputeEntropy(DeviceCtx* ctx, const int64_t num_instances, const int64_t num_classes,
@@ -32,6 +40,20 @@ struct SparseCrossEntropyKernelUtil<DeviceType::kCPU, T, K> {
     }
   }
 
+  static void ComputeEntropyWithLogSumExp(DeviceCtx* ctx, const int64_t num_instances,
+                                          const int64_t num_classes, const int64_t depth,
+                                          const int64_t lower_bound, const T* x, const K* labels,
+                                          const T* log_sum_exp, T* y) {
+    FOR_RANGE(int64_t, i, 0, num_instances) {
+      CHECK_GE(labels[i], 0);
+      CHECK_LT(labels[i], depth);
+      K label = labels[i] - lower_bound;
+      if (label >= 0 && label < num_classes) {
+        y[i] = log_sum_exp[i] - x[i * num_classes + label];
+      }
+    }
+  }
+
   static void ComputeDiff(DeviceCtx* ctx, const int64_t num_instances, const int64_t num_classes,
                           const int64_t depth, const int64_t lower_bound, const T* x,
                           const K* labels, const T* dy, T* dx) {
@@ -49,19 +71,37 @@ struct SparseCrossEntropyKernelUtil<DeviceType::kCPU, T, K> {
                                      const int64_t num_classes, const int64_t depth,
                                      const int64_t lower_bound, const T* prob, const K* labels,
                                      const T* dy, T* dx) {
-    FOR_RANGE(int64_t, i, 0, elem_cnt) {
-      const int32_t row_id = i / num_classes;
-      const int32_t col_id = i - row_id * num_classes;
-      CHECK_GE(labels[row_id], 0);
-      CHECK_LT(labels[row_id], depth);
-      K label = labels[row_id] - lower_bound;
-
-      if (label == col_id) {
-        dx[i] = dy[row_id] * (prob[i] - 1);
-      } else {
-        dx[i] = dy[row_id] * prob[i];
+    const int64_t num_instances = elem_cnt / num_classes;
+    // dx may be prob, so the prob of the label is read before its row is overwritten
+    const auto ComputeRows = [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        CHECK_GE(labels[i], 0);
+        CHECK_LT(labels[i], depth);
+        const K label = labels[i] - lower_bound;
+        const bool has_label = label >= 0 && label < num_classes;
+        const T* row_prob = prob + i * num_classes;
+        T* row_dx = dx + i * num_classes;
+        const T label_prob = has_label ? row_prob[label] : static_cast<T>(0);
+        const T row_dy = dy[i];
+        for (int64_t j = 0; j < num_classes; ++j) { row_dx[j] = row_dy * row_prob[j]; }
+        if (has_label) { row_dx[label] = row_dy * (label_prob - 1); }
       }
+    };
+    int64_t part_num = 1;
+    if (Global<ThreadPool>::Get() != nullptr) {
+      part_num = std::min<int64_t>(Global<ThreadPool>::Get()->thread_num(),
+                                   elem_cnt / kParallelMinPartSize);
+      part_num = std::min(part_num, num_instances);
+    }
+    if (part_num <= 1) {
+      ComputeRows(0, num_instances);
+      return;
     }
+    BalancedSplitter bs(num_instances, part_num);
+    MultiThreadLoop(part_num, [&](size_t part_id) {
+      const Range range = bs.At(part_id);
+      ComputeRows(range.begin(), range.end());
+    });
   }
 };
 
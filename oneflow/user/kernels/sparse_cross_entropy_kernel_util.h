@@ -26,6 +26,12 @@ struct SparseCrossEntropyKernelUtil {
   static void ComputeEntropy(DeviceCtx* ctx, const int64_t num_instances, const int64_t num_classes,
                              const int64_t depth, const int64_t lower_bound, const T* x,
                              const K* labels, T* y);
+  // y[i] = log_sum_exp[i] - x[i][label], the entropy of softmax(x) computed from the logits x and
+  // the log normalizers of their rows. y may be log_sum_exp. Only implemented on cpu.
+  static void ComputeEntropyWithLogSumExp(DeviceCtx* ctx, const int64_t num_instances,
+                                          const int64_t num_classes, const int64_t depth,
+                                          const int64_t lower_bound, const T* x, const K* labels,
+                                          const T* log_sum_exp, T* y);
   static void ComputeDiff(DeviceCtx* ctx, const int64_t num_instances, const int64_t num_classes,
                           const int64_t depth, const int64_t lower_bound, const T* x,
                           const K* labels, const T* dy, T* dx);
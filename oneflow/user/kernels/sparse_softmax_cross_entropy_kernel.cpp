@@ -58,12 +58,14 @@ class SparseSoftmaxCrossEntropyKernel final : public user_op::OpKernel {
     const int64_t num_classes = prediction->shape().elem_cnt() / num_instances;
     const int64_t lower_bound = 0;
     const int64_t depth = ctx->Attr<int64_t>("depth");
-    SoftmaxKernelUtil<device_type, T>::ComputeProb(
+    // the log normalizers of the rows are written to out and turned into the entropy in place,
+    // which neither reads prob back nor loses precision to the log of a small prob
+    SoftmaxKernelUtil<device_type, T>::ComputeProbAndLogSumExp(
         ctx->device_ctx(), num_instances, num_classes, prediction->dptr<T>(), prob->mut_dptr<T>(),
-        tmp_buffer->mut_dptr(), tmp_buffer->shape().elem_cnt());
-    SparseCrossEntropyKernelUtil<device_type, T, K>::ComputeEntropy(
-        ctx->device_ctx(), num_instances, num_classes, depth, lower_bound, prob->dptr<T>(),
-        label->dptr<K>(), out->mut_dptr<T>());
+        out->mut_dptr<T>(), tmp_buffer->mut_dptr(), tmp_buffer->shape().elem_cnt());
+    SparseCrossEntropyKernelUtil<device_type, T, K>::ComputeEntropyWithLogSumExp(
+        ctx->device_ctx(), num_instances, num_classes, depth, lower_bound, prediction->dptr<T>(),
+        label->dptr<K>(), out->dptr<T>(), out->mut_dptr<T>());
   }
   bool AlwaysComputeWhenAllOutputsEmpty() const override { return false; }
 };
@@ -0,0 +1,73 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/framework.h"
+
+namespace oneflow {
+
+namespace {
+
+Maybe<void> InferColumnarDataLoaderTensorDesc(user_op::InferContext* ctx, int64_t batch_size) {
+  const auto& column_names = ctx->Attr<std::vector<std::string>>("column_names");
+  const auto& row_lengths = ctx->Attr<std::vector<int64_t>>("row_lengths");
+  CHECK_GT_OR_RETURN(column_names.size(), 0);
+  CHECK_EQ_OR_RETURN(column_names.size(), ctx->outputs().size());
+  CHECK_EQ_OR_RETURN(row_lengths.size(), ctx->outputs().size());
+  FOR_RANGE(int32_t, i, 0, ctx->outputs().size()) {
+    CHECK_GT_OR_RETURN(row_lengths.at(i), 0);
+    *ctx->Shape4ArgNameAndIndex("out", i) = Shape({batch_size, row_lengths.at(i)});
+  }
+  return Maybe<void>::Ok();
+}
+
+}  // namespace
+
+REGISTER_CPU_ONLY_USER_OP("columnar_data_loader")
+    .OutputWithMinimum("out", 1)
+    .Attr<std::vector<std::string>>("files")
+    .Attr<std::vector<std::string>>("column_names")
+    .Attr<std::vector<int64_t>>("row_lengths")
+    .Attr<std::vector<DataType>>("dtypes")
+    .Attr<int64_t>("batch_size")
+    .Attr<bool>("shuffle", false)
+    .Attr<int64_t>("random_seed")
+    .SetPhysicalTensorDescInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
+      int64_t local_batch_size = ctx->Attr<int64_t>("batch_size");
+      const SbpParallel& sbp = ctx->SbpParallel4ArgNameAndIndex("out", 0);
+      int64_t parallel_num = ctx->parallel_ctx().parallel_num();
+      if (sbp.has_split_parallel() && parallel_num > 1) {
+        CHECK_EQ_OR_RETURN(local_batch_size % parallel_num, 0);
+        local_batch_size /= parallel_num;
+      }
+      return InferColumnarDataLoaderTensorDesc(ctx, local_batch_size);
+    })
+    .SetLogicalTensorDescInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
+      return InferColumnarDataLoaderTensorDesc(ctx, ctx->Attr<int64_t>("batch_size"));
+    })
+    .SetGetSbpFn([](user_op::SbpContext* ctx) -> Maybe<void> {
+      ctx->NewBuilder().Split(ctx->outputs(), 0).Build();
+      return Maybe<void>::Ok();
+    })
+    .SetDataTypeInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
+      const auto& dtypes = ctx->Attr<std::vector<DataType>>("dtypes");
+      CHECK_EQ_OR_RETURN(dtypes.size(), ctx->outputs().size());
+      FOR_RANGE(int32_t, i, 0, ctx->outputs().size()) {
+        CHECK_OR_RETURN(IsPODDataType(dtypes.at(i)));
+        *ctx->Dtype4ArgNameAndIndex("out", i) = dtypes.at(i);
+      }
+      return Maybe<void>::Ok();
+    });
+
+}  // namespace oneflow
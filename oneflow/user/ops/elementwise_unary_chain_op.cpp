@@ -0,0 +1,37 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/core/framework/framework.h"
+
+namespace oneflow {
+
+// Composition of unary elementwise ops, y = f_n(...f_1(x)). It is emitted by the eager
+// elementwise fusion and has no gradient: autograd records the original ops.
+REGISTER_USER_OP("elementwise_unary_chain")
+    .Input("x")
+    .Output("y")
+    .Attr<std::vector<std::string>>("op_type_names")
+    .Attr<std::vector<float>>("scalars")
+    .SetTensorDescInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
+      const auto& op_type_names = ctx->Attr<std::vector<std::string>>("op_type_names");
+      CHECK_EQ_OR_RETURN(op_type_names.size(), ctx->Attr<std::vector<float>>("scalars").size());
+      *ctx->Shape4ArgNameAndIndex("y", 0) = *ctx->Shape4ArgNameAndIndex("x", 0);
+      *ctx->IsDynamic4ArgNameAndIndex("y", 0) = *ctx->IsDynamic4ArgNameAndIndex("x", 0);
+      return Maybe<void>::Ok();
+    })
+    .SetGetSbpFn(user_op::GetSbpFnUtil::SplitForEachAxis)
+    .SetDataTypeInferFn(user_op::TensorDescInferFnUtil::UnchangedDataType);
+
+}  // namespace oneflow
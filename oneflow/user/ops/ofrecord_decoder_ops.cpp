@@ -18,6 +18,16 @@ limitations under the License.
 
 namespace oneflow {
 
+namespace {
+
+// ofrecord_reader outputs OFRecord, or the serialized records in tensor buffers if
+// output_serialized is set
+bool IsRecordDataType(DataType data_type) {
+  return data_type == DataType::kOFRecord || data_type == DataType::kTensorBuffer;
+}
+
+}  // namespace
+
 REGISTER_CPU_ONLY_USER_OP("ofrecord_raw_decoder")
     .Input("in")
     .Output("out")
@@ -53,7 +63,7 @@ REGISTER_CPU_ONLY_USER_OP("ofrecord_raw_decoder")
     .SetDataTypeInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
       user_op::TensorDesc* in_tensor = ctx->TensorDesc4ArgNameAndIndex("in", 0);
       user_op::TensorDesc* out_tensor = ctx->TensorDesc4ArgNameAndIndex("out", 0);
-      CHECK_OR_RETURN(in_tensor->data_type() == DataType::kOFRecord);
+      CHECK_OR_RETURN(IsRecordDataType(in_tensor->data_type()));
       *out_tensor->mut_data_type() = ctx->Attr<DataType>("data_type");
       return Maybe<void>::Ok();
     });
@@ -79,7 +89,7 @@ REGISTER_CPU_ONLY_USER_OP("ofrecord_bytes_decoder")
     .SetDataTypeInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
       const user_op::TensorDesc* in = ctx->TensorDesc4ArgNameAndIndex("in", 0);
       user_op::TensorDesc* out = ctx->TensorDesc4ArgNameAndIndex("out", 0);
-      CHECK_OR_RETURN(in->data_type() == DataType::kOFRecord);
+      CHECK_OR_RETURN(IsRecordDataType(in->data_type()));
       *out->mut_data_type() = DataType::kTensorBuffer;
       return Maybe<void>::Ok();
     });
@@ -112,7 +122,7 @@ REGISTER_CPU_ONLY_USER_OP("ofrecord_image_decoder")
     .SetDataTypeInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
       user_op::TensorDesc* in_tensor = ctx->TensorDesc4ArgNameAndIndex("in", 0);
       user_op::TensorDesc* out_tensor = ctx->TensorDesc4ArgNameAndIndex("out", 0);
-      CHECK_OR_RETURN(in_tensor->data_type() == DataType::kOFRecord);
+      CHECK_OR_RETURN(IsRecordDataType(in_tensor->data_type()));
       *out_tensor->mut_data_type() = DataType::kTensorBuffer;
       return Maybe<void>::Ok();
     });
@@ -150,7 +160,7 @@ REGISTER_CPU_ONLY_USER_OP("ofrecord_image_decoder_random_crop")
     .SetDataTypeInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
       user_op::TensorDesc* in_tensor = ctx->TensorDesc4ArgNameAndIndex("in", 0);
       user_op::TensorDesc* out_tensor = ctx->TensorDesc4ArgNameAndIndex("out", 0);
-      CHECK_OR_RETURN(in_tensor->data_type() == DataType::kOFRecord);
+      CHECK_OR_RETURN(IsRecordDataType(in_tensor->data_type()));
       *out_tensor->mut_data_type() = DataType::kTensorBuffer;
       return Maybe<void>::Ok();
     });
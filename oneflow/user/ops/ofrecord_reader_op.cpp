@@ -28,6 +28,9 @@ REGISTER_CPU_ONLY_USER_OP("OFRecordReader")
     .Attr<int64_t>("seed", -1)
     .Attr<int32_t>("shuffle_buffer_size", 1024)
     .Attr<bool>("shuffle_after_epoch", false)
+    // outputs the serialized records in tensor buffers instead of parsing them into OFRecord,
+    // for the decoders to read their features in place
+    .Attr<bool>("output_serialized", false)
     .SetPhysicalTensorDescInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
       user_op::TensorDesc* out_tensor = ctx->TensorDesc4ArgNameAndIndex("out", 0);
       int32_t local_batch_size = ctx->Attr<int32_t>("batch_size");
@@ -57,7 +60,8 @@ REGISTER_CPU_ONLY_USER_OP("OFRecordReader")
       out_modifier->set_header_infered_before_compute(false);
     })
     .SetDataTypeInferFn([](user_op::InferContext* ctx) -> Maybe<void> {
-      *ctx->Dtype4ArgNameAndIndex("out", 0) = DataType::kOFRecord;
+      *ctx->Dtype4ArgNameAndIndex("out", 0) =
+          ctx->Attr<bool>("output_serialized") ? DataType::kTensorBuffer : DataType::kOFRecord;
       return Maybe<void>::Ok();
     });
 
@@ -0,0 +1,116 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/summary/crc32c.h"
+#include "oneflow/core/common/platform.h"
+#include <cstring>
+
+#if defined(OF_PLATFORM_IS_X86) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define OF_CRC32C_WITH_SSE42
+#endif
+
+namespace oneflow {
+
+namespace summary {
+
+namespace {
+
+// reversed Castagnoli polynomial
+constexpr uint32_t kCrc32cPoly = 0x82f63b78u;
+
+// table[0] extends a crc by one byte, table[k] by one byte followed by k zero bytes.
+struct Crc32cTables {
+  uint32_t table[8][256];
+
+  Crc32cTables() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; ++j) { crc = (crc >> 1) ^ ((crc & 1) ? kCrc32cPoly : 0); }
+      table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (int k = 1; k < 8; ++k) {
+        table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xff];
+      }
+    }
+  }
+};
+
+const Crc32cTables& GetCrc32cTables() {
+  static const Crc32cTables tables;
+  return tables;
+}
+
+inline uint32_t LoadLittleEndian32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+         | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint32_t ExtendCrc32BySlicing8(uint32_t crc, const uint8_t* p, size_t size) {
+  const auto& t = GetCrc32cTables().table;
+  for (; size >= 8; p += 8, size -= 8) {
+    const uint32_t lo = LoadLittleEndian32(p) ^ crc;
+    const uint32_t hi = LoadLittleEndian32(p + 4);
+    crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24]
+          ^ t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+  }
+  for (; size > 0; ++p, --size) { crc = t[0][(crc ^ *p) & 0xff] ^ (crc >> 8); }
+  return crc;
+}
+
+#ifdef OF_CRC32C_WITH_SSE42
+
+__attribute__((target("sse4.2"))) uint32_t ExtendCrc32BySse42(uint32_t crc, const uint8_t* p,
+                                                              size_t size) {
+#ifdef __x86_64__
+  uint64_t crc64 = crc;
+  for (; size >= 8; p += 8, size -= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+#endif
+  for (; size >= 4; p += 4, size -= 4) {
+    uint32_t word;
+    std::memcpy(&word, p, sizeof(word));
+    crc = _mm_crc32_u32(crc, word);
+  }
+  for (; size > 0; ++p, --size) { crc = _mm_crc32_u8(crc, *p); }
+  return crc;
+}
+
+#endif  // OF_CRC32C_WITH_SSE42
+
+using ExtendCrc32Fn = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+ExtendCrc32Fn ChooseExtendCrc32Fn() {
+#ifdef OF_CRC32C_WITH_SSE42
+  if (__builtin_cpu_supports("sse4.2")) { return &ExtendCrc32BySse42; }
+#endif  // OF_CRC32C_WITH_SSE42
+  return &ExtendCrc32BySlicing8;
+}
+
+}  // namespace
+
+uint32_t ExtendCrc32(uint32_t crc, const char* buf, size_t size) {
+  static const ExtendCrc32Fn Extend = ChooseExtendCrc32Fn();
+  return ~Extend(~crc, reinterpret_cast<const uint8_t*>(buf), size);
+}
+
+}  // namespace summary
+
+}  // namespace oneflow
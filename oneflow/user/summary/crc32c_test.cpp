@@ -0,0 +1,64 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/user/summary/crc32c.h"
+
+namespace oneflow {
+
+namespace summary {
+
+namespace test {
+
+namespace {
+
+uint32_t GetCrc32BytewiseForTest(const char* buf, size_t size) {
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= static_cast<uint8_t>(buf[i]);
+    for (int j = 0; j < 8; ++j) { crc = (crc >> 1) ^ ((crc & 1) ? 0x82f63b78u : 0); }
+  }
+  return ~crc;
+}
+
+}  // namespace
+
+TEST(Crc32c, standard_results) {
+  ASSERT_EQ(GetCrc32("", 0), 0);
+  ASSERT_EQ(GetCrc32("123456789", 9), 0xe3069283u);
+  std::string zeros(32, '\0');
+  ASSERT_EQ(GetCrc32(zeros.data(), zeros.size()), 0x8a9136aau);
+  std::string ones(32, '\xff');
+  ASSERT_EQ(GetCrc32(ones.data(), ones.size()), 0x62a8ab43u);
+}
+
+TEST(Crc32c, unaligned_and_extended) {
+  std::string data(1027, '\0');
+  for (size_t i = 0; i < data.size(); ++i) { data[i] = static_cast<char>(i * 131 + 7); }
+  for (size_t offset = 0; offset < 9; ++offset) {
+    for (size_t size = 0; offset + size <= data.size(); size += 37) {
+      const char* buf = data.data() + offset;
+      const uint32_t expected = GetCrc32BytewiseForTest(buf, size);
+      ASSERT_EQ(GetCrc32(buf, size), expected);
+      const size_t half = size / 2;
+      ASSERT_EQ(ExtendCrc32(GetCrc32(buf, half), buf + half, size - half), expected);
+    }
+  }
+}
+
+}  // namespace test
+
+}  // namespace summary
+
+}  // namespace oneflow
@@ -60,10 +60,7 @@ Maybe<void> FillHistogramInSummary(const user_op::Tensor& value, const std::stri
   v->set_tag(tag);
   *v->mutable_metadata() = metadata;
   summary::Histogram histo;
-  for (int64_t i = 0; i < value.shape().elem_cnt(); i++) {
-    double double_val = value.dptr<T>()[i];
-    histo.AppendValue(double_val);
-  }
+  histo.AppendValues(value.dptr<T>(), value.shape().elem_cnt());
   histo.AppendToProto(v->mutable_histo());
   return Maybe<void>::Ok();
 }
@@ -21,17 +21,24 @@ namespace oneflow {
 
 namespace summary {
 
-EventsWriter::EventsWriter() : is_inited_(false) {}
+EventsWriter::EventsWriter()
+    : is_inited_(false),
+      appended_event_cnt_(0),
+      written_event_cnt_(0),
+      is_flush_requested_(false),
+      is_closed_(false) {}
 
 EventsWriter::~EventsWriter() { Close(); }
 
 Maybe<void> EventsWriter::Init(const std::string& logdir) {
+  if (is_inited_) { return Maybe<void>::Ok(); }
   file_system_ = std::make_unique<fs::PosixFileSystem>();
   log_dir_ = logdir + "/event";
   file_system_->RecursivelyCreateDirIfNotExist(log_dir_);
   TryToInit();
+  is_closed_ = false;
   is_inited_ = true;
-  last_flush_time_ = CurrentMircoTime();
+  writer_thread_ = std::thread(&EventsWriter::PollEventQueue, this);
   return Maybe<void>::Ok();
 }
 
@@ -56,32 +63,77 @@ Maybe<void> EventsWriter::TryToInit() {
     event.set_wall_time(current_time);
     event.set_file_version(FILE_VERSION);
     WriteEvent(event);
-    Flush();
   }
   return Maybe<void>::Ok();
 }
 
 void EventsWriter::AppendQueue(std::unique_ptr<Event> event) {
-  queue_mutex.lock();
-  event_queue_.emplace_back(std::move(event));
-  queue_mutex.unlock();
-  if (event_queue_.size() > MAX_QUEUE_NUM || CurrentMircoTime() - last_flush_time_ > FLUSH_TIME) {
-    Flush();
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    event_queue_.emplace_back(std::move(event));
+    appended_event_cnt_ += 1;
+    if (event_queue_.size() <= MAX_QUEUE_NUM) { return; }
   }
+  queue_cond_.notify_one();
 }
 
 void EventsWriter::Flush() {
-  queue_mutex.lock();
-  for (const std::unique_ptr<Event>& e : event_queue_) { WriteEvent(*e); }
-  event_queue_.clear();
-  queue_mutex.unlock();
-  FileFlush();
-  last_flush_time_ = CurrentMircoTime();
+  if (!is_inited_) { return; }
+  std::unique_lock<std::mutex> lock(queue_mutex);
+  const int64_t appended_event_cnt = appended_event_cnt_;
+  is_flush_requested_ = true;
+  queue_cond_.notify_one();
+  written_cond_.wait(lock, [&]() { return written_event_cnt_ >= appended_event_cnt; });
+}
+
+void EventsWriter::PollEventQueue() {
+  while (true) {
+    std::vector<std::unique_ptr<Event>> events;
+    int64_t appended_event_cnt = 0;
+    bool is_closed = false;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      queue_cond_.wait_for(lock, std::chrono::microseconds(FLUSH_TIME), [this]() {
+        return is_closed_ || is_flush_requested_ || event_queue_.size() > MAX_QUEUE_NUM;
+      });
+      events.swap(event_queue_);
+      appended_event_cnt = appended_event_cnt_;
+      is_flush_requested_ = false;
+      is_closed = is_closed_;
+    }
+    if (!events.empty()) {
+      std::string records;
+      for (const std::unique_ptr<Event>& e : events) { AppendRecord(*e, &records); }
+      WriteRecords(records);
+    }
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      written_event_cnt_ = appended_event_cnt;
+    }
+    written_cond_.notify_all();
+    if (is_closed) { break; }
+  }
 }
 
 void EventsWriter::WriteEvent(const Event& event) {
-  std::string event_str;
-  event.AppendToString(&event_str);
+  std::string records;
+  AppendRecord(event, &records);
+  WriteRecords(records);
+}
+
+void EventsWriter::AppendRecord(const Event& event, std::string* records) {
+  const size_t size = event.ByteSizeLong();
+  char head[kHeadSize];
+  EncodeHead(head, size);
+  records->append(head, sizeof(head));
+  const size_t offset = records->size();
+  event.AppendToString(records);
+  char tail[kTailSize];
+  EncodeTail(tail, records->data() + offset, size);
+  records->append(tail, sizeof(tail));
+}
+
+void EventsWriter::WriteRecords(const std::string& records) {
   if (!TryToInit().IsOk()) {
     LOG(ERROR) << "Write failed because file could not be opened.";
     return;
@@ -90,14 +142,7 @@ void EventsWriter::WriteEvent(const Event& event) {
     LOG(WARNING) << "Log file is closed!";
     return;
   }
-
-  char head[kHeadSize];
-  char tail[kTailSize];
-  EncodeHead(head, event_str.size());
-  EncodeTail(tail, event_str.data(), event_str.size());
-  writable_file_->Append(head, sizeof(head));
-  writable_file_->Append(event_str.data(), event_str.size());
-  writable_file_->Append(tail, sizeof(tail));
+  writable_file_->Append(records.data(), records.size());
   FileFlush();
 }
 
@@ -108,8 +153,14 @@ void EventsWriter::FileFlush() {
 
 void EventsWriter::Close() {
   if (!is_inited_) { return; }
-  queue_mutex.unlock();
   Flush();
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    is_closed_ = true;
+  }
+  queue_cond_.notify_one();
+  writer_thread_.join();
+  is_inited_ = false;
   if (writable_file_ != nullptr) {
     writable_file_->Close();
     writable_file_.reset(nullptr);
@@ -22,7 +22,9 @@ limitations under the License.
 #include "oneflow/core/summary/event.pb.h"
 
 #include <time.h>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 namespace oneflow {
 
@@ -34,13 +36,18 @@ namespace summary {
 const size_t kHeadSize = sizeof(uint64_t) + sizeof(uint32_t);
 const size_t kTailSize = sizeof(uint32_t);
 
+// Events appended by the step threads are serialized, checksummed and written in batches by a
+// background thread, which wakes up when more than MAX_QUEUE_NUM events are queued, on Flush, or
+// every FLUSH_TIME microseconds.
 class EventsWriter {
  public:
   EventsWriter();
   ~EventsWriter();
 
   Maybe<void> Init(const std::string& logdir);
+  // Writes `event` on the calling thread, bypassing the queue.
   void WriteEvent(const Event& event);
+  // Blocks until all events appended before are written to the log file.
   void Flush();
   void Close();
 
@@ -49,6 +56,9 @@ class EventsWriter {
 
  private:
   Maybe<void> TryToInit();
+  void PollEventQueue();
+  void WriteRecords(const std::string& records);
+  static void AppendRecord(const Event& event, std::string* records);
   inline static void EncodeHead(char* head, size_t size);
   inline static void EncodeTail(char* tail, const char* data, size_t size);
 
@@ -57,9 +67,15 @@ class EventsWriter {
   std::string filename_;
   std::unique_ptr<fs::FileSystem> file_system_;
   std::unique_ptr<fs::WritableFile> writable_file_;
-  uint64_t last_flush_time_;
   std::vector<std::unique_ptr<Event>> event_queue_;
+  int64_t appended_event_cnt_;
+  int64_t written_event_cnt_;
+  bool is_flush_requested_;
+  bool is_closed_;
   std::mutex queue_mutex;
+  std::condition_variable queue_cond_;
+  std::condition_variable written_cond_;
+  std::thread writer_thread_;
   OF_DISALLOW_COPY(EventsWriter);
 };
 
@@ -15,6 +15,9 @@ limitations under the License.
 */
 #include "oneflow/user/summary/histogram.h"
 #include "oneflow/core/common/maybe.h"
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/common/data_type_seq.h"
+#include "oneflow/core/thread/thread_manager.h"
 #include <cfloat>
 #include <algorithm>
 
@@ -721,6 +724,48 @@ void Histogram::AppendValue(double value) {
   containers_.at(idx) += 1.0;
 }
 
+template<typename T>
+void Histogram::AppendValues(const T* values, int64_t count) {
+  constexpr int64_t kMinValueCntPerPart = 1 << 16;
+  int64_t part_num = count / kMinValueCntPerPart;
+  if (part_num > 1 && Global<ThreadPool>::Get() != nullptr) {
+    part_num = std::min<int64_t>(part_num, Global<ThreadPool>::Get()->thread_num());
+  } else {
+    part_num = 1;
+  }
+  if (part_num == 1) {
+    for (int64_t i = 0; i < count; ++i) { AppendValue(static_cast<double>(values[i])); }
+    return;
+  }
+  const BalancedSplitter bs(count, part_num);
+  std::vector<Histogram> part_histograms(part_num);
+  MultiThreadLoop(part_num, [&](size_t part_id) {
+    Histogram* histogram = &part_histograms.at(part_id);
+    const Range range = bs.At(part_id);
+    for (int64_t i = range.begin(); i < range.end(); ++i) {
+      histogram->AppendValue(static_cast<double>(values[i]));
+    }
+  });
+  for (const Histogram& histogram : part_histograms) { MergeFrom(histogram); }
+}
+
+#define INSTANTIATE_HISTOGRAM_APPEND_VALUES(type_cpp, type_proto) \
+  template void Histogram::AppendValues<type_cpp>(const type_cpp* values, int64_t count);
+OF_PP_FOR_EACH_TUPLE(INSTANTIATE_HISTOGRAM_APPEND_VALUES, POD_DATA_TYPE_SEQ)
+#undef INSTANTIATE_HISTOGRAM_APPEND_VALUES
+
+void Histogram::MergeFrom(const Histogram& other) {
+  CHECK(max_constainers_ == other.max_constainers_);
+  value_count_ += other.value_count_;
+  value_sum_ += other.value_sum_;
+  sum_value_squares_ += other.sum_value_squares_;
+  min_value_ = std::min(min_value_, other.min_value_);
+  max_value_ = std::max(max_value_, other.max_value_);
+  for (size_t idx = 0; idx < containers_.size(); idx++) {
+    containers_.at(idx) += other.containers_.at(idx);
+  }
+}
+
 void Histogram::AppendToProto(HistogramProto* hist_proto) {
   hist_proto->Clear();
   hist_proto->set_num(value_count_);
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ONEFLOW_USER_SUMMARY_HISTOGRAM_H_
 #define ONEFLOW_USER_SUMMARY_HISTOGRAM_H_
 
+#include <cstdint>
 #include <vector>
 #include "oneflow/core/summary/summary.pb.h"
 
@@ -29,6 +30,10 @@ class Histogram {
   ~Histogram() {}
 
   void AppendValue(double value);
+  // Large inputs are bucketed by several threads into partial histograms, then merged.
+  template<typename T>
+  void AppendValues(const T* values, int64_t count);
+  void MergeFrom(const Histogram& other);
   void AppendToProto(HistogramProto* proto);
 
  private:
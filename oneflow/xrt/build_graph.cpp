@@ -131,6 +131,10 @@ void GraphBuilder::SetupGraphEdges() {
     sbp_policy.push_back(BlobSbpPolicy(src, name));
     sbp_policy.push_back(BlobSbpPolicy(dst, name));
     edge->Attr("sbp_policy", sbp_policy);
+    // Set data type and shape
+    const BlobDesc& blob_desc = src->LogicalBlobDesc4Lbi(BlobNameToId(name));
+    edge->Attr("data_type", blob_desc.data_type());
+    edge->Attr("shape", blob_desc.shape());
   }
 }
 
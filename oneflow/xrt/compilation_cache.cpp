@@ -15,52 +15,301 @@ limitations under the License.
 */
 #include "oneflow/xrt/compilation_cache.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "oneflow/xrt/utility/env.h"
+
+#ifdef WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+DEFINE_int64(xrt_compilation_cache_capacity, EnvToInt64(FLAGS_xrt_compilation_cache_capacity, 64),
+             "Maximum executables cached by a launch kernel.");
+DEFINE_int64(xrt_compilation_cache_max_bytes,
+             EnvToInt64(FLAGS_xrt_compilation_cache_max_bytes, 1LL << 30),
+             "Maximum bytes of executables cached by a launch kernel, -1 means unlimited.");
+DEFINE_string(xrt_compilation_cache_dir, EnvToString(FLAGS_xrt_compilation_cache_dir, ""),
+              "Directory to persist compiled executables, empty means disabled.");
+
 namespace oneflow {
 namespace xrt {
 
+namespace {
+
+constexpr char kPersistentMagic[] = "OFXRTEXE";
+
+// Hashes the data of `param`, which may be in device memory.
+size_t ParameterDataHash(const Parameter& param) {
+  std::string host_data(param.byte_size(), '\0');
+#ifdef WITH_CUDA
+  CHECK_EQ(cudaSuccess,
+           cudaMemcpy(&host_data[0], param.data(), host_data.size(), cudaMemcpyDefault));
+#else
+  std::memcpy(&host_data[0], param.data(), host_data.size());
+#endif
+  return std::hash<std::string>()(host_data);
+}
+
+// Returns "name=hash;" for each constant parameter of `names`, or an empty
+// string if one of them is not an entry parameter.
+std::string ConstantParameterDigest(const std::vector<std::string>& names,
+                                    const std::vector<Parameter>& entry_params) {
+  std::ostringstream ss;
+  for (const std::string& name : names) {
+    const auto& it = std::find_if(entry_params.begin(), entry_params.end(),
+                                  [&](const Parameter& param) { return param.name() == name; });
+    if (it == entry_params.end()) { return ""; }
+    ss << name << "=" << std::hex << ParameterDataHash(*it) << ";";
+  }
+  return ss.str();
+}
+
+std::vector<std::string> ConstantParameterNamesOfDigest(const std::string& digest) {
+  std::vector<std::string> names;
+  std::istringstream ss(digest);
+  std::string item;
+  while (std::getline(ss, item, ';')) { names.push_back(item.substr(0, item.find('='))); }
+  return names;
+}
+
+}  // namespace
+
+std::string Signature::ToString() const {
+  std::ostringstream ss;
+  ss << builder_name << ";" << XrtEngine_Name(engine) << ";" << device_ordinal << ";";
+  for (const auto& shape : entry_shapes) { ss << shape.ToString() << ";"; }
+  ss << options;
+  return ss.str();
+}
+
 bool operator==(const Signature& lhs, const Signature& rhs) {
-  return lhs.builder_name == rhs.builder_name && lhs.device_ordinal == rhs.device_ordinal
-         && lhs.entry_shapes == rhs.entry_shapes;
+  return lhs.builder_name == rhs.builder_name && lhs.engine == rhs.engine
+         && lhs.device_ordinal == rhs.device_ordinal && lhs.entry_shapes == rhs.entry_shapes
+         && lhs.options == rhs.options;
 }
 
 size_t SignatureHash::operator()(const Signature& signature) const {
   size_t hash_val =
       std::hash<std::string>()(signature.builder_name) ^ std::hash<int>()(signature.device_ordinal);
+  hash_val ^= std::hash<XrtEngine>()(signature.engine);
+  hash_val ^= std::hash<std::string>()(signature.options);
   for (const auto& shape : signature.entry_shapes) { hash_val ^= std::hash<Shape>()(shape); }
   return hash_val;
 }
 
-Signature ComputeSignature(const std::string& name, const int device_ordinal,
-                           const std::vector<Parameter>& entry_params) {
+Signature ComputeSignature(const std::string& name, const XrtEngine& engine,
+                           const int device_ordinal, const std::vector<Parameter>& entry_params,
+                           const std::string& options) {
   Signature signature;
   signature.builder_name = name;
+  signature.engine = engine;
   signature.device_ordinal = device_ordinal;
   signature.entry_shapes.resize(entry_params.size());
   for (int i = 0; i < entry_params.size(); ++i) {
     signature.entry_shapes[i] = entry_params[i].shape();
   }
+  signature.options = options;
   return std::move(signature);
 }
 
-Executable* CompilationCache::GetRecord(const Signature& signature) const {
-  Executable* record = nullptr;
+std::string CompilationCache::Metrics::ToString() const {
+  std::ostringstream ss;
+  ss << "hits " << hit_cnt << ", misses " << miss_cnt << ", loads " << load_cnt << ", evictions "
+     << evict_cnt << ", compiles " << compile_cnt << " in " << compile_time_ns / 1e9 << "s";
+  return ss.str();
+}
+
+CompilationCache::CompilationCache()
+    : CompilationCache(FLAGS_xrt_compilation_cache_capacity, FLAGS_xrt_compilation_cache_max_bytes,
+                       FLAGS_xrt_compilation_cache_dir) {}
+
+CompilationCache::CompilationCache(int64_t capacity, int64_t max_bytes,
+                                   const std::string& persistent_dir)
+    : capacity_(capacity), max_bytes_(max_bytes), persistent_dir_(persistent_dir), byte_size_(0) {
+  CHECK_GT(capacity_, 0);
+}
+
+CompilationCache::~CompilationCache() {
+  if (metrics_.miss_cnt > 0) { VLOG(1) << "Compilation cache: " << metrics_.ToString(); }
+}
+
+std::shared_ptr<Executable> CompilationCache::GetRecord(const Signature& signature) {
   // std::shared_lock<std::shared_mutex> lock(mutex_);
   std::lock_guard<std::mutex> lock(mutex_);
   const auto& it = records_.find(signature);
-  if (it != records_.end()) { record = it->second.get(); }
-  return record;
+  if (it == records_.end()) {
+    ++metrics_.miss_cnt;
+    return nullptr;
+  }
+  ++metrics_.hit_cnt;
+  Entry* entry = &it->second;
+  lru_list_.splice(lru_list_.begin(), lru_list_, entry->lru_iter);
+  // Some engines build the executable on the first run, so the byte size is
+  // known only after it.
+  UpdateByteSize(entry);
+  std::shared_ptr<Executable> executable = entry->executable;
+  EvictIfNeeded(signature);
+  return executable;
 }
 
 void CompilationCache::Record(const Signature& signature,
-                              const std::shared_ptr<Executable>& result) {
+                              const std::shared_ptr<Executable>& result,
+                              int64_t compile_time_ns) {
   // std::unique_lock<std::shared_mutex> lock(mutex_);
   std::lock_guard<std::mutex> lock(mutex_);
-  records_.emplace(signature, result);
+  if (compile_time_ns > 0) {
+    ++metrics_.compile_cnt;
+    metrics_.compile_time_ns += compile_time_ns;
+  }
+  const auto& it = records_.find(signature);
+  if (it != records_.end()) {
+    byte_size_ -= it->second.byte_size;
+    lru_list_.erase(it->second.lru_iter);
+    records_.erase(it);
+  }
+  lru_list_.push_front(signature);
+  Entry entry{result, lru_list_.begin(), 0, !persistent_dir_.empty()};
+  UpdateByteSize(&entry);
+  records_.emplace(signature, std::move(entry));
+  EvictIfNeeded(signature);
+}
+
+void CompilationCache::UpdateByteSize(Entry* entry) {
+  const int64_t byte_size = std::max<int64_t>(entry->executable->ByteSize(), 0);
+  byte_size_ += byte_size - entry->byte_size;
+  entry->byte_size = byte_size;
+}
+
+void CompilationCache::EvictIfNeeded(const Signature& keep) {
+  while (lru_list_.size() > 1
+         && (static_cast<int64_t>(lru_list_.size()) > capacity_
+             || (max_bytes_ >= 0 && byte_size_ > max_bytes_))) {
+    const Signature& victim = lru_list_.back();
+    if (victim == keep) { break; }
+    const auto& it = records_.find(victim);
+    CHECK(it != records_.end());
+    byte_size_ -= it->second.byte_size;
+    records_.erase(it);
+    lru_list_.pop_back();
+    ++metrics_.evict_cnt;
+  }
+}
+
+std::string CompilationCache::PersistentPath(const Signature& signature) const {
+  const auto& deserializer = ExecutableDeserializer::Registry()->Lookup(signature.engine);
+  const std::string key = signature.ToString() + ";" + deserializer.version;
+  std::ostringstream ss;
+  ss << persistent_dir_ << "/" << XrtEngine_Name(signature.engine) << "_" << std::hex
+     << std::hash<std::string>()(key);
+  return ss.str();
+}
+
+std::shared_ptr<Executable> CompilationCache::Load(const Signature& signature,
+                                                   const std::string& graph_fingerprint,
+                                                   const std::vector<Parameter>& entry_params) {
+  if (persistent_dir_.empty()) { return nullptr; }
+  if (!ExecutableDeserializer::Registry()->IsRegistered(signature.engine)) { return nullptr; }
+  const auto& deserializer = ExecutableDeserializer::Registry()->Lookup(signature.engine);
+  std::ifstream in(PersistentPath(signature), std::ios::in | std::ios::binary);
+  if (!in.good()) { return nullptr; }
+  std::string magic, key;
+  if (!std::getline(in, magic) || magic != kPersistentMagic) { return nullptr; }
+  // The full key is stored to tell apart signatures with the same hash value.
+  if (!std::getline(in, key) || key != signature.ToString() + ";" + deserializer.version) {
+    return nullptr;
+  }
+  // The graph or a constant changed since the executable was persisted. The
+  // file is overwritten once the executable is recompiled.
+  std::string fingerprint, constant_digest;
+  if (!std::getline(in, fingerprint) || fingerprint != graph_fingerprint
+      || !std::getline(in, constant_digest)
+      || constant_digest
+             != ConstantParameterDigest(ConstantParameterNamesOfDigest(constant_digest),
+                                        entry_params)) {
+    VLOG(2) << "Skip the stale persisted executable of " << signature.builder_name;
+    return nullptr;
+  }
+  std::ostringstream data;
+  data << in.rdbuf();
+  std::shared_ptr<Executable> executable =
+      deserializer.deserialize(signature.builder_name, data.str());
+  if (!executable) {
+    LOG(WARNING) << "Failed to load the persisted executable of " << signature.builder_name;
+    return nullptr;
+  }
+  Record(signature, executable);
+  std::lock_guard<std::mutex> lock(mutex_);
+  records_.at(signature).need_persist = false;
+  ++metrics_.load_cnt;
+  return executable;
+}
+
+void CompilationCache::Persist(const Signature& signature, const std::string& graph_fingerprint,
+                               const std::vector<Parameter>& entry_params) {
+  std::shared_ptr<Executable> executable;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& it = records_.find(signature);
+    if (it == records_.end() || !it->second.need_persist) { return; }
+    it->second.need_persist = false;
+    executable = it->second.executable;
+  }
+  if (!ExecutableDeserializer::Registry()->IsRegistered(signature.engine)) { return; }
+  std::string data;
+  if (!executable->Serialize(&data)) { return; }
+  const std::vector<std::string> constant_names = executable->ConstantParameterNames();
+  const std::string constant_digest = ConstantParameterDigest(constant_names, entry_params);
+  if (constant_digest.empty() && !constant_names.empty()) { return; }
+  const auto& deserializer = ExecutableDeserializer::Registry()->Lookup(signature.engine);
+  const std::string path = PersistentPath(signature);
+  // Written to a temporary file first, so that a concurrent `Load` never reads
+  // a partial executable.
+  const std::string tmp_path = path + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(this));
+  {
+    std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out << kPersistentMagic << "\n" << signature.ToString() << ";" << deserializer.version << "\n"
+        << graph_fingerprint << "\n"
+        << constant_digest << "\n";
+    out.write(data.data(), data.size());
+    if (!out.good()) {
+      LOG(WARNING) << "Failed to persist the executable of " << signature.builder_name << " to "
+                   << tmp_path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  VLOG(2) << "Persisted executable of " << signature.builder_name << " to " << path;
 }
 
 void CompilationCache::Release() {
-  util::Map<Signature, std::shared_ptr<Executable>, SignatureHash> empty_records;
+  std::lock_guard<std::mutex> lock(mutex_);
+  util::Map<Signature, Entry, SignatureHash> empty_records;
   records_.swap(empty_records);
+  lru_list_.clear();
+  byte_size_ = 0;
+}
+
+CompilationCache::Metrics CompilationCache::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+size_t CompilationCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return records_.size();
+}
+
+int64_t CompilationCache::byte_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return byte_size_;
 }
 
 }  // namespace xrt
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ONEFLOW_XRT_COMPILATION_CACHE_H_
 #define ONEFLOW_XRT_COMPILATION_CACHE_H_
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -25,6 +26,8 @@ limitations under the License.
 #include "oneflow/core/common/shape.h"
 #include "oneflow/xrt/executable.h"
 #include "oneflow/xrt/parameter.h"
+#include "oneflow/xrt/types.h"
+#include "oneflow/xrt/utility/registry.h"
 #include "oneflow/xrt/utility/stl.h"
 
 namespace oneflow {
@@ -33,11 +36,18 @@ namespace xrt {
 struct Signature {
   // Builder name
   std::string builder_name;
+  // Engine the executable is compiled for
+  XrtEngine engine;
   // Device ordinal
   int device_ordinal;
   // std::vector<Shape> entry_data_types;
   // It will lose efficacy if the entry shapes has been changed.
   std::vector<Shape> entry_shapes;
+  // Engine options that change the compilation result, such as the precision
+  // of TensorRT.
+  std::string options;
+
+  std::string ToString() const;
 };
 
 bool operator==(const Signature& lhs, const Signature& rhs);
@@ -46,23 +56,111 @@ struct SignatureHash {
   size_t operator()(const Signature& signature) const;
 };
 
-Signature ComputeSignature(const std::string& name, const int device_ordinal,
-                           const std::vector<xrt::Parameter>& entry_params);
+Signature ComputeSignature(const std::string& name, const XrtEngine& engine,
+                           const int device_ordinal,
+                           const std::vector<xrt::Parameter>& entry_params,
+                           const std::string& options = "");
+
+// Restores the executables of an engine serialized by `Executable::Serialize`.
+struct ExecutableDeserializer {
+  // Library version of the engine. Executables persisted by another version
+  // are never loaded.
+  std::string version;
+  std::function<std::shared_ptr<Executable>(const std::string& name, const std::string& data)>
+      deserialize;
+
+  static auto Registry() -> util::Registry<XrtEngine, ExecutableDeserializer>* {
+    return util::Registry<XrtEngine, ExecutableDeserializer>::Global();
+  }
+};
 
+// Executables compiled by a launch kernel.
+//
+// Records are evicted in least recently used order once the cache holds more
+// than `capacity` records or more than `max_bytes` bytes reported by
+// `Executable::ByteSize`. If `persistent_dir` is not empty, executables of the
+// engines registered with an `ExecutableDeserializer` are written to it by
+// `Persist` and read back by `Load`, so that a restarted job skips compiling.
+// A persisted executable is only loaded if the graph fingerprint and the values
+// of its constant entry parameters still match the ones it was compiled from.
 class CompilationCache {
  public:
-  Executable* GetRecord(const Signature& signature) const;
-
-  void Record(const Signature& signature, const std::shared_ptr<Executable>& result);
+  struct Metrics {
+    int64_t hit_cnt = 0;
+    int64_t miss_cnt = 0;
+    int64_t load_cnt = 0;
+    int64_t evict_cnt = 0;
+    int64_t compile_cnt = 0;
+    int64_t compile_time_ns = 0;
+
+    std::string ToString() const;
+  };
+
+  // Limits are read from flags `xrt_compilation_cache_capacity`,
+  // `xrt_compilation_cache_max_bytes` and `xrt_compilation_cache_dir`.
+  CompilationCache();
+  CompilationCache(int64_t capacity, int64_t max_bytes, const std::string& persistent_dir);
+  virtual ~CompilationCache();
+
+  std::shared_ptr<Executable> GetRecord(const Signature& signature);
+
+  void Record(const Signature& signature, const std::shared_ptr<Executable>& result,
+              int64_t compile_time_ns = 0);
+
+  // Returns nullptr if there is no persisted executable of `signature` compiled
+  // from the graph of `graph_fingerprint` and the constant values in
+  // `entry_params`. A loaded executable is recorded.
+  std::shared_ptr<Executable> Load(const Signature& signature, const std::string& graph_fingerprint,
+                                   const std::vector<Parameter>& entry_params);
+
+  // Writes the executable of `signature` to the persistent directory once. It
+  // should be called after the executable has run since some engines build
+  // their executables lazily.
+  void Persist(const Signature& signature, const std::string& graph_fingerprint,
+               const std::vector<Parameter>& entry_params);
 
   void Release();
 
+  Metrics metrics() const;
+  size_t size() const;
+  int64_t byte_size() const;
+
  private:
+  struct Entry {
+    std::shared_ptr<Executable> executable;
+    util::List<Signature>::iterator lru_iter;
+    int64_t byte_size;
+    bool need_persist;
+  };
+
+  std::string PersistentPath(const Signature& signature) const;
+  void UpdateByteSize(Entry* entry);
+  void EvictIfNeeded(const Signature& keep);
+
+  int64_t capacity_;
+  int64_t max_bytes_;
+  std::string persistent_dir_;
+
   // static std::shared_mutex mutex_;
   mutable std::mutex mutex_;
-  util::Map<Signature, std::shared_ptr<Executable>, SignatureHash> records_;
+  util::Map<Signature, Entry, SignatureHash> records_;
+  // The most recently used signature comes first.
+  util::List<Signature> lru_list_;
+  int64_t byte_size_;
+  Metrics metrics_;
 };
 
+#define REGISTER_EXECUTABLE_DESERIALIZER(Engine, Version, Deserialize)                     \
+  namespace {                                                                              \
+  struct _XrtExecutableDeserializer {                                                      \
+    _XrtExecutableDeserializer() {                                                         \
+      ExecutableDeserializer::Registry()->Register(                                        \
+          Engine, ExecutableDeserializer{Version, Deserialize});                           \
+    }                                                                                      \
+  };                                                                                       \
+  static _XrtExecutableDeserializer _xrt_executable_deserializer_ __attribute__((unused)); \
+  }  // namespace
+
 }  // namespace xrt
 }  // namespace oneflow
 
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ONEFLOW_XRT_EXECUTABLE_H_
 #define ONEFLOW_XRT_EXECUTABLE_H_
 
+#include <string>
 #include <vector>
 
 #include "oneflow/xrt/parameter.h"
@@ -78,6 +79,17 @@ class Executable {
 
   const std::vector<Parameter>& Results() const { return results_; }
 
+  // Estimated memory footprint of the executable in bytes.
+  virtual int64_t ByteSize() const { return 0; }
+
+  // Serializes the executable so that it can be restored by the
+  // `ExecutableDeserializer` of the engine. Returns false if it's not supported.
+  virtual bool Serialize(std::string* data) const { return false; }
+
+  // Names of the entry parameters whose values are compiled into the
+  // executable as constants, such as the weights of a TensorRT engine.
+  virtual std::vector<std::string> ConstantParameterNames() const { return {}; }
+
  protected:
   // Executable name.
   std::string name_;
@@ -20,6 +20,9 @@ limitations under the License.
 #include "oneflow/xrt/graph_compiler.h"
 #include "oneflow/xrt/platform.h"
 #include "oneflow/xrt/utility/env.h"
+#include "absl/strings/str_cat.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
 // General executable setup.
 DEFINE_int64(max_workspace_bytes, EnvToInt64(FLAGS_max_workspace_bytes, -1),
@@ -56,17 +59,38 @@ void BlobDescGetter<device_type>::DumpEntryBlobDescTo(
 }
 
 template<DeviceType device_type>
-xrt::Executable* XrtLaunchKernel<device_type>::BuildExecutable(
-    const std::vector<xrt::Parameter>& entry_params,
+const std::string& XrtLaunchKernel<device_type>::GraphFingerprint() const {
+  if (graph_fingerprint_.empty()) {
+    // Maps are serialized in a deterministic order, so that the fingerprint
+    // stays the same across restarts.
+    std::string serialized;
+    {
+      google::protobuf::io::StringOutputStream string_stream(&serialized);
+      google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+      coded_stream.SetSerializationDeterministic(true);
+      this->op_conf().xrt_launch_conf().SerializeToCodedStream(&coded_stream);
+      this->kernel_conf().xrt_launch_conf().SerializeToCodedStream(&coded_stream);
+    }
+    graph_fingerprint_ = absl::StrCat(serialized.size(), "-", std::hash<std::string>()(serialized));
+  }
+  return graph_fingerprint_;
+}
+
+template<DeviceType device_type>
+std::shared_ptr<xrt::Executable> XrtLaunchKernel<device_type>::BuildExecutable(
+    const xrt::Signature& signature, const std::vector<xrt::Parameter>& entry_params,
     const std::vector<xrt::Parameter>& return_params,
     const std::vector<xrt::InputOutputAlias>& aliases, const int device_ordinal) const {
   if (!compilation_cache_) { compilation_cache_.reset(new xrt::CompilationCache); }
 
-  xrt::Executable* executable = nullptr;
-  xrt::Signature signature =
-      xrt::ComputeSignature(this->op_conf().name(), device_ordinal, entry_params);
+  std::shared_ptr<xrt::Executable> executable;
   bool force_compile = false;
-  if (!force_compile) { executable = compilation_cache_->GetRecord(signature); }
+  if (!force_compile) {
+    executable = compilation_cache_->GetRecord(signature);
+    if (!executable) {
+      executable = compilation_cache_->Load(signature, GraphFingerprint(), entry_params);
+    }
+  }
 
   if (!executable) {
     VLOG(2) << "Build executable for launch op " << this->op_conf().name();
@@ -94,15 +118,17 @@ xrt::Executable* XrtLaunchKernel<device_type>::BuildExecutable(
     }
     xrt::XrtEngine engine = xrt::StringToXrtEngine(launch_conf.engine());
     xrt::XrtDevice device = xrt::DeviceTypeToXrtDevice(device_type);
+    const double start_time = GetCurTime();
     xrt::GraphCompiler compiler(this->op_conf().name(), engine, device, device_ordinal);
-    auto result = compiler.Compile(graph.get(), entry_params, return_params, aliases);
+    executable = compiler.Compile(graph.get(), entry_params, return_params, aliases);
+    const double compile_time = GetCurTime() - start_time;
     // Record new compilation result
-    compilation_cache_->Record(signature, result);
-    // Get compilation result from cache
-    executable = compilation_cache_->GetRecord(signature);
+    compilation_cache_->Record(signature, executable, compile_time);
+    VLOG(2) << "Compiled launch op " << this->op_conf().name() << " in " << compile_time / 1e9
+            << "s, compilation cache: " << compilation_cache_->metrics().ToString();
   }
 
-  return std::move(executable);
+  return executable;
 }
 
 template<DeviceType device_type>
@@ -164,10 +190,8 @@ void XrtLaunchKernel<device_type>::ForwardDataContent(
   MakeInputOutputAlias(entry_params, &return_params, &aliases);
   // Mapping parameter names to function input and output names.
   MappingParamsToFunctionNames(&entry_params, &return_params);
-  // Build executable.
-  auto executable = BuildExecutable(entry_params, return_params, aliases, device_ordinal);
-  if (!executable) { LOG(FATAL) << "Executable is built failed."; }
-  // Run executable.
+  // Setup run options.
+  xrt::XrtEngine engine = xrt::StringToXrtEngine(this->op_conf().xrt_launch_conf().engine());
   xrt::ExecutableRunOptions run_options;
   run_options.device_ordinal = device_ordinal;
   run_options.return_params = return_params;
@@ -177,15 +201,30 @@ void XrtLaunchKernel<device_type>::ForwardDataContent(
     run_options.device_memory_limit = FLAGS_max_workspace_bytes;
     block_until_done = false;
   }
-  if (executable->engine() == xrt::XrtEngine::TENSORRT) {
+  // Options which change the compilation result are a part of the signature.
+  std::string options;
+  if (engine == xrt::XrtEngine::TENSORRT) {
     CHECK_EQ(device_type, DeviceType::kGPU);
     run_options.max_batch_size = FLAGS_max_batch_size;
     run_options.tensorrt_fp16 = FLAGS_tensorrt_fp16;
     run_options.tensorrt_int8 = FLAGS_tensorrt_int8;
     run_options.tensorrt_int8_calibration = FLAGS_int8_calibration;
+    options = absl::StrCat(run_options.max_batch_size, ",", run_options.device_memory_limit, ",",
+                           run_options.tensorrt_fp16, ",", run_options.tensorrt_int8);
   }
+  // Build executable.
+  xrt::Signature signature = xrt::ComputeSignature(this->op_conf().name(), engine, device_ordinal,
+                                                   entry_params, options);
+  auto executable =
+      BuildExecutable(signature, entry_params, return_params, aliases, device_ordinal);
+  if (!executable) { LOG(FATAL) << "Executable is built failed."; }
+  // Run executable.
   bool status = executable->Run(entry_params, run_options, block_until_done);
   CHECK(status) << "Executable is running failed.";
+  // The int8 engine of TensorRT depends on the calibration of the running job.
+  if (!run_options.tensorrt_int8) {
+    compilation_cache_->Persist(signature, GraphFingerprint(), entry_params);
+  }
 
   const std::vector<xrt::Parameter>& results = executable->Results();
   CHECK_EQ(results.size(), return_params.size());
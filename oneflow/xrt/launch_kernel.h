@@ -52,10 +52,10 @@ class XrtLaunchKernel : public KernelIf<device_type> {
   void ForwardDataContent(const KernelCtx& ctx,
                           std::function<Blob*(const std::string&)> BnInOp2Blob) const override;
 
-  xrt::Executable* BuildExecutable(const std::vector<xrt::Parameter>& entry_params,
-                                   const std::vector<xrt::Parameter>& return_params,
-                                   const std::vector<xrt::InputOutputAlias>& aliases,
-                                   const int device_ordinal) const;
+  std::shared_ptr<xrt::Executable> BuildExecutable(
+      const xrt::Signature& signature, const std::vector<xrt::Parameter>& entry_params,
+      const std::vector<xrt::Parameter>& return_params,
+      const std::vector<xrt::InputOutputAlias>& aliases, const int device_ordinal) const;
 
   void MakeInputOutputAlias(                            // NOLINT
       const std::vector<xrt::Parameter>& entry_params,  // NOLINT
@@ -65,11 +65,15 @@ class XrtLaunchKernel : public KernelIf<device_type> {
   void MappingParamsToFunctionNames(std::vector<xrt::Parameter>* entry_params,
                                     std::vector<xrt::Parameter>* return_params) const;
 
+  // Identifies the subgraph and launch conf the executables are compiled from.
+  const std::string& GraphFingerprint() const;
+
   bool IsStateless() const override { return false; }
 
  private:
   mutable BlobDescGetter<device_type> desc_getter_;
   mutable std::shared_ptr<xrt::CompilationCache> compilation_cache_;
+  mutable std::string graph_fingerprint_;
 };
 
 }  // namespace oneflow
@@ -0,0 +1,63 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/native_executable.h"
+
+#include <cstring>
+
+#include "glog/logging.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+bool NativeExecutable::Run(const std::vector<Parameter>& inputs,
+                           const ExecutableRunOptions& run_options, bool block_until_done) {
+  const auto& return_params = run_options.return_params;
+  for (int64_t i = 0; i < program_->buffers.size(); ++i) {
+    const NativeBuffer& buffer = program_->buffers[i];
+    switch (buffer.kind) {
+      case NativeBuffer::kEntry: {
+        CHECK_LT(buffer.index, inputs.size());
+        buffers_[i] = reinterpret_cast<char*>(inputs[buffer.index].data());
+        break;
+      }
+      case NativeBuffer::kReturn: {
+        CHECK_LT(buffer.index, return_params.size());
+        buffers_[i] = reinterpret_cast<char*>(return_params[buffer.index].data());
+        break;
+      }
+      case NativeBuffer::kArena: {
+        buffers_[i] = arena_.data() + buffer.offset;
+        break;
+      }
+    }
+  }
+  for (const auto& instruction : program_->instructions) { instruction(buffers_.data()); }
+  for (const auto& pair : program_->return_copies) {
+    char* dst = reinterpret_cast<char*>(return_params[pair.second].data());
+    if (dst != buffers_[pair.first]) {
+      std::memcpy(dst, buffers_[pair.first], program_->buffers[pair.first].byte_size);
+    }
+  }
+  // Instructions run synchronously on the calling thread, so there is nothing
+  // to wait for even if `block_until_done` is false.
+  this->results_ = return_params;
+  return true /*Success*/;
+}
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
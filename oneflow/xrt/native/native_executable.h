@@ -0,0 +1,56 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_XRT_NATIVE_NATIVE_EXECUTABLE_H_
+#define ONEFLOW_XRT_NATIVE_NATIVE_EXECUTABLE_H_
+
+#include <memory>
+#include <vector>
+
+#include "oneflow/xrt/executable.h"
+#include "oneflow/xrt/native/native_program.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+class NativeExecutable : public Executable {
+ public:
+  NativeExecutable(const std::string& name, const std::shared_ptr<const NativeProgram>& program)
+      : Executable(name, XrtEngine::NATIVE),
+        program_(program),
+        arena_(program->arena_byte_size),
+        buffers_(program->buffers.size(), nullptr) {}
+
+  virtual ~NativeExecutable() = default;
+
+  bool Run(const std::vector<Parameter>& inputs, const ExecutableRunOptions& run_options,
+           bool block_until_done = true) override;
+
+  int64_t ByteSize() const override { return arena_.size(); }
+
+ private:
+  std::shared_ptr<const NativeProgram> program_;
+  // Scratch memory of the intermediate buffers.
+  std::vector<char> arena_;
+  // Address of each buffer of the program, updated on each run.
+  std::vector<char*> buffers_;
+};
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
+
+#endif  // ONEFLOW_XRT_NATIVE_NATIVE_EXECUTABLE_H_
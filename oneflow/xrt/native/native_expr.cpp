@@ -0,0 +1,219 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/native_expr.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+namespace {
+
+// Blocks evaluated by a thread at least.
+constexpr int64_t kMinBlocksPerThread = 64;
+
+void LoadBlock(const float* src, int64_t div, int64_t mod, int64_t start, int64_t n, float* out) {
+  if (mod == 1) {
+    std::fill(out, out + n, src[0]);
+    return;
+  }
+  int64_t q = start / div;
+  int64_t r = start % div;
+  if (mod > 0) { q %= mod; }
+  for (int64_t i = 0; i < n; ++i) {
+    out[i] = src[q];
+    if (++r == div) {
+      r = 0;
+      if (++q == mod) { q = 0; }
+    }
+  }
+}
+
+void UnaryBlock(NativeUnaryOp op, float scalar, const float* x, int64_t n, float* y) {
+  switch (op) {
+    case NativeUnaryOp::kIdentity: std::copy(x, x + n, y); break;
+    case NativeUnaryOp::kRelu:
+      for (int64_t i = 0; i < n; ++i) { y[i] = x[i] > 0.f ? x[i] : 0.f; }
+      break;
+    case NativeUnaryOp::kSigmoid:
+      for (int64_t i = 0; i < n; ++i) { y[i] = 1.f / (1.f + std::exp(-x[i])); }
+      break;
+    case NativeUnaryOp::kTanh:
+      for (int64_t i = 0; i < n; ++i) { y[i] = std::tanh(x[i]); }
+      break;
+    case NativeUnaryOp::kGelu:
+      for (int64_t i = 0; i < n; ++i) {
+        y[i] = 0.5f * x[i] * (1.f + std::erf(x[i] * static_cast<float>(M_SQRT1_2)));
+      }
+      break;
+    case NativeUnaryOp::kRsqrt:
+      for (int64_t i = 0; i < n; ++i) { y[i] = 1.f / std::sqrt(x[i]); }
+      break;
+    case NativeUnaryOp::kLeakyRelu:
+      for (int64_t i = 0; i < n; ++i) { y[i] = x[i] > 0.f ? x[i] : scalar * x[i]; }
+      break;
+    case NativeUnaryOp::kAddScalar:
+      for (int64_t i = 0; i < n; ++i) { y[i] = x[i] + scalar; }
+      break;
+    case NativeUnaryOp::kMulScalar:
+      for (int64_t i = 0; i < n; ++i) { y[i] = x[i] * scalar; }
+      break;
+    default: UNIMPLEMENTED();
+  }
+}
+
+void BinaryBlock(NativeBinaryOp op, const float* a, const float* b, int64_t n, float* y) {
+  switch (op) {
+    case NativeBinaryOp::kAdd:
+      for (int64_t i = 0; i < n; ++i) { y[i] = a[i] + b[i]; }
+      break;
+    case NativeBinaryOp::kMul:
+      for (int64_t i = 0; i < n; ++i) { y[i] = a[i] * b[i]; }
+      break;
+    case NativeBinaryOp::kDiv:
+      for (int64_t i = 0; i < n; ++i) { y[i] = a[i] / b[i]; }
+      break;
+    case NativeBinaryOp::kMin:
+      for (int64_t i = 0; i < n; ++i) { y[i] = std::min(a[i], b[i]); }
+      break;
+    default: UNIMPLEMENTED();
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<const NativeExpr> NativeExpr::Load(int64_t buffer_id, int64_t div, int64_t mod) {
+  auto expr = std::make_shared<NativeExpr>();
+  expr->kind = kLoad;
+  expr->buffer_id = buffer_id;
+  expr->div = div;
+  expr->mod = mod;
+  return expr;
+}
+
+std::shared_ptr<const NativeExpr> NativeExpr::Unary(NativeUnaryOp op, float scalar,
+                                                    const std::shared_ptr<const NativeExpr>& x) {
+  auto expr = std::make_shared<NativeExpr>();
+  expr->kind = kUnary;
+  expr->unary_op = op;
+  expr->scalar = scalar;
+  expr->operands = {x};
+  expr->num_nodes = x->num_nodes + 1;
+  return expr;
+}
+
+std::shared_ptr<const NativeExpr> NativeExpr::Binary(NativeBinaryOp op,
+                                                     const std::shared_ptr<const NativeExpr>& a,
+                                                     const std::shared_ptr<const NativeExpr>& b) {
+  auto expr = std::make_shared<NativeExpr>();
+  expr->kind = kBinary;
+  expr->binary_op = op;
+  expr->operands = {a, b};
+  expr->num_nodes = a->num_nodes + b->num_nodes + 1;
+  return expr;
+}
+
+NativeExprEvaluator::NativeExprEvaluator(const NativeExpr& root) {
+  HashMap<const NativeExpr*, int32_t> expr2step;
+  Flatten(&root, &expr2step);
+}
+
+int32_t NativeExprEvaluator::Flatten(const NativeExpr* expr,
+                                     HashMap<const NativeExpr*, int32_t>* expr2step) {
+  const auto& it = expr2step->find(expr);
+  if (it != expr2step->end()) { return it->second; }
+  Step step{expr->kind, expr->unary_op, expr->binary_op, expr->scalar, expr->buffer_id,
+            expr->div,  expr->mod,      -1,              -1};
+  if (expr->operands.size() > 0) { step.lhs = Flatten(expr->operands.at(0).get(), expr2step); }
+  if (expr->operands.size() > 1) { step.rhs = Flatten(expr->operands.at(1).get(), expr2step); }
+  steps_.push_back(step);
+  const int32_t index = steps_.size() - 1;
+  expr2step->emplace(expr, index);
+  return index;
+}
+
+void NativeExprEvaluator::InitScratch(Scratch* scratch) const {
+  scratch->regs.resize(steps_.size() * kNativeBlockSize);
+  scratch->values.resize(steps_.size());
+}
+
+const float* NativeExprEvaluator::Eval(char** buffers, int64_t start, int64_t n, Scratch* scratch,
+                                       float* out) const {
+  CHECK_LE(n, kNativeBlockSize);
+  const int32_t num_steps = steps_.size();
+  for (int32_t i = 0; i < num_steps; ++i) {
+    const Step& step = steps_[i];
+    float* reg = scratch->regs.data() + i * kNativeBlockSize;
+    if (i == num_steps - 1 && out != nullptr) { reg = out; }
+    if (step.kind == NativeExpr::kLoad) {
+      const float* src = reinterpret_cast<const float*>(buffers[step.buffer_id]);
+      if (step.div == 1 && step.mod == 0) {
+        // Contiguous loads are read in place.
+        if (reg == out) {
+          std::copy(src + start, src + start + n, out);
+          scratch->values[i] = out;
+        } else {
+          scratch->values[i] = src + start;
+        }
+        continue;
+      }
+      LoadBlock(src, step.div, step.mod, start, n, reg);
+    } else if (step.kind == NativeExpr::kUnary) {
+      UnaryBlock(step.unary_op, step.scalar, scratch->values[step.lhs], n, reg);
+    } else {
+      BinaryBlock(step.binary_op, scratch->values[step.lhs], scratch->values[step.rhs], n, reg);
+    }
+    scratch->values[i] = reg;
+  }
+  return scratch->values[num_steps - 1];
+}
+
+void NativeExprEvaluator::EvalTo(char** buffers, int64_t elem_cnt, float* out) const {
+  const int64_t num_blocks = RoundUp(elem_cnt, kNativeBlockSize) / kNativeBlockSize;
+  const auto EvalBlocks = [&](int64_t begin, int64_t end) {
+    Scratch scratch;
+    InitScratch(&scratch);
+    for (int64_t block = begin; block < end; ++block) {
+      const int64_t start = block * kNativeBlockSize;
+      const int64_t n = std::min(kNativeBlockSize, elem_cnt - start);
+      Eval(buffers, start, n, &scratch, out + start);
+    }
+  };
+  const int64_t num_chunks = num_blocks / kMinBlocksPerThread;
+  if (num_chunks <= 1) {
+    EvalBlocks(0, num_blocks);
+  } else {
+    BalancedSplitter bs(num_blocks, num_chunks);
+    MultiThreadLoop(num_chunks, [&](size_t i) { EvalBlocks(bs.At(i).begin(), bs.At(i).end()); });
+  }
+}
+
+std::vector<int64_t> NativeExprEvaluator::buffer_ids() const {
+  std::vector<int64_t> buffer_ids;
+  for (const Step& step : steps_) {
+    if (step.kind == NativeExpr::kLoad) { buffer_ids.push_back(step.buffer_id); }
+  }
+  return buffer_ids;
+}
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,128 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_XRT_NATIVE_NATIVE_EXPR_H_
+#define ONEFLOW_XRT_NATIVE_NATIVE_EXPR_H_
+
+#include <memory>
+#include <vector>
+
+#include "oneflow/core/common/shape.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+// Elements are evaluated block by block, so that the intermediate values of a
+// fused expression stay in cache.
+constexpr int64_t kNativeBlockSize = 512;
+
+enum class NativeUnaryOp {
+  kIdentity,
+  kRelu,
+  kSigmoid,
+  kTanh,
+  kGelu,
+  kRsqrt,
+  kLeakyRelu,
+  kAddScalar,
+  kMulScalar,
+};
+
+enum class NativeBinaryOp {
+  kAdd,
+  kMul,
+  kDiv,
+  kMin,
+};
+
+// Node of an elementwise expression over the flat index of its output.
+struct NativeExpr {
+  enum Kind {
+    kLoad,
+    kUnary,
+    kBinary,
+  };
+
+  static std::shared_ptr<const NativeExpr> Load(int64_t buffer_id, int64_t div, int64_t mod);
+  static std::shared_ptr<const NativeExpr> Unary(NativeUnaryOp op, float scalar,
+                                                 const std::shared_ptr<const NativeExpr>& x);
+  static std::shared_ptr<const NativeExpr> Binary(NativeBinaryOp op,
+                                                  const std::shared_ptr<const NativeExpr>& a,
+                                                  const std::shared_ptr<const NativeExpr>& b);
+
+  bool IsContiguousLoad() const { return kind == kLoad && div == 1 && mod == 0; }
+
+  Kind kind;
+  // Element i of a load reads element `(i / div) % mod` of buffer `buffer_id`,
+  // `mod` 0 means no modulo.
+  int64_t buffer_id = -1;
+  int64_t div = 1;
+  int64_t mod = 0;
+  NativeUnaryOp unary_op = NativeUnaryOp::kIdentity;
+  NativeBinaryOp binary_op = NativeBinaryOp::kAdd;
+  float scalar = 0.f;
+  std::vector<std::shared_ptr<const NativeExpr>> operands;
+  // Number of nodes in the expression, shared nodes are counted once per use.
+  int64_t num_nodes = 1;
+};
+
+// Flattened expression. Shared nodes are evaluated once per block.
+class NativeExprEvaluator {
+ public:
+  explicit NativeExprEvaluator(const NativeExpr& root);
+
+  // Per thread storage of the intermediate values of a block.
+  struct Scratch {
+    std::vector<float> regs;
+    std::vector<const float*> values;
+  };
+  void InitScratch(Scratch* scratch) const;
+
+  // Evaluates elements [start, start + n) of the expression, n <= kNativeBlockSize. The result is
+  // written to `out` if it's not nullptr, otherwise the returned pointer points to either the
+  // scratch or a buffer.
+  const float* Eval(char** buffers, int64_t start, int64_t n, Scratch* scratch,
+                    float* out = nullptr) const;
+
+  // Evaluates all `elem_cnt` elements into `out`, in parallel for large `elem_cnt`.
+  void EvalTo(char** buffers, int64_t elem_cnt, float* out) const;
+
+  // Buffers read by the expression.
+  std::vector<int64_t> buffer_ids() const;
+
+ private:
+  struct Step {
+    NativeExpr::Kind kind;
+    NativeUnaryOp unary_op;
+    NativeBinaryOp binary_op;
+    float scalar;
+    int64_t buffer_id;
+    int64_t div;
+    int64_t mod;
+    int32_t lhs;
+    int32_t rhs;
+  };
+
+  int32_t Flatten(const NativeExpr* expr, HashMap<const NativeExpr*, int32_t>* expr2step);
+
+  std::vector<Step> steps_;
+};
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
+
+#endif  // ONEFLOW_XRT_NATIVE_NATIVE_EXPR_H_
@@ -0,0 +1,146 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <cmath>
+
+#include "oneflow/xrt/native/native_expr.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+namespace test {
+
+namespace {
+
+std::vector<float> Eval(const std::shared_ptr<const NativeExpr>& expr,
+                        std::vector<std::vector<float>>* buffers, int64_t elem_cnt) {
+  std::vector<char*> buffer_ptrs;
+  for (auto& buffer : *buffers) { buffer_ptrs.push_back(reinterpret_cast<char*>(buffer.data())); }
+  std::vector<float> out(elem_cnt);
+  NativeExprEvaluator(*expr).EvalTo(buffer_ptrs.data(), elem_cnt, out.data());
+  return out;
+}
+
+std::vector<float> Iota(int64_t elem_cnt, float start) {
+  std::vector<float> values(elem_cnt);
+  for (int64_t i = 0; i < elem_cnt; ++i) { values[i] = start + i * 0.25f; }
+  return values;
+}
+
+float UnaryRef(NativeUnaryOp op, float scalar, float x) {
+  switch (op) {
+    case NativeUnaryOp::kIdentity: return x;
+    case NativeUnaryOp::kRelu: return x > 0.f ? x : 0.f;
+    case NativeUnaryOp::kSigmoid: return 1.f / (1.f + std::exp(-x));
+    case NativeUnaryOp::kTanh: return std::tanh(x);
+    case NativeUnaryOp::kGelu: return 0.5f * x * (1.f + std::erf(x / std::sqrt(2.f)));
+    case NativeUnaryOp::kRsqrt: return 1.f / std::sqrt(x);
+    case NativeUnaryOp::kLeakyRelu: return x > 0.f ? x : scalar * x;
+    case NativeUnaryOp::kAddScalar: return x + scalar;
+    case NativeUnaryOp::kMulScalar: return x * scalar;
+  }
+  return 0.f;
+}
+
+float BinaryRef(NativeBinaryOp op, float a, float b) {
+  switch (op) {
+    case NativeBinaryOp::kAdd: return a + b;
+    case NativeBinaryOp::kMul: return a * b;
+    case NativeBinaryOp::kDiv: return a / b;
+    case NativeBinaryOp::kMin: return std::min(a, b);
+  }
+  return 0.f;
+}
+
+}  // namespace
+
+TEST(NativeExpr, load) {
+  // Spans several blocks with a partial last block.
+  const int64_t elem_cnt = 2 * kNativeBlockSize + 3;
+  std::vector<std::vector<float>> buffers{Iota(elem_cnt, 0.f)};
+  const auto out = Eval(NativeExpr::Load(0, 1, 0), &buffers, elem_cnt);
+  ASSERT_EQ(out, buffers[0]);
+}
+
+TEST(NativeExpr, broadcast_load) {
+  // A (3, 1) buffer broadcasted to (2, 3, 4) reads element (i / 4) % 3.
+  std::vector<std::vector<float>> buffers{Iota(3, 1.f), Iota(1, 5.f)};
+  const auto out = Eval(NativeExpr::Load(0, 4, 3), &buffers, 24);
+  for (int64_t i = 0; i < 24; ++i) { ASSERT_EQ(out[i], buffers[0][(i / 4) % 3]); }
+  // A (3, 1) buffer broadcasted to (3, 4) has no modulo.
+  const auto no_mod = Eval(NativeExpr::Load(0, 4, 0), &buffers, 12);
+  for (int64_t i = 0; i < 12; ++i) { ASSERT_EQ(no_mod[i], buffers[0][i / 4]); }
+  // A scalar.
+  const auto scalar = Eval(NativeExpr::Load(1, 1, 1), &buffers, 7);
+  for (int64_t i = 0; i < 7; ++i) { ASSERT_EQ(scalar[i], 5.f); }
+}
+
+TEST(NativeExpr, unary) {
+  const int64_t elem_cnt = kNativeBlockSize + 1;
+  // Positive values are kept for rsqrt.
+  std::vector<std::vector<float>> buffers{Iota(elem_cnt, -2.f), Iota(elem_cnt, 0.5f)};
+  for (NativeUnaryOp op :
+       {NativeUnaryOp::kIdentity, NativeUnaryOp::kRelu, NativeUnaryOp::kSigmoid,
+        NativeUnaryOp::kTanh, NativeUnaryOp::kGelu, NativeUnaryOp::kRsqrt,
+        NativeUnaryOp::kLeakyRelu, NativeUnaryOp::kAddScalar, NativeUnaryOp::kMulScalar}) {
+    const int64_t buffer_id = op == NativeUnaryOp::kRsqrt ? 1 : 0;
+    const auto expr = NativeExpr::Unary(op, 0.3f, NativeExpr::Load(buffer_id, 1, 0));
+    ASSERT_EQ(expr->num_nodes, 2);
+    const auto out = Eval(expr, &buffers, elem_cnt);
+    for (int64_t i = 0; i < elem_cnt; ++i) {
+      ASSERT_NEAR(out[i], UnaryRef(op, 0.3f, buffers[buffer_id][i]), 1e-5)
+          << "op " << static_cast<int>(op) << ", element " << i;
+    }
+  }
+}
+
+TEST(NativeExpr, binary) {
+  const int64_t elem_cnt = kNativeBlockSize + 1;
+  std::vector<std::vector<float>> buffers{Iota(elem_cnt, -2.f), Iota(elem_cnt, 0.5f)};
+  for (NativeBinaryOp op :
+       {NativeBinaryOp::kAdd, NativeBinaryOp::kMul, NativeBinaryOp::kDiv, NativeBinaryOp::kMin}) {
+    const auto expr = NativeExpr::Binary(op, NativeExpr::Load(0, 1, 0), NativeExpr::Load(1, 1, 0));
+    ASSERT_EQ(expr->num_nodes, 3);
+    const auto out = Eval(expr, &buffers, elem_cnt);
+    for (int64_t i = 0; i < elem_cnt; ++i) {
+      ASSERT_NEAR(out[i], BinaryRef(op, buffers[0][i], buffers[1][i]), 1e-5)
+          << "op " << static_cast<int>(op) << ", element " << i;
+    }
+  }
+}
+
+TEST(NativeExpr, shared_node) {
+  // (relu(x) + 1) * relu(x) with the relu node shared.
+  const int64_t elem_cnt = 100;
+  std::vector<std::vector<float>> buffers{Iota(elem_cnt, -10.f)};
+  const auto relu = NativeExpr::Unary(NativeUnaryOp::kRelu, 0.f, NativeExpr::Load(0, 1, 0));
+  const auto expr = NativeExpr::Binary(
+      NativeBinaryOp::kMul, NativeExpr::Unary(NativeUnaryOp::kAddScalar, 1.f, relu), relu);
+  // Shared nodes are counted once per use.
+  ASSERT_EQ(expr->num_nodes, 6);
+  const auto out = Eval(expr, &buffers, elem_cnt);
+  for (int64_t i = 0; i < elem_cnt; ++i) {
+    const float r = std::max(buffers[0][i], 0.f);
+    ASSERT_FLOAT_EQ(out[i], (r + 1.f) * r);
+  }
+  ASSERT_EQ(NativeExprEvaluator(*expr).buffer_ids(), std::vector<int64_t>{0});
+}
+
+}  // namespace test
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,106 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/native_graph_compiler.h"
+#include "oneflow/xrt/native/ops/op_kernel.h"
+#include "oneflow/xrt/node_util.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+Argument NativeGraphCompiler::ArgFromParameter(const Parameter& param) {
+  return Argument(param.name(), param.shape(), param.data_type());
+}
+
+void NativeGraphCompiler::SetupKernelContextParam(const XrtNode* node,
+                                                  NativeOpContext::Param* context_param) {
+  util::Map<Argument, NativeValue> input_values;
+  util::Map<std::string /* produce/consume key */, Argument> input_output_args;
+  std::vector<std::string> output_names;
+  for (const XrtEdge* edge : node->in_edges()) {
+    if (!edge->IsControlEdge()) {
+      const Argument& arg = edge->argument();
+      CHECK_GT(operands_.count(arg), 0);
+      input_values.emplace(arg, operands_.at(arg));
+      input_output_args.emplace(arg.meta_data().consume_key, arg);
+    }
+  }
+  for (const XrtEdge* edge : node->out_edges()) {
+    if (!edge->IsControlEdge()) {
+      const Argument& arg = edge->argument();
+      const std::string& k = arg.meta_data().produce_key;
+      input_output_args.emplace(k, arg);
+      output_names.push_back(k);
+    }
+  }
+
+  size_t num_outputs = input_output_args.size() - input_values.size();
+  context_param->builder = &builder_;
+  context_param->message = OpMessage(node);
+  context_param->arguments = std::move(input_output_args);
+  context_param->inputs = std::move(input_values);
+  context_param->output_names = std::move(output_names);
+  context_param->num_outputs = num_outputs;
+}
+
+std::shared_ptr<Executable> NativeGraphCompiler::Compile(
+    const XrtGraph* graph, const std::vector<Parameter>& entry_params,
+    const std::vector<Parameter>& return_params, const std::vector<InputOutputAlias>& aliases) {
+  for (int i = 0; i < entry_params.size(); ++i) {
+    CHECK_EQ(entry_params[i].data_type(), DataType::kFloat)
+        << "Native engine only supports float parameters.";
+    const Shape& shape = entry_params[i].shape();
+    operands_.emplace(ArgFromParameter(entry_params[i]),
+                      NativeValue::Buffer(builder_.AddEntryBuffer(i, shape), shape));
+  }
+  // Compile each node as topology order.
+  algorithm::TopologyVisit(*graph, [&](const XrtNode* node) {
+    NativeOpContext::Param param;
+    SetupKernelContextParam(node, &param);
+    NativeOpContext op_context(param);
+    auto op_kernel = BuildOpKernel(node->type());
+    op_kernel->Compile(&op_context);
+
+    // An expression consumed more than once is materialized, so that it's not
+    // evaluated again by each consumer.
+    util::Map<Argument, int> arg2num_consumers;
+    for (const XrtEdge* edge : node->out_edges()) {
+      if (!edge->IsControlEdge()) { ++arg2num_consumers[edge->argument()]; }
+    }
+    const auto& outputs = op_context.outputs();
+    for (auto it = outputs.begin(); it != outputs.end(); ++it) {
+      NativeValue value = it->second;
+      if (value.is_expr() && arg2num_consumers[it->first] > 1) {
+        value = NativeValue::Buffer(builder_.Materialize(value), value.shape());
+      }
+      operands_[it->first] = value;
+    }
+  });
+
+  std::vector<NativeValue> return_values(return_params.size());
+  for (int i = 0; i < return_params.size(); ++i) {
+    const Argument arg = ArgFromParameter(return_params[i]);
+    CHECK_GT(operands_.count(arg), 0);
+    return_values[i] = operands_.at(arg);
+  }
+  return std::make_shared<NativeExecutable>(this->name_, builder_.Build(return_values));
+}
+
+REGISTER_GRAPH_COMPILER(XrtEngine::NATIVE, NativeGraphCompiler);
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
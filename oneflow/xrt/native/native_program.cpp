@@ -0,0 +1,313 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/native_program.h"
+
+#include <algorithm>
+#include <map>
+
+#include "glog/logging.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+namespace {
+
+constexpr int64_t kArenaAlignment = 64;
+
+// Extends `shape` with leading 1s to `num_axes`.
+std::vector<int64_t> ExtendedDims(const Shape& shape, int64_t num_axes) {
+  CHECK_LE(shape.NumAxes(), num_axes);
+  std::vector<int64_t> dims(num_axes - shape.NumAxes(), 1);
+  for (int64_t i = 0; i < shape.NumAxes(); ++i) { dims.push_back(shape.At(i)); }
+  return dims;
+}
+
+}  // namespace
+
+NativeValue NativeValue::Buffer(int64_t buffer_id, const Shape& shape) {
+  NativeValue value;
+  value.buffer_id_ = buffer_id;
+  value.shape_ = shape;
+  return value;
+}
+
+NativeValue NativeValue::Expr(const std::shared_ptr<const NativeExpr>& expr, const Shape& shape) {
+  NativeValue value;
+  value.expr_ = expr;
+  value.shape_ = shape;
+  return value;
+}
+
+NativeValue NativeValue::Reshape(const Shape& shape) const {
+  CHECK_EQ(shape.elem_cnt(), shape_.elem_cnt());
+  NativeValue value = *this;
+  value.shape_ = shape;
+  return value;
+}
+
+int64_t NativeValue::buffer_id() const {
+  CHECK(!is_expr()) << "The value has not been materialized.";
+  return buffer_id_;
+}
+
+int64_t NativeProgramBuilder::AddEntryBuffer(int64_t index, const Shape& shape) {
+  NativeBuffer buffer;
+  buffer.kind = NativeBuffer::kEntry;
+  buffer.index = index;
+  buffer.byte_size = shape.elem_cnt() * sizeof(float);
+  buffers_.push_back(buffer);
+  buffer2def_.push_back(-1);
+  buffer2last_use_.push_back(-1);
+  return buffers_.size() - 1;
+}
+
+int64_t NativeProgramBuilder::AddArenaBuffer(const Shape& shape) {
+  NativeBuffer buffer;
+  buffer.kind = NativeBuffer::kArena;
+  buffer.byte_size = shape.elem_cnt() * sizeof(float);
+  buffers_.push_back(buffer);
+  buffer2def_.push_back(-1);
+  buffer2last_use_.push_back(-1);
+  return buffers_.size() - 1;
+}
+
+void NativeProgramBuilder::AddInstruction(const NativeInstruction& instruction,
+                                          const std::vector<int64_t>& reads,
+                                          const std::vector<int64_t>& writes) {
+  const int64_t index = instructions_.size();
+  for (int64_t buffer_id : reads) {
+    CHECK(buffers_.at(buffer_id).kind == NativeBuffer::kEntry || buffer2def_.at(buffer_id) >= 0)
+        << "Buffer " << buffer_id << " is read before it's written.";
+    buffer2last_use_[buffer_id] = index;
+  }
+  for (int64_t buffer_id : writes) {
+    if (buffer2def_.at(buffer_id) < 0) { buffer2def_[buffer_id] = index; }
+    buffer2last_use_[buffer_id] = std::max(buffer2last_use_[buffer_id], index);
+  }
+  instructions_.push_back(instruction);
+}
+
+std::shared_ptr<const NativeExpr> NativeProgramBuilder::AsExpr(const NativeValue& value) {
+  if (value.is_expr()) { return value.expr(); }
+  return NativeExpr::Load(value.buffer_id(), 1, 0);
+}
+
+std::shared_ptr<const NativeExpr> NativeProgramBuilder::BroadcastExpr(const NativeValue& value,
+                                                                      const Shape& shape) {
+  const int64_t num_axes = shape.NumAxes();
+  const std::vector<int64_t> dims = ExtendedDims(value.shape(), num_axes);
+  if (value.shape().elem_cnt() == shape.elem_cnt()) {
+    for (int64_t i = 0; i < num_axes; ++i) { CHECK_EQ(dims[i], shape.At(i)); }
+    return AsExpr(value);
+  }
+  const int64_t buffer_id = Materialize(value);
+  if (value.shape().elem_cnt() == 1) { return NativeExpr::Load(buffer_id, 1, 1); }
+  // Axes of the value which are not 1 must be a range of the broadcasted axes, then element i
+  // reads element (i / div) % mod.
+  int64_t begin = num_axes;
+  int64_t end = 0;
+  for (int64_t i = 0; i < num_axes; ++i) {
+    if (dims[i] != 1) {
+      begin = std::min(begin, i);
+      end = i + 1;
+    }
+  }
+  bool is_range = true;
+  for (int64_t i = begin; i < end; ++i) {
+    CHECK(dims[i] == shape.At(i) || dims[i] == 1);
+    if (dims[i] != shape.At(i)) { is_range = false; }
+  }
+  if (!is_range) {
+    return NativeExpr::Load(MaterializeBroadcast(buffer_id, value.shape(), shape), 1, 0);
+  }
+  const int64_t div = shape.Count(end);
+  const int64_t mod = begin == 0 ? 0 : shape.Count(begin, end);
+  return NativeExpr::Load(buffer_id, div, mod);
+}
+
+int64_t NativeProgramBuilder::MaterializeBroadcast(int64_t buffer_id, const Shape& from,
+                                                   const Shape& to) {
+  const int64_t num_axes = to.NumAxes();
+  const std::vector<int64_t> dims = ExtendedDims(from, num_axes);
+  // Stride of each broadcasted axis in the source, 0 if the axis is broadcasted.
+  std::vector<int64_t> strides(num_axes, 0);
+  int64_t stride = 1;
+  for (int64_t i = num_axes - 1; i >= 0; --i) {
+    if (dims[i] != 1) { strides[i] = stride; }
+    stride *= dims[i];
+  }
+  const std::vector<int64_t> out_dims(to.dim_vec().begin(), to.dim_vec().end());
+  const int64_t elem_cnt = to.elem_cnt();
+  const int64_t out_buffer_id = AddArenaBuffer(to);
+  AddInstruction(
+      [=](char** buffers) {
+        const float* src = reinterpret_cast<const float*>(buffers[buffer_id]);
+        float* out = reinterpret_cast<float*>(buffers[out_buffer_id]);
+        std::vector<int64_t> index(num_axes, 0);
+        int64_t offset = 0;
+        for (int64_t i = 0; i < elem_cnt; ++i) {
+          out[i] = src[offset];
+          for (int64_t axis = num_axes - 1; axis >= 0; --axis) {
+            offset += strides[axis];
+            if (++index[axis] < out_dims[axis]) { break; }
+            offset -= strides[axis] * out_dims[axis];
+            index[axis] = 0;
+          }
+        }
+      },
+      {buffer_id}, {out_buffer_id});
+  return out_buffer_id;
+}
+
+NativeValue NativeProgramBuilder::MakeExprValue(const std::shared_ptr<const NativeExpr>& expr,
+                                                const Shape& shape) {
+  const NativeValue value = NativeValue::Expr(expr, shape);
+  if (expr->num_nodes <= kNativeMaxFusedNodes) { return value; }
+  return NativeValue::Buffer(Materialize(value), shape);
+}
+
+NativeValue NativeProgramBuilder::Unary(NativeUnaryOp op, float scalar, const NativeValue& x) {
+  return MakeExprValue(NativeExpr::Unary(op, scalar, AsExpr(x)), x.shape());
+}
+
+NativeValue NativeProgramBuilder::Binary(NativeBinaryOp op, const NativeValue& a,
+                                         const NativeValue& b, const Shape& shape) {
+  return MakeExprValue(NativeExpr::Binary(op, BroadcastExpr(a, shape), BroadcastExpr(b, shape)),
+                       shape);
+}
+
+int64_t NativeProgramBuilder::Materialize(const NativeValue& value) {
+  if (!value.is_expr()) { return value.buffer_id(); }
+  const int64_t buffer_id = AddArenaBuffer(value.shape());
+  MaterializeTo(value, buffer_id);
+  return buffer_id;
+}
+
+void NativeProgramBuilder::MaterializeTo(const NativeValue& value, int64_t buffer_id) {
+  const auto evaluator = std::make_shared<NativeExprEvaluator>(*AsExpr(value));
+  const int64_t elem_cnt = value.shape().elem_cnt();
+  AddInstruction(
+      [=](char** buffers) {
+        evaluator->EvalTo(buffers, elem_cnt, reinterpret_cast<float*>(buffers[buffer_id]));
+      },
+      evaluator->buffer_ids(), {buffer_id});
+}
+
+std::shared_ptr<NativeProgram> NativeProgramBuilder::Build(
+    const std::vector<NativeValue>& return_values) {
+  auto program = std::make_shared<NativeProgram>();
+  std::vector<bool> is_rewired(buffers_.size(), false);
+  for (int64_t i = 0; i < return_values.size(); ++i) {
+    const NativeValue& value = return_values[i];
+    if (value.is_expr()) {
+      NativeBuffer buffer;
+      buffer.kind = NativeBuffer::kReturn;
+      buffer.index = i;
+      buffer.byte_size = value.shape().elem_cnt() * sizeof(float);
+      buffers_.push_back(buffer);
+      buffer2def_.push_back(-1);
+      buffer2last_use_.push_back(-1);
+      is_rewired.push_back(true);
+      MaterializeTo(value, buffers_.size() - 1);
+      continue;
+    }
+    const int64_t buffer_id = value.buffer_id();
+    if (buffers_[buffer_id].kind == NativeBuffer::kArena && !is_rewired[buffer_id]) {
+      // Computes the returned value in the return parameter directly.
+      buffers_[buffer_id].kind = NativeBuffer::kReturn;
+      buffers_[buffer_id].index = i;
+      is_rewired[buffer_id] = true;
+    } else {
+      program->return_copies.emplace_back(buffer_id, i);
+      buffer2last_use_[buffer_id] = instructions_.size();
+    }
+  }
+  program->instructions = instructions_;
+  program->buffers = buffers_;
+  PlanArena(program.get());
+  return program;
+}
+
+void NativeProgramBuilder::PlanArena(NativeProgram* program) const {
+  const int64_t num_instructions = instructions_.size();
+  std::vector<std::vector<int64_t>> instruction2defs(num_instructions + 1);
+  std::vector<std::vector<int64_t>> instruction2frees(num_instructions + 1);
+  for (int64_t i = 0; i < program->buffers.size(); ++i) {
+    NativeBuffer* buffer = &program->buffers[i];
+    if (buffer->kind != NativeBuffer::kArena) { continue; }
+    if (buffer->byte_size == 0) {
+      buffer->offset = 0;
+      continue;
+    }
+    CHECK_GE(buffer2def_[i], 0) << "Buffer " << i << " is never written.";
+    instruction2defs[buffer2def_[i]].push_back(i);
+    instruction2frees[buffer2last_use_[i]].push_back(i);
+  }
+  // First fit in the free blocks, keyed by offset. The arena grows if no block fits.
+  std::map<int64_t, int64_t> offset2free_size;
+  int64_t arena_size = 0;
+  const auto Allocate = [&](int64_t size) {
+    for (auto it = offset2free_size.begin(); it != offset2free_size.end(); ++it) {
+      if (it->second < size) { continue; }
+      const int64_t offset = it->first;
+      const int64_t remain = it->second - size;
+      offset2free_size.erase(it);
+      if (remain > 0) { offset2free_size.emplace(offset + size, remain); }
+      return offset;
+    }
+    int64_t offset = arena_size;
+    if (!offset2free_size.empty()) {
+      const auto last = std::prev(offset2free_size.end());
+      if (last->first + last->second == arena_size) {
+        offset = last->first;
+        offset2free_size.erase(last);
+      }
+    }
+    arena_size = offset + size;
+    return offset;
+  };
+  const auto Free = [&](int64_t offset, int64_t size) {
+    auto it = offset2free_size.emplace(offset, size).first;
+    const auto next = std::next(it);
+    if (next != offset2free_size.end() && offset + size == next->first) {
+      it->second += next->second;
+      offset2free_size.erase(next);
+    }
+    if (it != offset2free_size.begin()) {
+      const auto prev = std::prev(it);
+      if (prev->first + prev->second == it->first) {
+        prev->second += it->second;
+        offset2free_size.erase(it);
+      }
+    }
+  };
+  for (int64_t t = 0; t <= num_instructions; ++t) {
+    for (int64_t buffer_id : instruction2defs[t]) {
+      NativeBuffer* buffer = &program->buffers[buffer_id];
+      buffer->offset = Allocate(RoundUp(buffer->byte_size, kArenaAlignment));
+    }
+    for (int64_t buffer_id : instruction2frees[t]) {
+      const NativeBuffer& buffer = program->buffers[buffer_id];
+      Free(buffer.offset, RoundUp(buffer.byte_size, kArenaAlignment));
+    }
+  }
+  program->arena_byte_size = arena_size;
+}
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,124 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef ONEFLOW_XRT_NATIVE_NATIVE_PROGRAM_H_
+#define ONEFLOW_XRT_NATIVE_NATIVE_PROGRAM_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "oneflow/core/common/shape.h"
+#include "oneflow/xrt/native/native_expr.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+// Maximum nodes of a fused expression, a larger expression is materialized.
+constexpr int64_t kNativeMaxFusedNodes = 64;
+
+// Value of an argument while compiling, either materialized in a buffer or an
+// elementwise expression which is not evaluated until it's consumed.
+class NativeValue {
+ public:
+  NativeValue() = default;
+
+  static NativeValue Buffer(int64_t buffer_id, const Shape& shape);
+  static NativeValue Expr(const std::shared_ptr<const NativeExpr>& expr, const Shape& shape);
+
+  NativeValue Reshape(const Shape& shape) const;
+
+  bool is_expr() const { return expr_ != nullptr; }
+  int64_t buffer_id() const;
+  const std::shared_ptr<const NativeExpr>& expr() const { return expr_; }
+  const Shape& shape() const { return shape_; }
+
+ private:
+  int64_t buffer_id_ = -1;
+  std::shared_ptr<const NativeExpr> expr_;
+  Shape shape_;
+};
+
+struct NativeBuffer {
+  enum Kind {
+    kEntry,
+    kReturn,
+    kArena,
+  };
+
+  Kind kind;
+  // Index of the entry or return parameter.
+  int64_t index = -1;
+  int64_t byte_size = 0;
+  // Offset in the scratch arena.
+  int64_t offset = -1;
+};
+
+// An instruction reads and writes buffers by id.
+using NativeInstruction = std::function<void(char** buffers)>;
+
+struct NativeProgram {
+  std::vector<NativeBuffer> buffers;
+  std::vector<NativeInstruction> instructions;
+  // Pairs of buffer id and return index, copied after running the instructions.
+  std::vector<std::pair<int64_t, int64_t>> return_copies;
+  int64_t arena_byte_size = 0;
+};
+
+// Builds a program of an xrt graph. Values are fused into a consumer as long as
+// it's elementwise, and intermediate buffers are placed in one scratch arena
+// which is planned by the live ranges of the buffers.
+class NativeProgramBuilder {
+ public:
+  NativeProgramBuilder() = default;
+  virtual ~NativeProgramBuilder() = default;
+
+  int64_t AddEntryBuffer(int64_t index, const Shape& shape);
+  int64_t AddArenaBuffer(const Shape& shape);
+  void AddInstruction(const NativeInstruction& instruction, const std::vector<int64_t>& reads,
+                      const std::vector<int64_t>& writes);
+
+  // Returns the expression of `value`.
+  std::shared_ptr<const NativeExpr> AsExpr(const NativeValue& value);
+  // Returns the expression reading `value` broadcasted to `shape`. Axes are aligned to the right.
+  std::shared_ptr<const NativeExpr> BroadcastExpr(const NativeValue& value, const Shape& shape);
+
+  NativeValue Unary(NativeUnaryOp op, float scalar, const NativeValue& x);
+  NativeValue Binary(NativeBinaryOp op, const NativeValue& a, const NativeValue& b,
+                     const Shape& shape);
+
+  // Returns the buffer of `value`, an expression is evaluated by a fused loop.
+  int64_t Materialize(const NativeValue& value);
+  void MaterializeTo(const NativeValue& value, int64_t buffer_id);
+
+  std::shared_ptr<NativeProgram> Build(const std::vector<NativeValue>& return_values);
+
+ private:
+  NativeValue MakeExprValue(const std::shared_ptr<const NativeExpr>& expr, const Shape& shape);
+  int64_t MaterializeBroadcast(int64_t buffer_id, const Shape& from, const Shape& to);
+  void PlanArena(NativeProgram* program) const;
+
+  std::vector<NativeBuffer> buffers_;
+  std::vector<NativeInstruction> instructions_;
+  std::vector<int64_t> buffer2def_;
+  std::vector<int64_t> buffer2last_use_;
+};
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
+
+#endif  // ONEFLOW_XRT_NATIVE_NATIVE_PROGRAM_H_
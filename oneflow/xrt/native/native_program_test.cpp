@@ -0,0 +1,151 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <cstring>
+
+#include "oneflow/xrt/native/native_program.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+namespace test {
+
+namespace {
+
+// Runs `program` the way NativeExecutable does.
+void RunProgram(const NativeProgram& program, std::vector<std::vector<float>>* entries,
+                std::vector<std::vector<float>>* returns) {
+  std::vector<char> arena(program.arena_byte_size);
+  std::vector<char*> buffers(program.buffers.size());
+  for (int64_t i = 0; i < program.buffers.size(); ++i) {
+    const NativeBuffer& buffer = program.buffers[i];
+    if (buffer.kind == NativeBuffer::kEntry) {
+      buffers[i] = reinterpret_cast<char*>(entries->at(buffer.index).data());
+    } else if (buffer.kind == NativeBuffer::kReturn) {
+      buffers[i] = reinterpret_cast<char*>(returns->at(buffer.index).data());
+    } else {
+      buffers[i] = arena.data() + buffer.offset;
+    }
+  }
+  for (const auto& instruction : program.instructions) { instruction(buffers.data()); }
+  for (const auto& pair : program.return_copies) {
+    std::memcpy(returns->at(pair.second).data(), buffers[pair.first],
+                program.buffers[pair.first].byte_size);
+  }
+}
+
+bool IsOverlapped(const NativeBuffer& lhs, const NativeBuffer& rhs) {
+  return lhs.offset < rhs.offset + rhs.byte_size && rhs.offset < lhs.offset + lhs.byte_size;
+}
+
+}  // namespace
+
+TEST(NativeProgram, reuse_dead_buffer) {
+  // x -> a -> b -> c -> d, each step materialized. a is dead once b is written, so c takes its
+  // place and the arena holds two buffers.
+  const Shape shape({1024});
+  NativeProgramBuilder builder;
+  NativeValue value = NativeValue::Buffer(builder.AddEntryBuffer(0, shape), shape);
+  std::vector<int64_t> buffer_ids;
+  for (int i = 0; i < 4; ++i) {
+    value = builder.Unary(NativeUnaryOp::kAddScalar, 1.f, value);
+    buffer_ids.push_back(builder.Materialize(value));
+    value = NativeValue::Buffer(buffer_ids.back(), shape);
+  }
+  const auto program = builder.Build({value});
+  const NativeBuffer& a = program->buffers.at(buffer_ids[0]);
+  const NativeBuffer& b = program->buffers.at(buffer_ids[1]);
+  const NativeBuffer& c = program->buffers.at(buffer_ids[2]);
+  const NativeBuffer& d = program->buffers.at(buffer_ids[3]);
+  ASSERT_EQ(a.kind, NativeBuffer::kArena);
+  ASSERT_EQ(c.kind, NativeBuffer::kArena);
+  // The returned value is computed in the return parameter.
+  ASSERT_EQ(d.kind, NativeBuffer::kReturn);
+  ASSERT_TRUE(program->return_copies.empty());
+  ASSERT_EQ(a.offset, c.offset);
+  ASSERT_FALSE(IsOverlapped(a, b));
+  ASSERT_FALSE(IsOverlapped(b, c));
+  ASSERT_EQ(program->arena_byte_size, 2 * shape.elem_cnt() * sizeof(float));
+
+  std::vector<std::vector<float>> entries{std::vector<float>(1024, 2.f)};
+  std::vector<std::vector<float>> returns{std::vector<float>(1024, 0.f)};
+  RunProgram(*program, &entries, &returns);
+  for (float v : returns[0]) { ASSERT_EQ(v, 6.f); }
+}
+
+TEST(NativeProgram, live_buffers_not_overlapped) {
+  // Buffers of different sizes with interleaved live ranges: every buffer is read by the last
+  // instruction, which sums them all.
+  NativeProgramBuilder builder;
+  const Shape shape({300});
+  const NativeValue x = NativeValue::Buffer(builder.AddEntryBuffer(0, shape), shape);
+  std::vector<NativeValue> values;
+  std::vector<int64_t> buffer_ids;
+  for (int i = 0; i < 5; ++i) {
+    const Shape value_shape({i % 2 == 0 ? 300 : 1});
+    NativeValue value = builder.Unary(NativeUnaryOp::kMulScalar, i + 1.f, x);
+    if (value_shape.elem_cnt() == 1) {
+      // A scalar buffer, read through a broadcasting load.
+      const int64_t buffer_id = builder.AddArenaBuffer(value_shape);
+      builder.AddInstruction(
+          [=](char** buffers) { reinterpret_cast<float*>(buffers[buffer_id])[0] = i + 1.f; },
+          {}, {buffer_id});
+      value = NativeValue::Buffer(buffer_id, value_shape);
+    } else {
+      value = NativeValue::Buffer(builder.Materialize(value), shape);
+    }
+    buffer_ids.push_back(value.buffer_id());
+    values.push_back(value);
+  }
+  NativeValue sum = values.at(0);
+  for (int i = 1; i < values.size(); ++i) {
+    sum = builder.Binary(NativeBinaryOp::kAdd, sum, values.at(i), shape);
+  }
+  const auto program = builder.Build({sum});
+  for (int64_t i = 0; i < buffer_ids.size(); ++i) {
+    for (int64_t j = i + 1; j < buffer_ids.size(); ++j) {
+      ASSERT_FALSE(
+          IsOverlapped(program->buffers.at(buffer_ids[i]), program->buffers.at(buffer_ids[j])))
+          << "buffer " << buffer_ids[i] << " and " << buffer_ids[j];
+    }
+  }
+
+  std::vector<std::vector<float>> entries{std::vector<float>(300, 1.f)};
+  std::vector<std::vector<float>> returns{std::vector<float>(300, 0.f)};
+  RunProgram(*program, &entries, &returns);
+  // 1 * x + 2 + 3 * x + 4 + 5 * x
+  for (float v : returns[0]) { ASSERT_EQ(v, 15.f); }
+}
+
+TEST(NativeProgram, return_entry_copied) {
+  // An entry returned as is is copied to the return parameter.
+  const Shape shape({8});
+  NativeProgramBuilder builder;
+  const NativeValue x = NativeValue::Buffer(builder.AddEntryBuffer(0, shape), shape);
+  const auto program = builder.Build({x});
+  ASSERT_EQ(program->return_copies.size(), 1);
+  ASSERT_EQ(program->arena_byte_size, 0);
+  std::vector<std::vector<float>> entries{std::vector<float>(8, 3.f)};
+  std::vector<std::vector<float>> returns{std::vector<float>(8, 0.f)};
+  RunProgram(*program, &entries, &returns);
+  ASSERT_EQ(returns[0], entries[0]);
+}
+
+}  // namespace test
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
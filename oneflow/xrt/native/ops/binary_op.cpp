@@ -0,0 +1,87 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/ops/op_context.h"
+#include "oneflow/xrt/native/ops/op_kernel.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+class AddOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    const Shape shape = ctx->SoleOutputShape();
+    NativeValue sum = ctx->Input("in_0");
+    for (int i = 1; i < ctx->num_inputs(); ++i) {
+      sum = ctx->builder()->Binary(NativeBinaryOp::kAdd, sum, ctx->Input(absl::StrCat("in_", i)),
+                                   shape);
+    }
+    ctx->SetSoleOutput(sum);
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(Add, AddOp).Finalize();
+
+template<NativeBinaryOp op>
+class BcastBinaryOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    ctx->SetSoleOutput(ctx->builder()->Binary(op, ctx->Input("x_0"), ctx->Input("y_0"),
+                                              ctx->SoleOutputShape()));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(BcastAdd, BcastBinaryOp<NativeBinaryOp::kAdd>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(BcastMul, BcastBinaryOp<NativeBinaryOp::kMul>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(BcastDiv, BcastBinaryOp<NativeBinaryOp::kDiv>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(BcastMin, BcastBinaryOp<NativeBinaryOp::kMin>).Finalize();
+
+class MultiplyOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    CHECK_EQ(ctx->InputShape("x_0"), ctx->InputShape("y_0"));
+    ctx->SetSoleOutput(ctx->builder()->Binary(NativeBinaryOp::kMul, ctx->Input("x_0"),
+                                              ctx->Input("y_0"), ctx->SoleOutputShape()));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(Multiply, MultiplyOp).Finalize();
+
+class BiasAddOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    const Shape in_shape = ctx->InputShape("a_0");
+    const Shape bias_shape = ctx->InputShape("b_0");
+    CHECK_EQ(bias_shape.NumAxes(), 1);
+    int32_t axis = ctx->Attr<int32_t>("axis");
+    if (axis < 0) { axis += in_shape.NumAxes(); }
+    CHECK_EQ(in_shape.At(axis), bias_shape.At(0));
+    // View the bias as [1, ..., C, ..., 1] to broadcast it along the other axes.
+    DimVector dim_vec(in_shape.NumAxes(), 1);
+    dim_vec[axis] = bias_shape.At(0);
+    const NativeValue bias = ctx->Input("b_0").Reshape(Shape(dim_vec));
+    ctx->SetOutput("out_0",
+                   ctx->builder()->Binary(NativeBinaryOp::kAdd, ctx->Input("a_0"), bias, in_shape));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(BiasAdd, BiasAddOp).Finalize();
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
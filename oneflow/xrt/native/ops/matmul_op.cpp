@@ -0,0 +1,87 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <cstring>
+
+#include "oneflow/core/common/blas.h"
+#include "oneflow/xrt/native/ops/op_context.h"
+#include "oneflow/xrt/native/ops/op_kernel.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+class MatMulOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    const Shape a_shape = ctx->InputShape("a_0");
+    const Shape b_shape = ctx->InputShape("b_0");
+    const int64_t num_axes = a_shape.NumAxes();
+    // Nodes of other shapes are not clustered, see IsCompiledNode.
+    CHECK_GE(num_axes, 2);
+    CHECK_EQ(num_axes, b_shape.NumAxes());
+    CHECK_EQ(a_shape.Count(0, num_axes - 2), b_shape.Count(0, num_axes - 2))
+        << "Batch dims of " << a_shape.ToString() << " and " << b_shape.ToString()
+        << " are not the same.";
+
+    const bool transpose_a = ctx->Attr<bool>("transpose_a");
+    const bool transpose_b = ctx->Attr<bool>("transpose_b");
+    const float alpha = static_cast<float>(ctx->Attr<double>("alpha"));
+    const int64_t batch = a_shape.Count(0, num_axes - 2);
+    const int64_t m = a_shape.At(transpose_a ? num_axes - 1 : num_axes - 2);
+    const int64_t k = a_shape.At(transpose_a ? num_axes - 2 : num_axes - 1);
+    const int64_t n = b_shape.At(transpose_b ? num_axes - 2 : num_axes - 1);
+    CHECK_EQ(k, b_shape.At(transpose_b ? num_axes - 1 : num_axes - 2));
+    const int64_t lda = transpose_a ? m : k;
+    const int64_t ldb = transpose_b ? k : n;
+    const enum CBLAS_TRANSPOSE trans_a = transpose_a ? CblasTrans : CblasNoTrans;
+    const enum CBLAS_TRANSPOSE trans_b = transpose_b ? CblasTrans : CblasNoTrans;
+
+    NativeProgramBuilder* builder = ctx->builder();
+    const Shape out_shape = ctx->SoleOutputShape();
+    const int64_t a = builder->Materialize(ctx->Input("a_0"));
+    const int64_t b = builder->Materialize(ctx->Input("b_0"));
+    const int64_t out = builder->AddArenaBuffer(out_shape);
+    std::vector<int64_t> reads{a, b};
+    int64_t add_to_output = -1;
+    if (ctx->HasInput("_add_to_output_0")) {
+      add_to_output = builder->Materialize(ctx->Input("_add_to_output_0"));
+      reads.push_back(add_to_output);
+    }
+    builder->AddInstruction(
+        [=](char** buffers) {
+          const float* a_ptr = reinterpret_cast<const float*>(buffers[a]);
+          const float* b_ptr = reinterpret_cast<const float*>(buffers[b]);
+          float* out_ptr = reinterpret_cast<float*>(buffers[out]);
+          float beta = 0.f;
+          if (add_to_output >= 0) {
+            std::memcpy(out_ptr, buffers[add_to_output], batch * m * n * sizeof(float));
+            beta = 1.f;
+          }
+          for (int64_t i = 0; i < batch; ++i) {
+            cblas_gemm<float>(CblasRowMajor, trans_a, trans_b, m, n, k, alpha, a_ptr + i * m * k,
+                              lda, b_ptr + i * k * n, ldb, beta, out_ptr + i * m * n, n);
+          }
+        },
+        reads, {out});
+    ctx->SetSoleOutput(NativeValue::Buffer(out, out_shape));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(MatMul, MatMulOp).Finalize();
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,161 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <algorithm>
+
+#include "oneflow/core/common/balanced_splitter.h"
+#include "oneflow/core/thread/thread_manager.h"
+#include "oneflow/xrt/native/ops/op_context.h"
+#include "oneflow/xrt/native/ops/op_kernel.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+namespace {
+
+// Minimum elements of a reduce pass handled by a thread.
+constexpr int64_t kMinElemsPerThread = 64 * kNativeBlockSize;
+
+// Reduces a [outer, r, inner] view of `src` along the middle axis into `out`.
+void ReduceSumPass(const NativeExprEvaluator& src, char** buffers, int64_t outer, int64_t r,
+                   int64_t inner, float* out) {
+  const int64_t elem_cnt = outer * r * inner;
+  if (inner == 1) {
+    // Rows are reduced by parallel partial sums if there are too few of them.
+    const int64_t max_chunks = std::max<int64_t>(elem_cnt / kMinElemsPerThread, 1);
+    const int64_t num_parts = std::min<int64_t>((max_chunks + outer - 1) / outer, r);
+    const int64_t num_tasks = outer * num_parts;
+    const int64_t num_chunks = std::min<int64_t>(num_tasks, max_chunks);
+    BalancedSplitter part_splitter(r, num_parts);
+    std::vector<double> partial_sums(num_tasks, 0.0);
+    BalancedSplitter chunk_splitter(num_tasks, num_chunks);
+    const auto ReduceChunk = [&](size_t chunk) {
+      NativeExprEvaluator::Scratch scratch;
+      src.InitScratch(&scratch);
+      const Range range = chunk_splitter.At(chunk);
+      for (int64_t task = range.begin(); task < range.end(); ++task) {
+        const int64_t o = task / num_parts;
+        const Range part = part_splitter.At(task % num_parts);
+        double sum = 0.0;
+        for (int64_t k = part.begin(); k < part.end(); k += kNativeBlockSize) {
+          const int64_t n = std::min<int64_t>(kNativeBlockSize, part.end() - k);
+          const float* x = src.Eval(buffers, o * r + k, n, &scratch);
+          float block_sum = 0.f;
+          for (int64_t i = 0; i < n; ++i) { block_sum += x[i]; }
+          sum += block_sum;
+        }
+        partial_sums[task] = sum;
+      }
+    };
+    if (num_chunks == 1) {
+      ReduceChunk(0);
+    } else {
+      MultiThreadLoop(num_chunks, ReduceChunk);
+    }
+    for (int64_t o = 0; o < outer; ++o) {
+      double sum = 0.0;
+      for (int64_t p = 0; p < num_parts; ++p) { sum += partial_sums[o * num_parts + p]; }
+      out[o] = static_cast<float>(sum);
+    }
+    return;
+  }
+  // Blocks of the inner axis are accumulated over the reduced axis.
+  const int64_t num_inner_blocks = RoundUp(inner, kNativeBlockSize) / kNativeBlockSize;
+  const int64_t num_tasks = outer * num_inner_blocks;
+  const int64_t num_chunks =
+      std::max<int64_t>(std::min<int64_t>(num_tasks, elem_cnt / kMinElemsPerThread), 1);
+  BalancedSplitter chunk_splitter(num_tasks, num_chunks);
+  const auto ReduceChunk = [&](size_t chunk) {
+    NativeExprEvaluator::Scratch scratch;
+    src.InitScratch(&scratch);
+    std::vector<float> acc(kNativeBlockSize);
+    const Range range = chunk_splitter.At(chunk);
+    for (int64_t task = range.begin(); task < range.end(); ++task) {
+      const int64_t o = task / num_inner_blocks;
+      const int64_t j = (task % num_inner_blocks) * kNativeBlockSize;
+      const int64_t n = std::min<int64_t>(kNativeBlockSize, inner - j);
+      std::fill(acc.begin(), acc.begin() + n, 0.f);
+      for (int64_t k = 0; k < r; ++k) {
+        const float* x = src.Eval(buffers, (o * r + k) * inner + j, n, &scratch);
+        for (int64_t i = 0; i < n; ++i) { acc[i] += x[i]; }
+      }
+      std::copy(acc.begin(), acc.begin() + n, out + o * inner + j);
+    }
+  };
+  if (num_chunks == 1) {
+    ReduceChunk(0);
+  } else {
+    MultiThreadLoop(num_chunks, ReduceChunk);
+  }
+}
+
+}  // namespace
+
+class ReduceSumOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    const Shape in_shape = ctx->SoleInputShape();
+    const Shape out_shape = ctx->SoleOutputShape();
+    std::vector<int32_t> axis = ctx->Attr<std::vector<int32_t>>("axis");
+    std::vector<bool> is_reduced(in_shape.NumAxes(), axis.empty());
+    for (int32_t i : axis) { is_reduced.at(i < 0 ? i + in_shape.NumAxes() : i) = true; }
+    // Adjacent axes are merged if both of them are reduced or kept, and axes of size 1 are
+    // dropped, so that the reduction is done by as few passes as possible.
+    std::vector<int64_t> group_sizes;
+    std::vector<bool> group_reduced;
+    for (int64_t i = 0; i < in_shape.NumAxes(); ++i) {
+      if (in_shape.At(i) == 1) { continue; }
+      if (!group_sizes.empty() && group_reduced.back() == is_reduced[i]) {
+        group_sizes.back() *= in_shape.At(i);
+      } else {
+        group_sizes.push_back(in_shape.At(i));
+        group_reduced.push_back(is_reduced[i]);
+      }
+    }
+    NativeProgramBuilder* builder = ctx->builder();
+    NativeValue value = ctx->SoleInput();
+    if (std::find(group_reduced.begin(), group_reduced.end(), true) == group_reduced.end()) {
+      ctx->SetSoleOutput(value.Reshape(out_shape));
+      return;
+    }
+    // Reduce from the innermost reduced group, the input expression is fused into the first pass.
+    for (int64_t g = group_sizes.size() - 1; g >= 0; --g) {
+      if (!group_reduced[g]) { continue; }
+      int64_t outer = 1;
+      for (int64_t i = 0; i < g; ++i) { outer *= group_sizes[i]; }
+      int64_t inner = 1;
+      for (int64_t i = g + 1; i < group_sizes.size(); ++i) { inner *= group_sizes[i]; }
+      const int64_t r = group_sizes[g];
+      const auto src = std::make_shared<NativeExprEvaluator>(*builder->AsExpr(value));
+      const Shape pass_shape({outer * inner});
+      const int64_t out = builder->AddArenaBuffer(pass_shape);
+      builder->AddInstruction(
+          [=](char** buffers) {
+            ReduceSumPass(*src, buffers, outer, r, inner, reinterpret_cast<float*>(buffers[out]));
+          },
+          src->buffer_ids(), {out});
+      value = NativeValue::Buffer(out, pass_shape);
+      group_sizes[g] = 1;
+    }
+    ctx->SetSoleOutput(value.Reshape(out_shape));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(ReduceSum, ReduceSumOp).Finalize();
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -0,0 +1,69 @@
+/*
+Copyright 2020 The OneFlow Authors. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "oneflow/xrt/native/ops/op_context.h"
+#include "oneflow/xrt/native/ops/op_kernel.h"
+
+namespace oneflow {
+namespace xrt {
+namespace native {
+
+template<NativeUnaryOp op>
+class ApplyUnaryOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    ctx->SetSoleOutput(ctx->builder()->Unary(op, 0.f, ctx->SoleInput()));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(Identity, ApplyUnaryOp<NativeUnaryOp::kIdentity>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(Relu, ApplyUnaryOp<NativeUnaryOp::kRelu>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(Sigmoid, ApplyUnaryOp<NativeUnaryOp::kSigmoid>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(Tanh, ApplyUnaryOp<NativeUnaryOp::kTanh>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(Gelu, ApplyUnaryOp<NativeUnaryOp::kGelu>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(Rsqrt, ApplyUnaryOp<NativeUnaryOp::kRsqrt>).Finalize();
+
+class LeakyReluOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    const float alpha = ctx->Attr<float>("alpha");
+    ctx->SetSoleOutput(ctx->builder()->Unary(NativeUnaryOp::kLeakyRelu, alpha, ctx->SoleInput()));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(LeakyRelu, LeakyReluOp).Finalize();
+
+template<NativeUnaryOp op>
+class ScalarBinaryOp : public NativeOpKernel {
+ public:
+  void Compile(NativeOpContext* ctx) override {
+    float scalar = 0.f;
+    if (ctx->Attr<bool>("has_int_operand")) {
+      scalar = static_cast<float>(ctx->Attr<int64_t>("int_operand"));
+    } else if (ctx->Attr<bool>("has_float_operand")) {
+      scalar = static_cast<float>(ctx->Attr<double>("float_operand"));
+    } else {
+      UNIMPLEMENTED();
+    }
+    ctx->SetSoleOutput(ctx->builder()->Unary(op, scalar, ctx->SoleInput()));
+  }
+};
+
+REGISTER_NATIVE_OP_KERNEL(ScalarAdd, ScalarBinaryOp<NativeUnaryOp::kAddScalar>).Finalize();
+REGISTER_NATIVE_OP_KERNEL(ScalarMul, ScalarBinaryOp<NativeUnaryOp::kMulScalar>).Finalize();
+
+}  // namespace native
+}  // namespace xrt
+}  // namespace oneflow
@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/xrt/node_util.h"
+#include "oneflow/core/common/data_type.pb.h"
 #include "oneflow/xrt/kernel/op_kernel.h"
 #include "oneflow/xrt/types.h"
 #include "oneflow/xrt/utility/message_attr.h"
@@ -22,6 +23,26 @@ limitations under the License.
 namespace oneflow {
 namespace xrt {
 
+namespace {
+
+// The native matmul multiplies a batch of matrices of the same batch dims, so
+// broadcasting between batch dims is left to the original kernel.
+bool IsNativeMatMulSupported(const XrtNode* node) {
+  util::Map<std::string, Shape> input_shapes;
+  for (const XrtEdge* edge : node->in_edges()) {
+    if (edge->IsControlEdge() || !edge->HasAttr("shape")) { continue; }
+    input_shapes.emplace(edge->argument().meta_data().consume_key, edge->Attr<Shape>("shape"));
+  }
+  if (input_shapes.count("a_0") == 0 || input_shapes.count("b_0") == 0) { return false; }
+  const Shape& a_shape = input_shapes.at("a_0");
+  const Shape& b_shape = input_shapes.at("b_0");
+  const int64_t num_axes = a_shape.NumAxes();
+  return num_axes >= 2 && b_shape.NumAxes() == num_axes
+         && a_shape.Count(0, num_axes - 2) == b_shape.Count(0, num_axes - 2);
+}
+
+}  // namespace
+
 const PbMessage* OpMessage(const XrtNode* node) {
   const PbMessage* message = &node->param();
   if (!node->IsArgumentNode()) {
@@ -33,6 +54,20 @@ const PbMessage* OpMessage(const XrtNode* node) {
 
 bool IsCompiledNode(const XrtNode* node, const XrtEngine& engine, const bool train_phase) {
   auto field = MakeXrtField(node->device(), engine);
+  if (engine == XrtEngine::NATIVE) {
+    // Kernels of the native engine only support float.
+    for (const XrtEdge* edge : node->in_edges()) {
+      if (edge->HasAttr("data_type") && edge->Attr<DataType>("data_type") != DataType::kFloat) {
+        return false;
+      }
+    }
+    for (const XrtEdge* edge : node->out_edges()) {
+      if (edge->HasAttr("data_type") && edge->Attr<DataType>("data_type") != DataType::kFloat) {
+        return false;
+      }
+    }
+    if (node->type() == "MatMul" && !IsNativeMatMulSupported(node)) { return false; }
+  }
   return OpKernelRegistered(node->type(), field)
          && (!train_phase || TrainPhaseEnabled(node->type(), field));
 }
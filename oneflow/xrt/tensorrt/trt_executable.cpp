@@ -14,7 +14,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include "oneflow/xrt/tensorrt/trt_executable.h"
+#include "oneflow/xrt/compilation_cache.h"
 #include "oneflow/xrt/tensorrt/trt_int8_calibrator.h"
+#include "oneflow/xrt/tensorrt/trt_logger.h"
 #include "oneflow/xrt/platform.h"
 
 #include <iostream>
@@ -142,7 +144,8 @@ bool TrtExecutable::Run(const std::vector<Parameter>& inputs,
   }
   // TODO(hjchen2): Check batch size is same for all binding parameters.
   const int batch_size = binding_params[0]->shape().At(0);
-  if (batch_size > engine_->getMaxBatchSize()) {
+  // A deserialized engine has no builder and can not be rebuilt.
+  if (builder_ && batch_size > engine_->getMaxBatchSize()) {
     LOG(WARNING) << "Rebuild engine since the maximum batch size "  // NOLINT
                  << engine_->getMaxBatchSize()                      // NOLINT
                  << " is less than the input batch size " << batch_size;
@@ -186,6 +189,44 @@ bool TrtExecutable::Run(const std::vector<Parameter>& inputs,
                        block_until_done);
 }
 
+int64_t TrtExecutable::ByteSize() const {
+  return engine_ ? engine_->getDeviceMemorySize() : 0;
+}
+
+bool TrtExecutable::Serialize(std::string* data) const {
+  // The engine is built on the first run.
+  if (!engine_ || calibrator_) { return false; }
+  auto serialized = nv::unique_ptr<nvinfer1::IHostMemory>(engine_->serialize());
+  if (!serialized) { return false; }
+  data->assign(reinterpret_cast<const char*>(serialized->data()), serialized->size());
+  return true;
+}
+
+std::vector<std::string> TrtExecutable::ConstantParameterNames() const {
+  std::vector<std::string> names;
+  for (const auto& pair : host_weights_) { names.push_back(pair.first); }
+  return names;
+}
+
+namespace {
+
+std::shared_ptr<Executable> DeserializeTrtExecutable(const std::string& name,
+                                                     const std::string& data) {
+  static nv::Logger logger;
+  // The runtime should outlive the engines deserialized by it.
+  static nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger);
+  nv::unique_ptr<nvinfer1::ICudaEngine> engine(
+      runtime->deserializeCudaEngine(data.data(), data.size(), nullptr));
+  if (!engine) { return nullptr; }
+  return std::make_shared<TrtExecutable>(
+      name, std::move(engine), util::Map<std::string, std::shared_ptr<std::vector<uint8_t>>>{});
+}
+
+}  // namespace
+
+REGISTER_EXECUTABLE_DESERIALIZER(XrtEngine::TENSORRT, std::to_string(getInferLibVersion()),
+                                 DeserializeTrtExecutable);
+
 }  // namespace tensorrt
 
 }  // namespace xrt
@@ -53,6 +53,12 @@ class TrtExecutable : public Executable {
   bool Run(const std::vector<Parameter>& inputs, const ExecutableRunOptions& run_options,
            bool block_until_done = true) override;
 
+  int64_t ByteSize() const override;
+
+  bool Serialize(std::string* data) const override;
+
+  std::vector<std::string> ConstantParameterNames() const override;
+
  private:
   nvinfer1::ICudaEngine* CreateExecutableEngine(const ExecutableRunOptions& run_options,
                                                 const int batch_size = 1,
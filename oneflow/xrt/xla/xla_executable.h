@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef ONEFLOW_XRT_XLA_XLA_EXECUTABLE_H_
 #define ONEFLOW_XRT_XLA_XLA_EXECUTABLE_H_
 
+#include <algorithm>
+
 #include "oneflow/xrt/executable.h"
 #include "tensorflow/compiler/xla/client/local_client.h"
 
@@ -39,6 +41,10 @@ class XlaExecutable : public Executable {
   bool Run(const std::vector<Parameter>& inputs, const ExecutableRunOptions& run_options,
            bool block_until_done = true) override;
 
+  int64_t ByteSize() const override {
+    return std::max<int64_t>(executable_->executable()->SizeOfGeneratedCodeInBytes(), 0);
+  }
+
  private:
   XrtDevice device_;
 